@@ -1421,13 +1421,13 @@ normalize (bfd *abfd, const char *file)
    utility from interpreting those lines as prototypes to put into
    the autogenerated bfd.h header...
 
-   Note - the string is returned in a static buffer.  */
+   Note - the string is returned in a static buffer, one per thread.  */
 
 static const char *
 adjust_relative_path (const char * path, const char * ref_path)
 {
-  static char *pathbuf = NULL;
-  static unsigned int pathbuf_len = 0;
+  static TLS char *pathbuf = NULL;
+  static TLS unsigned int pathbuf_len = 0;
   const char *pathp;
   const char *refp;
   char * lpath;
@@ -829,6 +829,13 @@ typedef struct bfd_section
   /* Explicitly specified section type, if non-zero.  */
   unsigned int type;
 
+  /* Contents handed out by bfd_get_section_view, if any.  */
+  struct bfd_section_view *view;
+
+  /* For a section decompressed on reading, the pieces it was
+     compressed in, once part of its contents has been read.  */
+  struct decompress_chunks *decompress_chunks;
+
 } asection;
 
 static inline const char *
@@ -1002,8 +1009,11 @@ discarded_section (const asection *sec)
   /* symbol,                    symbol_ptr_ptr,                     */ \
      (struct bfd_symbol *) SYM, &SEC.symbol,                           \
 								       \
-  /* map_head, map_tail, already_assigned, type                     */ \
-     { NULL }, { NULL }, NULL,             0                           \
+  /* map_head, map_tail, already_assigned, type, view,              */ \
+     { NULL }, { NULL }, NULL,             0,    NULL,                 \
+								       \
+  /* decompress_chunks                                              */ \
+     NULL                                                              \
 								       \
     }
 
@@ -1076,6 +1086,14 @@ bool bfd_get_section_contents
 bool bfd_malloc_and_get_section
    (bfd *abfd, asection *section, bfd_byte **buf);
 
+bool bfd_section_view_mappable (bfd *abfd, asection *section);
+
+bool bfd_get_section_view
+   (bfd *abfd, asection *section, const bfd_byte **buf,
+    bfd_size_type *size);
+
+void bfd_release_section_view (bfd *abfd, asection *section);
+
 bool bfd_copy_private_section_data
    (bfd *ibfd, asection *isec, bfd *obfd, asection *osec);
 
@@ -2541,6 +2559,17 @@ unsigned int bfd_init (void);
 /* Value returned by bfd_init.  */
 #define BFD_INIT_MAGIC (sizeof (struct bfd_section))
 
+typedef bool (*bfd_lock_unlock_fn_type) (void *);
+
+bool bfd_thread_init
+   (bfd_lock_unlock_fn_type lock,
+    bfd_lock_unlock_fn_type unlock,
+    void *data);
+
+void bfd_thread_cleanup (void);
+
+unsigned int bfd_set_thread_count (unsigned int count);
+
 long bfd_get_reloc_upper_bound (bfd *abfd, asection *sect);
 
 long bfd_canonicalize_reloc
@@ -706,14 +706,14 @@ CODE_FRAGMENT
 .
 INTERNAL
 .{* A buffer that is freed on bfd_close.  *}
-.extern char *_bfd_error_buf;
+.extern TLS char *_bfd_error_buf;
 .
 */
 
-static bfd_error_type bfd_error;
-static bfd_error_type input_error;
-static bfd *input_bfd;
-char *_bfd_error_buf;
+static TLS bfd_error_type bfd_error;
+static TLS bfd_error_type input_error;
+static TLS bfd *input_bfd;
+TLS char *_bfd_error_buf;
 
 const char *const bfd_errmsgs[] =
 {
@@ -750,7 +750,8 @@ SYNOPSIS
 	bfd_error_type bfd_get_error (void);
 
 DESCRIPTION
-	Return the current BFD error condition.
+	Return the current BFD error condition.  Each thread has its
+	own error condition.
 */
 
 bfd_error_type
@@ -1467,7 +1468,7 @@ err_sprintf (void *stream, const char *fmt, ...)
 /* Communicate the bfd processed by bfd_check_format_matches to the
    error handling function error_handler_sprintf.  */
 
-static bfd *error_handler_bfd;
+static TLS bfd *error_handler_bfd;
 
 /* An error handler that prints to a string, then dups that string to
    a per-xvec cache.  */
@@ -1503,6 +1504,13 @@ error_handler_sprintf (const char *fmt, va_list ap)
 
 static bfd_error_handler_type _bfd_error_internal = error_handler_fprintf;
 
+/* If not NULL, the routine handling BFD error messages in this thread
+   in place of _bfd_error_internal.  bfd_check_format_matches uses this
+   to collect or silence the messages for the bfd it is checking
+   without affecting other threads.  */
+
+static TLS bfd_error_handler_type _bfd_thread_error_internal;
+
 /*
 FUNCTION
 	_bfd_error_handler
@@ -1529,7 +1537,10 @@ _bfd_error_handler (const char *fmt, ...)
   va_list ap;
 
   va_start (ap, fmt);
-  _bfd_error_internal (fmt, ap);
+  if (_bfd_thread_error_internal != NULL)
+    _bfd_thread_error_internal (fmt, ap);
+  else
+    _bfd_error_internal (fmt, ap);
   va_end (ap);
 }
 
@@ -1542,7 +1553,8 @@ SYNOPSIS
 
 DESCRIPTION
 	Set the BFD error handler function.  Returns the previous
-	function.
+	function.  The handler is shared by all threads, and may be
+	called from several threads at once.
 */
 
 bfd_error_handler_type
@@ -1555,6 +1567,31 @@ bfd_set_error_handler (bfd_error_handler_type pnew)
   return pold;
 }
 
+/*
+INTERNAL_FUNCTION
+	_bfd_set_thread_error_handler
+
+SYNOPSIS
+	bfd_error_handler_type _bfd_set_thread_error_handler
+	  (bfd_error_handler_type);
+
+DESCRIPTION
+	Set the BFD error handler function of the calling thread,
+	overriding the one set by bfd_set_error_handler, or remove the
+	override if the argument is NULL.  Returns the previous
+	override.
+*/
+
+bfd_error_handler_type
+_bfd_set_thread_error_handler (bfd_error_handler_type pnew)
+{
+  bfd_error_handler_type pold;
+
+  pold = _bfd_thread_error_internal;
+  _bfd_thread_error_internal = pnew;
+  return pold;
+}
+
 /*
 INTERNAL_FUNCTION
 	_bfd_set_error_handler_caching
@@ -1563,15 +1600,16 @@ SYNOPSIS
 	bfd_error_handler_type _bfd_set_error_handler_caching (bfd *);
 
 DESCRIPTION
-	Set the BFD error handler function to one that stores messages
-	to the per_xvec_warn array.  Returns the previous function.
+	Set the BFD error handler function of the calling thread to one
+	that stores messages to the per_xvec_warn array.  Returns the
+	previous override, see _bfd_set_thread_error_handler.
 */
 
 bfd_error_handler_type
 _bfd_set_error_handler_caching (bfd *abfd)
 {
   error_handler_bfd = abfd;
-  return bfd_set_error_handler (error_handler_sprintf);
+  return _bfd_set_thread_error_handler (error_handler_sprintf);
 }
 
 /*
@@ -1708,10 +1746,219 @@ bfd_init (void)
   input_error = bfd_error_no_error;
   _bfd_error_program_name = NULL;
   _bfd_error_internal = error_handler_fprintf;
+  _bfd_thread_error_internal = NULL;
   _bfd_assert_handler = _bfd_default_assert_handler;
 
   return BFD_INIT_MAGIC;
 }
+
+/*
+SUBSECTION
+	Threading
+
+	BFD has limited support for use from several threads.  A
+	program that wants this must call <<bfd_thread_init>> once,
+	before starting any other threads that use BFD, to provide
+	functions that lock and unlock a mutex.  BFD then protects its
+	global data, such as the cache of open files (@pxref{File
+	Caching}) and the counters used to number BFDs and sections,
+	with that mutex, so section ids stay unique across threads.
+	The error state (@pxref{Error reporting}) is kept per thread,
+	so <<bfd_get_error>> returns the last error of the calling
+	thread.
+
+	With that, different threads may use different BFDs at the same
+	time, including opening them with <<bfd_openr>>, recognizing them
+	with <<bfd_check_format>>, reading their symbols and section
+	contents, and looking up source lines with
+	<<bfd_find_nearest_line>>.
+
+	A given BFD must only be used by one thread at a time; it is up
+	to the program to serialize calls on a BFD shared between
+	threads.  The members of a (non-thin) archive share the file,
+	and the file position, of the archive, so all of them count as
+	one BFD together with the archive for this purpose.
+	<<bfd_init>>, <<bfd_set_error_handler>> and the other functions
+	that change process-wide settings must not be called while
+	other threads use BFD.  The error handler itself may be called
+	from several threads at once.
+
+CODE_FRAGMENT
+.typedef bool (*bfd_lock_unlock_fn_type) (void *);
+.
+*/
+
+/* The functions and their argument set by bfd_thread_init.  */
+
+static bfd_lock_unlock_fn_type lock_fn;
+static bfd_lock_unlock_fn_type unlock_fn;
+static void *lock_data;
+
+/*
+FUNCTION
+	bfd_thread_init
+
+SYNOPSIS
+	bool bfd_thread_init
+	  (bfd_lock_unlock_fn_type lock,
+	   bfd_lock_unlock_fn_type unlock,
+	   void *data);
+
+DESCRIPTION
+	Make BFD safe to use from several threads, as described above.
+	@var{lock} and @var{unlock} are called with @var{data} to lock
+	and unlock a single mutex protecting the global data of BFD.
+	BFD never takes the mutex recursively.  The functions return
+	true on success, or set the BFD error and return false on
+	failure.
+
+	This may only be called once.  Returns false, setting the BFD
+	error, if it was called before or if BFD was built without
+	support for thread-local storage.
+*/
+
+bool
+bfd_thread_init (bfd_lock_unlock_fn_type lock, bfd_lock_unlock_fn_type unlock,
+		 void *data)
+{
+#ifdef BFD_NO_TLS
+  (void) lock;
+  (void) unlock;
+  (void) data;
+  bfd_set_error (bfd_error_sorry);
+  return false;
+#else
+  if (lock == NULL || unlock == NULL || lock_fn != NULL)
+    {
+      bfd_set_error (bfd_error_invalid_operation);
+      return false;
+    }
+
+  lock_fn = lock;
+  unlock_fn = unlock;
+  lock_data = data;
+  return true;
+#endif
+}
+
+/*
+FUNCTION
+	bfd_thread_cleanup
+
+SYNOPSIS
+	void bfd_thread_cleanup (void);
+
+DESCRIPTION
+	Free the memory BFD keeps for the calling thread.  A thread
+	that used BFD should call this before it exits.  It is fine to
+	call this several times.
+*/
+
+void
+bfd_thread_cleanup (void)
+{
+  free (_bfd_error_buf);
+  _bfd_error_buf = NULL;
+  input_bfd = NULL;
+}
+
+/* The setting made by bfd_set_thread_count.  */
+
+static unsigned int thread_count = 1;
+
+/*
+FUNCTION
+	bfd_set_thread_count
+
+SYNOPSIS
+	unsigned int bfd_set_thread_count (unsigned int count);
+
+DESCRIPTION
+	Let BFD use up to @var{count} threads of its own for work done
+	within a single call, such as compressing or decompressing a
+	large section in pieces.  A @var{count} of 0 means one thread
+	per processor.  The default of 1 does all such work on the
+	calling thread.  Returns the previous setting.
+*/
+
+unsigned int
+bfd_set_thread_count (unsigned int count)
+{
+  unsigned int old = thread_count;
+
+  thread_count = count;
+  return old;
+}
+
+/*
+INTERNAL_FUNCTION
+	_bfd_thread_count
+
+SYNOPSIS
+	unsigned int _bfd_thread_count (void);
+
+DESCRIPTION
+	Return the number of threads BFD may use for work within a
+	single call, as set by bfd_set_thread_count, and at least 1.
+*/
+
+unsigned int
+_bfd_thread_count (void)
+{
+  unsigned int count = thread_count;
+
+#if defined (HAVE_SYSCONF) && defined (_SC_NPROCESSORS_ONLN)
+  if (count == 0)
+    {
+      long n = sysconf (_SC_NPROCESSORS_ONLN);
+      if (n > 0)
+	count = n;
+    }
+#endif
+  if (count == 0)
+    count = 1;
+  return count;
+}
+
+/*
+INTERNAL_FUNCTION
+	bfd_lock
+
+SYNOPSIS
+	bool bfd_lock (void);
+
+DESCRIPTION
+	Acquire the global BFD lock, if bfd_thread_init was called.
+	Returns false, with the BFD error set, on failure.
+*/
+
+bool
+bfd_lock (void)
+{
+  if (lock_fn != NULL)
+    return lock_fn (lock_data);
+  return true;
+}
+
+/*
+INTERNAL_FUNCTION
+	bfd_unlock
+
+SYNOPSIS
+	bool bfd_unlock (void);
+
+DESCRIPTION
+	Release the global BFD lock taken by bfd_lock.  Returns false,
+	with the BFD error set, on failure.
+*/
+
+bool
+bfd_unlock (void)
+{
+  if (unlock_fn != NULL)
+    return unlock_fn (lock_data);
+  return true;
+}
 
 /*
 INODE
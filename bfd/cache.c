@@ -217,10 +217,16 @@ close_one (void)
   return bfd_cache_delete (to_kill);
 }
 
+static bool cache_init_unlocked (bfd *);
+static FILE *open_file_unlocked (bfd *);
+
 /* Check to see if the required BFD is the same as the last one
    looked up. If so, then it can use the stream in the BFD with
    impunity, since it can't have changed since the last lookup;
-   otherwise, it has to perform the complicated lookup function.  */
+   otherwise, it has to perform the complicated lookup function.
+
+   The cache is shared by all threads, so this and everything using
+   the stream it returns must be done with the BFD lock held.  */
 
 #define bfd_cache_lookup(x, flag) \
   ((x) == bfd_last_cache			\
@@ -258,7 +264,7 @@ bfd_cache_lookup_worker (bfd *abfd, enum cache_flag flag)
   if (flag & CACHE_NO_OPEN)
     return NULL;
 
-  if (bfd_open_file (abfd) == NULL)
+  if (open_file_unlocked (abfd) == NULL)
     ;
   else if (!(flag & CACHE_NO_SEEK)
 	   && _bfd_real_fseek ((FILE *) abfd->iostream,
@@ -277,19 +283,35 @@ bfd_cache_lookup_worker (bfd *abfd, enum cache_flag flag)
 static file_ptr
 cache_btell (struct bfd *abfd)
 {
-  FILE *f = bfd_cache_lookup (abfd, CACHE_NO_OPEN);
+  file_ptr result;
+  FILE *f;
+
+  if (!bfd_lock ())
+    return -1;
+  f = bfd_cache_lookup (abfd, CACHE_NO_OPEN);
   if (f == NULL)
-    return abfd->where;
-  return _bfd_real_ftell (f);
+    result = abfd->where;
+  else
+    result = _bfd_real_ftell (f);
+  if (!bfd_unlock ())
+    return -1;
+  return result;
 }
 
 static int
 cache_bseek (struct bfd *abfd, file_ptr offset, int whence)
 {
-  FILE *f = bfd_cache_lookup (abfd, whence != SEEK_CUR ? CACHE_NO_SEEK : CACHE_NORMAL);
-  if (f == NULL)
+  int result = -1;
+  FILE *f;
+
+  if (!bfd_lock ())
     return -1;
-  return _bfd_real_fseek (f, offset, whence);
+  f = bfd_cache_lookup (abfd, whence != SEEK_CUR ? CACHE_NO_SEEK : CACHE_NORMAL);
+  if (f != NULL)
+    result = _bfd_real_fseek (f, offset, whence);
+  if (!bfd_unlock ())
+    return -1;
+  return result;
 }
 
 /* Note that archive entries don't have streams; they share their parent's.
@@ -340,9 +362,14 @@ cache_bread (struct bfd *abfd, void *buf, file_ptr nbytes)
   file_ptr nread = 0;
   FILE *f;
 
+  if (!bfd_lock ())
+    return -1;
   f = bfd_cache_lookup (abfd, CACHE_NORMAL);
   if (f == NULL)
-    return -1;
+    {
+      bfd_unlock ();
+      return -1;
+    }
 
   /* Some filesystems are unable to handle reads that are too large
      (for instance, NetApp shares with oplocks turned off).  To avoid
@@ -373,6 +400,8 @@ cache_bread (struct bfd *abfd, void *buf, file_ptr nbytes)
 	break;
     }
 
+  if (!bfd_unlock ())
+    return -1;
   return nread;
 }
 
@@ -380,16 +409,26 @@ static file_ptr
 cache_bwrite (struct bfd *abfd, const void *from, file_ptr nbytes)
 {
   file_ptr nwrite;
-  FILE *f = bfd_cache_lookup (abfd, CACHE_NORMAL);
+  FILE *f;
 
+  if (!bfd_lock ())
+    return -1;
+  f = bfd_cache_lookup (abfd, CACHE_NORMAL);
   if (f == NULL)
-    return 0;
+    {
+      if (!bfd_unlock ())
+	return -1;
+      return 0;
+    }
   nwrite = fwrite (from, 1, nbytes, f);
   if (nwrite < nbytes && ferror (f))
     {
       bfd_set_error (bfd_error_system_call);
+      bfd_unlock ();
       return -1;
     }
+  if (!bfd_unlock ())
+    return -1;
   return nwrite;
 }
 
@@ -402,28 +441,40 @@ cache_bclose (struct bfd *abfd)
 static int
 cache_bflush (struct bfd *abfd)
 {
-  int sts;
-  FILE *f = bfd_cache_lookup (abfd, CACHE_NO_OPEN);
+  int sts = 0;
+  FILE *f;
 
-  if (f == NULL)
-    return 0;
-  sts = fflush (f);
-  if (sts < 0)
-    bfd_set_error (bfd_error_system_call);
+  if (!bfd_lock ())
+    return -1;
+  f = bfd_cache_lookup (abfd, CACHE_NO_OPEN);
+  if (f != NULL)
+    {
+      sts = fflush (f);
+      if (sts < 0)
+	bfd_set_error (bfd_error_system_call);
+    }
+  if (!bfd_unlock ())
+    return -1;
   return sts;
 }
 
 static int
 cache_bstat (struct bfd *abfd, struct stat *sb)
 {
-  int sts;
-  FILE *f = bfd_cache_lookup (abfd, CACHE_NO_SEEK_ERROR);
+  int sts = -1;
+  FILE *f;
 
-  if (f == NULL)
+  if (!bfd_lock ())
+    return -1;
+  f = bfd_cache_lookup (abfd, CACHE_NO_SEEK_ERROR);
+  if (f != NULL)
+    {
+      sts = fstat (fileno (f), sb);
+      if (sts < 0)
+	bfd_set_error (bfd_error_system_call);
+    }
+  if (!bfd_unlock ())
     return -1;
-  sts = fstat (fileno (f), sb);
-  if (sts < 0)
-    bfd_set_error (bfd_error_system_call);
   return sts;
 }
 
@@ -449,9 +500,14 @@ cache_bmmap (struct bfd *abfd ATTRIBUTE_UNUSED,
       file_ptr pg_offset;
       bfd_size_type pg_len;
 
+      if (!bfd_lock ())
+	return ret;
       f = bfd_cache_lookup (abfd, CACHE_NO_SEEK_ERROR);
       if (f == NULL)
-	return ret;
+	{
+	  bfd_unlock ();
+	  return ret;
+	}
 
       if (pagesize_m1 == 0)
 	pagesize_m1 = getpagesize () - 1;
@@ -469,6 +525,8 @@ cache_bmmap (struct bfd *abfd ATTRIBUTE_UNUSED,
 	  *map_len = pg_len;
 	  ret = (char *) ret + (offset & pagesize_m1);
 	}
+      if (!bfd_unlock ())
+	return (void *) -1;
     }
 #endif
 
@@ -492,8 +550,8 @@ DESCRIPTION
 	Add a newly opened BFD to the cache.
 */
 
-bool
-bfd_cache_init (bfd *abfd)
+static bool
+cache_init_unlocked (bfd *abfd)
 {
   BFD_ASSERT (abfd->iostream != NULL);
   if (open_files >= bfd_cache_max_open ())
@@ -508,6 +566,19 @@ bfd_cache_init (bfd *abfd)
   return true;
 }
 
+bool
+bfd_cache_init (bfd *abfd)
+{
+  bool ret;
+
+  if (!bfd_lock ())
+    return false;
+  ret = cache_init_unlocked (abfd);
+  if (!bfd_unlock ())
+    return false;
+  return ret;
+}
+
 /*
 FUNCTION
 	bfd_cache_close
@@ -523,8 +594,8 @@ DESCRIPTION
 	returned if all is well.
 */
 
-bool
-bfd_cache_close (bfd *abfd)
+static bool
+cache_close_unlocked (bfd *abfd)
 {
   /* Don't remove this test.  bfd_reinit depends on it.  */
   if (abfd->iovec != &cache_iovec)
@@ -537,6 +608,19 @@ bfd_cache_close (bfd *abfd)
   return bfd_cache_delete (abfd);
 }
 
+bool
+bfd_cache_close (bfd *abfd)
+{
+  bool ret;
+
+  if (!bfd_lock ())
+    return false;
+  ret = cache_close_unlocked (abfd);
+  if (!bfd_unlock ())
+    return false;
+  return ret;
+}
+
 /*
 FUNCTION
 	bfd_cache_close_all
@@ -559,17 +643,21 @@ bfd_cache_close_all (void)
 {
   bool ret = true;
 
+  if (!bfd_lock ())
+    return false;
   while (bfd_last_cache != NULL)
     {
       bfd *prev_bfd_last_cache = bfd_last_cache;
 
-      ret &= bfd_cache_close (bfd_last_cache);
+      ret &= cache_close_unlocked (bfd_last_cache);
 
-      /* Stop a potential infinite loop should bfd_cache_close()
+      /* Stop a potential infinite loop should cache_close_unlocked()
 	 not update bfd_last_cache.  */
       if (bfd_last_cache == prev_bfd_last_cache)
 	break;
     }
+  if (!bfd_unlock ())
+    return false;
 
   return ret;
 }
@@ -589,8 +677,8 @@ DESCRIPTION
 	cache, so it won't have to be removed from it.
 */
 
-FILE *
-bfd_open_file (bfd *abfd)
+static FILE *
+open_file_unlocked (bfd *abfd)
 {
   abfd->cacheable = true;	/* Allow it to be closed later.  */
 
@@ -655,9 +743,22 @@ bfd_open_file (bfd *abfd)
     bfd_set_error (bfd_error_system_call);
   else
     {
-      if (! bfd_cache_init (abfd))
+      if (! cache_init_unlocked (abfd))
 	return NULL;
     }
 
   return (FILE *) abfd->iostream;
 }
+
+FILE *
+bfd_open_file (bfd *abfd)
+{
+  FILE *ret;
+
+  if (!bfd_lock ())
+    return NULL;
+  ret = open_file_unlocked (abfd);
+  if (!bfd_unlock ())
+    return NULL;
+  return ret;
+}
@@ -28,9 +28,22 @@
 #include "libbfd.h"
 #include "safe-ctype.h"
 #include "libiberty.h"
+#ifdef ENABLE_THREADS
+#include <pthread.h>
+#endif
 
 #define MAX_COMPRESSION_HEADER_SIZE 24
 
+/* Sections larger than this are compressed in pieces of this many
+   bytes, which can be compressed and decompressed independently of
+   each other.  With zstd each piece is a frame of its own; with zlib
+   each ends in a full flush, so the section is still a single zlib
+   stream.  */
+#define COMPRESS_CHUNK_SIZE (4 * 1024 * 1024)
+
+/* The most threads used to compress or decompress one section.  */
+#define COMPRESS_MAX_THREADS 16
+
 /*
 EXTERNAL
 .{* Types of compressed DWARF debug sections.  *}
@@ -502,6 +515,299 @@ bfd_convert_section_contents (bfd *ibfd, sec_ptr isec, bfd *obfd,
   return true;
 }
 
+/* One piece of a section compressed in chunks.  */
+
+struct compress_chunk
+{
+  /* The uncompressed data, and its offset in the section.  */
+  bfd_byte *data;
+  size_t size;
+  size_t offset;
+  /* The compressed data.  */
+  bfd_byte *cdata;
+  size_t csize;
+  /* Where the compressed data starts in the section, for a piece
+     which is read when needed.  */
+  file_ptr coffset;
+  /* The Adler-32 checksum of DATA, for zlib.  */
+  uLong adler;
+  /* Set for the piece which ends the zlib stream.  */
+  bool last;
+};
+
+/* A set of chunks to be compressed or decompressed.  */
+
+struct compress_chunks
+{
+  struct compress_chunk *chunk;
+  unsigned int count;
+  bool (*process) (struct compress_chunk *);
+  /* The next chunk to process.  */
+  unsigned int next;
+  bool failed;
+#ifdef ENABLE_THREADS
+  /* Guards NEXT and FAILED.  */
+  pthread_mutex_t lock;
+#endif
+};
+
+static void *
+compress_chunks_worker (void *arg)
+{
+  struct compress_chunks *work = (struct compress_chunks *) arg;
+  unsigned int i;
+
+  for (;;)
+    {
+#ifdef ENABLE_THREADS
+      pthread_mutex_lock (&work->lock);
+#endif
+      i = work->next;
+      if (i < work->count && !work->failed)
+	work->next++;
+      else
+	i = work->count;
+#ifdef ENABLE_THREADS
+      pthread_mutex_unlock (&work->lock);
+#endif
+      if (i == work->count)
+	break;
+      if (!work->process (&work->chunk[i]))
+	{
+#ifdef ENABLE_THREADS
+	  pthread_mutex_lock (&work->lock);
+#endif
+	  work->failed = true;
+#ifdef ENABLE_THREADS
+	  pthread_mutex_unlock (&work->lock);
+#endif
+	}
+    }
+  return NULL;
+}
+
+/* Run WORK->PROCESS on each chunk of WORK, sharing them out among
+   threads when there are several chunks and bfd_set_thread_count
+   allows it.  The result does not depend on the number of threads.  */
+
+static bool
+process_compress_chunks (struct compress_chunks *work)
+{
+  work->next = 0;
+  work->failed = false;
+#ifdef ENABLE_THREADS
+  pthread_t threads[COMPRESS_MAX_THREADS - 1];
+  unsigned int nthreads = _bfd_thread_count (), started, i;
+
+  if (nthreads > work->count)
+    nthreads = work->count;
+  if (nthreads > COMPRESS_MAX_THREADS)
+    nthreads = COMPRESS_MAX_THREADS;
+
+  if (pthread_mutex_init (&work->lock, NULL) != 0)
+    {
+      bfd_set_error (bfd_error_no_memory);
+      return false;
+    }
+  /* If a thread cannot be started, the others do its share.  */
+  for (started = 0; started + 1 < nthreads; started++)
+    if (pthread_create (&threads[started], NULL,
+			compress_chunks_worker, work) != 0)
+      break;
+  compress_chunks_worker (work);
+  for (i = 0; i < started; i++)
+    pthread_join (threads[i], NULL);
+  pthread_mutex_destroy (&work->lock);
+#else
+  compress_chunks_worker (work);
+#endif
+  return !work->failed;
+}
+
+static bool
+zlib_compress_chunk (struct compress_chunk *chunk)
+{
+  z_stream strm;
+  uLong bound;
+  int rc;
+
+  memset (&strm, 0, sizeof strm);
+  if (deflateInit2 (&strm, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS,
+		    8, Z_DEFAULT_STRATEGY) != Z_OK)
+    return false;
+  /* deflateBound allows for Z_FINISH; a full flush adds an empty
+     stored block.  */
+  bound = deflateBound (&strm, chunk->size) + 16;
+  chunk->cdata = bfd_malloc (bound);
+  if (chunk->cdata == NULL)
+    {
+      deflateEnd (&strm);
+      return false;
+    }
+  strm.next_in = chunk->data;
+  strm.avail_in = chunk->size;
+  strm.next_out = chunk->cdata;
+  strm.avail_out = bound;
+  rc = deflate (&strm, chunk->last ? Z_FINISH : Z_FULL_FLUSH);
+  chunk->csize = bound - strm.avail_out;
+  chunk->adler = adler32 (adler32 (0, NULL, 0), chunk->data, chunk->size);
+  /* The stream is left unfinished after a flush, which deflateEnd
+     reports as an error; the output is complete all the same.  */
+  deflateEnd (&strm);
+  return (chunk->last
+	  ? rc == Z_STREAM_END
+	  : rc == Z_OK && strm.avail_in == 0 && strm.avail_out != 0);
+}
+
+#ifdef HAVE_ZSTD
+static bool
+zstd_compress_chunk (struct compress_chunk *chunk)
+{
+  size_t bound = ZSTD_compressBound (chunk->size);
+
+  chunk->cdata = bfd_malloc (bound);
+  if (chunk->cdata == NULL)
+    return false;
+  chunk->csize = ZSTD_compress (chunk->cdata, bound, chunk->data, chunk->size,
+				ZSTD_CLEVEL_DEFAULT);
+  return !ZSTD_isError (chunk->csize);
+}
+
+static bool
+zstd_decompress_chunk (struct compress_chunk *chunk)
+{
+  size_t ret = ZSTD_decompress (chunk->data, chunk->size,
+				chunk->cdata, chunk->csize);
+  return !ZSTD_isError (ret) && ret == chunk->size;
+}
+
+/* Split the SIZE bytes of zstd data at DATA into its frames.  Return
+   the number of frames, with a malloc'd array describing them in
+   *CHUNKS.  Return 0 if a frame does not record how big it is when
+   decompressed, or if the frames do not decompress to exactly
+   UNCOMPRESSED_SIZE bytes.  */
+
+static unsigned int
+zstd_frames (bfd_byte *data, size_t size, size_t uncompressed_size,
+	     struct compress_chunk **chunks)
+{
+  struct compress_chunk *chunk = NULL;
+  unsigned int count = 0, alloc = 0;
+  size_t offset = 0;
+
+  while (size != 0)
+    {
+      size_t csize = ZSTD_findFrameCompressedSize (data, size);
+      unsigned long long usize;
+
+      if (ZSTD_isError (csize))
+	break;
+      usize = ZSTD_getFrameContentSize (data, csize);
+      if (usize == ZSTD_CONTENTSIZE_UNKNOWN
+	  || usize == ZSTD_CONTENTSIZE_ERROR
+	  || usize > uncompressed_size - offset)
+	break;
+      if (count == alloc)
+	{
+	  struct compress_chunk *n;
+
+	  alloc = alloc ? alloc * 2 : 16;
+	  n = bfd_realloc (chunk, alloc * sizeof (*chunk));
+	  if (n == NULL)
+	    break;
+	  chunk = n;
+	}
+      memset (&chunk[count], 0, sizeof (*chunk));
+      chunk[count].cdata = data;
+      chunk[count].csize = csize;
+      chunk[count].offset = offset;
+      chunk[count].size = usize;
+      count++;
+      offset += usize;
+      data += csize;
+      size -= csize;
+    }
+
+  if (size != 0 || offset != uncompressed_size)
+    {
+      free (chunk);
+      return 0;
+    }
+  *chunks = chunk;
+  return count;
+}
+#endif
+
+/* Compress SIZE bytes at DATA, in chunks, to at most BUFFER_SIZE
+   bytes at BUFFER.  Return the compressed size, BUFFER_SIZE if the
+   result does not fit, or 0 on error.  */
+
+static size_t
+compress_chunked (bool is_zstd, bfd_byte *data, size_t size,
+		  bfd_byte *buffer, size_t buffer_size)
+{
+  struct compress_chunks work;
+  size_t total, off;
+  unsigned int i;
+
+  memset (&work, 0, sizeof work);
+  work.count = (size + COMPRESS_CHUNK_SIZE - 1) / COMPRESS_CHUNK_SIZE;
+  work.chunk = bfd_zmalloc (work.count * sizeof (*work.chunk));
+  if (work.chunk == NULL)
+    return 0;
+  for (i = 0, off = 0; i < work.count; i++, off += COMPRESS_CHUNK_SIZE)
+    {
+      work.chunk[i].data = data + off;
+      work.chunk[i].size = (size - off < COMPRESS_CHUNK_SIZE
+			    ? size - off : COMPRESS_CHUNK_SIZE);
+    }
+  work.chunk[work.count - 1].last = true;
+#ifdef HAVE_ZSTD
+  work.process = is_zstd ? zstd_compress_chunk : zlib_compress_chunk;
+#else
+  if (is_zstd)
+    abort ();
+  work.process = zlib_compress_chunk;
+#endif
+
+  total = 0;
+  if (process_compress_chunks (&work))
+    {
+      /* A zlib stream starts with the header "compress" would write,
+	 and ends with the checksum of all the data.  */
+      total = is_zstd ? 0 : 2 + 4;
+      for (i = 0; i < work.count; i++)
+	total += work.chunk[i].csize;
+      if (total > buffer_size)
+	total = buffer_size;
+      else
+	{
+	  bfd_byte *p = buffer;
+	  uLong adler = adler32 (0, NULL, 0);
+
+	  if (!is_zstd)
+	    {
+	      *p++ = 0x78;
+	      *p++ = 0x9c;
+	    }
+	  for (i = 0; i < work.count; i++)
+	    {
+	      memcpy (p, work.chunk[i].cdata, work.chunk[i].csize);
+	      p += work.chunk[i].csize;
+	      adler = adler32_combine (adler, work.chunk[i].adler,
+				       work.chunk[i].size);
+	    }
+	  if (!is_zstd)
+	    bfd_putb32 (adler, p);
+	}
+    }
+
+  for (i = 0; i < work.count; i++)
+    free (work.chunk[i].cdata);
+  free (work.chunk);
+  return total;
+}
+
 static bool
 decompress_contents (bool is_zstd, bfd_byte *compressed_buffer,
 		     bfd_size_type compressed_size,
@@ -511,8 +817,29 @@ decompress_contents (bool is_zstd, bfd_byte *compressed_buffer,
   if (is_zstd)
     {
 #ifdef HAVE_ZSTD
-      size_t ret = ZSTD_decompress (uncompressed_buffer, uncompressed_size,
-				    compressed_buffer, compressed_size);
+      struct compress_chunks work;
+      size_t ret;
+
+      /* Decompress the frames of a section compressed in chunks
+	 side by side.  */
+      memset (&work, 0, sizeof work);
+      if (uncompressed_size > COMPRESS_CHUNK_SIZE
+	  && (work.count = zstd_frames (compressed_buffer, compressed_size,
+					uncompressed_size, &work.chunk)) != 0)
+	{
+	  bool ok;
+	  unsigned int i;
+
+	  for (i = 0; i < work.count; i++)
+	    work.chunk[i].data = uncompressed_buffer + work.chunk[i].offset;
+	  work.process = zstd_decompress_chunk;
+	  ok = process_compress_chunks (&work);
+	  free (work.chunk);
+	  return ok;
+	}
+
+      ret = ZSTD_decompress (uncompressed_buffer, uncompressed_size,
+			     compressed_buffer, compressed_size);
       return !ZSTD_isError (ret);
 #endif
     }
@@ -647,7 +974,22 @@ bfd_compress_section_contents (bfd *abfd, sec_ptr sec)
     }
   else
     {
-      if (abfd->flags & BFD_COMPRESS_ZSTD)
+      if (uncompressed_size > COMPRESS_CHUNK_SIZE)
+	{
+	  compressed_size = compress_chunked ((abfd->flags
+					       & BFD_COMPRESS_ZSTD) != 0,
+					      input_buffer, uncompressed_size,
+					      buffer + new_header_size,
+					      compressed_size
+					      - new_header_size);
+	  if (compressed_size == 0)
+	    {
+	      bfd_release (abfd, buffer);
+	      bfd_set_error (bfd_error_bad_value);
+	      return 0;
+	    }
+	}
+      else if (abfd->flags & BFD_COMPRESS_ZSTD)
 	{
 #if HAVE_ZSTD
 	  compressed_size = ZSTD_compress (buffer + new_header_size,
@@ -696,6 +1038,44 @@ bfd_compress_section_contents (bfd *abfd, sec_ptr sec)
   return uncompressed_size;
 }
 
+/* Read SIZE bytes at OFFSET in the compressed contents of SEC,
+   compression header and all, into a malloc'd buffer.  */
+
+static bfd_byte *
+read_compressed_contents (bfd *abfd, sec_ptr sec, file_ptr offset,
+			  bfd_size_type size)
+{
+  const unsigned int compress_status = sec->compress_status;
+  bfd_size_type save_size;
+  bfd_size_type save_rawsize;
+  bfd_byte *compressed_buffer;
+  bool ret;
+
+  compressed_buffer = (bfd_byte *) bfd_malloc (size);
+  if (compressed_buffer == NULL)
+    return NULL;
+  save_rawsize = sec->rawsize;
+  save_size = sec->size;
+  /* Clear rawsize, set size to compressed size and set compress_status
+     to COMPRESS_SECTION_NONE.  If the compressed size is bigger than
+     the uncompressed size, bfd_get_section_contents will fail.  */
+  sec->rawsize = 0;
+  sec->size = sec->compressed_size;
+  sec->compress_status = COMPRESS_SECTION_NONE;
+  ret = bfd_get_section_contents (abfd, sec, compressed_buffer,
+				  offset, size);
+  /* Restore rawsize and size.  */
+  sec->rawsize = save_rawsize;
+  sec->size = save_size;
+  sec->compress_status = compress_status;
+  if (!ret)
+    {
+      free (compressed_buffer);
+      return NULL;
+    }
+  return compressed_buffer;
+}
+
 /*
 FUNCTION
 	bfd_get_full_section_contents
@@ -720,9 +1100,6 @@ bfd_get_full_section_contents (bfd *abfd, sec_ptr sec, bfd_byte **ptr)
   bfd_size_type readsz = bfd_get_section_limit_octets (abfd, sec);
   bfd_size_type allocsz = bfd_get_section_alloc_size (abfd, sec);
   bfd_byte *p = *ptr;
-  bool ret;
-  bfd_size_type save_size;
-  bfd_size_type save_rawsize;
   bfd_byte *compressed_buffer;
   unsigned int compression_header_size;
   const unsigned int compress_status = sec->compress_status;
@@ -776,25 +1153,10 @@ bfd_get_full_section_contents (bfd *abfd, sec_ptr sec, bfd_byte **ptr)
     case DECOMPRESS_SECTION_ZLIB:
     case DECOMPRESS_SECTION_ZSTD:
       /* Read in the full compressed section contents.  */
-      compressed_buffer = (bfd_byte *) bfd_malloc (sec->compressed_size);
+      compressed_buffer = read_compressed_contents (abfd, sec, 0,
+						    sec->compressed_size);
       if (compressed_buffer == NULL)
 	return false;
-      save_rawsize = sec->rawsize;
-      save_size = sec->size;
-      /* Clear rawsize, set size to compressed size and set compress_status
-	 to COMPRESS_SECTION_NONE.  If the compressed size is bigger than
-	 the uncompressed size, bfd_get_section_contents will fail.  */
-      sec->rawsize = 0;
-      sec->size = sec->compressed_size;
-      sec->compress_status = COMPRESS_SECTION_NONE;
-      ret = bfd_get_section_contents (abfd, sec, compressed_buffer,
-				      0, sec->compressed_size);
-      /* Restore rawsize and size.  */
-      sec->rawsize = save_rawsize;
-      sec->size = save_size;
-      sec->compress_status = compress_status;
-      if (!ret)
-	goto fail_compressed;
 
       if (p == NULL)
 	p = (bfd_byte *) bfd_malloc (allocsz);
@@ -843,6 +1205,180 @@ bfd_get_full_section_contents (bfd *abfd, sec_ptr sec, bfd_byte **ptr)
     }
 }
 
+/* The pieces a section decompressed on reading was compressed in,
+   recorded by the first partial read of its contents.  */
+
+struct decompress_chunks
+{
+  /* Each piece's offset and size in the decompressed contents, and
+     the offset and size of its compressed data.  A section which was
+     not compressed in zstd frames is a single piece.  */
+  struct compress_chunk *chunk;
+  unsigned int count;
+  /* The piece last decompressed into DATA, or COUNT if none.  */
+  unsigned int cached;
+  bfd_byte *data;
+};
+
+/* Record the pieces SEC was compressed in, in SEC->decompress_chunks.
+   Finding the zstd frames reads all of the compressed data once;
+   after that, only the frames being read are fetched.  */
+
+static bool
+init_decompress_chunks (bfd *abfd, sec_ptr sec)
+{
+  bfd_size_type size = bfd_get_section_limit_octets (abfd, sec);
+  struct decompress_chunks *chunks;
+  unsigned int header_size;
+
+  if (_bfd_section_size_insane (abfd, sec))
+    {
+      bfd_set_error (bfd_error_bad_value);
+      return false;
+    }
+  header_size = bfd_get_compression_header_size (abfd, sec);
+  if (header_size == 0)
+    header_size = 12;
+
+  chunks = bfd_zmalloc (sizeof (*chunks));
+  if (chunks == NULL)
+    return false;
+
+#ifdef HAVE_ZSTD
+  if (sec->compress_status == DECOMPRESS_SECTION_ZSTD
+      && size > COMPRESS_CHUNK_SIZE)
+    {
+      bfd_byte *buffer;
+      unsigned int i;
+
+      buffer = read_compressed_contents (abfd, sec, 0, sec->compressed_size);
+      if (buffer == NULL)
+	{
+	  free (chunks);
+	  return false;
+	}
+      chunks->count = zstd_frames (buffer + header_size,
+				   sec->compressed_size - header_size,
+				   size, &chunks->chunk);
+      for (i = 0; i < chunks->count; i++)
+	{
+	  chunks->chunk[i].coffset = chunks->chunk[i].cdata - buffer;
+	  chunks->chunk[i].cdata = NULL;
+	}
+      free (buffer);
+    }
+#endif
+
+  if (chunks->count == 0)
+    {
+      chunks->chunk = bfd_zmalloc (sizeof (*chunks->chunk));
+      if (chunks->chunk == NULL)
+	{
+	  free (chunks);
+	  return false;
+	}
+      chunks->count = 1;
+      chunks->chunk[0].size = size;
+      chunks->chunk[0].coffset = header_size;
+      chunks->chunk[0].csize = sec->compressed_size - header_size;
+    }
+  chunks->cached = chunks->count;
+  sec->decompress_chunks = chunks;
+  return true;
+}
+
+/* Read and decompress piece I of SEC into BUF.  */
+
+static bool
+decompress_chunk (bfd *abfd, sec_ptr sec, unsigned int i, bfd_byte *buf)
+{
+  struct compress_chunk *c = &sec->decompress_chunks->chunk[i];
+  bfd_byte *cdata;
+  bool ok;
+
+  cdata = read_compressed_contents (abfd, sec, c->coffset, c->csize);
+  if (cdata == NULL)
+    return false;
+  ok = decompress_contents (sec->compress_status == DECOMPRESS_SECTION_ZSTD,
+			    cdata, c->csize, buf, c->size);
+  free (cdata);
+  if (!ok)
+    bfd_set_error (bfd_error_bad_value);
+  return ok;
+}
+
+/* Read COUNT bytes at OFFSET in the decompressed contents of SEC,
+   which is to be decompressed on reading.  Only the pieces holding
+   the requested bytes are read and decompressed.  The last piece
+   read in part is kept, so reading a section a little at a time
+   decompresses each piece once.  */
+
+bool
+_bfd_get_decompressed_section_contents (bfd *abfd, sec_ptr sec,
+					void *location, file_ptr offset,
+					bfd_size_type count)
+{
+  struct decompress_chunks *chunks;
+  size_t start = offset, end = offset + count;
+  unsigned int i;
+
+  if (sec->decompress_chunks == NULL
+      && !init_decompress_chunks (abfd, sec))
+    return false;
+  chunks = sec->decompress_chunks;
+
+  for (i = 0; i < chunks->count; i++)
+    {
+      struct compress_chunk *c = &chunks->chunk[i];
+      size_t from, to;
+
+      if (c->offset + c->size <= start || c->offset >= end)
+	continue;
+      if (c->offset >= start && c->offset + c->size <= end
+	  && i != chunks->cached)
+	{
+	  /* All of the piece is wanted.  */
+	  if (!decompress_chunk (abfd, sec, i,
+				 (bfd_byte *) location + (c->offset - start)))
+	    return false;
+	  continue;
+	}
+      if (i != chunks->cached)
+	{
+	  free (chunks->data);
+	  chunks->cached = chunks->count;
+	  chunks->data = bfd_malloc (c->size);
+	  if (chunks->data == NULL
+	      || !decompress_chunk (abfd, sec, i, chunks->data))
+	    return false;
+	  chunks->cached = i;
+	}
+      from = c->offset > start ? c->offset : start;
+      to = c->offset + c->size < end ? c->offset + c->size : end;
+      memcpy ((bfd_byte *) location + (from - start),
+	      chunks->data + (from - c->offset), to - from);
+    }
+  return true;
+}
+
+/* Free the pieces recorded by partial reads of the sections of
+   ABFD.  */
+
+void
+_bfd_free_decompress_chunks (bfd *abfd)
+{
+  asection *sec;
+
+  for (sec = abfd->sections; sec != NULL; sec = sec->next)
+    if (sec->decompress_chunks != NULL)
+      {
+	free (sec->decompress_chunks->chunk);
+	free (sec->decompress_chunks->data);
+	free (sec->decompress_chunks);
+	sec->decompress_chunks = NULL;
+      }
+}
+
 /*
 FUNCTION
 	bfd_is_section_compressed_info
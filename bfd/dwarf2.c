@@ -211,6 +211,10 @@ struct dwarf2_debug_file
   /* A pointer to the memory block allocated for .debug_info sections.  */
   bfd_byte *dwarf_info_buffer;
 
+  /* If dwarf_info_buffer is a section view rather than malloc'd, the
+     section it belongs to.  */
+  asection *dwarf_info_view;
+
   /* Length of the loaded .debug_info sections.  */
   bfd_size_type dwarf_info_size;
 
@@ -338,6 +342,27 @@ struct dwarf2_debug
 
   /* True if we opened bfd_ptr.  */
   bool close_on_cleanup;
+
+  /* Address ranges of the compilation units in f, as recorded by
+     .gdb_index or .debug_aranges, sorted by low address.  Read when
+     an address lookup first misses the units parsed so far.  */
+  struct unit_index_range *unit_index;
+  size_t unit_index_count;
+  bool unit_index_read;
+};
+
+/* An entry in the unit index above.  */
+
+struct unit_index_range
+{
+  bfd_vma low;
+  bfd_vma high;
+
+  /* The highest HIGH of this and all preceding entries.  */
+  bfd_vma max_high;
+
+  /* Offset of the compilation unit in .debug_info.  */
+  uint64_t unit_offset;
 };
 
 struct arange
@@ -1834,7 +1859,15 @@ struct funcinfo
   int line;
   int tag;
   bool is_linkage;
+  /* Whether the symbols have been searched for one at the start of
+     this function, giving SYM_NAME and SYM_FILE.  Only done if NAME is
+     not a linkage name.  */
+  bool sym_searched;
   const char *name;
+  /* The name of the symbol at the start of the function, if any.  */
+  const char *sym_name;
+  /* The file symbol for that symbol, if any.  */
+  const char *sym_file;
   struct arange arange;
   /* The offset of the funcinfo from the start of the unit.  */
   uint64_t unit_offset;
@@ -2892,9 +2925,11 @@ decode_line_info (struct comp_unit *unit)
       bfd_vma low_pc  = (bfd_vma) -1;
       bfd_vma high_pc = 0;
 
+      /* The file register starts at 1 in every DWARF version, which
+	 for DWARF 5 need not be the primary source file in entry 0.  */
       if (table->num_files)
 	{
-	  if (table->use_dir_and_file_0)
+	  if (table->use_dir_and_file_0 && table->num_files == 1)
 	    filename = concat_filename (table, 0);
 	  else
 	    filename = concat_filename (table, 1);
@@ -3901,7 +3936,7 @@ scan_unit_for_symbols (struct comp_unit *unit)
       abbrev = lookup_abbrev (abbrev_number, unit->abbrevs);
       if (! abbrev)
 	{
-	  static unsigned int previous_failed_abbrev = -1U;
+	  static TLS unsigned int previous_failed_abbrev = -1U;
 
 	  /* Avoid multiple reports of the same missing abbrev.  */
 	  if (abbrev_number != previous_failed_abbrev)
@@ -5484,12 +5519,36 @@ _bfd_dwarf2_slurp_debug_info (bfd *abfd, bfd *debug_bfd,
 
   if (! find_debug_info (debug_bfd, debug_sections, msec))
     {
-      /* Case 1: only one info section.  */
-      total_size = msec->size;
-      if (! read_section (debug_bfd, &stash->debug_sections[debug_info],
-			  symbols, 0,
-			  &stash->f.dwarf_info_buffer, &total_size))
-	goto restore_vma;
+      /* Case 1: only one info section.  If it needs no relocation,
+	 and its BFD lives at least as long as the stash, look at the
+	 contents in place rather than copying them.  */
+      if ((debug_bfd == abfd || stash->close_on_cleanup)
+	  && (msec->flags & SEC_HAS_CONTENTS) != 0
+	  && ((debug_bfd->flags & (HAS_RELOC | EXEC_P | DYNAMIC)) != HAS_RELOC
+	      || (msec->flags & SEC_RELOC) == 0))
+	{
+	  const bfd_byte *view;
+
+	  if (_bfd_section_size_insane (debug_bfd, msec))
+	    {
+	      /* PR 26946 */
+	      _bfd_error_handler (_("DWARF error: section %s is too big"),
+				  msec->name);
+	      goto restore_vma;
+	    }
+	  if (!bfd_get_section_view (debug_bfd, msec, &view, &total_size))
+	    goto restore_vma;
+	  stash->f.dwarf_info_buffer = (bfd_byte *) view;
+	  stash->f.dwarf_info_view = msec;
+	}
+      else
+	{
+	  total_size = msec->size;
+	  if (! read_section (debug_bfd, &stash->debug_sections[debug_info],
+			      symbols, 0,
+			      &stash->f.dwarf_info_buffer, &total_size))
+	    goto restore_vma;
+	}
     }
   else
     {
@@ -5542,34 +5601,48 @@ _bfd_dwarf2_slurp_debug_info (bfd *abfd, bfd *debug_bfd,
   return false;
 }
 
-/* Parse the next DWARF2 compilation unit at FILE->INFO_PTR.  */
+/* Return the compilation unit read from FILE which contains
+   INFO_PTR, if any.  */
 
 static struct comp_unit *
-stash_comp_unit (struct dwarf2_debug *stash, struct dwarf2_debug_file *file)
+lookup_comp_unit (struct dwarf2_debug_file *file, bfd_byte *info_ptr)
 {
-  bfd_size_type length;
-  unsigned int offset_size;
-  bfd_byte *info_ptr_unit = file->info_ptr;
-  bfd_byte *info_ptr_end = file->dwarf_info_buffer + file->dwarf_info_size;
+  /* A one byte range, since an empty one at the start of a unit would
+     also match the unit before.  */
+  struct addr_range range = { info_ptr, info_ptr + 1 };
+  splay_tree_node v;
 
-  if (file->info_ptr >= info_ptr_end)
+  if (file->comp_unit_tree == NULL)
     return NULL;
+  v = splay_tree_lookup (file->comp_unit_tree, (splay_tree_key) &range);
+  return v != NULL ? (struct comp_unit *) v->value : NULL;
+}
 
-  length = read_4_bytes (file->bfd_ptr, &file->info_ptr, info_ptr_end);
+/* Read the length of the compilation unit header at *INFO_PTR,
+   advancing *INFO_PTR past it and setting *OFFSET_SIZE to the size of
+   the offsets in the unit.  */
+
+static bfd_size_type
+read_comp_unit_length (bfd *abfd, bfd_byte **info_ptr,
+		       bfd_byte *info_ptr_end, unsigned int *offset_size)
+{
+  bfd_size_type length;
+
+  length = read_4_bytes (abfd, info_ptr, info_ptr_end);
   /* A 0xffffff length is the DWARF3 way of indicating
      we use 64-bit offsets, instead of 32-bit offsets.  */
   if (length == 0xffffffff)
     {
-      offset_size = 8;
-      length = read_8_bytes (file->bfd_ptr, &file->info_ptr, info_ptr_end);
+      *offset_size = 8;
+      length = read_8_bytes (abfd, info_ptr, info_ptr_end);
     }
   /* A zero length is the IRIX way of indicating 64-bit offsets,
      mostly because the 64-bit length will generally fit in 32
      bits, and the endianness helps.  */
   else if (length == 0)
     {
-      offset_size = 8;
-      length = read_4_bytes (file->bfd_ptr, &file->info_ptr, info_ptr_end);
+      *offset_size = 8;
+      length = read_4_bytes (abfd, info_ptr, info_ptr_end);
     }
   /* In the absence of the hints above, we assume 32-bit DWARF2
      offsets even for targets with 64-bit addresses, because:
@@ -5581,49 +5654,101 @@ stash_comp_unit (struct dwarf2_debug *stash, struct dwarf2_debug_file *file)
      the size hints that are tested for above then they are
      not conforming to the DWARF3 standard anyway.  */
   else
-    offset_size = 4;
+    *offset_size = 4;
+  return length;
+}
+
+/* Parse the DWARF2 compilation unit at INFO_PTR_UNIT in FILE, and add
+   it to the units read from FILE.  Return NULL on error, or if the
+   unit would overlap one already read.  */
+
+static struct comp_unit *
+read_comp_unit (struct dwarf2_debug *stash, struct dwarf2_debug_file *file,
+		bfd_byte *info_ptr_unit)
+{
+  bfd_size_type length;
+  unsigned int offset_size;
+  bfd_byte *info_ptr = info_ptr_unit;
+  bfd_byte *info_ptr_end = file->dwarf_info_buffer + file->dwarf_info_size;
+  struct comp_unit *each;
+  struct addr_range *r;
+
+  length = read_comp_unit_length (file->bfd_ptr, &info_ptr, info_ptr_end,
+				  &offset_size);
+  if (length == 0
+      || length > (size_t) (info_ptr_end - info_ptr))
+    return NULL;
+
+  /* Units may be read out of order when found through an index, so
+     make sure this one does not overlap any already read.  */
+  struct addr_range range = { info_ptr_unit, info_ptr + length };
+  if (file->comp_unit_tree != NULL
+      && splay_tree_lookup (file->comp_unit_tree,
+			    (splay_tree_key) &range) != NULL)
+    return NULL;
+
+  each = parse_comp_unit (stash, file, info_ptr, length, info_ptr_unit,
+			  offset_size);
+  if (each == NULL)
+    return NULL;
+
+  if (file->comp_unit_tree == NULL)
+    file->comp_unit_tree
+      = splay_tree_new (splay_tree_compare_addr_range,
+			splay_tree_free_addr_range, NULL);
+
+  r = (struct addr_range *) bfd_malloc (sizeof (struct addr_range));
+  r->start = each->info_ptr_unit;
+  r->end = each->end_ptr;
+  splay_tree_node v = splay_tree_lookup (file->comp_unit_tree,
+					 (splay_tree_key)r);
+  if (v != NULL || r->end <= r->start)
+    abort ();
+  splay_tree_insert (file->comp_unit_tree, (splay_tree_key)r,
+		     (splay_tree_value)each);
+
+  if (file->all_comp_units)
+    file->all_comp_units->prev_unit = each;
+  else
+    file->last_comp_unit = each;
+
+  each->next_unit = file->all_comp_units;
+  file->all_comp_units = each;
 
-  if (length != 0
-      && length <= (size_t) (info_ptr_end - file->info_ptr))
+  if (each->arange.high == 0)
     {
-      struct comp_unit *each = parse_comp_unit (stash, file,
-						file->info_ptr, length,
-						info_ptr_unit, offset_size);
-      if (each)
-	{
-	  if (file->comp_unit_tree == NULL)
-	    file->comp_unit_tree
-	      = splay_tree_new (splay_tree_compare_addr_range,
-				splay_tree_free_addr_range, NULL);
-
-	  struct addr_range *r
-	    = (struct addr_range *)bfd_malloc (sizeof (struct addr_range));
-	  r->start = each->info_ptr_unit;
-	  r->end = each->end_ptr;
-	  splay_tree_node v = splay_tree_lookup (file->comp_unit_tree,
-						 (splay_tree_key)r);
-	  if (v != NULL || r->end <= r->start)
-	    abort ();
-	  splay_tree_insert (file->comp_unit_tree, (splay_tree_key)r,
-			     (splay_tree_value)each);
-
-	  if (file->all_comp_units)
-	    file->all_comp_units->prev_unit = each;
-	  else
-	    file->last_comp_unit = each;
+      each->next_unit_without_ranges = file->all_comp_units_without_ranges;
+      file->all_comp_units_without_ranges = each->next_unit_without_ranges;
+    }
 
-	  each->next_unit = file->all_comp_units;
-	  file->all_comp_units = each;
+  return each;
+}
 
-	  if (each->arange.high == 0)
-	    {
-	      each->next_unit_without_ranges = file->all_comp_units_without_ranges;
-	      file->all_comp_units_without_ranges = each->next_unit_without_ranges;
-	    }
+/* Parse the next DWARF2 compilation unit at FILE->INFO_PTR, skipping
+   any units already read.  */
+
+static struct comp_unit *
+stash_comp_unit (struct dwarf2_debug *stash, struct dwarf2_debug_file *file)
+{
+  bfd_byte *info_ptr_end = file->dwarf_info_buffer + file->dwarf_info_size;
+  struct comp_unit *each;
 
-	  file->info_ptr += length;
+  while (file->info_ptr < info_ptr_end)
+    {
+      each = lookup_comp_unit (file, file->info_ptr);
+      if (each == NULL)
+	{
+	  each = read_comp_unit (stash, file, file->info_ptr);
+	  if (each == NULL)
+	    break;
+	  file->info_ptr = each->end_ptr;
 	  return each;
 	}
+      /* A unit read through the index which does not start here
+	 straddles a unit boundary, so one of them is bogus.  */
+      if (each->info_ptr_unit != file->info_ptr)
+	break;
+      file->info_ptr = each->end_ptr;
     }
 
   /* Don't trust any of the DWARF info after a corrupted length or
@@ -5632,6 +5757,341 @@ stash_comp_unit (struct dwarf2_debug *stash, struct dwarf2_debug_file *file)
   return NULL;
 }
 
+/* Append the range LOW to HIGH of the unit at UNIT_OFFSET in
+   .debug_info to STASH's unit index, which has room for *ALLOC
+   entries.  */
+
+static bool
+add_unit_index_range (struct dwarf2_debug *stash, size_t *alloc,
+		      bfd_vma low, bfd_vma high, uint64_t unit_offset)
+{
+  struct unit_index_range *r;
+
+  if (low >= high || unit_offset >= stash->f.dwarf_info_size)
+    return true;
+
+  if (stash->unit_index_count == *alloc)
+    {
+      size_t amt = *alloc != 0 ? *alloc * 2 : 64;
+
+      r = (struct unit_index_range *)
+	bfd_realloc (stash->unit_index, amt * sizeof (*r));
+      if (r == NULL)
+	return false;
+      stash->unit_index = r;
+      *alloc = amt;
+    }
+
+  r = &stash->unit_index[stash->unit_index_count++];
+  r->low = low;
+  r->high = high;
+  r->unit_offset = unit_offset;
+  return true;
+}
+
+/* Read the address area of a .gdb_index section SEC into STASH's unit
+   index.  Return FALSE if SEC is not an index we understand.  */
+
+static bool
+read_gdb_index (struct dwarf2_debug *stash, asection *sec, size_t *alloc)
+{
+  bfd_size_type size = bfd_section_size (sec);
+  bfd_byte *buf;
+  bfd_byte *p;
+  uint32_t version, cu_list, types_list, addr_area, symtab, cu_count;
+  bool ret = false;
+
+  /* Versions 7 to 9 share the header fields and address area used
+     here.  Everything in the index is little-endian.  */
+  if (size < 24
+      || !bfd_malloc_and_get_section (stash->f.bfd_ptr, sec, &buf))
+    return false;
+
+  version = bfd_getl32 (buf);
+  cu_list = bfd_getl32 (buf + 4);
+  types_list = bfd_getl32 (buf + 8);
+  addr_area = bfd_getl32 (buf + 12);
+  symtab = bfd_getl32 (buf + 16);
+  if (version >= 7 && version <= 9
+      && cu_list <= types_list
+      && types_list <= addr_area
+      && addr_area <= symtab
+      && symtab <= size)
+    {
+      cu_count = (types_list - cu_list) / 16;
+      ret = true;
+      for (p = buf + addr_area; buf + symtab - p >= 20; p += 20)
+	{
+	  uint32_t cu_index = bfd_getl32 (p + 16);
+
+	  /* Type units have no code.  */
+	  if (cu_index >= cu_count)
+	    continue;
+	  if (!add_unit_index_range (stash, alloc,
+				     bfd_getl64 (p), bfd_getl64 (p + 8),
+				     bfd_getl64 (buf + cu_list
+						 + cu_index * 16)))
+	    {
+	      ret = false;
+	      break;
+	    }
+	}
+    }
+
+  free (buf);
+  return ret;
+}
+
+/* Read the .debug_aranges section of STASH into its unit index.  */
+
+static bool
+read_debug_aranges (struct dwarf2_debug *stash, size_t *alloc)
+{
+  bfd *abfd = stash->f.bfd_ptr;
+  bfd_byte *buf = NULL;
+  bfd_size_type size;
+  bfd_byte *p, *end;
+  bool ret = true;
+
+  if (!read_section (abfd, &stash->debug_sections[debug_aranges], NULL, 0,
+		     &buf, &size))
+    return false;
+
+  p = buf;
+  end = buf + size;
+  while (ret && p < end)
+    {
+      bfd_byte *set = p;
+      bfd_byte *set_end;
+      uint64_t length, unit_offset;
+      unsigned int offset_size, version, addr_size, seg_size, tuple_size;
+
+      length = read_4_bytes (abfd, &p, end);
+      offset_size = 4;
+      if (length == 0xffffffff)
+	{
+	  length = read_8_bytes (abfd, &p, end);
+	  offset_size = 8;
+	}
+      if (length == 0 || length > (size_t) (end - p))
+	break;
+      set_end = p + length;
+
+      version = read_2_bytes (abfd, &p, set_end);
+      unit_offset = read_n_bytes (abfd, &p, set_end, offset_size);
+      addr_size = read_1_byte (abfd, &p, set_end);
+      seg_size = read_1_byte (abfd, &p, set_end);
+      if (version == 2
+	  && seg_size == 0
+	  && (addr_size == 2 || addr_size == 4 || addr_size == 8))
+	{
+	  /* The tuples are aligned to their size from the start of
+	     the set.  */
+	  tuple_size = 2 * addr_size;
+	  p = set + (p - set + tuple_size - 1) / tuple_size * tuple_size;
+	  while (ret && set_end - p >= tuple_size)
+	    {
+	      bfd_vma low = read_n_bytes (abfd, &p, set_end, addr_size);
+	      bfd_vma len = read_n_bytes (abfd, &p, set_end, addr_size);
+
+	      if (low == 0 && len == 0)
+		break;
+	      ret = add_unit_index_range (stash, alloc, low, low + len,
+					  unit_offset);
+	    }
+	}
+      p = set_end;
+    }
+
+  free (buf);
+  return ret;
+}
+
+/* Compare two unit index entries by low address, for qsort.  */
+
+static int
+compare_unit_index_ranges (const void *a, const void *b)
+{
+  const struct unit_index_range *r1 = (const struct unit_index_range *) a;
+  const struct unit_index_range *r2 = (const struct unit_index_range *) b;
+
+  if (r1->low != r2->low)
+    return r1->low < r2->low ? -1 : 1;
+  if (r1->unit_offset != r2->unit_offset)
+    return r1->unit_offset < r2->unit_offset ? -1 : 1;
+  return 0;
+}
+
+/* Compare two unit index entries by unit offset, for qsort.  */
+
+static int
+compare_unit_index_offsets (const void *a, const void *b)
+{
+  const struct unit_index_range *r1 = (const struct unit_index_range *) a;
+  const struct unit_index_range *r2 = (const struct unit_index_range *) b;
+
+  if (r1->unit_offset != r2->unit_offset)
+    return r1->unit_offset < r2->unit_offset ? -1 : 1;
+  return 0;
+}
+
+/* Remove the entries of STASH's unit index whose offset is not the
+   start of a unit found by walking .debug_info from its start, as
+   stash_comp_unit does.  A unit read at any other offset would
+   overlap the units around it.  Only the unit lengths are read.  */
+
+static void
+check_unit_index_offsets (struct dwarf2_debug *stash)
+{
+  struct dwarf2_debug_file *file = &stash->f;
+  bfd_byte *info_ptr = file->dwarf_info_buffer;
+  bfd_byte *info_ptr_end = info_ptr + file->dwarf_info_size;
+  size_t i, j;
+
+  qsort (stash->unit_index, stash->unit_index_count,
+	 sizeof (*stash->unit_index), compare_unit_index_offsets);
+  for (i = j = 0; i < stash->unit_index_count; i++)
+    {
+      uint64_t unit_offset = stash->unit_index[i].unit_offset;
+
+      while (info_ptr < info_ptr_end
+	     && (uint64_t) (info_ptr - file->dwarf_info_buffer) < unit_offset)
+	{
+	  bfd_byte *p = info_ptr;
+	  unsigned int offset_size;
+	  bfd_size_type length;
+
+	  length = read_comp_unit_length (file->bfd_ptr, &p, info_ptr_end,
+					  &offset_size);
+	  if (length == 0 || length > (size_t) (info_ptr_end - p))
+	    info_ptr = info_ptr_end;
+	  else
+	    info_ptr = p + length;
+	}
+      if (info_ptr < info_ptr_end
+	  && (uint64_t) (info_ptr - file->dwarf_info_buffer) == unit_offset)
+	stash->unit_index[j++] = stash->unit_index[i];
+    }
+  stash->unit_index_count = j;
+}
+
+/* Build STASH's unit index from .gdb_index if there is one, otherwise
+   from .debug_aranges.  .debug_names maps names rather than addresses
+   to units, so is no help here.  Only a single unrelocated .debug_info
+   section is indexed in a way that matches how we read it.  */
+
+static void
+read_unit_index (struct dwarf2_debug *stash)
+{
+  bfd *abfd = stash->f.bfd_ptr;
+  const struct dwarf_debug_section *aranges;
+  asection *msec;
+  size_t alloc = 0;
+  size_t i;
+  bool ok = false;
+
+  if ((abfd->flags & (EXEC_P | DYNAMIC)) == 0
+      || stash->adjusted_section_count != 0
+      || (msec = find_debug_info (abfd, stash->debug_sections, NULL)) == NULL
+      || find_debug_info (abfd, stash->debug_sections, msec) != NULL)
+    return;
+
+  msec = bfd_get_section_by_name (abfd, ".gdb_index");
+  if (msec != NULL && (msec->flags & SEC_HAS_CONTENTS) != 0)
+    ok = read_gdb_index (stash, msec, &alloc);
+
+  aranges = &stash->debug_sections[debug_aranges];
+  if (!ok
+      && (bfd_get_section_by_name (abfd, aranges->uncompressed_name) != NULL
+	  || (aranges->compressed_name != NULL
+	      && bfd_get_section_by_name (abfd,
+					  aranges->compressed_name) != NULL)))
+    {
+      stash->unit_index_count = 0;
+      ok = read_debug_aranges (stash, &alloc);
+    }
+
+  if (!ok)
+    {
+      free (stash->unit_index);
+      stash->unit_index = NULL;
+      stash->unit_index_count = 0;
+      return;
+    }
+
+  check_unit_index_offsets (stash);
+  qsort (stash->unit_index, stash->unit_index_count,
+	 sizeof (*stash->unit_index), compare_unit_index_ranges);
+  for (i = 0; i < stash->unit_index_count; i++)
+    {
+      stash->unit_index[i].max_high = stash->unit_index[i].high;
+      if (i != 0
+	  && stash->unit_index[i - 1].max_high > stash->unit_index[i].high)
+	stash->unit_index[i].max_high = stash->unit_index[i - 1].max_high;
+    }
+}
+
+/* Look up ADDR in STASH's unit index, reading only those compilation
+   units not yet read whose ranges cover it.  */
+
+static bool
+find_nearest_line_in_index (struct dwarf2_debug *stash,
+			    bfd_vma addr,
+			    const char **filename_ptr,
+			    struct funcinfo **function_ptr,
+			    unsigned int *linenumber_ptr,
+			    unsigned int *discriminator_ptr)
+{
+  struct dwarf2_debug_file *file = &stash->f;
+  size_t lo, hi;
+
+  /* Nothing to gain once all the units have been read.  */
+  if (file->info_ptr >= file->dwarf_info_buffer + file->dwarf_info_size)
+    return false;
+
+  if (!stash->unit_index_read)
+    {
+      stash->unit_index_read = true;
+      read_unit_index (stash);
+    }
+
+  /* Find the first range starting above ADDR, then work back through
+     those which might contain it.  */
+  lo = 0;
+  hi = stash->unit_index_count;
+  while (lo < hi)
+    {
+      size_t mid = lo + (hi - lo) / 2;
+
+      if (stash->unit_index[mid].low <= addr)
+	lo = mid + 1;
+      else
+	hi = mid;
+    }
+
+  while (lo-- > 0 && stash->unit_index[lo].max_high > addr)
+    {
+      struct unit_index_range *r = &stash->unit_index[lo];
+      bfd_byte *info_ptr_unit = file->dwarf_info_buffer + r->unit_offset;
+      struct comp_unit *each;
+
+      /* Units already read were checked by our caller.  */
+      if (addr >= r->high
+	  || lookup_comp_unit (file, info_ptr_unit) != NULL)
+	continue;
+
+      each = read_comp_unit (stash, file, info_ptr_unit);
+      if (each != NULL
+	  && comp_unit_may_contain_address (each, addr)
+	  && comp_unit_find_nearest_line (each, addr, filename_ptr,
+					  function_ptr, linenumber_ptr,
+					  discriminator_ptr))
+	return true;
+    }
+
+  return false;
+}
+
 /* Hash function for an asymbol.  */
 
 static hashval_t
@@ -5733,6 +6193,44 @@ _bfd_dwarf2_find_nearest_line (bfd *abfd,
      pinfo);
 }
 
+/* Set FUNCTION's SYM_NAME and SYM_FILE from the symbol at its start,
+   which is looked for in SECTION of ABFD.  */
+
+static void
+find_function_sym (struct dwarf2_debug *stash, bfd *abfd,
+		   asymbol **symbols, asection *section,
+		   struct funcinfo *function)
+{
+  asymbol *fun;
+  asymbol **syms = symbols;
+  asection *sec = section;
+  const char *name;
+  const char *file;
+  bfd_vma sec_vma;
+
+  function->sym_searched = true;
+  if (section == NULL)
+    return;
+
+  sec_vma = section->vma;
+  if (section->output_section != NULL)
+    sec_vma = section->output_section->vma + section->output_offset;
+  if (function->arange.low < sec_vma
+      || function->arange.low - sec_vma >= bfd_get_section_limit (abfd,
+								  section))
+    return;
+
+  _bfd_dwarf2_stash_syms (stash, abfd, &sec, &syms);
+  fun = _bfd_elf_find_function (abfd, syms, sec,
+				function->arange.low - sec_vma,
+				&file, &name);
+  if (fun == NULL)
+    return;
+  function->sym_file = file;
+  if (fun->value + sec_vma == function->arange.low)
+    function->sym_name = name;
+}
+
 /* Find the source code location of SYMBOL.  If SYMBOL is NULL
    then find the nearest source code location corresponding to
    the address SECTION + OFFSET.
@@ -5963,6 +6461,13 @@ _bfd_dwarf2_find_nearest_line_with_alt
 	    goto done;
 	  prev_each = &each->next_unit_without_ranges;
 	}
+
+      /* Then just the units an index says cover ADDR.  */
+      found = find_nearest_line_in_index (stash, addr, filename_ptr,
+					  &function, linenumber_ptr,
+					  discriminator_ptr);
+      if (found)
+	goto done;
     }
 
   /* Read each remaining comp. units checking each as they are read.  */
@@ -5997,9 +6502,26 @@ _bfd_dwarf2_find_nearest_line_with_alt
       if (!found)
         found = 2;
     }
-  else if (functionname_ptr
-	   && (!*functionname_ptr
-	       || (function && !function->is_linkage)))
+  else if (functionname_ptr && function)
+    {
+      /* A symbol at the start of the function likely gives its linkage
+	 name.  Searching the symbols is slow, so it is done once per
+	 function, and always at the start of the function so that the
+	 name given does not depend on which of its addresses was looked
+	 up first.  */
+      if (!function->sym_searched)
+	find_function_sym (stash, abfd, symbols, section, function);
+
+      if (function->sym_name != NULL)
+	*functionname_ptr = function->sym_name;
+      else
+	*functionname_ptr = function->name;
+      if (!*filename_ptr)
+	*filename_ptr = function->sym_file;
+      if (!found && function->sym_name != NULL)
+	found = 2;
+    }
+  else if (functionname_ptr && !*functionname_ptr)
     {
       asymbol *fun;
       asymbol **syms = symbols;
@@ -6012,22 +6534,6 @@ _bfd_dwarf2_find_nearest_line_with_alt
 
       if (!found && fun != NULL)
 	found = 2;
-
-      if (function && !function->is_linkage)
-	{
-	  bfd_vma sec_vma;
-
-	  sec_vma = section->vma;
-	  if (section->output_section != NULL)
-	    sec_vma = section->output_section->vma + section->output_offset;
-	  if (fun == NULL)
-	    *functionname_ptr = function->name;
-	  else if (fun->value + sec_vma == function->arange.low)
-	    function->name = *functionname_ptr;
-	  /* Even if we didn't find a linkage name, say that we have
-	     to stop a repeated search of symbols.  */
-	  function->is_linkage = true;
-	}
     }
 
   unset_sections (stash);
@@ -6125,13 +6631,17 @@ _bfd_dwarf2_cleanup_debug_info (bfd *abfd, void **pinfo)
       free (file->dwarf_ranges_buffer);
       free (file->dwarf_line_buffer);
       free (file->dwarf_abbrev_buffer);
-      free (file->dwarf_info_buffer);
+      if (file->dwarf_info_view != NULL)
+	bfd_release_section_view (file->bfd_ptr, file->dwarf_info_view);
+      else
+	free (file->dwarf_info_buffer);
       if (file == &stash->alt)
 	break;
       file = &stash->alt;
     }
   free (stash->sec_vma);
   free (stash->adjusted_sections);
+  free (stash->unit_index);
   if (stash->close_on_cleanup)
     bfd_close (stash->f.bfd_ptr);
   if (stash->alt.bfd_ptr)
@@ -1252,6 +1252,26 @@ struct elf_backend_data
      asection *input_section, bfd_byte *contents, Elf_Internal_Rela *relocs,
      Elf_Internal_Sym *local_syms, asection **local_sections);
 
+  /* This function, if defined, is called for each relocation in a
+     section which is not SEC_ALLOC.  It should return TRUE if
+     RELOCATE_SECTION may apply a relocation of type R_TYPE in such a
+     section, against a symbol which is defined, at the same time as
+     it handles other sections in other threads.  RELOCATE_SECTION
+     must then only modify CONTENTS and RELOCS for these relocations,
+     must not call the einfo callback for them, and must not return
+     2.  If every relocation in a section passes, bfd_elf_final_link
+     may relocate the section on a worker thread.  */
+  bool (*elf_backend_threadsafe_reloc_p)
+    (unsigned int r_type);
+
+  /* This function, if defined, is called by bfd_elf_final_link once
+     the size of the TLS segment is known, before any section is
+     relocated.  It should set anything in the link hash table which
+     RELOCATE_SECTION needs and which depends on the final layout,
+     since RELOCATE_SECTION may be running on several threads.  */
+  void (*elf_backend_relocate_begin)
+    (struct bfd_link_info *info);
+
   /* The FINISH_DYNAMIC_SYMBOL function is called by the ELF backend
      linker just before it writes a symbol out to the .dynsym section.
      The processor backend may make any required adjustment to the
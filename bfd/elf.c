@@ -12181,7 +12181,7 @@ elfcore_grok_nto_note (bfd *abfd, Elf_Internal_Note *note)
   /* Every GREG section has a STATUS section before it.  Store the
      tid from the previous call to pass down to the next gregs
      function.  */
-  static long tid = 1;
+  static TLS long tid = 1;
 
   switch (note->type)
     {
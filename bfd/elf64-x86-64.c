@@ -2547,8 +2547,6 @@ elf_x86_64_relocate_section (bfd *output_bfd,
   local_got_offsets = elf_local_got_offsets (input_bfd);
   local_tlsdesc_gotents = elf_x86_local_tlsdesc_gotent (input_bfd);
 
-  _bfd_x86_elf_set_tls_module_base (info);
-
   status = true;
   rel = wrel = relocs;
   relend = relocs + input_section->reloc_count;
@@ -4295,6 +4293,36 @@ elf_x86_64_relocate_section (bfd *output_bfd,
   return status;
 }
 
+/* Return TRUE if elf_x86_64_relocate_section may apply a relocation
+   of type R_TYPE in a section which is not SEC_ALLOC at the same time
+   as other such sections.  Such relocations only modify the section
+   contents, since dynamic relocations are not propagated for them.  */
+
+static bool
+elf_x86_64_threadsafe_reloc_p (unsigned int r_type)
+{
+  switch (r_type)
+    {
+    case R_X86_64_NONE:
+    case R_X86_64_8:
+    case R_X86_64_16:
+    case R_X86_64_32:
+    case R_X86_64_32S:
+    case R_X86_64_64:
+    case R_X86_64_PC8:
+    case R_X86_64_PC16:
+    case R_X86_64_PC32:
+    case R_X86_64_PC64:
+    case R_X86_64_DTPOFF32:
+    case R_X86_64_DTPOFF64:
+    case R_X86_64_SIZE32:
+    case R_X86_64_SIZE64:
+      return true;
+    default:
+      return false;
+    }
+}
+
 /* Finish up dynamic symbol handling.  We set the contents of various
    dynamic sections here.  */
 
@@ -5460,6 +5488,8 @@ elf_x86_64_special_sections[]=
 #endif
 #define elf_backend_reloc_type_class	    elf_x86_64_reloc_type_class
 #define elf_backend_relocate_section	    elf_x86_64_relocate_section
+#define elf_backend_threadsafe_reloc_p	    elf_x86_64_threadsafe_reloc_p
+#define elf_backend_relocate_begin	    _bfd_x86_elf_set_tls_module_base
 #define elf_backend_init_index_section	    _bfd_elf_init_1_index_section
 #define elf_backend_object_p		    elf64_x86_64_elf_object_p
 #define bfd_elf64_get_synthetic_symtab	    elf_x86_64_get_synthetic_symtab
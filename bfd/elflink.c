@@ -36,6 +36,9 @@
 #ifndef CHAR_BIT
 #define CHAR_BIT 8
 #endif
+#ifdef ENABLE_THREADS
+#include <pthread.h>
+#endif
 
 /* This struct is used to pass information to routines called via
    elf_link_hash_traverse which must return failure.  */
@@ -8724,6 +8727,32 @@ struct elf_final_link_info
   size_t filesym_count;
   /* Local symbol hash table.  */
   struct bfd_hash_table local_hash_table;
+  /* Input files with sections left for worker threads to relocate.  */
+  struct elf_deferred_input *deferred;
+  /* Where to link the next of those, or NULL if every section is
+     relocated as soon as its input file is processed.  */
+  struct elf_deferred_input **deferred_tail;
+};
+
+/* An input file some of whose sections are relocated by worker
+   threads, once elf_link_input_bfd has processed every input file.  */
+
+struct elf_deferred_input
+{
+  struct elf_deferred_input *next;
+  bfd *input_bfd;
+  /* Copies of the local symbols of INPUT_BFD and of the sections
+     they are defined in, as left by elf_link_input_bfd.  */
+  Elf_Internal_Sym *isymbuf;
+  asection **sections;
+  /* The sections to relocate, in order.  */
+  asection **secs;
+  /* The relocations of each of SECS, as read by elf_link_input_bfd
+     to decide whether to defer it.  These are copies, unless they are
+     the relocations cached in the section's data.  */
+  Elf_Internal_Rela **relocs;
+  unsigned int count;
+  unsigned int alloc;
 };
 
 struct local_hash_entry
@@ -11030,6 +11059,126 @@ _bfd_elf_check_kept_section (asection *sec, struct bfd_link_info *info)
   return kept;
 }
 
+/* Return TRUE if input section O is of a kind which a worker thread
+   may relocate: one which is not loaded and which is copied to the
+   output unchanged apart from its relocations.  */
+
+static bool
+elf_link_can_defer_section (struct elf_final_link_info *flinfo,
+			    asection *o)
+{
+  const struct elf_backend_data *bed;
+
+  bed = get_elf_backend_data (flinfo->output_bfd);
+  return ((o->flags & (SEC_ALLOC | SEC_RELOC | SEC_EXCLUDE
+		       | SEC_ELF_REVERSE_COPY)) == SEC_RELOC
+	  && o->reloc_count != 0
+	  && o->sec_info_type == SEC_INFO_TYPE_NONE
+	  && elf_section_data (o)->this_hdr.contents == NULL
+	  && bed->elf_backend_write_section == NULL);
+}
+
+/* Return TRUE if a worker thread may apply a relocation against H in
+   a section which is not loaded.  The relocation must not lead to a
+   report about an undefined or dynamic symbol.  */
+
+static bool
+elf_link_can_defer_reloc_against (struct elf_link_hash_entry *h)
+{
+  if (h->root.type == bfd_link_hash_undefweak)
+    return true;
+  if (h->root.type != bfd_link_hash_defined
+      && h->root.type != bfd_link_hash_defweak)
+    return false;
+  return (h->root.u.def.section->owner == NULL
+	  || (h->root.u.def.section->owner->flags & DYNAMIC) == 0);
+}
+
+/* Leave input section O of INPUT_BFD for a worker thread to relocate.
+   *PDINPUT is the record of such sections of INPUT_BFD, or NULL if O
+   is the first.  INTERNAL_RELOCS are the relocations of O, which are
+   kept so that the worker thread need not read them again.  */
+
+static bool
+elf_link_defer_section (struct elf_final_link_info *flinfo,
+			struct elf_deferred_input **pdinput,
+			bfd *input_bfd, asection *o,
+			Elf_Internal_Rela *internal_relocs)
+{
+  struct elf_deferred_input *dinput = *pdinput;
+  Elf_Internal_Rela *relocs;
+
+  if (dinput == NULL)
+    {
+      dinput = (struct elf_deferred_input *) bfd_zmalloc (sizeof (*dinput));
+      if (dinput == NULL)
+	return false;
+      dinput->input_bfd = input_bfd;
+      *flinfo->deferred_tail = dinput;
+      flinfo->deferred_tail = &dinput->next;
+      *pdinput = dinput;
+    }
+
+  if (dinput->count == dinput->alloc)
+    {
+      unsigned int alloc = dinput->alloc == 0 ? 8 : dinput->alloc * 2;
+      asection **secs;
+      Elf_Internal_Rela **prelocs;
+
+      secs = (asection **) bfd_realloc (dinput->secs,
+					alloc * sizeof (*secs));
+      if (secs == NULL)
+	return false;
+      dinput->secs = secs;
+      prelocs = (Elf_Internal_Rela **) bfd_realloc (dinput->relocs,
+						    alloc * sizeof (*prelocs));
+      if (prelocs == NULL)
+	return false;
+      dinput->relocs = prelocs;
+      dinput->alloc = alloc;
+    }
+
+  /* INTERNAL_RELOCS is usually flinfo->internal_relocs, which the next
+     section will reuse.  */
+  relocs = internal_relocs;
+  if (relocs != NULL && relocs != elf_section_data (o)->relocs)
+    {
+      bfd_size_type amt = o->reloc_count * sizeof (Elf_Internal_Rela);
+
+      relocs = (Elf_Internal_Rela *) bfd_malloc (amt);
+      if (relocs == NULL)
+	return false;
+      memcpy (relocs, internal_relocs, amt);
+    }
+  dinput->secs[dinput->count] = o;
+  dinput->relocs[dinput->count] = relocs;
+  dinput->count++;
+  return true;
+}
+
+/* Keep copies of the LOCSYMCOUNT local symbols in ISYMBUF, and of
+   their SECTIONS, for the worker thread relocating DINPUT.  */
+
+static bool
+elf_link_save_deferred_syms (struct elf_deferred_input *dinput,
+			     Elf_Internal_Sym *isymbuf,
+			     asection **sections,
+			     size_t locsymcount)
+{
+  if (locsymcount == 0)
+    return true;
+
+  dinput->isymbuf = (Elf_Internal_Sym *)
+    bfd_malloc (locsymcount * sizeof (*isymbuf));
+  dinput->sections = (asection **)
+    bfd_malloc (locsymcount * sizeof (*sections));
+  if (dinput->isymbuf == NULL || dinput->sections == NULL)
+    return false;
+  memcpy (dinput->isymbuf, isymbuf, locsymcount * sizeof (*isymbuf));
+  memcpy (dinput->sections, sections, locsymcount * sizeof (*sections));
+  return true;
+}
+
 /* Link an input file into the linker output file.  This function
    handles all the sections and relocations of the input file at once.
    This is so that we only have to read the local symbols once, and
@@ -11057,6 +11206,7 @@ elf_link_input_bfd (struct elf_final_link_info *flinfo, bfd *input_bfd)
   bfd_vma r_type_mask;
   int r_sym_shift;
   bool have_file_sym = false;
+  struct elf_deferred_input *dinput = NULL;
 
   output_bfd = flinfo->output_bfd;
   bed = get_elf_backend_data (output_bfd);
@@ -11291,6 +11441,7 @@ elf_link_input_bfd (struct elf_final_link_info *flinfo, bfd *input_bfd)
   for (o = input_bfd->sections; o != NULL; o = o->next)
     {
       bfd_byte *contents;
+      bool can_defer, defer, viewed;
 
       if (! o->linker_mark)
 	{
@@ -11375,11 +11526,20 @@ elf_link_input_bfd (struct elf_final_link_info *flinfo, bfd *input_bfd)
 	  continue;
 	}
 
+      /* A section which a worker thread may relocate is not read
+	 until its relocations have been checked below.  */
+      can_defer = (flinfo->deferred_tail != NULL
+		   && elf_link_can_defer_section (flinfo, o));
+      defer = can_defer;
+      viewed = false;
+      if (can_defer)
+	contents = NULL;
+
       /* Get the contents of the section.  They have been cached by a
 	 relaxation routine.  Note that o is a section in an input
 	 file, so the contents field will not have been set by any of
 	 the routines which work on output files.  */
-      if (elf_section_data (o)->this_hdr.contents != NULL)
+      else if (elf_section_data (o)->this_hdr.contents != NULL)
 	{
 	  contents = elf_section_data (o)->this_hdr.contents;
 	  if (bed->caches_rawsize
@@ -11397,6 +11557,26 @@ elf_link_input_bfd (struct elf_final_link_info *flinfo, bfd *input_bfd)
 	   contents anymore, they have been recorded earlier.  Except
 	   if the backend has special provisions for writing sections.  */
 	contents = NULL;
+      else if ((o->flags & (SEC_RELOC | SEC_EXCLUDE
+			    | SEC_ELF_REVERSE_COPY)) == 0
+	       && o->sec_info_type == SEC_INFO_TYPE_NONE
+	       && !bed->elf_backend_write_section
+	       && (o->rawsize == 0 || o->rawsize == o->size)
+	       && bfd_section_view_mappable (input_bfd, o))
+	{
+	  /* Nothing changes these contents on their way to the output,
+	     so write them from a mapping of the input file instead of
+	     copying them into flinfo->contents first.  Other sections
+	     are better read into flinfo->contents, which is reused,
+	     than into a buffer of their own.  */
+	  const bfd_byte *view;
+	  bfd_size_type view_size;
+
+	  if (! bfd_get_section_view (input_bfd, o, &view, &view_size))
+	    return false;
+	  contents = (bfd_byte *) view;
+	  viewed = true;
+	}
       else
 	{
 	  contents = flinfo->contents;
@@ -11441,6 +11621,11 @@ elf_link_input_bfd (struct elf_final_link_info *flinfo, bfd *input_bfd)
 	      struct elf_link_hash_entry *h = NULL;
 	      const char *sym_name;
 
+	      if (defer
+		  && !(*bed->elf_backend_threadsafe_reloc_p) (rel->r_info
+							      & r_type_mask))
+		defer = false;
+
 	      if (r_symndx == STN_UNDEF)
 		continue;
 
@@ -11489,6 +11674,9 @@ elf_link_input_bfd (struct elf_final_link_info *flinfo, bfd *input_bfd)
 		      h->root.u.undef.abfd = h->root.u.def.section->owner;
 		    }
 
+		  if (defer && !elf_link_can_defer_reloc_against (h))
+		    defer = false;
+
 		  ps = NULL;
 		  if (h->root.type == bfd_link_hash_defined
 		      || h->root.type == bfd_link_hash_defweak)
@@ -11569,6 +11757,20 @@ elf_link_input_bfd (struct elf_final_link_info *flinfo, bfd *input_bfd)
 		}
 	    }
 
+	  if (defer)
+	    {
+	      if (!elf_link_defer_section (flinfo, &dinput, input_bfd, o,
+					   internal_relocs))
+		return false;
+	      continue;
+	    }
+	  if (can_defer)
+	    {
+	      contents = flinfo->contents;
+	      if (! bfd_get_full_section_contents (input_bfd, o, &contents))
+		return false;
+	    }
+
 	  /* Relocate the section by invoking a back end routine.
 
 	     The back end routine is responsible for adjusting the
@@ -11958,8 +12160,377 @@ elf_link_input_bfd (struct elf_final_link_info *flinfo, bfd *input_bfd)
 	  }
 	  break;
 	}
+
+      if (viewed)
+	bfd_release_section_view (input_bfd, o);
+    }
+
+  if (dinput != NULL)
+    {
+      /* A worker thread reporting a relocation overflow may need the
+	 names of local symbols, so read them now.  */
+      if (locsymcount != 0)
+	bfd_elf_string_from_elf_section (input_bfd, symtab_hdr->sh_link, 0);
+      if (!elf_link_save_deferred_syms (dinput, isymbuf, flinfo->sections,
+					locsymcount))
+	return false;
+    }
+
+  return true;
+}
+
+/* State shared by the threads relocating the sections which
+   elf_link_input_bfd left for them.  */
+
+struct elf_deferred_state
+{
+  struct elf_final_link_info *flinfo;
+  /* The next input file whose sections are to be relocated.  */
+  struct elf_deferred_input *next;
+  /* Set when relocating a section has failed.  */
+  bool failed;
+  /* The BFD error of the first failure.  The error is kept per
+     thread, so it is passed back to the calling thread here.  */
+  bfd_error_type error;
+#ifdef ENABLE_THREADS
+  /* Guards NEXT, FAILED and ERROR.  Input files are only read, the
+     output file only written, and problems only reported, while
+     holding it, since BFD's file cache is not thread safe and the
+     callbacks reporting problems may read the input files.  It is
+     recursive, as the BFD error handler may be called while it is
+     held.  */
+  pthread_mutex_t lock;
+#endif
+};
+
+/* Buffers used by one thread relocating sections.  */
+
+struct elf_deferred_buffers
+{
+  void *contents;
+  bfd_size_type contents_size;
+};
+
+static void
+elf_deferred_lock (struct elf_deferred_state *state ATTRIBUTE_UNUSED)
+{
+#ifdef ENABLE_THREADS
+  pthread_mutex_lock (&state->lock);
+#endif
+}
+
+static void
+elf_deferred_unlock (struct elf_deferred_state *state ATTRIBUTE_UNUSED)
+{
+#ifdef ENABLE_THREADS
+  pthread_mutex_unlock (&state->lock);
+#endif
+}
+
+/* Make sure the buffer *PBUF, of *PSIZE bytes, holds at least SIZE
+   bytes.  Its contents are not preserved.  */
+
+static bool
+elf_deferred_buffer (void **pbuf, bfd_size_type *psize, bfd_size_type size)
+{
+  if (size <= *psize)
+    return true;
+  free (*pbuf);
+  *pbuf = bfd_malloc (size);
+  *psize = *pbuf != NULL ? size : 0;
+  return *pbuf != NULL;
+}
+
+/* Relocate input section O of DINPUT, whose relocations are
+   INTERNAL_RELOCS, and write it to the output, as elf_link_input_bfd
+   would have done.  */
+
+static bool
+elf_link_relocate_deferred_section (struct elf_deferred_state *state,
+				    struct elf_deferred_buffers *buf,
+				    struct elf_deferred_input *dinput,
+				    asection *o,
+				    Elf_Internal_Rela *internal_relocs)
+{
+  struct elf_final_link_info *flinfo = state->flinfo;
+  bfd *output_bfd = flinfo->output_bfd;
+  bfd *input_bfd = dinput->input_bfd;
+  const struct elf_backend_data *bed = get_elf_backend_data (output_bfd);
+  bfd_size_type size;
+  bfd_byte *contents;
+  file_ptr offset;
+  bool ok;
+
+  size = o->rawsize > o->size ? o->rawsize : o->size;
+  if (!elf_deferred_buffer (&buf->contents, &buf->contents_size, size))
+    return false;
+
+  contents = (bfd_byte *) buf->contents;
+  elf_deferred_lock (state);
+  ok = bfd_get_full_section_contents (input_bfd, o, &contents);
+  elf_deferred_unlock (state);
+  if (!ok)
+    return false;
+
+  if (!(*bed->elf_backend_relocate_section) (output_bfd, flinfo->info,
+					     input_bfd, o, contents,
+					     internal_relocs,
+					     dinput->isymbuf,
+					     dinput->sections))
+    return false;
+
+  offset = (file_ptr) o->output_offset;
+  offset *= bfd_octets_per_byte (output_bfd, o);
+  elf_deferred_lock (state);
+  ok = bfd_set_section_contents (output_bfd, o->output_section, contents,
+				 offset, o->size);
+  elf_deferred_unlock (state);
+  return ok;
+}
+
+/* The body of each thread relocating deferred sections.  Input files
+   are taken from STATE one at a time, so that the local symbols of
+   each are only seen by one thread.  */
+
+static void *
+elf_link_deferred_worker (void *arg)
+{
+  struct elf_deferred_state *state = (struct elf_deferred_state *) arg;
+  struct elf_deferred_buffers buf;
+  struct elf_deferred_input *dinput;
+  unsigned int i;
+
+  memset (&buf, 0, sizeof (buf));
+  while (1)
+    {
+      elf_deferred_lock (state);
+      dinput = state->failed ? NULL : state->next;
+      if (dinput != NULL)
+	state->next = dinput->next;
+      elf_deferred_unlock (state);
+      if (dinput == NULL)
+	break;
+
+      for (i = 0; i < dinput->count; i++)
+	if (!elf_link_relocate_deferred_section (state, &buf, dinput,
+						 dinput->secs[i],
+						 dinput->relocs[i]))
+	  {
+	    elf_deferred_lock (state);
+	    if (!state->failed)
+	      state->error = bfd_get_error ();
+	    state->failed = true;
+	    elf_deferred_unlock (state);
+	    break;
+	  }
+    }
+
+  free (buf.contents);
+  return NULL;
+}
+
+#ifdef ENABLE_THREADS
+
+/* The callbacks of the link and the BFD error handler, while worker
+   threads are running.  The threads report problems through the
+   wrappers below, one at a time and not while another thread does
+   I/O, under the lock of ELF_DEFERRED_REPORT_STATE.  */
+
+static const struct bfd_link_callbacks *elf_deferred_callbacks;
+static bfd_error_handler_type elf_deferred_error_handler;
+static struct elf_deferred_state *elf_deferred_report_state;
+
+static void
+elf_deferred_warning (struct bfd_link_info *info, const char *warning,
+		      const char *symbol, bfd *abfd, asection *section,
+		      bfd_vma address)
+{
+  elf_deferred_lock (elf_deferred_report_state);
+  elf_deferred_callbacks->warning (info, warning, symbol, abfd, section,
+				   address);
+  elf_deferred_unlock (elf_deferred_report_state);
+}
+
+static void
+elf_deferred_undefined_symbol (struct bfd_link_info *info,
+			       const char *name, bfd *abfd,
+			       asection *section, bfd_vma address,
+			       bool is_fatal)
+{
+  elf_deferred_lock (elf_deferred_report_state);
+  elf_deferred_callbacks->undefined_symbol (info, name, abfd, section,
+					    address, is_fatal);
+  elf_deferred_unlock (elf_deferred_report_state);
+}
+
+static void
+elf_deferred_reloc_overflow (struct bfd_link_info *info,
+			     struct bfd_link_hash_entry *entry,
+			     const char *name, const char *reloc_name,
+			     bfd_vma addend, bfd *abfd, asection *section,
+			     bfd_vma address)
+{
+  elf_deferred_lock (elf_deferred_report_state);
+  elf_deferred_callbacks->reloc_overflow (info, entry, name, reloc_name,
+					  addend, abfd, section, address);
+  elf_deferred_unlock (elf_deferred_report_state);
+}
+
+static void
+elf_deferred_reloc_dangerous (struct bfd_link_info *info,
+			      const char *message, bfd *abfd,
+			      asection *section, bfd_vma address)
+{
+  elf_deferred_lock (elf_deferred_report_state);
+  elf_deferred_callbacks->reloc_dangerous (info, message, abfd, section,
+					   address);
+  elf_deferred_unlock (elf_deferred_report_state);
+}
+
+static void
+elf_deferred_unattached_reloc (struct bfd_link_info *info,
+			       const char *name, bfd *abfd,
+			       asection *section, bfd_vma address)
+{
+  elf_deferred_lock (elf_deferred_report_state);
+  elf_deferred_callbacks->unattached_reloc (info, name, abfd, section,
+					    address);
+  elf_deferred_unlock (elf_deferred_report_state);
+}
+
+static void
+elf_deferred_error (const char *fmt, va_list ap)
+{
+  elf_deferred_lock (elf_deferred_report_state);
+  elf_deferred_error_handler (fmt, ap);
+  elf_deferred_unlock (elf_deferred_report_state);
+}
+
+#endif /* ENABLE_THREADS */
+
+/* Free the records of input files with deferred sections.  */
+
+static void
+elf_link_free_deferred (struct elf_final_link_info *flinfo)
+{
+  while (flinfo->deferred != NULL)
+    {
+      struct elf_deferred_input *dinput = flinfo->deferred;
+      unsigned int i;
+
+      flinfo->deferred = dinput->next;
+      for (i = 0; i < dinput->count; i++)
+	if (dinput->relocs[i] != elf_section_data (dinput->secs[i])->relocs)
+	  free (dinput->relocs[i]);
+      free (dinput->relocs);
+      free (dinput->isymbuf);
+      free (dinput->sections);
+      free (dinput->secs);
+      free (dinput);
+    }
+}
+
+/* Relocate and write out the sections which elf_link_input_bfd left
+   for worker threads.  Each input file is handled by one thread, and
+   the sections of different files are relocated in parallel.  Their
+   output ranges are disjoint, so only reading the inputs and writing
+   the output need to be serialized.  */
+
+static bool
+elf_link_relocate_deferred (struct elf_final_link_info *flinfo)
+{
+  struct elf_deferred_state state;
+  struct elf_deferred_input *dinput;
+  unsigned int ninputs;
+  unsigned int nthreads;
+
+  if (flinfo->deferred == NULL)
+    return true;
+
+  state.flinfo = flinfo;
+  state.next = flinfo->deferred;
+  state.failed = false;
+  state.error = bfd_error_no_error;
+
+  ninputs = 0;
+  for (dinput = flinfo->deferred; dinput != NULL; dinput = dinput->next)
+    ninputs++;
+
+  nthreads = flinfo->info->thread_count;
+#if defined (HAVE_SYSCONF) && defined (_SC_NPROCESSORS_ONLN)
+  if (nthreads == 0)
+    {
+      long n = sysconf (_SC_NPROCESSORS_ONLN);
+      if (n > 0)
+	nthreads = n;
+    }
+#endif
+  if (nthreads > ninputs)
+    nthreads = ninputs;
+
+#ifdef ENABLE_THREADS
+  {
+    pthread_mutexattr_t attr;
+
+    pthread_mutexattr_init (&attr);
+    pthread_mutexattr_settype (&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init (&state.lock, &attr);
+    pthread_mutexattr_destroy (&attr);
+  }
+  if (nthreads > 1)
+    {
+      struct bfd_link_info *info = flinfo->info;
+      struct bfd_link_callbacks callbacks;
+      pthread_t *threads;
+      unsigned int started;
+      unsigned int i;
+
+      threads = (pthread_t *) bfd_malloc ((nthreads - 1) * sizeof (*threads));
+      if (threads == NULL)
+	{
+	  pthread_mutex_destroy (&state.lock);
+	  return false;
+	}
+
+      elf_deferred_report_state = &state;
+      elf_deferred_callbacks = info->callbacks;
+      callbacks = *info->callbacks;
+      callbacks.warning = elf_deferred_warning;
+      callbacks.undefined_symbol = elf_deferred_undefined_symbol;
+      callbacks.reloc_overflow = elf_deferred_reloc_overflow;
+      callbacks.reloc_dangerous = elf_deferred_reloc_dangerous;
+      callbacks.unattached_reloc = elf_deferred_unattached_reloc;
+      info->callbacks = &callbacks;
+      elf_deferred_error_handler = bfd_set_error_handler (elf_deferred_error);
+
+      /* This thread works too.  If a thread cannot be started, the
+	 others do its share.  */
+      for (started = 0; started < nthreads - 1; started++)
+	if (pthread_create (&threads[started], NULL,
+			    elf_link_deferred_worker, &state) != 0)
+	  break;
+      elf_link_deferred_worker (&state);
+      for (i = 0; i < started; i++)
+	pthread_join (threads[i], NULL);
+
+      bfd_set_error_handler (elf_deferred_error_handler);
+      info->callbacks = elf_deferred_callbacks;
+      elf_deferred_report_state = NULL;
+      free (threads);
     }
+  else
+#endif
+    elf_link_deferred_worker (&state);
+#ifdef ENABLE_THREADS
+  pthread_mutex_destroy (&state.lock);
+#endif
 
+  elf_link_free_deferred (flinfo);
+  if (state.failed)
+    {
+      bfd_set_error (state.error);
+      return false;
+    }
   return true;
 }
 
@@ -12263,6 +12834,7 @@ elf_final_link_free (bfd *obfd, struct elf_final_link_info *flinfo)
   free (flinfo->sections);
   if (flinfo->symshndxbuf != (Elf_External_Sym_Shndx *) -1)
     free (flinfo->symshndxbuf);
+  elf_link_free_deferred (flinfo);
   for (o = obfd->sections; o != NULL; o = o->next)
     {
       struct bfd_elf_section_data *esdo = elf_section_data (o);
@@ -12325,6 +12897,15 @@ bfd_elf_final_link (bfd *abfd, struct bfd_link_info *info)
   if (flinfo.symstrtab == NULL)
     return false;
 
+#ifdef ENABLE_THREADS
+  /* Let worker threads relocate the sections which are not loaded,
+     if the backend allows it.  */
+  if (info->threads
+      && !emit_relocs
+      && bed->elf_backend_threadsafe_reloc_p != NULL)
+    flinfo.deferred_tail = &flinfo.deferred;
+#endif
+
   if (! dynamic)
     {
       flinfo.hash_sec = NULL;
@@ -12770,6 +13351,9 @@ bfd_elf_final_link (bfd *abfd, struct bfd_link_info *info)
       htab->tls_size = end - base;
     }
 
+  if (bed->elf_backend_relocate_begin != NULL)
+    bed->elf_backend_relocate_begin (info);
+
   if (!_bfd_elf_fixup_eh_frame_hdr (info))
     return false;
 
@@ -12866,6 +13450,9 @@ bfd_elf_final_link (bfd *abfd, struct bfd_link_info *info)
 	}
     }
 
+  if (!elf_link_relocate_deferred (&flinfo))
+    goto error_return;
+
   /* Free symbol buffer if needed.  */
   if (!info->reduce_memory_overheads)
     {
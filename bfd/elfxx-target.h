@@ -502,6 +502,12 @@
 #ifndef elf_backend_relocate_section
 #define elf_backend_relocate_section	0
 #endif
+#ifndef elf_backend_threadsafe_reloc_p
+#define elf_backend_threadsafe_reloc_p	NULL
+#endif
+#ifndef elf_backend_relocate_begin
+#define elf_backend_relocate_begin	NULL
+#endif
 #ifndef elf_backend_finish_dynamic_symbol
 #define elf_backend_finish_dynamic_symbol	0
 #endif
@@ -854,6 +860,8 @@ static const struct elf_backend_data elfNN_bed =
   elf_backend_strip_zero_sized_dynamic_sections,
   elf_backend_init_index_section,
   elf_backend_relocate_section,
+  elf_backend_threadsafe_reloc_p,
+  elf_backend_relocate_begin,
   elf_backend_finish_dynamic_symbol,
   elf_backend_finish_dynamic_sections,
   elf_backend_begin_write_processing,
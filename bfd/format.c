@@ -108,6 +108,7 @@ struct bfd_preserve
   struct bfd_section *section_last;
   unsigned int section_count;
   unsigned int section_id;
+  unsigned int section_ids_taken;
   unsigned int symcount;
   bool read_only;
   bfd_vma start_address;
@@ -135,7 +136,8 @@ bfd_preserve_save (bfd *abfd, struct bfd_preserve *preserve,
   preserve->sections = abfd->sections;
   preserve->section_last = abfd->section_last;
   preserve->section_count = abfd->section_count;
-  preserve->section_id = _bfd_section_id;
+  _bfd_section_id_mark (&preserve->section_id,
+			&preserve->section_ids_taken);
   preserve->symcount = abfd->symcount;
   preserve->read_only = abfd->read_only;
   preserve->start_address = abfd->start_address;
@@ -181,9 +183,10 @@ io_reinit (bfd *abfd, struct bfd_preserve *preserve)
 
 static void
 bfd_reinit (bfd *abfd, unsigned int section_id,
+	    unsigned int section_ids_taken,
 	    struct bfd_preserve *preserve, bfd_cleanup cleanup)
 {
-  _bfd_section_id = section_id;
+  _bfd_section_id_reset (section_id, section_ids_taken);
   if (cleanup)
     cleanup (abfd);
   abfd->tdata.any = NULL;
@@ -210,7 +213,7 @@ bfd_preserve_restore (bfd *abfd, struct bfd_preserve *preserve)
   abfd->sections = preserve->sections;
   abfd->section_last = preserve->section_last;
   abfd->section_count = preserve->section_count;
-  _bfd_section_id = preserve->section_id;
+  _bfd_section_id_reset (preserve->section_id, preserve->section_ids_taken);
   abfd->symcount = preserve->symcount;
   abfd->read_only = preserve->read_only;
   abfd->start_address = preserve->start_address;
@@ -311,11 +314,11 @@ bfd_check_format_matches (bfd *abfd, bfd_format format, char ***matching)
   const bfd_target *save_targ, *right_targ, *ar_right_targ, *match_targ;
   int match_count, best_count, best_match;
   int ar_match_index;
-  unsigned int initial_section_id = _bfd_section_id;
+  unsigned int initial_section_id, initial_section_ids_taken;
   struct bfd_preserve preserve, preserve_match;
   bfd_cleanup cleanup = NULL;
   bfd_error_handler_type orig_error_handler;
-  static int in_check_format;
+  static TLS int in_check_format;
 
   if (matching != NULL)
     *matching = NULL;
@@ -340,6 +343,8 @@ bfd_check_format_matches (bfd *abfd, bfd_format format, char ***matching)
 	return false;
     }
 
+  _bfd_section_id_mark (&initial_section_id, &initial_section_ids_taken);
+
   /* Presume the answer is yes.  */
   abfd->format = format;
   save_targ = abfd->xvec;
@@ -347,7 +352,7 @@ bfd_check_format_matches (bfd *abfd, bfd_format format, char ***matching)
   /* Don't report errors on recursive calls checking the first element
      of an archive.  */
   if (in_check_format)
-    orig_error_handler = bfd_set_error_handler (null_error_handler);
+    orig_error_handler = _bfd_set_thread_error_handler (null_error_handler);
   else
     orig_error_handler = _bfd_set_error_handler_caching (abfd);
   ++in_check_format;
@@ -412,7 +417,8 @@ bfd_check_format_matches (bfd *abfd, bfd_format format, char ***matching)
       /* If we already tried a match, the bfd is modified and may
 	 have sections attached, which will confuse the next
 	 _bfd_check_format call.  */
-      bfd_reinit (abfd, initial_section_id, &preserve, cleanup);
+      bfd_reinit (abfd, initial_section_id, initial_section_ids_taken,
+		  &preserve, cleanup);
       /* Free bfd_alloc memory too.  If we have matched and preserved
 	 a target then the high water mark is that much higher.  */
       if (preserve_match.marker)
@@ -571,7 +577,8 @@ bfd_check_format_matches (bfd *abfd, bfd_format format, char ***matching)
 	 RIGHT_TARG again.  */
       if (match_targ != right_targ)
 	{
-	  bfd_reinit (abfd, initial_section_id, &preserve, cleanup);
+	  bfd_reinit (abfd, initial_section_id, initial_section_ids_taken,
+		      &preserve, cleanup);
 	  bfd_release (abfd, preserve.marker);
 	  if (bfd_seek (abfd, (file_ptr) 0, SEEK_SET) != 0)
 	    goto err_ret;
@@ -592,7 +599,7 @@ bfd_check_format_matches (bfd *abfd, bfd_format format, char ***matching)
       if (preserve_match.marker != NULL)
 	bfd_preserve_finish (abfd, &preserve_match);
       bfd_preserve_finish (abfd, &preserve);
-      bfd_set_error_handler (orig_error_handler);
+      _bfd_set_thread_error_handler (orig_error_handler);
 
       struct per_xvec_message **list = _bfd_per_xvec_warn (abfd->xvec, 0);
       if (*list)
@@ -644,7 +651,7 @@ bfd_check_format_matches (bfd *abfd, bfd_format format, char ***matching)
   if (preserve_match.marker != NULL)
     bfd_preserve_finish (abfd, &preserve_match);
   bfd_preserve_restore (abfd, &preserve);
-  bfd_set_error_handler (orig_error_handler);
+  _bfd_set_thread_error_handler (orig_error_handler);
   struct per_xvec_message **list = _bfd_per_xvec_warn (NULL, 0);
   struct per_xvec_message **one = NULL;
   for (size_t i = 0; i < _bfd_target_vector_entries + 1; i++)
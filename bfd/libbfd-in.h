@@ -33,6 +33,20 @@
 #endif
 #endif
 
+/* The storage class of variables holding per-thread state, such as
+   the BFD error.  Empty if the compiler has no thread-local storage,
+   in which case bfd_thread_init fails.  */
+#ifndef TLS
+#if defined __STDC_VERSION__ && __STDC_VERSION__ >= 201112L
+#define TLS _Thread_local
+#elif defined __GNUC__
+#define TLS __thread
+#else
+#define TLS
+#define BFD_NO_TLS 1
+#endif
+#endif
+
 #include "hashtab.h"
 
 #ifdef __cplusplus
@@ -64,7 +78,8 @@ struct section_hash_entry
   asection section;
 };
 
-/* Unique section id.  */
+/* Unique section id.  Shared by all threads, and only changed under
+   bfd_lock.  */
 extern unsigned int _bfd_section_id ATTRIBUTE_HIDDEN;
 
 /* tdata for an archive.  For an input archive, cache
@@ -269,6 +284,13 @@ extern bool _bfd_generic_get_section_contents
 extern bool _bfd_generic_get_section_contents_in_window
   (bfd *, asection *, bfd_window *, file_ptr, bfd_size_type) ATTRIBUTE_HIDDEN;
 
+/* Read part of a section which is decompressed on reading.  */
+extern bool _bfd_get_decompressed_section_contents
+  (bfd *, asection *, void *, file_ptr, bfd_size_type) ATTRIBUTE_HIDDEN;
+
+/* Free what partial reads of decompressed sections have kept.  */
+extern void _bfd_free_decompress_chunks (bfd *) ATTRIBUTE_HIDDEN;
+
 /* Generic routines to use for BFD_JUMP_TABLE_COPY.  Use
    BFD_JUMP_TABLE_COPY (_bfd_generic).  */
 
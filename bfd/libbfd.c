@@ -1044,6 +1044,11 @@ _bfd_generic_get_section_contents (bfd *abfd,
   if (count == 0)
     return true;
 
+  if (section->compress_status == DECOMPRESS_SECTION_ZLIB
+      || section->compress_status == DECOMPRESS_SECTION_ZSTD)
+    return _bfd_get_decompressed_section_contents (abfd, section, location,
+						   offset, count);
+
   if (section->compress_status != COMPRESS_SECTION_NONE)
     {
       _bfd_error_handler
@@ -39,6 +39,20 @@
 #endif
 #endif
 
+/* The storage class of variables holding per-thread state, such as
+   the BFD error.  Empty if the compiler has no thread-local storage,
+   in which case bfd_thread_init fails.  */
+#ifndef TLS
+#if defined __STDC_VERSION__ && __STDC_VERSION__ >= 201112L
+#define TLS _Thread_local
+#elif defined __GNUC__
+#define TLS __thread
+#else
+#define TLS
+#define BFD_NO_TLS 1
+#endif
+#endif
+
 #include "hashtab.h"
 
 #ifdef __cplusplus
@@ -70,7 +84,8 @@ struct section_hash_entry
   asection section;
 };
 
-/* Unique section id.  */
+/* Unique section id.  Shared by all threads, and only changed under
+   bfd_lock.  */
 extern unsigned int _bfd_section_id ATTRIBUTE_HIDDEN;
 
 /* tdata for an archive.  For an input archive, cache
@@ -275,6 +290,13 @@ extern bool _bfd_generic_get_section_contents
 extern bool _bfd_generic_get_section_contents_in_window
   (bfd *, asection *, bfd_window *, file_ptr, bfd_size_type) ATTRIBUTE_HIDDEN;
 
+/* Read part of a section which is decompressed on reading.  */
+extern bool _bfd_get_decompressed_section_contents
+  (bfd *, asection *, void *, file_ptr, bfd_size_type) ATTRIBUTE_HIDDEN;
+
+/* Free what partial reads of decompressed sections have kept.  */
+extern void _bfd_free_decompress_chunks (bfd *) ATTRIBUTE_HIDDEN;
+
 /* Generic routines to use for BFD_JUMP_TABLE_COPY.  Use
    BFD_JUMP_TABLE_COPY (_bfd_generic).  */
 
@@ -934,14 +956,23 @@ unsigned int bfd_log2 (bfd_vma x) ATTRIBUTE_HIDDEN;
 
 /* Extracted from bfd.c.  */
 /* A buffer that is freed on bfd_close.  */
-extern char *_bfd_error_buf;
+extern TLS char *_bfd_error_buf;
 
 char *bfd_asprintf (const char *fmt, ...) ATTRIBUTE_HIDDEN;
 
+bfd_error_handler_type _bfd_set_thread_error_handler
+   (bfd_error_handler_type) ATTRIBUTE_HIDDEN;
+
 bfd_error_handler_type _bfd_set_error_handler_caching (bfd *) ATTRIBUTE_HIDDEN;
 
 const char *_bfd_get_error_program_name (void) ATTRIBUTE_HIDDEN;
 
+unsigned int _bfd_thread_count (void) ATTRIBUTE_HIDDEN;
+
+bool bfd_lock (void) ATTRIBUTE_HIDDEN;
+
+bool bfd_unlock (void) ATTRIBUTE_HIDDEN;
+
 /* Extracted from bfdio.c.  */
 struct bfd_iovec
 {
@@ -3572,6 +3603,12 @@ bool _bfd_unrecognized_reloc
     unsigned int r_type) ATTRIBUTE_HIDDEN;
 
 /* Extracted from section.c.  */
+void _bfd_section_id_mark (unsigned int *id, unsigned int *taken) ATTRIBUTE_HIDDEN;
+
+void _bfd_section_id_reset (unsigned int id, unsigned int taken) ATTRIBUTE_HIDDEN;
+
+void _bfd_free_section_views (bfd *abfd) ATTRIBUTE_HIDDEN;
+
 bool _bfd_section_size_insane (bfd *abfd, asection *sec) ATTRIBUTE_HIDDEN;
 
 /* Extracted from stabs.c.  */
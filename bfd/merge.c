@@ -30,6 +30,9 @@
 #include "libbfd.h"
 #include "objalloc.h"
 #include "libiberty.h"
+#ifdef ENABLE_THREADS
+#include <pthread.h>
+#endif
 
 /* We partition all mergable input sections into sets of similar
    characteristics.  These sets are the unit of merging.  All content
@@ -62,6 +65,9 @@ struct sec_merge_hash_entry
     bfd_size_type index;
     /* Entry this is a suffix of (if alignment is 0).  */
     struct sec_merge_hash_entry *suffix;
+    /* Position of the first occurrence, while sections are recorded
+       concurrently.  */
+    uint64_t seq;
   } u;
   /* Next entity in the hash table (in order of entering).  */
   struct sec_merge_hash_entry *next;
@@ -109,6 +115,10 @@ struct sec_merge_info
   struct sec_merge_sec_info **last;
   /* A hash table used to hold section content.  */
   struct sec_merge_hash *htab;
+  /* When sections are recorded concurrently, the tables holding the
+     content with the same top bits of the hash.  The first is HTAB.  */
+  struct sec_merge_hash **shards;
+  unsigned int nshards;
 };
 
 /* Offset into input mergable sections are represented by this type.
@@ -674,6 +684,8 @@ _bfd_add_merge_section (bfd *abfd, void **psinfo, asection *sec,
       sinfo->next = (struct sec_merge_info *) *psinfo;
       sinfo->chain = NULL;
       sinfo->last = &sinfo->chain;
+      sinfo->shards = NULL;
+      sinfo->nshards = 0;
       *psinfo = sinfo;
       sinfo->htab = sec_merge_init (sec->entsize, (sec->flags & SEC_STRINGS));
       if (sinfo->htab == NULL)
@@ -693,18 +705,12 @@ _bfd_add_merge_section (bfd *abfd, void **psinfo, asection *sec,
   return false;
 }
 
-/* Record one whole input section (described by SECINFO) into the hash table
-   SINFO.  */
+/* Read in all the contents of the input merge section SEC (possibly
+   decompressing it).  Return NULL on error.  */
 
-static bool
-record_section (struct sec_merge_info *sinfo,
-		struct sec_merge_sec_info *secinfo)
+static bfd_byte *
+read_merge_section (asection *sec)
 {
-  asection *sec = secinfo->sec;
-  struct sec_merge_hash_entry *entry;
-  unsigned char *p, *end;
-  bfd_vma mask, eltalign;
-  unsigned int align;
   bfd_size_type amt;
   bfd_byte *contents;
 
@@ -716,13 +722,49 @@ record_section (struct sec_merge_info *sinfo,
     amt += sec->entsize;
   contents = bfd_malloc (amt);
   if (!contents)
-    goto error_return;
+    return NULL;
 
-  /* Slurp in all section contents (possibly decompressing it).  */
   sec->rawsize = sec->size;
   if (sec->flags & SEC_STRINGS)
     memset (contents + sec->size, 0, sec->entsize);
   if (! bfd_get_full_section_contents (sec->owner, sec, &contents))
+    {
+      free (contents);
+      return NULL;
+    }
+  return contents;
+}
+
+/* Return the alignment of a blob at input offset OFS in a section
+   whose alignment is MASK + 1.  */
+
+static inline unsigned int
+blob_alignment (bfd_vma ofs, bfd_vma mask)
+{
+  bfd_vma eltalign = ofs;
+
+  eltalign = ((eltalign ^ (eltalign - 1)) + 1) >> 1;
+  if (!eltalign || eltalign > mask)
+    eltalign = mask + 1;
+  return eltalign;
+}
+
+/* Record one whole input section (described by SECINFO) into the hash table
+   SINFO.  */
+
+static bool
+record_section (struct sec_merge_info *sinfo,
+		struct sec_merge_sec_info *secinfo)
+{
+  asection *sec = secinfo->sec;
+  struct sec_merge_hash_entry *entry;
+  unsigned char *p, *end;
+  bfd_vma mask;
+  unsigned int align;
+  bfd_byte *contents;
+
+  contents = read_merge_section (sec);
+  if (!contents)
     goto error_return;
 
   /* Now populate the hash table and offset mapping.  */
@@ -747,12 +789,8 @@ record_section (struct sec_merge_info *sinfo,
       unsigned len;
       uint32_t hash = hashit (sinfo->htab, (char*) p, &len);
       unsigned int ofs = p - contents;
-      eltalign = ofs;
-      eltalign = ((eltalign ^ (eltalign - 1)) + 1) >> 1;
-      if (!eltalign || eltalign > mask)
-	eltalign = mask + 1;
       entry = sec_merge_hash_lookup (sinfo->htab, (char *) p, len, hash,
-				     (unsigned) eltalign);
+				     blob_alignment (ofs, mask));
       if (! entry)
 	goto error_return;
       if (! append_offsetmap (secinfo, ofs, entry))
@@ -780,6 +818,580 @@ record_section (struct sec_merge_info *sinfo,
   return false;
 }
 
+#ifdef ENABLE_THREADS
+
+/* Recording of input sections on worker threads.  The sections of a
+   sec_merge_info are recorded in batches.  First the contents of each
+   section in the batch are read in, and the blobs found in them and
+   their hashes are computed, one section per thread at a time.  Then
+   each thread inserts the blobs whose hashes have the same top bits
+   into a table of its own, going through the sections in order.  Once
+   all sections are recorded the entries of the tables are merged back
+   into the order in which they were first seen, so the result is the
+   same as when recording the sections one at a time with
+   record_section.  */
+
+/* At most this many sections, or a few more than this many octets of
+   section contents, are held in memory at once.  */
+#define MERGE_BATCH_SECTIONS 1024
+#define MERGE_BATCH_SIZE (64 * 1024 * 1024)
+
+/* No more tables than this are used.  */
+#define MERGE_MAX_SHARDS 64
+
+/* A blob found in an input section.  */
+
+struct sec_merge_blob
+{
+  mapofs_type ofs;
+  unsigned int len;
+  uint32_t hash;
+  unsigned int alignment;
+};
+
+/* An input section of the current batch.  */
+
+struct sec_merge_pending
+{
+  struct sec_merge_sec_info *secinfo;
+  /* Position of the section in its sec_merge_info.  */
+  uint64_t seq;
+  bfd_byte *contents;
+  struct sec_merge_blob *blobs;
+  unsigned int nblobs;
+};
+
+/* State shared by the threads recording a batch.  */
+
+struct sec_merge_threads
+{
+  struct sec_merge_info *sinfo;
+  unsigned int nthreads;
+  struct sec_merge_pending pending[MERGE_BATCH_SECTIONS];
+  unsigned int npending;
+  bfd_size_type pending_size;
+  /* Number of recorded sections before this batch.  */
+  uint64_t seq;
+  /* Shift of a hash to get the index of its table.  */
+  unsigned int shard_shift;
+  /* The next section or table for a thread to work on.  */
+  unsigned int next;
+  bool failed;
+  /* The BFD error of the first thread to fail, which is only set in
+     that thread.  */
+  bfd_error_type error;
+  pthread_mutex_t lock;
+};
+
+/* Return the next unit of work in STATE, or LIMIT if there is none
+   left.  */
+
+static unsigned int
+merge_next_work (struct sec_merge_threads *state, unsigned int limit)
+{
+  unsigned int i;
+
+  pthread_mutex_lock (&state->lock);
+  i = state->next;
+  if (i < limit && !state->failed)
+    state->next++;
+  else
+    i = limit;
+  pthread_mutex_unlock (&state->lock);
+  return i;
+}
+
+/* Note that a thread working on STATE failed, and why.  */
+
+static void
+merge_work_failed (struct sec_merge_threads *state)
+{
+  pthread_mutex_lock (&state->lock);
+  if (!state->failed)
+    state->error = bfd_get_error ();
+  state->failed = true;
+  pthread_mutex_unlock (&state->lock);
+}
+
+/* Read in the contents of PEND and find all blobs in them.  */
+
+static bool
+scan_pending_section (struct sec_merge_threads *state,
+		      struct sec_merge_pending *pend)
+{
+  struct sec_merge_sec_info *secinfo = pend->secinfo;
+  asection *sec = secinfo->sec;
+  unsigned char *p, *end;
+  unsigned int nalloc;
+  bfd_vma mask;
+
+  /* BFD does not support reading input files from several threads.  */
+  pthread_mutex_lock (&state->lock);
+  pend->contents = read_merge_section (sec);
+  pthread_mutex_unlock (&state->lock);
+  if (pend->contents == NULL)
+    return false;
+
+  mask = ((bfd_vma) 1 << sec->alignment_power) - 1;
+  end = pend->contents + sec->size;
+  nalloc = 0;
+  for (p = pend->contents; p < end;)
+    {
+      struct sec_merge_blob *blob;
+
+      if (pend->nblobs == nalloc)
+	{
+	  nalloc = nalloc ? 2 * nalloc : 2048;
+	  pend->blobs = bfd_realloc (pend->blobs,
+				     nalloc * sizeof (pend->blobs[0]));
+	  if (pend->blobs == NULL)
+	    return false;
+	}
+      blob = &pend->blobs[pend->nblobs++];
+      blob->hash = hashit (state->sinfo->htab, (char *) p, &blob->len);
+      blob->ofs = p - pend->contents;
+      blob->alignment = blob_alignment (blob->ofs, mask);
+      p += blob->len;
+    }
+
+  /* Size the offset map for all blobs and the sentinel, see
+     record_section.  */
+  secinfo->map_ofs = bfd_malloc ((pend->nblobs + 1)
+				 * sizeof (secinfo->map_ofs[0]));
+  secinfo->map = bfd_malloc ((pend->nblobs + 1) * sizeof (secinfo->map[0]));
+  if (secinfo->map_ofs == NULL || secinfo->map == NULL)
+    return false;
+  MAP_OFS (secinfo, pend->nblobs) = sec->size;
+  secinfo->map[pend->nblobs].entry = NULL;
+  secinfo->noffsetmap = pend->nblobs;
+  return true;
+}
+
+/* Insert the blobs of all sections of the batch in STATE whose hashes
+   belong to table SHARD into that table.  */
+
+static bool
+fill_merge_shard (struct sec_merge_threads *state, unsigned int shard)
+{
+  struct sec_merge_hash *table = state->sinfo->shards[shard];
+  unsigned int i, j;
+
+  for (i = 0; i < state->npending; i++)
+    {
+      struct sec_merge_pending *pend = &state->pending[i];
+      struct sec_merge_sec_info *secinfo = pend->secinfo;
+      unsigned int count = 0;
+
+      for (j = 0; j < pend->nblobs; j++)
+	if (pend->blobs[j].hash >> state->shard_shift == shard)
+	  count++;
+      if (!sec_merge_maybe_resize (table, count))
+	{
+	  bfd_set_error (bfd_error_no_memory);
+	  return false;
+	}
+
+      for (j = 0; j < pend->nblobs; j++)
+	{
+	  struct sec_merge_blob *blob = &pend->blobs[j];
+	  struct sec_merge_hash_entry *entry;
+	  bfd_size_type size;
+
+	  if (blob->hash >> state->shard_shift != shard)
+	    continue;
+
+	  size = table->size;
+	  entry = sec_merge_hash_lookup (table,
+					 (char *) pend->contents + blob->ofs,
+					 blob->len, blob->hash,
+					 blob->alignment);
+	  if (entry == NULL)
+	    return false;
+	  if (table->size != size)
+	    entry->u.seq = ((state->seq + i) << 32) | blob->ofs;
+	  MAP_OFS (secinfo, j) = blob->ofs;
+	  secinfo->map[j].entry = entry;
+	}
+    }
+  return true;
+}
+
+/* Thread function scanning the sections of a batch.  */
+
+static void *
+merge_scan_worker (void *arg)
+{
+  struct sec_merge_threads *state = (struct sec_merge_threads *) arg;
+  unsigned int i;
+
+  while ((i = merge_next_work (state, state->npending)) < state->npending)
+    if (!scan_pending_section (state, &state->pending[i]))
+      merge_work_failed (state);
+  return NULL;
+}
+
+/* Thread function inserting the blobs of a batch into the tables.  */
+
+static void *
+merge_fill_worker (void *arg)
+{
+  struct sec_merge_threads *state = (struct sec_merge_threads *) arg;
+  unsigned int nshards = state->sinfo->nshards;
+  unsigned int i;
+
+  while ((i = merge_next_work (state, nshards)) < nshards)
+    if (!fill_merge_shard (state, i))
+      merge_work_failed (state);
+  return NULL;
+}
+
+/* Run WORKER on STATE->NTHREADS threads, this one included.  */
+
+static bool
+run_merge_workers (struct sec_merge_threads *state, void *(*worker) (void *))
+{
+  pthread_t threads[MERGE_MAX_SHARDS];
+  unsigned int started, i;
+
+  state->next = 0;
+  /* If a thread cannot be started, the others do its share.  */
+  for (started = 0; started < state->nthreads - 1; started++)
+    if (pthread_create (&threads[started], NULL, worker, state) != 0)
+      break;
+  (*worker) (state);
+  for (i = 0; i < started; i++)
+    pthread_join (threads[i], NULL);
+  if (state->failed)
+    {
+      bfd_set_error (state->error);
+      return false;
+    }
+  return true;
+}
+
+/* Record the batch of sections in STATE.  */
+
+static bool
+record_pending_sections (struct sec_merge_threads *state)
+{
+  bool ok;
+  unsigned int i;
+
+  ok = (run_merge_workers (state, merge_scan_worker)
+	&& run_merge_workers (state, merge_fill_worker));
+
+  for (i = 0; i < state->npending; i++)
+    {
+      free (state->pending[i].contents);
+      free (state->pending[i].blobs);
+    }
+  memset (state->pending, 0, state->npending * sizeof (state->pending[0]));
+  state->seq += state->npending;
+  state->npending = 0;
+  state->pending_size = 0;
+  return ok;
+}
+
+/* Add SECINFO to the batch of sections in STATE, recording the batch
+   once it is full.  */
+
+static bool
+record_section_concurrently (struct sec_merge_threads *state,
+			     struct sec_merge_sec_info *secinfo)
+{
+  state->pending[state->npending++].secinfo = secinfo;
+  state->pending_size += secinfo->sec->size;
+  if (state->npending == MERGE_BATCH_SECTIONS
+      || state->pending_size >= MERGE_BATCH_SIZE)
+    return record_pending_sections (state);
+  return true;
+}
+
+/* Put the entries of all tables of SINFO into a single list in HTAB in
+   the order they were first seen.  */
+
+static void
+merge_shard_entries (struct sec_merge_info *sinfo)
+{
+  struct sec_merge_hash_entry *heads[MERGE_MAX_SHARDS];
+  struct sec_merge_hash *htab = sinfo->htab;
+  bfd_size_type size = 0;
+  unsigned int i;
+
+  for (i = 0; i < sinfo->nshards; i++)
+    {
+      heads[i] = sinfo->shards[i]->first;
+      size += sinfo->shards[i]->size;
+    }
+  htab->first = NULL;
+  htab->last = NULL;
+  htab->size = size;
+
+  /* Each table lists its entries in the order they were first seen, so
+     it's enough to repeatedly take the earliest of the heads.  */
+  for (;;)
+    {
+      struct sec_merge_hash_entry *e = NULL;
+      unsigned int best = 0;
+
+      for (i = 0; i < sinfo->nshards; i++)
+	if (heads[i] != NULL && (e == NULL || heads[i]->u.seq < e->u.seq))
+	  {
+	    e = heads[i];
+	    best = i;
+	  }
+      if (e == NULL)
+	break;
+      heads[best] = e->next;
+
+      e->next = NULL;
+      e->u.suffix = NULL;
+      if (htab->first == NULL)
+	htab->first = e;
+      else
+	htab->last->next = e;
+      htab->last = e;
+    }
+}
+
+/* Return the number of threads to use for merging with INFO, at most
+   MERGE_MAX_SHARDS, or 1 if no worker threads should be used.  */
+
+static unsigned int
+merge_thread_count (struct bfd_link_info *info)
+{
+  unsigned int nthreads;
+
+  if (info == NULL || !info->threads)
+    return 1;
+
+  nthreads = info->thread_count;
+#if defined (HAVE_SYSCONF) && defined (_SC_NPROCESSORS_ONLN)
+  if (nthreads == 0)
+    {
+      long n = sysconf (_SC_NPROCESSORS_ONLN);
+      if (n > 0)
+	nthreads = n;
+    }
+#endif
+  if (nthreads > MERGE_MAX_SHARDS)
+    nthreads = MERGE_MAX_SHARDS;
+  if (nthreads < 1)
+    nthreads = 1;
+  return nthreads;
+}
+
+/* Return a state for recording the sections of SINFO on worker
+   threads, or NULL if they should be recorded by this thread.  */
+
+static struct sec_merge_threads *
+merge_threads_init (struct bfd_link_info *info, struct sec_merge_info *sinfo)
+{
+  struct sec_merge_threads *state;
+  unsigned int nthreads, nshards, i;
+
+  if (sinfo->chain->next == NULL)
+    return NULL;
+
+  nthreads = merge_thread_count (info);
+  if (nthreads < 2)
+    return NULL;
+
+  state = bfd_zmalloc (sizeof (*state));
+  if (state == NULL)
+    return NULL;
+
+  /* Use a power of two number of tables, so that the top bits of a
+     hash select its table.  */
+  for (nshards = 1, state->shard_shift = 32;
+       nshards < nthreads;
+       nshards *= 2, state->shard_shift--)
+    ;
+  if (sinfo->shards == NULL)
+    {
+      sinfo->shards = bfd_zmalloc (nshards * sizeof (sinfo->shards[0]));
+      if (sinfo->shards == NULL)
+	{
+	  free (state);
+	  return NULL;
+	}
+      sinfo->nshards = nshards;
+      sinfo->shards[0] = sinfo->htab;
+      for (i = 1; i < nshards; i++)
+	{
+	  sinfo->shards[i] = sec_merge_init (sinfo->htab->entsize,
+					     sinfo->htab->strings);
+	  if (sinfo->shards[i] == NULL)
+	    {
+	      free (state);
+	      return NULL;
+	    }
+	}
+    }
+
+  state->sinfo = sinfo;
+  state->nthreads = nthreads;
+  pthread_mutex_init (&state->lock, NULL);
+  return state;
+}
+
+/* Record the remaining sections of STATE, merge the tables and free
+   STATE.  */
+
+static bool
+merge_threads_finish (struct sec_merge_threads *state, bool ok)
+{
+  if (ok && state->npending != 0)
+    ok = record_pending_sections (state);
+  else
+    {
+      unsigned int i;
+
+      for (i = 0; i < state->npending; i++)
+	{
+	  free (state->pending[i].contents);
+	  free (state->pending[i].blobs);
+	}
+    }
+  if (ok)
+    merge_shard_entries (state->sinfo);
+  pthread_mutex_destroy (&state->lock);
+  free (state);
+  return ok;
+}
+
+/* Sorting of the strings for suffix merging on worker threads.  The
+   array is cut into one slice per thread and each slice is sorted
+   with qsort on its own thread.  Neighbouring slices are then merged
+   until only one is left.  No two strings compare equal, so the
+   result is the same as that of a single qsort.  */
+
+/* Don't give a thread fewer strings than this to sort.  */
+#define MERGE_SORT_SLICE_MIN 16384
+
+/* A slice of the strings being sorted.  */
+
+struct sec_merge_sort_slice
+{
+  struct sec_merge_hash_entry **start;
+  size_t count;
+  int (*cmp) (const void *, const void *);
+};
+
+/* Thread function sorting a slice.  */
+
+static void *
+merge_sort_worker (void *arg)
+{
+  struct sec_merge_sort_slice *slice = (struct sec_merge_sort_slice *) arg;
+
+  qsort (slice->start, slice->count, sizeof (slice->start[0]), slice->cmp);
+  return NULL;
+}
+
+/* Merge the sorted slices A and B into OUT.  */
+
+static void
+merge_sort_slices (const struct sec_merge_sort_slice *a,
+		   const struct sec_merge_sort_slice *b,
+		   struct sec_merge_hash_entry **out)
+{
+  struct sec_merge_hash_entry **p = a->start, **pend = p + a->count;
+  struct sec_merge_hash_entry **q = b->start, **qend = q + b->count;
+
+  while (p < pend && q < qend)
+    if (a->cmp (p, q) < 0)
+      *out++ = *p++;
+    else
+      *out++ = *q++;
+  while (p < pend)
+    *out++ = *p++;
+  while (q < qend)
+    *out++ = *q++;
+}
+
+/* Sort the COUNT strings in ARRAY with CMP on up to NTHREADS threads.
+   Return false if they were not sorted.  */
+
+static bool
+sort_strings_concurrently (struct sec_merge_hash_entry **array, size_t count,
+			   int (*cmp) (const void *, const void *),
+			   unsigned int nthreads)
+{
+  struct sec_merge_sort_slice slices[MERGE_MAX_SHARDS];
+  pthread_t threads[MERGE_MAX_SHARDS];
+  bool started[MERGE_MAX_SHARDS];
+  struct sec_merge_hash_entry **from, **to, **tmp;
+  unsigned int nslices, i;
+
+  nslices = count / MERGE_SORT_SLICE_MIN;
+  if (nslices > nthreads)
+    nslices = nthreads;
+  if (nslices < 2)
+    return false;
+
+  tmp = (struct sec_merge_hash_entry **) bfd_malloc (count * sizeof (*tmp));
+  if (tmp == NULL)
+    return false;
+
+  for (i = 0; i < nslices; i++)
+    {
+      slices[i].start = array + count * i / nslices;
+      slices[i].count = count * (i + 1) / nslices - count * i / nslices;
+      slices[i].cmp = cmp;
+    }
+
+  /* If a thread cannot be started, its slice is sorted here.  */
+  for (i = 1; i < nslices; i++)
+    started[i] = pthread_create (&threads[i], NULL, merge_sort_worker,
+				 &slices[i]) == 0;
+  merge_sort_worker (&slices[0]);
+  for (i = 1; i < nslices; i++)
+    if (started[i])
+      pthread_join (threads[i], NULL);
+    else
+      merge_sort_worker (&slices[i]);
+
+  from = array;
+  to = tmp;
+  while (nslices > 1)
+    {
+      unsigned int n = 0;
+
+      for (i = 0; i < nslices; i += 2, n++)
+	{
+	  struct sec_merge_hash_entry **out = to + (slices[i].start - from);
+
+	  if (i + 1 < nslices)
+	    {
+	      merge_sort_slices (&slices[i], &slices[i + 1], out);
+	      slices[n].count = slices[i].count + slices[i + 1].count;
+	    }
+	  else
+	    {
+	      memcpy (out, slices[i].start, slices[i].count * sizeof (*out));
+	      slices[n].count = slices[i].count;
+	    }
+	  slices[n].start = out;
+	}
+      nslices = n;
+      tmp = from;
+      from = to;
+      to = tmp;
+    }
+
+  if (from != array)
+    {
+      memcpy (array, from, count * sizeof (*array));
+      free (from);
+    }
+  else
+    free (to);
+  return true;
+}
+
+#endif /* ENABLE_THREADS */
+
 /* qsort comparison function.  Won't ever return zero as all entries
    differ, so there is no issue with qsort stability here.  */
 
@@ -850,7 +1462,8 @@ is_suffix (const struct sec_merge_hash_entry *A,
 /* This is a helper function for _bfd_merge_sections.  It attempts to
    merge strings matching suffixes of longer strings.  */
 static struct sec_merge_sec_info *
-merge_strings (struct sec_merge_info *sinfo)
+merge_strings (struct sec_merge_info *sinfo,
+	       struct bfd_link_info *info ATTRIBUTE_UNUSED)
 {
   struct sec_merge_hash_entry **array, **a, *e;
   struct sec_merge_sec_info *secinfo;
@@ -881,10 +1494,16 @@ merge_strings (struct sec_merge_info *sinfo)
   sinfo->htab->size = a - array;
   if (sinfo->htab->size != 0)
     {
-      qsort (array, (size_t) sinfo->htab->size,
-	     sizeof (struct sec_merge_hash_entry *),
-	     (alignment != (unsigned) -1 && alignment > sinfo->htab->entsize
-	      ? strrevcmp_align : strrevcmp));
+      int (*compare) (const void *, const void *)
+	= (alignment != (unsigned) -1 && alignment > sinfo->htab->entsize
+	   ? strrevcmp_align : strrevcmp);
+
+#ifdef ENABLE_THREADS
+      if (!sort_strings_concurrently (array, (size_t) sinfo->htab->size,
+				      compare, merge_thread_count (info)))
+#endif
+	qsort (array, (size_t) sinfo->htab->size,
+	       sizeof (struct sec_merge_hash_entry *), compare);
 
       /* Loop over the sorted array and merge suffixes */
       e = *--a;
@@ -958,10 +1577,17 @@ _bfd_merge_sections (bfd *abfd,
     {
       struct sec_merge_sec_info *secinfo;
       bfd_size_type align;  /* Bytes.  */
+#ifdef ENABLE_THREADS
+      struct sec_merge_threads *threads;
+#endif
 
       if (! sinfo->chain)
 	continue;
 
+#ifdef ENABLE_THREADS
+      threads = merge_threads_init (info, sinfo);
+#endif
+
       /* Record the sections into the hash table.  */
       align = 1;
       for (secinfo = sinfo->chain; secinfo; secinfo = secinfo->next)
@@ -973,6 +1599,14 @@ _bfd_merge_sections (bfd *abfd,
 	  }
 	else
 	  {
+#ifdef ENABLE_THREADS
+	    if (threads != NULL)
+	      {
+		if (!record_section_concurrently (threads, secinfo))
+		  break;
+	      }
+	    else
+#endif
 	    if (!record_section (sinfo, secinfo))
 	      return false;
 	    if (align)
@@ -985,12 +1619,22 @@ _bfd_merge_sections (bfd *abfd,
 	      }
 	  }
 
+#ifdef ENABLE_THREADS
+      if (threads != NULL
+	  && !merge_threads_finish (threads, secinfo == NULL))
+	{
+	  for (secinfo = sinfo->chain; secinfo; secinfo = secinfo->next)
+	    *secinfo->psecinfo = NULL;
+	  return false;
+	}
+#endif
+
       if (sinfo->htab->first == NULL)
 	continue;
 
       if (sinfo->htab->strings)
 	{
-	  secinfo = merge_strings (sinfo);
+	  secinfo = merge_strings (sinfo, info);
 	  if (!secinfo)
 	    return false;
 	}
@@ -1143,5 +1787,17 @@ _bfd_merge_sections_free (void *xsinfo)
 	}
       bfd_hash_table_free (&sinfo->htab->table);
       free (sinfo->htab);
+      if (sinfo->shards != NULL)
+	{
+	  unsigned int i;
+
+	  for (i = 1; i < sinfo->nshards; i++)
+	    if (sinfo->shards[i] != NULL)
+	      {
+		bfd_hash_table_free (&sinfo->shards[i]->table);
+		free (sinfo->shards[i]);
+	      }
+	  free (sinfo->shards);
+	}
     }
 }
@@ -81,6 +81,11 @@ _bfd_new_bfd (void)
   if (nbfd == NULL)
     return NULL;
 
+  if (!bfd_lock ())
+    {
+      free (nbfd);
+      return NULL;
+    }
   if (bfd_use_reserved_id)
     {
       nbfd->id = --bfd_reserved_id_counter;
@@ -88,6 +93,11 @@ _bfd_new_bfd (void)
     }
   else
     nbfd->id = bfd_id_counter++;
+  if (!bfd_unlock ())
+    {
+      free (nbfd);
+      return NULL;
+    }
 
   nbfd->memory = objalloc_create ();
   if (nbfd->memory == NULL)
@@ -163,6 +173,8 @@ _bfd_delete_bfd (bfd *abfd)
   /* The target _bfd_free_cached_info may not have done anything..  */
   if (abfd->memory)
     {
+      _bfd_free_section_views (abfd);
+      _bfd_free_decompress_chunks (abfd);
       bfd_hash_table_free (&abfd->section_htab);
       objalloc_free ((struct objalloc *) abfd->memory);
     }
@@ -212,6 +224,8 @@ _bfd_free_cached_info (bfd *abfd)
 	  memcpy (copy, filename, len);
 	  abfd->filename = copy;
 	}
+      _bfd_free_section_views (abfd);
+      _bfd_free_decompress_chunks (abfd);
       bfd_hash_table_free (&abfd->section_htab);
       objalloc_free ((struct objalloc *) abfd->memory);
 
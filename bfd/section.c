@@ -133,6 +133,9 @@ SUBSECTION
 #include "bfd.h"
 #include "libbfd.h"
 #include "bfdlink.h"
+#ifdef HAVE_MMAP
+#include <sys/mman.h>
+#endif
 
 /*
 DOCDD
@@ -563,6 +566,13 @@ CODE_FRAGMENT
 .  {* Explicitly specified section type, if non-zero.  *}
 .  unsigned int type;
 .
+.  {* Contents handed out by bfd_get_section_view, if any.  *}
+.  struct bfd_section_view *view;
+.
+.  {* For a section decompressed on reading, the pieces it was
+.     compressed in, once part of its contents has been read.  *}
+.  struct decompress_chunks *decompress_chunks;
+.
 .} asection;
 .
 
@@ -738,8 +748,11 @@ EXTERNAL
 .  {* symbol,                    symbol_ptr_ptr,                     *}	\
 .     (struct bfd_symbol *) SYM, &SEC.symbol,				\
 .									\
-.  {* map_head, map_tail, already_assigned, type                     *}	\
-.     { NULL }, { NULL }, NULL,             0				\
+.  {* map_head, map_tail, already_assigned, type, view,              *}	\
+.     { NULL }, { NULL }, NULL,             0,    NULL,			\
+.									\
+.  {* decompress_chunks                                              *}	\
+.     NULL								\
 .									\
 .    }
 .
@@ -831,24 +844,86 @@ _bfd_generic_new_section_hook (bfd *abfd, asection *newsect)
 
 unsigned int _bfd_section_id = 0x10;  /* id 0 to 3 used by STD_SECTION.  */
 
+/* The number of section ids taken by the calling thread.  */
+static TLS unsigned int section_ids_taken;
+
 /* Initializes a new section.  NEWSECT->NAME is already set.  */
 
 static asection *
 bfd_section_init (bfd *abfd, asection *newsect)
 {
-  newsect->id = _bfd_section_id;
+  if (!bfd_lock ())
+    return NULL;
+  newsect->id = _bfd_section_id++;
+  section_ids_taken++;
+  if (!bfd_unlock ())
+    return NULL;
   newsect->index = abfd->section_count;
   newsect->owner = abfd;
 
   if (! BFD_SEND (abfd, _new_section_hook, (abfd, newsect)))
     return NULL;
 
-  _bfd_section_id++;
   abfd->section_count++;
   bfd_section_list_append (abfd, newsect);
   return newsect;
 }
 
+/*
+INTERNAL_FUNCTION
+	_bfd_section_id_mark
+
+SYNOPSIS
+	void _bfd_section_id_mark (unsigned int *id, unsigned int *taken);
+
+DESCRIPTION
+	Store the next section id in @var{id}, and the number of
+	section ids taken so far by the calling thread in @var{taken},
+	for a later call to _bfd_section_id_reset.
+*/
+
+void
+_bfd_section_id_mark (unsigned int *id, unsigned int *taken)
+{
+  *taken = section_ids_taken;
+  if (!bfd_lock ())
+    {
+      /* An id below the first one never allows a reset.  */
+      *id = 0;
+      return;
+    }
+  *id = _bfd_section_id;
+  bfd_unlock ();
+}
+
+/*
+INTERNAL_FUNCTION
+	_bfd_section_id_reset
+
+SYNOPSIS
+	void _bfd_section_id_reset (unsigned int id, unsigned int taken);
+
+DESCRIPTION
+	Give back the section ids taken by the calling thread since
+	_bfd_section_id_mark returned @var{id} and @var{taken}, so
+	that they are used again.  Nothing is given back if another
+	thread has taken section ids in the meantime, as those must
+	stay unique.
+*/
+
+void
+_bfd_section_id_reset (unsigned int id, unsigned int taken)
+{
+  if (!bfd_lock ())
+    return;
+  if (_bfd_section_id - id == section_ids_taken - taken)
+    {
+      _bfd_section_id = id;
+      section_ids_taken = taken;
+    }
+  bfd_unlock ();
+}
+
 /*
 DOCDD
 INODE
@@ -1628,6 +1703,226 @@ bfd_malloc_and_get_section (bfd *abfd, sec_ptr sec, bfd_byte **buf)
   *buf = NULL;
   return bfd_get_full_section_contents (abfd, sec, buf);
 }
+
+/* Contents handed out by bfd_get_section_view.  */
+
+struct bfd_section_view
+{
+  const bfd_byte *data;
+  bfd_size_type size;
+  /* The page aligned mapping holding DATA, or NULL if DATA was
+     malloc'd.  */
+  void *map_addr;
+  bfd_size_type map_len;
+  /* Calls to bfd_get_section_view not yet released.  */
+  unsigned int refcount;
+};
+
+/* Sections smaller than this are read rather than mapped, since a
+   read costs less than setting up and tearing down a mapping.  */
+#define SECTION_VIEW_MMAP_MIN (64 * 1024)
+
+static void
+free_section_view (struct bfd_section_view *view)
+{
+#ifdef HAVE_MMAP
+  if (view->map_addr != NULL)
+    munmap (view->map_addr, view->map_len);
+  else
+#endif
+    free ((bfd_byte *) view->data);
+  free (view);
+}
+
+/*
+FUNCTION
+	bfd_section_view_mappable
+
+SYNOPSIS
+	bool bfd_section_view_mappable (bfd *abfd, asection *section);
+
+DESCRIPTION
+	Return @code{true} if @code{bfd_get_section_view} would map
+	@var{section} of @var{abfd} from the file rather than read it
+	into a buffer.  Only sections of at least 64K which are stored
+	uncompressed in a file opened for reading are mapped, and only
+	for targets which read section contents with the generic
+	routine.
+*/
+
+bool
+bfd_section_view_mappable (bfd *abfd ATTRIBUTE_UNUSED,
+			   asection *sec ATTRIBUTE_UNUSED)
+{
+#ifdef HAVE_MMAP
+  bfd_size_type size;
+  ufile_ptr filesize;
+
+  if (abfd->direction != read_direction
+      || (abfd->flags & BFD_IN_MEMORY) != 0
+      || (sec->flags & (SEC_HAS_CONTENTS | SEC_IN_MEMORY | SEC_CONSTRUCTOR))
+	 != SEC_HAS_CONTENTS
+      || sec->compress_status != COMPRESS_SECTION_NONE
+      || abfd->xvec->_bfd_get_section_contents
+	 != _bfd_generic_get_section_contents)
+    return false;
+
+  size = bfd_get_section_limit_octets (abfd, sec);
+  if (size < SECTION_VIEW_MMAP_MIN || size != (size_t) size)
+    return false;
+
+  /* Touching a mapping beyond the end of the file raises SIGBUS, so
+     leave sections which do not fit to the read path to diagnose.  */
+  filesize = bfd_get_file_size (abfd);
+  return (filesize != 0
+	  && sec->filepos >= 0
+	  && (ufile_ptr) sec->filepos <= filesize
+	  && size <= filesize - sec->filepos);
+#else
+  return false;
+#endif
+}
+
+/* Try to map the contents of SEC straight from the file into VIEW.
+   Return FALSE, without setting an error, if the section must be read
+   instead.  */
+
+static bool
+map_section_view (bfd *abfd ATTRIBUTE_UNUSED,
+		  asection *sec ATTRIBUTE_UNUSED,
+		  struct bfd_section_view *view ATTRIBUTE_UNUSED)
+{
+#ifdef HAVE_MMAP
+  bfd_size_type size;
+  void *data;
+
+  if (!bfd_section_view_mappable (abfd, sec))
+    return false;
+
+  size = bfd_get_section_limit_octets (abfd, sec);
+  data = bfd_mmap (abfd, NULL, size, PROT_READ, MAP_PRIVATE, sec->filepos,
+		   &view->map_addr, &view->map_len);
+  if (data == (void *) -1)
+    {
+      view->map_addr = NULL;
+      return false;
+    }
+  view->data = data;
+  view->size = size;
+  return true;
+#else
+  return false;
+#endif
+}
+
+/*
+FUNCTION
+	bfd_get_section_view
+
+SYNOPSIS
+	bool bfd_get_section_view
+	  (bfd *abfd, asection *section, const bfd_byte **buf,
+	   bfd_size_type *size);
+
+DESCRIPTION
+	Make all data from @var{section} in BFD @var{abfd} available
+	read-only at *@var{buf}, and set *@var{size} to its length.
+	Large uncompressed sections are mapped from the file rather
+	than copied; others, including compressed sections, are read
+	into a malloc'd buffer.
+
+	Views are reference counted: each successful call returns the
+	same data and must be matched by a call to
+	@code{bfd_release_section_view}.  Any view still held is
+	released when @var{abfd} is closed.  Return @code{true} on
+	success, @code{false} on failure in which case *@var{buf} will
+	be NULL.
+*/
+
+bool
+bfd_get_section_view (bfd *abfd, sec_ptr sec, const bfd_byte **buf,
+		      bfd_size_type *size)
+{
+  struct bfd_section_view *view = sec->view;
+
+  *buf = NULL;
+  if (view == NULL)
+    {
+      view = bfd_zmalloc (sizeof (*view));
+      if (view == NULL)
+	return false;
+
+      if (!map_section_view (abfd, sec, view))
+	{
+	  bfd_byte *data = NULL;
+
+	  if (!bfd_get_full_section_contents (abfd, sec, &data))
+	    {
+	      free (view);
+	      return false;
+	    }
+	  view->data = data;
+	  view->size = sec->size;
+	}
+      sec->view = view;
+    }
+
+  view->refcount++;
+  *buf = view->data;
+  *size = view->size;
+  return true;
+}
+
+/*
+FUNCTION
+	bfd_release_section_view
+
+SYNOPSIS
+	void bfd_release_section_view (bfd *abfd, asection *section);
+
+DESCRIPTION
+	Drop a reference obtained by @code{bfd_get_section_view}.  The
+	data is unmapped or freed when the last reference goes.
+*/
+
+void
+bfd_release_section_view (bfd *abfd ATTRIBUTE_UNUSED, sec_ptr sec)
+{
+  struct bfd_section_view *view = sec->view;
+
+  if (view == NULL)
+    return;
+  if (--view->refcount == 0)
+    {
+      sec->view = NULL;
+      free_section_view (view);
+    }
+}
+
+/*
+INTERNAL_FUNCTION
+	_bfd_free_section_views
+
+SYNOPSIS
+	void _bfd_free_section_views (bfd *abfd);
+
+DESCRIPTION
+	Release the section views of @var{abfd} which are still held.
+*/
+
+void
+_bfd_free_section_views (bfd *abfd)
+{
+  asection *sec;
+
+  for (sec = abfd->sections; sec != NULL; sec = sec->next)
+    if (sec->view != NULL)
+      {
+	free_section_view (sec->view);
+	sec->view = NULL;
+      }
+}
+
 /*
 FUNCTION
 	bfd_copy_private_section_data
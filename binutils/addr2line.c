@@ -38,6 +38,13 @@
 #include "bucomm.h"
 #include "elf-bfd.h"
 #include "safe-ctype.h"
+#include "hashtab.h"
+#ifdef HAVE_MMAP
+#include <sys/mman.h>
+#endif
+#ifdef ENABLE_THREADS
+#include <pthread.h>
+#endif
 
 static bool unwind_inlines;	/* -i, unwind inlined functions. */
 static bool with_addresses;	/* -a, show addresses.  */
@@ -45,6 +52,9 @@ static bool with_functions;	/* -f, show function names.  */
 static bool do_demangle;	/* -C, demangle names.  */
 static bool pretty_print;	/* -p, print on one line.  */
 static bool base_names;		/* -s, strip directory names.  */
+static const char *cache_dir;	/* --cache-dir, keep results in this dir.  */
+static bool batch;		/* --batch, read all addresses first.  */
+static unsigned int thread_count; /* --thread-count, threads for --batch.  */
 
 /* Flags passed to the name demangler.  */
 static int demangle_flags = DMGL_PARAMS | DMGL_ANSI;
@@ -52,35 +62,98 @@ static int demangle_flags = DMGL_PARAMS | DMGL_ANSI;
 static int naddr;		/* Number of addresses to process.  */
 static char **addr;		/* Hex addresses to process.  */
 
-static long symcount;
-static asymbol **syms;		/* Symbol table.  */
+static const char *target;	/* -b, the format of the input files.  */
+static const char *section_name; /* -j, section of the offsets.  */
+
+enum option_values
+  {
+    OPTION_CACHE_DIR = 150,
+    OPTION_BATCH,
+    OPTION_THREAD_COUNT
+  };
 
 static struct option long_options[] =
 {
   {"addresses", no_argument, NULL, 'a'},
   {"basenames", no_argument, NULL, 's'},
+  {"batch", no_argument, NULL, OPTION_BATCH},
+  {"cache-dir", required_argument, NULL, OPTION_CACHE_DIR},
   {"demangle", optional_argument, NULL, 'C'},
   {"exe", required_argument, NULL, 'e'},
   {"functions", no_argument, NULL, 'f'},
   {"inlines", no_argument, NULL, 'i'},
   {"pretty-print", no_argument, NULL, 'p'},
   {"recurse-limit", no_argument, NULL, 'R'},
-  {"recursion-limit", no_argument, NULL, 'R'},  
+  {"recursion-limit", no_argument, NULL, 'R'},
   {"no-recurse-limit", no_argument, NULL, 'r'},
-  {"no-recursion-limit", no_argument, NULL, 'r'},  
+  {"no-recursion-limit", no_argument, NULL, 'r'},
   {"section", required_argument, NULL, 'j'},
   {"target", required_argument, NULL, 'b'},
+  {"thread-count", required_argument, NULL, OPTION_THREAD_COUNT},
   {"help", no_argument, NULL, 'H'},
   {"version", no_argument, NULL, 'V'},
   {0, no_argument, 0, 0}
 };
 
+/* A file to look up addresses in, named by -e or by an "-e FILE" line
+   of input.  Files stay open until the end, since more addresses may
+   be given for them at any time.  */
+
+struct input_file
+{
+  struct input_file *next;
+  const char *name;
+  unsigned int index;		/* Order in which the file was named.  */
+  bfd *abfd;			/* NULL if the file cannot be used.  */
+  asection *section;		/* The -j section, if any.  */
+  long symcount;
+  asymbol **syms;		/* Symbol table.  */
+  bool syms_read;		/* Whether SYMS has been read.  */
+  struct addr_cache *cache;	/* The --cache-dir cache, if any.  */
+};
+
+static struct input_file *input_files;
+static unsigned int input_file_count;
+
+/* An address to look up, and what bfd_find_nearest_line found for it.
+   This is passed between find_locations and find_address_in_section.  */
+
+struct lookup
+{
+  struct input_file *file;
+  bfd_vma pc;
+  const char *filename;
+  const char *functionname;
+  unsigned int line;
+  unsigned int discriminator;
+  bool found;
+};
+
+/* The locations found for an address: where it is, followed when
+   unwinding inlines by where each enclosing inlined function was
+   called.  No locations means the address was not found.  */
+
+struct location
+{
+  const char *filename;
+  const char *functionname;
+  unsigned int line;
+  unsigned int discriminator;
+};
+
+struct result
+{
+  struct location *locs;
+  size_t nlocs;
+  size_t alloc;
+};
+
 static void usage (FILE *, int);
-static void slurp_symtab (bfd *);
+static void slurp_symtab (struct input_file *);
 static void find_address_in_section (bfd *, asection *, void *);
-static void find_offset_in_section (bfd *, asection *);
-static void translate_addresses (bfd *, asection *);
-
+static void find_offset_in_section (struct lookup *);
+static void translate_addresses (struct input_file *);
+
 /* Print a usage message to STREAM and exit with STATUS.  */
 
 static void
@@ -99,6 +172,9 @@ usage (FILE *stream, int status)
   -p --pretty-print      Make the output easier to read for humans\n\
   -s --basenames         Strip directory names\n\
   -f --functions         Show function names\n\
+  --cache-dir=<dir>      Keep results for files with a build-id in <dir>\n\
+  --batch                Read all addresses before looking them up\n\
+  --thread-count=<count> Use <count> threads with --batch\n\
   -C --demangle[=style]  Demangle function names\n\
   -R --recurse-limit     Enable a limit on recursion whilst demangling.  [Default]\n\
   -r --no-recurse-limit  Disable a limit on recursion whilst demangling\n\
@@ -111,12 +187,15 @@ usage (FILE *stream, int status)
     fprintf (stream, _("Report bugs to %s\n"), REPORT_BUGS_TO);
   exit (status);
 }
-
+
 /* Read in the symbol table.  */
 
 static void
-slurp_symtab (bfd *abfd)
+slurp_symtab (struct input_file *file)
 {
+  bfd *abfd = file->abfd;
+  asymbol **syms;
+  long symcount;
   long storage;
   bool dynamic = false;
 
@@ -161,74 +240,738 @@ slurp_symtab (bfd *abfd)
       free (syms);
       syms = NULL;
     }
+
+  file->syms = syms;
+  file->symcount = symcount;
 }
-
-/* These global variables are used to pass information between
-   translate_addresses and find_address_in_section.  */
 
-static bfd_vma pc;
-static const char *filename;
-static const char *functionname;
-static unsigned int line;
-static unsigned int discriminator;
-static bool found;
+/* Read in the symbol table when first needed, which is not at all if
+   every address is found in the cache.  */
+
+static void
+read_symtab (struct input_file *file)
+{
+  if (!file->syms_read)
+    {
+      file->syms_read = true;
+      slurp_symtab (file);
+    }
+}
 
 /* Look for an address in a section.  This is called via
    bfd_map_over_sections.  */
 
 static void
-find_address_in_section (bfd *abfd, asection *section,
-			 void *data ATTRIBUTE_UNUSED)
+find_address_in_section (bfd *abfd, asection *section, void *data)
 {
+  struct lookup *l = (struct lookup *) data;
   bfd_vma vma;
   bfd_size_type size;
 
-  if (found)
+  if (l->found)
     return;
 
   if ((bfd_section_flags (section) & SEC_ALLOC) == 0)
     return;
 
   vma = bfd_section_vma (section);
-  if (pc < vma)
+  if (l->pc < vma)
     return;
 
   size = bfd_section_size (section);
-  if (pc >= vma + size)
+  if (l->pc >= vma + size)
     return;
 
-  found = bfd_find_nearest_line_discriminator (abfd, section, syms, pc - vma,
-                                               &filename, &functionname,
-                                               &line, &discriminator);
+  l->found = bfd_find_nearest_line_discriminator (abfd, section,
+						  l->file->syms, l->pc - vma,
+						  &l->filename,
+						  &l->functionname,
+						  &l->line, &l->discriminator);
 }
 
 /* Look for an offset in a section.  This is directly called.  */
 
 static void
-find_offset_in_section (bfd *abfd, asection *section)
+find_offset_in_section (struct lookup *l)
 {
+  asection *section = l->file->section;
   bfd_size_type size;
 
-  if (found)
+  if (l->found)
     return;
 
   if ((bfd_section_flags (section) & SEC_ALLOC) == 0)
     return;
 
   size = bfd_section_size (section);
-  if (pc >= size)
+  if (l->pc >= size)
+    return;
+
+  l->found = bfd_find_nearest_line_discriminator (l->file->abfd, section,
+						  l->file->syms, l->pc,
+						  &l->filename,
+						  &l->functionname,
+						  &l->line, &l->discriminator);
+}
+
+/* Strings kept beyond the lookup that found them, with their offset in
+   the string table of a cache being written.  */
+
+struct kept_string
+{
+  uint32_t offset;
+  char str[1];
+};
+
+static hashval_t
+hash_kept_string (const void *p)
+{
+  return htab_hash_string (((const struct kept_string *) p)->str);
+}
+
+static int
+eq_kept_string (const void *p1, const void *p2)
+{
+  return strcmp (((const struct kept_string *) p1)->str,
+		 ((const struct kept_string *) p2)->str) == 0;
+}
+
+/* Return the copy of STR in the table *TAB, creating both as needed.  */
+
+static struct kept_string *
+keep_string (htab_t *tab, const char *str)
+{
+  struct kept_string *ks, **slot;
+  size_t len;
+
+  if (*tab == NULL)
+    *tab = htab_create_alloc (256, hash_kept_string, eq_kept_string,
+			      free, xcalloc, free);
+
+  len = strlen (str);
+  ks = xmalloc (sizeof (*ks) + len);
+  memcpy (ks->str, str, len + 1);
+  slot = (struct kept_string **) htab_find_slot (*tab, ks, INSERT);
+  if (*slot != NULL)
+    {
+      free (ks);
+      return *slot;
+    }
+  ks->offset = 0xffffffff;
+  *slot = ks;
+  return ks;
+}
+
+/* Append a location to RES.  */
+
+static void
+add_location (struct result *res, const char *file, const char *function,
+	      unsigned int lineno, unsigned int disc)
+{
+  if (res->nlocs == res->alloc)
+    {
+      res->alloc = res->alloc ? res->alloc * 2 : 4;
+      res->locs = xrealloc (res->locs, res->alloc * sizeof (*res->locs));
+    }
+  res->locs[res->nlocs].filename = file;
+  res->locs[res->nlocs].functionname = function;
+  res->locs[res->nlocs].line = lineno;
+  res->locs[res->nlocs].discriminator = disc;
+  res->nlocs++;
+}
+
+/* Look up the address in L, setting RES to its location and if needed
+   those of the functions it was inlined into.  The inlined-by lines
+   are printed with the discriminator of the first.  */
+
+static void
+find_locations (struct lookup *l, struct result *res, bool all_inlines)
+{
+  struct input_file *file = l->file;
+
+  res->nlocs = 0;
+  if (file->abfd == NULL)
     return;
 
-  found = bfd_find_nearest_line_discriminator (abfd, section, syms, pc,
-                                               &filename, &functionname,
-                                               &line, &discriminator);
+  read_symtab (file);
+  l->found = false;
+  if (file->section)
+    find_offset_in_section (l);
+  else
+    bfd_map_over_sections (file->abfd, find_address_in_section, l);
+  if (!l->found)
+    return;
+
+  do
+    add_location (res, l->filename, l->functionname, l->line,
+		  l->discriminator);
+  while ((unwind_inlines || all_inlines)
+	 && bfd_find_inliner_info (file->abfd, &l->filename,
+				   &l->functionname, &l->line));
+}
+
+/* With --cache-dir, the locations found for the addresses of a file
+   with a build-id are kept in DIR/<build-id>.a2l so that later runs
+   need not read the file's debug info for them.  Only addresses
+   actually looked up are stored, since BFD reports a location for an
+   address rather than for the range of addresses sharing it.  This
+   costs most of the benefit for lookups near, but not at, an address
+   already cached, such as other return addresses in the same function:
+   each of them still reads the debug info once.  Storing line table
+   ranges would need an interface to them in BFD.
+
+   Only addresses given a line number are stored.  Without one the
+   location came from the symbols alone, as for a stripped copy of the
+   file or one whose separate debug file is missing, and a later run
+   might do better.  The cache holds a header, the entries sorted by
+   address, their locations, then a string table, in host byte order,
+   so that it can be mapped and searched in place.  */
+
+#define CACHE_MAGIC	0x4332414c	/* "LA2C" on little-endian hosts.  */
+#define CACHE_VERSION	1
+#define CACHE_NO_STRING	0xffffffff
+
+struct cache_header
+{
+  uint32_t magic;
+  uint32_t version;
+  uint32_t nentries;
+  uint32_t nlocs;
+  uint32_t strsize;
+  uint32_t reserved;
+};
+
+struct cache_entry
+{
+  uint64_t addr;
+  uint32_t loc;			/* Index of the first location.  */
+  uint32_t nlocs;
+};
+
+struct cache_loc
+{
+  uint32_t filename;		/* Offsets in the string table.  */
+  uint32_t functionname;
+  uint32_t line;
+  uint32_t discriminator;
+};
+
+/* Addresses looked up this run, to be added to a cache.  Their strings
+   are kept in the cache's STRTAB, since not every BFD backend keeps
+   them for as long as the BFD is open.  */
+
+struct new_entry
+{
+  bfd_vma addr;
+  size_t loc;
+  size_t nlocs;
+};
+
+struct addr_cache
+{
+  char *file;			/* Name of the cache.  */
+  char *map;			/* Its contents.  */
+  size_t size;
+  bool mapped;			/* Whether MAP is mapped.  */
+  struct cache_header hdr;
+  const struct cache_entry *entries;
+  const struct cache_loc *locs;
+  const char *strings;
+
+  struct new_entry *new_entries;
+  size_t new_entry_count;
+  size_t new_entry_alloc;
+  struct location *new_locs;
+  size_t new_loc_count;
+  size_t new_loc_alloc;
+  htab_t strtab;
+};
+
+/* Open the cache for FILE, if it has a build-id.  A missing or
+   unusable cache is treated as empty.  */
+
+static void
+open_cache (struct input_file *file)
+{
+  const struct bfd_build_id *build_id = file->abfd->build_id;
+  struct addr_cache *c;
+  struct stat st;
+  char *hex;
+  uint64_t need;
+  unsigned int i;
+  int fd;
+
+  if (build_id == NULL || build_id->size == 0)
+    return;
+
+  c = xcalloc (1, sizeof (*c));
+  file->cache = c;
+  hex = xmalloc (build_id->size * 2 + 1);
+  for (i = 0; i < build_id->size; i++)
+    sprintf (hex + i * 2, "%02x", build_id->data[i]);
+  c->file = concat (cache_dir, "/", hex, ".a2l", NULL);
+  free (hex);
+
+  fd = open (c->file, O_RDONLY | O_BINARY);
+  if (fd < 0)
+    return;
+  if (fstat (fd, &st) < 0
+      || (uint64_t) st.st_size < sizeof (c->hdr)
+      || (uint64_t) st.st_size != (size_t) st.st_size)
+    {
+      close (fd);
+      return;
+    }
+  c->size = st.st_size;
+
+#ifdef HAVE_MMAP
+  c->map = mmap (NULL, c->size, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (c->map != MAP_FAILED)
+    c->mapped = true;
+  else
+#endif
+    {
+      c->map = xmalloc (c->size);
+      if ((size_t) read (fd, c->map, c->size) != c->size)
+	{
+	  free (c->map);
+	  c->map = NULL;
+	}
+    }
+  close (fd);
+  if (c->map == NULL)
+    return;
+
+  memcpy (&c->hdr, c->map, sizeof (c->hdr));
+  need = (sizeof (c->hdr)
+	  + (uint64_t) c->hdr.nentries * sizeof (struct cache_entry)
+	  + (uint64_t) c->hdr.nlocs * sizeof (struct cache_loc)
+	  + c->hdr.strsize);
+  if (c->hdr.magic != CACHE_MAGIC
+      || c->hdr.version != CACHE_VERSION
+      || need != c->size
+      || (c->hdr.strsize != 0
+	  && c->map[c->size - 1] != '\0'))
+    {
+      memset (&c->hdr, 0, sizeof (c->hdr));
+      return;
+    }
+  c->entries = (const struct cache_entry *) (c->map + sizeof (c->hdr));
+  c->locs = (const struct cache_loc *) (c->entries + c->hdr.nentries);
+  c->strings = (const char *) (c->locs + c->hdr.nlocs);
+}
+
+/* Set *STR to the string at OFFSET in cache C.  Return FALSE if OFFSET
+   is out of range.  */
+
+static bool
+cache_string (const struct addr_cache *c, uint32_t offset, const char **str)
+{
+  if (offset == CACHE_NO_STRING)
+    *str = NULL;
+  else if (offset < c->hdr.strsize)
+    *str = c->strings + offset;
+  else
+    return false;
+  return true;
+}
+
+/* Look for VMA in cache C, and if there set RES from it.  */
+
+static bool
+lookup_cache (const struct addr_cache *c, bfd_vma vma, struct result *res)
+{
+  const struct cache_entry *e;
+  size_t lo, hi;
+  uint32_t i;
+
+  lo = 0;
+  hi = c->hdr.nentries;
+  while (lo < hi)
+    {
+      size_t mid = lo + (hi - lo) / 2;
+
+      if (c->entries[mid].addr < vma)
+	lo = mid + 1;
+      else
+	hi = mid;
+    }
+  if (lo == c->hdr.nentries || c->entries[lo].addr != vma)
+    return false;
+
+  e = &c->entries[lo];
+  if (e->loc > c->hdr.nlocs || e->nlocs > c->hdr.nlocs - e->loc)
+    return false;
+
+  res->nlocs = 0;
+  for (i = 0; i < e->nlocs; i++)
+    {
+      const struct cache_loc *l = &c->locs[e->loc + i];
+      const char *file, *function;
+
+      if (!cache_string (c, l->filename, &file)
+	  || !cache_string (c, l->functionname, &function))
+	return false;
+      add_location (res, file, function, l->line, l->discriminator);
+    }
+  return true;
+}
+
+/* Remember the locations in RES for VMA, for writing to cache C.  An
+   address without a line number is not remembered, so that it is
+   looked up again should the file's debug info turn up.  */
+
+static void
+add_to_cache (struct addr_cache *c, bfd_vma vma, const struct result *res)
+{
+  struct new_entry *e;
+  size_t i;
+
+  for (i = 0; i < res->nlocs; i++)
+    if (res->locs[i].line != 0)
+      break;
+  if (i == res->nlocs)
+    return;
+
+  if (c->new_entry_count == c->new_entry_alloc)
+    {
+      c->new_entry_alloc = c->new_entry_alloc ? c->new_entry_alloc * 2 : 64;
+      c->new_entries = xrealloc (c->new_entries,
+				 c->new_entry_alloc * sizeof (*c->new_entries));
+    }
+  e = &c->new_entries[c->new_entry_count++];
+  e->addr = vma;
+  e->loc = c->new_loc_count;
+  e->nlocs = res->nlocs;
+
+  for (i = 0; i < res->nlocs; i++)
+    {
+      struct location *l;
+
+      if (c->new_loc_count == c->new_loc_alloc)
+	{
+	  c->new_loc_alloc = c->new_loc_alloc ? c->new_loc_alloc * 2 : 64;
+	  c->new_locs = xrealloc (c->new_locs,
+				  c->new_loc_alloc * sizeof (*c->new_locs));
+	}
+      l = &c->new_locs[c->new_loc_count++];
+      *l = res->locs[i];
+      if (l->filename != NULL)
+	l->filename = keep_string (&c->strtab, l->filename)->str;
+      if (l->functionname != NULL)
+	l->functionname = keep_string (&c->strtab, l->functionname)->str;
+    }
+}
+
+/* Compare new cache entries by address, for qsort.  */
+
+static int
+compare_new_entries (const void *a, const void *b)
+{
+  const struct new_entry *e1 = (const struct new_entry *) a;
+  const struct new_entry *e2 = (const struct new_entry *) b;
+
+  if (e1->addr != e2->addr)
+    return e1->addr < e2->addr ? -1 : 1;
+  return e1->loc < e2->loc ? -1 : e1->loc > e2->loc;
+}
+
+/* The cache being written.  */
+
+static struct cache_entry *out_entries;
+static size_t out_entry_count;
+static struct cache_loc *out_locs;
+static size_t out_loc_count;
+static size_t out_loc_alloc;
+static char *out_strings;
+static size_t out_strsize;
+static size_t out_str_alloc;
+
+/* Return the string table offset for STR in the cache C being
+   written.  */
+
+static uint32_t
+out_string (struct addr_cache *c, const char *str)
+{
+  struct kept_string *ks;
+  size_t len;
+
+  if (str == NULL)
+    return CACHE_NO_STRING;
+
+  ks = keep_string (&c->strtab, str);
+  if (ks->offset != CACHE_NO_STRING)
+    return ks->offset;
+
+  len = strlen (str) + 1;
+  if (out_strsize + len > out_str_alloc)
+    {
+      out_str_alloc = (out_strsize + len) * 2;
+      out_strings = xrealloc (out_strings, out_str_alloc);
+    }
+  memcpy (out_strings + out_strsize, str, len);
+  ks->offset = out_strsize;
+  out_strsize += len;
+  return ks->offset;
+}
+
+/* Append an entry for VMA with N locations from L to the cache C being
+   written.  */
+
+static void
+out_entry (struct addr_cache *c, bfd_vma vma, const struct location *l,
+	   size_t n)
+{
+  struct cache_entry *e = &out_entries[out_entry_count++];
+  size_t i;
+
+  e->addr = vma;
+  e->loc = out_loc_count;
+  e->nlocs = n;
+  if (out_loc_count + n > out_loc_alloc)
+    {
+      out_loc_alloc = (out_loc_count + n) * 2;
+      out_locs = xrealloc (out_locs, out_loc_alloc * sizeof (*out_locs));
+    }
+  for (i = 0; i < n; i++)
+    {
+      struct cache_loc *cl = &out_locs[out_loc_count++];
+
+      cl->filename = out_string (c, l[i].filename);
+      cl->functionname = out_string (c, l[i].functionname);
+      cl->line = l[i].line;
+      cl->discriminator = l[i].discriminator;
+    }
+}
+
+/* Write cache C, merging the entries read from it with those added
+   this run.  The new cache replaces the old one by renaming, so that
+   readers never see a partial file.  */
+
+static void
+write_cache (struct addr_cache *c)
+{
+  struct cache_header hdr;
+  struct result res = { NULL, 0, 0 };
+  char *tmpname;
+  size_t i, j;
+  FILE *f;
+  int fd;
+  bool ok;
+
+  if (c->new_entry_count == 0)
+    return;
+
+  qsort (c->new_entries, c->new_entry_count, sizeof (*c->new_entries),
+	 compare_new_entries);
+  out_entries = xmalloc ((c->hdr.nentries + c->new_entry_count)
+			 * sizeof (*out_entries));
+
+  i = 0;
+  j = 0;
+  while (i < c->hdr.nentries || j < c->new_entry_count)
+    {
+      if (j == c->new_entry_count
+	  || (i < c->hdr.nentries
+	      && c->entries[i].addr <= c->new_entries[j].addr))
+	{
+	  const struct cache_entry *e = &c->entries[i++];
+
+	  if (j < c->new_entry_count && e->addr == c->new_entries[j].addr)
+	    continue;
+	  if (lookup_cache (c, e->addr, &res))
+	    out_entry (c, e->addr, res.locs, res.nlocs);
+	}
+      else
+	{
+	  const struct new_entry *e = &c->new_entries[j++];
+
+	  /* The same address may have been looked up more than once.  */
+	  if (j < c->new_entry_count && e->addr == c->new_entries[j].addr)
+	    continue;
+	  out_entry (c, e->addr, c->new_locs + e->loc, e->nlocs);
+	}
+    }
+  free (res.locs);
+
+  if (out_entry_count < CACHE_NO_STRING
+      && out_loc_count < CACHE_NO_STRING
+      && out_strsize < CACHE_NO_STRING)
+    {
+      tmpname = make_tempname (c->file, &fd);
+      if (tmpname == NULL)
+	non_fatal (_("cannot create cache file in %s: %s"),
+		   cache_dir, strerror (errno));
+      else
+	{
+	  memset (&hdr, 0, sizeof (hdr));
+	  hdr.magic = CACHE_MAGIC;
+	  hdr.version = CACHE_VERSION;
+	  hdr.nentries = out_entry_count;
+	  hdr.nlocs = out_loc_count;
+	  hdr.strsize = out_strsize;
+
+	  f = fdopen (fd, FOPEN_WB);
+	  ok = (f != NULL
+		&& fwrite (&hdr, sizeof (hdr), 1, f) == 1
+		&& fwrite (out_entries, sizeof (*out_entries),
+			   out_entry_count, f) == out_entry_count
+		&& fwrite (out_locs, sizeof (*out_locs),
+			   out_loc_count, f) == out_loc_count
+		&& fwrite (out_strings, 1, out_strsize, f) == out_strsize);
+	  if (f != NULL)
+	    ok &= fclose (f) == 0;
+	  else
+	    close (fd);
+
+	  if (!ok || rename (tmpname, c->file) != 0)
+	    {
+	      non_fatal (_("cannot write %s: %s"), c->file, strerror (errno));
+	      unlink (tmpname);
+	    }
+	  free (tmpname);
+	}
+    }
+
+  free (out_entries);
+  out_entries = NULL;
+  out_entry_count = 0;
+  free (out_locs);
+  out_locs = NULL;
+  out_loc_count = out_loc_alloc = 0;
+  free (out_strings);
+  out_strings = NULL;
+  out_strsize = out_str_alloc = 0;
+}
+
+/* Release cache C.  */
+
+static void
+close_cache (struct addr_cache *c)
+{
+  if (c->map != NULL)
+    {
+#ifdef HAVE_MMAP
+      if (c->mapped)
+	munmap (c->map, c->size);
+      else
+#endif
+	free (c->map);
+    }
+  free (c->file);
+  free (c->new_entries);
+  free (c->new_locs);
+  if (c->strtab != NULL)
+    htab_delete (c->strtab);
+  free (c);
+}
+
+/* Open FILE_NAME as an object file to look up addresses in, reporting
+   any problem.  */
+
+static bfd *
+open_bfd (const char *file_name, asection **section)
+{
+  bfd *abfd;
+  char **matching;
+
+  *section = NULL;
+  if (get_file_size (file_name) < 1)
+    return NULL;
+
+  abfd = bfd_openr (file_name, target);
+  if (abfd == NULL)
+    {
+      bfd_nonfatal (file_name);
+      return NULL;
+    }
+
+  /* Decompress sections.  */
+  abfd->flags |= BFD_DECOMPRESS;
+
+  if (bfd_check_format (abfd, bfd_archive))
+    {
+      non_fatal (_("%s: cannot get addresses from archive"), file_name);
+      bfd_close (abfd);
+      return NULL;
+    }
+
+  if (! bfd_check_format_matches (abfd, bfd_object, &matching))
+    {
+      bfd_nonfatal (bfd_get_filename (abfd));
+      if (bfd_get_error () == bfd_error_file_ambiguously_recognized)
+	list_matching_formats (matching);
+      bfd_close (abfd);
+      return NULL;
+    }
+
+  if (section_name != NULL)
+    {
+      *section = bfd_get_section_by_name (abfd, section_name);
+      if (*section == NULL)
+	{
+	  non_fatal (_("%s: cannot find section %s"), file_name,
+		     section_name);
+	  bfd_close (abfd);
+	  return NULL;
+	}
+    }
+
+  return abfd;
+}
+
+/* Return the input file named FILE_NAME, opening it if need be.  */
+
+static struct input_file *
+get_input_file (const char *file_name)
+{
+  struct input_file *file;
+
+  for (file = input_files; file != NULL; file = file->next)
+    if (strcmp (file->name, file_name) == 0)
+      return file;
+
+  file = xcalloc (1, sizeof (*file));
+  file->name = xstrdup (file_name);
+  file->index = input_file_count++;
+  file->abfd = open_bfd (file_name, &file->section);
+  if (file->abfd != NULL && cache_dir != NULL && file->section == NULL)
+    open_cache (file);
+  file->next = input_files;
+  input_files = file;
+  return file;
+}
+
+/* Finish with all the input files, writing their caches.  */
+
+static void
+close_input_files (void)
+{
+  struct input_file *file;
+
+  while ((file = input_files) != NULL)
+    {
+      input_files = file->next;
+      if (file->cache != NULL)
+	{
+	  write_cache (file->cache);
+	  close_cache (file->cache);
+	}
+      free (file->syms);
+      if (file->abfd != NULL)
+	bfd_close (file->abfd);
+      free ((char *) file->name);
+      free (file);
+    }
 }
 
 /* Lookup a symbol with offset in symbol table.  */
 
 static bfd_vma
-lookup_symbol (bfd *abfd, char *sym, size_t offset)
+lookup_symbol (struct input_file *file, char *sym, size_t offset)
 {
+  asymbol **syms = file->syms;
+  long symcount = file->symcount;
   long i;
 
   for (i = 0; i < symcount; i++)
@@ -239,7 +982,7 @@ lookup_symbol (bfd *abfd, char *sym, size_t offset)
   /* Try again mangled */
   for (i = 0; i < symcount; i++)
     {
-      char *d = bfd_demangle (abfd, syms[i]->name, demangle_flags);
+      char *d = bfd_demangle (file->abfd, syms[i]->name, demangle_flags);
       bool match = d && !strcmp (d, sym);
       free (d);
 
@@ -280,221 +1023,640 @@ is_symbol (char *adr, char **symp, size_t *offset)
   return true;
 }
 
-/* Read hexadecimal or symbolic with offset addresses from stdin, translate into
-   file_name:line_number and optionally function name.  */
+/* Return the address given by ADR, a hexadecimal address or
+   symbol+offset, in FILE.  */
 
-static void
-translate_addresses (bfd *abfd, asection *section)
+static bfd_vma
+parse_address (struct input_file *file, char *adr)
 {
-  int read_stdin = (naddr == 0);
-  char *adr;
-  char addr_hex[100];
+  bfd *abfd = file->abfd;
   char *symp;
   size_t offset;
+  bfd_vma pc;
 
-  for (;;)
+  if (is_symbol (adr, &symp, &offset))
     {
-      if (read_stdin)
+      if (abfd == NULL)
+	return 0;
+      read_symtab (file);
+      pc = lookup_symbol (file, symp, offset);
+    }
+  else
+    pc = bfd_scan_vma (adr, NULL, 16);
+  if (abfd != NULL && bfd_get_flavour (abfd) == bfd_target_elf_flavour)
+    {
+      const struct elf_backend_data *bed = get_elf_backend_data (abfd);
+      bfd_vma sign = (bfd_vma) 1 << (bed->s->arch_size - 1);
+
+      pc &= (sign << 1) - 1;
+      if (bed->sign_extend_vma)
+	pc = (pc ^ sign) - sign;
+    }
+  return pc;
+}
+
+/* If LINE asks to switch to another file, as "-e FILE" or
+   "--exe=FILE", return the file name.  */
+
+static char *
+exe_line (char *line)
+{
+  char *p = line;
+  char *end;
+
+  while (ISSPACE (*p))
+    p++;
+  if (p[0] == '-' && p[1] == 'e' && ISSPACE (p[2]))
+    p += 2;
+  else if (startswith (p, "--exe="))
+    p += 6;
+  else
+    return NULL;
+
+  while (ISSPACE (*p))
+    p++;
+  end = p + strlen (p);
+  while (end > p && ISSPACE (end[-1]))
+    end--;
+  *end = '\0';
+  return *p != '\0' ? p : NULL;
+}
+
+/* Read a line of any length from stdin into *BUF, of size *SIZE.
+   Return FALSE at end of file.  */
+
+static bool
+read_line (char **buf, size_t *size)
+{
+  size_t len = 0;
+
+  if (*buf == NULL)
+    {
+      *size = 128;
+      *buf = xmalloc (*size);
+    }
+
+  while (fgets (*buf + len, *size - len, stdin) != NULL)
+    {
+      len += strlen (*buf + len);
+      if (len != 0 && (*buf)[len - 1] == '\n')
+	return true;
+      if (len + 1 < *size)
+	return true;
+      *size *= 2;
+      *buf = xrealloc (*buf, *size);
+    }
+  return len != 0;
+}
+
+/* Print RES, the locations found for PC in FILE.  */
+
+static void
+print_result (struct input_file *file, bfd_vma pc, const struct result *res)
+{
+  bfd *abfd = file->abfd;
+  size_t i;
+
+  if (with_addresses)
+    {
+      printf ("0x");
+      if (abfd != NULL)
+	bfd_printf_vma (abfd, pc);
+      else
+	printf ("%" PRIx64, (uint64_t) pc);
+
+      if (pretty_print)
+	printf (": ");
+      else
+	printf ("\n");
+    }
+
+  if (res->nlocs == 0)
+    {
+      if (with_functions)
 	{
-	  if (fgets (addr_hex, sizeof addr_hex, stdin) == NULL)
-	    break;
-	  adr = addr_hex;
+	  if (pretty_print)
+	    printf ("?? ");
+	  else
+	    printf ("??\n");
 	}
-      else
+      printf ("??:0\n");
+      return;
+    }
+
+  for (i = 0; i < res->nlocs; i++)
+    {
+      const struct location *loc = &res->locs[i];
+      const char *filename = loc->filename;
+
+      if (i != 0)
 	{
-	  if (naddr <= 0)
+	  if (!unwind_inlines)
 	    break;
-	  --naddr;
-	  adr = *addr++;
+	  if (pretty_print)
+	    /* Note for translators: This printf is used to join the
+	       line number/file name pair that has just been printed with
+	       the line number/file name pair that is going to be printed
+	       by the next iteration of the loop.  Eg:
+
+		 123:bar.c (inlined by) 456:main.c  */
+	    printf (_(" (inlined by) "));
 	}
 
-      if (is_symbol (adr, &symp, &offset))
-        pc = lookup_symbol (abfd, symp, offset);
-      else
-        pc = bfd_scan_vma (adr, NULL, 16);
-      if (bfd_get_flavour (abfd) == bfd_target_elf_flavour)
+      if (with_functions)
 	{
-	  const struct elf_backend_data *bed = get_elf_backend_data (abfd);
-	  bfd_vma sign = (bfd_vma) 1 << (bed->s->arch_size - 1);
+	  const char *name;
+	  char *alloc = NULL;
+
+	  name = loc->functionname;
+	  if (name == NULL || *name == '\0')
+	    name = "??";
+	  else if (do_demangle)
+	    {
+	      alloc = bfd_demangle (abfd, name, demangle_flags);
+	      if (alloc != NULL)
+		name = alloc;
+	    }
+
+	  printf ("%s", name);
+	  if (pretty_print)
+	    /* Note for translators:  This printf is used to join the
+	       function name just printed above to the line number/
+	       file name pair that is about to be printed below.  Eg:
 
-	  pc &= (sign << 1) - 1;
-	  if (bed->sign_extend_vma)
-	    pc = (pc ^ sign) - sign;
+		 foo at 123:bar.c  */
+	    printf (_(" at "));
+	  else
+	    printf ("\n");
+
+	  free (alloc);
 	}
 
-      if (with_addresses)
-        {
-          printf ("0x");
-          bfd_printf_vma (abfd, pc);
+      if (base_names && filename != NULL)
+	{
+	  const char *h;
 
-          if (pretty_print)
-            printf (": ");
-          else
-            printf ("\n");
-        }
+	  h = strrchr (filename, '/');
+	  if (h != NULL)
+	    filename = h + 1;
+	}
 
-      found = false;
-      if (section)
-	find_offset_in_section (abfd, section);
+      printf ("%s:", filename ? filename : "??");
+      if (loc->line != 0)
+	{
+	  if (loc->discriminator != 0)
+	    printf ("%u (discriminator %u)\n", loc->line, loc->discriminator);
+	  else
+	    printf ("%u\n", loc->line);
+	}
       else
-	bfd_map_over_sections (abfd, find_address_in_section, NULL);
+	printf ("?\n");
+    }
+}
+
+/* Look up PC in FILE, from its cache if it has one, setting RES.  */
 
-      if (! found)
+static void
+translate_address (struct input_file *file, bfd_vma pc, struct result *res)
+{
+  struct lookup l;
+
+  if (file->cache != NULL && lookup_cache (file->cache, pc, res))
+    return;
+
+  l.file = file;
+  l.pc = pc;
+  find_locations (&l, res, file->cache != NULL);
+  if (file->cache != NULL)
+    add_to_cache (file->cache, pc, res);
+}
+
+/* Read hexadecimal or symbolic with offset addresses from stdin, translate into
+   file_name:line_number and optionally function name.  Lines of the form
+   "-e FILE" switch to looking up addresses in FILE.  */
+
+static void
+translate_addresses (struct input_file *file)
+{
+  int read_stdin = (naddr == 0);
+  struct result res = { NULL, 0, 0 };
+  char *line = NULL;
+  size_t line_size = 0;
+  char *adr;
+  bfd_vma pc;
+
+  for (;;)
+    {
+      if (read_stdin)
 	{
-	  if (with_functions)
+	  char *name;
+
+	  if (!read_line (&line, &line_size))
+	    break;
+	  adr = line;
+	  name = exe_line (adr);
+	  if (name != NULL)
 	    {
-	      if (pretty_print)
-		printf ("?? ");
-	      else
-		printf ("??\n");
+	      file = get_input_file (name);
+	      continue;
 	    }
-	  printf ("??:0\n");
 	}
       else
 	{
-	  while (1)
-            {
-              if (with_functions)
-                {
-                  const char *name;
-                  char *alloc = NULL;
-
-                  name = functionname;
-                  if (name == NULL || *name == '\0')
-                    name = "??";
-                  else if (do_demangle)
-                    {
-                      alloc = bfd_demangle (abfd, name, demangle_flags);
-                      if (alloc != NULL)
-                        name = alloc;
-                    }
-
-                  printf ("%s", name);
-                  if (pretty_print)
-		    /* Note for translators:  This printf is used to join the
-		       function name just printed above to the line number/
-		       file name pair that is about to be printed below.  Eg:
-
-		         foo at 123:bar.c  */
-                    printf (_(" at "));
-                  else
-                    printf ("\n");
-
-		  free (alloc);
-                }
-
-              if (base_names && filename != NULL)
-                {
-                  char *h;
-
-                  h = strrchr (filename, '/');
-                  if (h != NULL)
-                    filename = h + 1;
-                }
-
-              printf ("%s:", filename ? filename : "??");
-	      if (line != 0)
-                {
-                  if (discriminator != 0)
-                    printf ("%u (discriminator %u)\n", line, discriminator);
-                  else
-                    printf ("%u\n", line);
-                }
-	      else
-		printf ("?\n");
-              if (!unwind_inlines)
-                found = false;
-              else
-                found = bfd_find_inliner_info (abfd, &filename, &functionname,
-					       &line);
-              if (! found)
-                break;
-              if (pretty_print)
-		/* Note for translators: This printf is used to join the
-		   line number/file name pair that has just been printed with
-		   the line number/file name pair that is going to be printed
-		   by the next iteration of the while loop.  Eg:
-
-		     123:bar.c (inlined by) 456:main.c  */
-                printf (_(" (inlined by) "));
-            }
+	  if (naddr <= 0)
+	    break;
+	  --naddr;
+	  adr = *addr++;
 	}
 
+      pc = parse_address (file, adr);
+      translate_address (file, pc, &res);
+      print_result (file, pc, &res);
+
       /* fflush() is essential for using this command as a server
          child process that reads addresses from a pipe and responds
          with line number information, processing one address at a
          time.  */
       fflush (stdout);
     }
+
+  free (line);
+  free (res.locs);
 }
 
-/* Process a file.  Returns an exit value for main().  */
+/* With --batch, all the addresses are read before any is looked up.
+   Those not in a cache are sorted by file and address, and each file's
+   are split into runs of neighbouring addresses, at most one for each
+   thread.  Worker threads take the runs in turn.  A BFD may only be
+   used by one thread at a time, so each worker opens its own BFD for a
+   file, and reads the debug info it needs from it.  Since the runs are
+   of neighbouring addresses, that is mostly the compilation units
+   covering its run.  The results are printed in the order the
+   addresses were given, after which the workers' BFDs, which hold the
+   names found, are closed.  */
+
+/* The fewest addresses worth a BFD of their own.  */
+#define BATCH_MIN_RUN 256
+
+struct batch_addr
+{
+  struct input_file *file;
+  bfd_vma pc;
+  bool done;			/* Whether RESULT is set.  */
+  struct result result;
+};
 
-static int
-process_file (const char *file_name, const char *section_name,
-	      const char *target)
+struct batch_run
 {
-  bfd *abfd;
-  asection *section;
-  char **matching;
+  struct input_file *file;
+  size_t *order;		/* Indices in BATCH_ADDRS.  */
+  size_t count;
+};
 
-  if (get_file_size (file_name) < 1)
-    return 1;
+struct batch_worker
+{
+  /* Whether to use the input files themselves.  */
+  bool use_input_files;
 
-  abfd = bfd_openr (file_name, target);
-  if (abfd == NULL)
-    bfd_fatal (file_name);
+  /* Otherwise, this worker's own opens of them.  */
+  struct input_file *files;
+};
 
-  /* Decompress sections.  */
-  abfd->flags |= BFD_DECOMPRESS;
+static struct batch_addr *batch_addrs;
+static struct batch_run *batch_runs;
+static size_t batch_run_count;
+static size_t next_batch_run;
 
-  if (bfd_check_format (abfd, bfd_archive))
+#ifdef ENABLE_THREADS
+static pthread_mutex_t batch_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t bfd_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static bool
+lock_bfd (void *data)
+{
+  return pthread_mutex_lock ((pthread_mutex_t *) data) == 0;
+}
+
+static bool
+unlock_bfd (void *data)
+{
+  return pthread_mutex_unlock ((pthread_mutex_t *) data) == 0;
+}
+#endif
+
+/* Take the next run of addresses to look up, or return NULL.  */
+
+static struct batch_run *
+next_run (void)
+{
+  struct batch_run *run = NULL;
+
+#ifdef ENABLE_THREADS
+  pthread_mutex_lock (&batch_lock);
+#endif
+  if (next_batch_run < batch_run_count)
+    run = &batch_runs[next_batch_run++];
+#ifdef ENABLE_THREADS
+  pthread_mutex_unlock (&batch_lock);
+#endif
+  return run;
+}
+
+/* Return worker W's copy of input file FILE.  */
+
+static struct input_file *
+worker_file (struct batch_worker *w, struct input_file *file)
+{
+  struct input_file *wf;
+
+  if (w->use_input_files)
+    return file;
+
+  for (wf = w->files; wf != NULL; wf = wf->next)
+    if (wf->index == file->index)
+      return wf;
+
+  wf = xcalloc (1, sizeof (*wf));
+  wf->name = file->name;
+  wf->index = file->index;
+  wf->abfd = open_bfd (file->name, &wf->section);
+  wf->next = w->files;
+  w->files = wf;
+  return wf;
+}
+
+/* Close worker W's copies of the input files.  */
+
+static void
+close_worker_files (struct batch_worker *w)
+{
+  struct input_file *wf;
+
+  while ((wf = w->files) != NULL)
     {
-      non_fatal (_("%s: cannot get addresses from archive"), file_name);
-      bfd_close (abfd);
-      return 1;
+      w->files = wf->next;
+      free (wf->syms);
+      if (wf->abfd != NULL)
+	bfd_close (wf->abfd);
+      free (wf);
     }
+}
 
-  if (! bfd_check_format_matches (abfd, bfd_object, &matching))
+/* Look up addresses for worker W until there are none left.  */
+
+static void
+run_batch (struct batch_worker *w)
+{
+  struct batch_run *run;
+
+  while ((run = next_run ()) != NULL)
     {
-      bfd_nonfatal (bfd_get_filename (abfd));
-      if (bfd_get_error () == bfd_error_file_ambiguously_recognized)
-	list_matching_formats (matching);
-      bfd_close (abfd);
-      return 1;
+      struct input_file *wf = worker_file (w, run->file);
+      size_t i;
+
+      for (i = 0; i < run->count; i++)
+	{
+	  struct batch_addr *ba = &batch_addrs[run->order[i]];
+	  struct lookup l;
+
+	  l.file = wf;
+	  l.pc = ba->pc;
+	  find_locations (&l, &ba->result, run->file->cache != NULL);
+	}
     }
+}
 
-  if (section_name != NULL)
+#ifdef ENABLE_THREADS
+static void *
+batch_thread (void *data)
+{
+  run_batch ((struct batch_worker *) data);
+  bfd_thread_cleanup ();
+  return NULL;
+}
+#endif
+
+/* Compare the addresses at two indices in BATCH_ADDRS by file and
+   address, for qsort.  */
+
+static int
+compare_batch_addrs (const void *a, const void *b)
+{
+  const struct batch_addr *a1 = &batch_addrs[*(const size_t *) a];
+  const struct batch_addr *a2 = &batch_addrs[*(const size_t *) b];
+
+  if (a1->file->index != a2->file->index)
+    return a1->file->index < a2->file->index ? -1 : 1;
+  if (a1->pc != a2->pc)
+    return a1->pc < a2->pc ? -1 : 1;
+  return *(const size_t *) a < *(const size_t *) b ? -1 : 1;
+}
+
+/* Return the number of threads to use for --batch.  */
+
+static unsigned int
+batch_threads (void)
+{
+  unsigned int n = thread_count;
+
+#if defined (HAVE_SYSCONF) && defined (_SC_NPROCESSORS_ONLN)
+  if (n == 0)
+    {
+      long cpus = sysconf (_SC_NPROCESSORS_ONLN);
+
+      if (cpus > 0)
+	n = cpus;
+    }
+#endif
+  return n != 0 ? n : 1;
+}
+
+/* Read all the addresses, from stdin or the command line, then look
+   them up and print the results in order.  */
+
+static void
+translate_batch (struct input_file *file)
+{
+  struct batch_worker *workers;
+  struct batch_addr *ba;
+  size_t count = 0;
+  size_t alloc = 0;
+  size_t *order;
+  size_t norder;
+  size_t i, j;
+  unsigned int nthreads, nworkers, w;
+  char *line = NULL;
+  size_t line_size = 0;
+
+  for (;;)
     {
-      section = bfd_get_section_by_name (abfd, section_name);
-      if (section == NULL)
+      char *adr;
+
+      if (naddr == 0)
 	{
-	  non_fatal (_("%s: cannot find section %s"), file_name, section_name);
-	  bfd_close (abfd);
-	  return 1;
+	  char *name;
+
+	  if (!read_line (&line, &line_size))
+	    break;
+	  adr = line;
+	  name = exe_line (adr);
+	  if (name != NULL)
+	    {
+	      file = get_input_file (name);
+	      continue;
+	    }
+	}
+      else if (naddr < 0)
+	break;
+      else
+	{
+	  adr = *addr++;
+	  if (--naddr == 0)
+	    naddr = -1;
+	}
+
+      if (count == alloc)
+	{
+	  alloc = alloc ? alloc * 2 : 1024;
+	  batch_addrs = xrealloc (batch_addrs, alloc * sizeof (*batch_addrs));
 	}
+      ba = &batch_addrs[count++];
+      memset (ba, 0, sizeof (*ba));
+      ba->file = file;
+      ba->pc = parse_address (file, adr);
+      if (file->abfd == NULL
+	  || (file->cache != NULL
+	      && lookup_cache (file->cache, ba->pc, &ba->result)))
+	ba->done = true;
     }
-  else
-    section = NULL;
+  free (line);
+
+  /* Split the rest into runs.  */
+  order = xmalloc ((count ? count : 1) * sizeof (*order));
+  norder = 0;
+  for (i = 0; i < count; i++)
+    if (!batch_addrs[i].done)
+      order[norder++] = i;
+  qsort (order, norder, sizeof (*order), compare_batch_addrs);
+
+  nthreads = batch_threads ();
+  batch_runs = xmalloc ((norder ? norder : 1) * sizeof (*batch_runs));
+  batch_run_count = 0;
+  next_batch_run = 0;
+  for (i = 0; i < norder; i = j)
+    {
+      struct input_file *f = batch_addrs[order[i]].file;
+      size_t n, nruns, k;
+
+      for (j = i; j < norder && batch_addrs[order[j]].file == f; j++)
+	;
+      n = j - i;
+      nruns = (n + BATCH_MIN_RUN - 1) / BATCH_MIN_RUN;
+      if (nruns > nthreads)
+	nruns = nthreads;
+      for (k = 0; k < nruns; k++)
+	{
+	  struct batch_run *run = &batch_runs[batch_run_count++];
+	  size_t start = n * k / nruns;
 
-  slurp_symtab (abfd);
+	  run->file = f;
+	  run->order = order + i + start;
+	  run->count = n * (k + 1) / nruns - start;
+	}
+    }
 
-  translate_addresses (abfd, section);
+  /* This thread looks up addresses too, using the input files.  */
+  nworkers = batch_run_count < nthreads ? batch_run_count : nthreads;
+  if (nworkers == 0)
+    nworkers = 1;
+#ifdef ENABLE_THREADS
+  {
+    static bool bfd_threads;
+
+    if (nworkers > 1
+	&& !bfd_threads
+	&& !bfd_thread_init (lock_bfd, unlock_bfd, &bfd_mutex))
+      nworkers = 1;
+    if (nworkers > 1)
+      bfd_threads = true;
+  }
+#else
+  nworkers = 1;
+#endif
+  workers = xcalloc (nworkers, sizeof (*workers));
+  workers[0].use_input_files = true;
 
-  free (syms);
-  syms = NULL;
+#ifdef ENABLE_THREADS
+  {
+    pthread_t *threads = xmalloc (nworkers * sizeof (*threads));
+    unsigned int started = 1;
 
-  bfd_close (abfd);
+    for (w = 1; w < nworkers; w++)
+      if (pthread_create (&threads[w], NULL, batch_thread, &workers[w]) == 0)
+	started++;
+      else
+	break;
+    run_batch (&workers[0]);
+    for (w = 1; w < started; w++)
+      pthread_join (threads[w], NULL);
+    free (threads);
+  }
+#else
+  run_batch (&workers[0]);
+#endif
 
-  return 0;
+  for (i = 0; i < count; i++)
+    {
+      ba = &batch_addrs[i];
+      if (!ba->done && ba->file->cache != NULL)
+	add_to_cache (ba->file->cache, ba->pc, &ba->result);
+      print_result (ba->file, ba->pc, &ba->result);
+      free (ba->result.locs);
+    }
+  fflush (stdout);
+
+  for (w = 1; w < nworkers; w++)
+    close_worker_files (&workers[w]);
+  free (workers);
+  free (batch_runs);
+  batch_runs = NULL;
+  free (order);
+  free (batch_addrs);
+  batch_addrs = NULL;
 }
-
+
+/* Process a file.  Returns an exit value for main().  */
+
+static int
+process_file (const char *file_name)
+{
+  struct input_file *file;
+  int status = 0;
+
+  file = get_input_file (file_name);
+  if (file->abfd == NULL)
+    status = 1;
+  else
+    {
+      if (batch)
+	translate_batch (file);
+      else
+	translate_addresses (file);
+
+      for (file = input_files; file != NULL; file = file->next)
+	if (file->abfd == NULL)
+	  status = 1;
+    }
+
+  close_input_files ();
+
+  return status;
+}
+
 int
 main (int argc, char **argv)
 {
   const char *file_name;
-  const char *section_name;
-  char *target;
   int c;
 
 #ifdef HAVE_LC_MESSAGES
@@ -576,6 +1738,23 @@ main (int argc, char **argv)
 	case 'j':
 	  section_name = optarg;
 	  break;
+	case OPTION_CACHE_DIR:
+	  cache_dir = optarg;
+	  break;
+	case OPTION_BATCH:
+	  batch = true;
+	  break;
+	case OPTION_THREAD_COUNT:
+	  {
+	    char *end;
+	    unsigned long count = strtoul (optarg, &end, 0);
+
+	    if (*optarg == '\0' || *end != '\0' || count == 0
+		|| count > 1024)
+	      fatal (_("invalid thread count `%s'"), optarg);
+	    thread_count = count;
+	  }
+	  break;
 	default:
 	  usage (stderr, 1);
 	  break;
@@ -588,5 +1767,5 @@ main (int argc, char **argv)
   addr = argv + optind;
   naddr = argc - optind;
 
-  return process_file (file_name, section_name, target);
+  return process_file (file_name);
 }
@@ -0,0 +1,224 @@
+/* A program to test using BFD from several threads.
+   Copyright (C) 2023 Free Software Foundation, Inc.
+
+   This file is part of the GNU Binutils.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+   MA 02110-1301, USA.  */
+
+/* Each thread opens and reads every file given on the command line a
+   few times, keeping the BFDs open.  Once all the threads are done,
+   every section must have a different id.  Each thread also checks
+   that the BFD error set by the others does not change its own.  */
+
+#include "sysdep.h"
+#include "bfd.h"
+
+#ifdef ENABLE_THREADS
+#include <pthread.h>
+
+#define NTHREADS 8
+#define ROUNDS 4
+
+static pthread_mutex_t bfd_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_barrier_t barrier;
+
+static const char **files;
+static int nfiles;
+
+/* A different error for each thread to set.  */
+
+static const bfd_error_type thread_errors[NTHREADS] =
+{
+  bfd_error_system_call,
+  bfd_error_invalid_target,
+  bfd_error_wrong_format,
+  bfd_error_invalid_operation,
+  bfd_error_no_memory,
+  bfd_error_no_symbols,
+  bfd_error_no_armap,
+  bfd_error_bad_value
+};
+
+struct thread_data
+{
+  pthread_t thread;
+  unsigned int index;
+  bfd **bfds;
+  const char *failure;
+};
+
+static bool
+lock_bfd (void *data)
+{
+  return pthread_mutex_lock ((pthread_mutex_t *) data) == 0;
+}
+
+static bool
+unlock_bfd (void *data)
+{
+  return pthread_mutex_unlock ((pthread_mutex_t *) data) == 0;
+}
+
+static void *
+thread_main (void *arg)
+{
+  struct thread_data *t = (struct thread_data *) arg;
+  bfd_error_type error = thread_errors[t->index];
+  unsigned int i;
+
+  bfd_set_error (error);
+  pthread_barrier_wait (&barrier);
+  if (bfd_get_error () != error)
+    t->failure = "error changed by another thread";
+
+  for (i = 0; t->failure == NULL && i < ROUNDS * (unsigned int) nfiles; i++)
+    {
+      bfd *abfd;
+      asection *sec;
+
+      abfd = bfd_openr (files[i % nfiles], NULL);
+      if (abfd == NULL)
+	{
+	  t->failure = "error opening file";
+	  break;
+	}
+      t->bfds[i] = abfd;
+      if (!bfd_check_format (abfd, bfd_object))
+	{
+	  t->failure = "not an object";
+	  break;
+	}
+      for (sec = abfd->sections; sec != NULL; sec = sec->next)
+	if ((sec->flags & SEC_HAS_CONTENTS) != 0)
+	  {
+	    bfd_byte *contents;
+
+	    if (!bfd_malloc_and_get_section (abfd, sec, &contents))
+	      {
+		t->failure = "error reading section";
+		break;
+	      }
+	    free (contents);
+	  }
+    }
+
+  bfd_thread_cleanup ();
+  return NULL;
+}
+
+static int
+compare_ids (const void *a, const void *b)
+{
+  unsigned int id1 = *(const unsigned int *) a;
+  unsigned int id2 = *(const unsigned int *) b;
+
+  return id1 < id2 ? -1 : id1 > id2;
+}
+#endif
+
+static void
+die (const char *s)
+{
+  printf ("oops: %s\n", s);
+  exit (1);
+}
+
+int
+main (int argc, const char **argv)
+{
+#ifdef ENABLE_THREADS
+  struct thread_data *threads;
+  unsigned int *ids;
+  size_t nids, i;
+  unsigned int t;
+  int n;
+
+  if (argc < 2)
+    die ("Usage: test objectfile...");
+
+  files = argv + 1;
+  nfiles = argc - 1;
+  threads = calloc (NTHREADS, sizeof (*threads));
+  if (threads == NULL)
+    die ("out of memory");
+  for (t = 0; t < NTHREADS; t++)
+    {
+      threads[t].bfds = calloc (ROUNDS * nfiles, sizeof (bfd *));
+      if (threads[t].bfds == NULL)
+	die ("out of memory");
+    }
+
+  if (bfd_init () != BFD_INIT_MAGIC)
+    die ("BFD version mismatch");
+  if (!bfd_thread_init (lock_bfd, unlock_bfd, &bfd_mutex))
+    {
+      printf ("no threads\n");
+      return 0;
+    }
+  if (pthread_barrier_init (&barrier, NULL, NTHREADS) != 0)
+    die ("pthread_barrier_init failed");
+
+  for (t = 0; t < NTHREADS; t++)
+    {
+      threads[t].index = t;
+      if (pthread_create (&threads[t].thread, NULL, thread_main,
+			  &threads[t]) != 0)
+	die ("pthread_create failed");
+    }
+  for (t = 0; t < NTHREADS; t++)
+    pthread_join (threads[t].thread, NULL);
+  for (t = 0; t < NTHREADS; t++)
+    if (threads[t].failure != NULL)
+      die (threads[t].failure);
+
+  nids = 0;
+  for (t = 0; t < NTHREADS; t++)
+    for (n = 0; n < ROUNDS * nfiles; n++)
+      nids += bfd_count_sections (threads[t].bfds[n]);
+  ids = malloc (nids * sizeof (*ids));
+  if (ids == NULL)
+    die ("out of memory");
+  nids = 0;
+  for (t = 0; t < NTHREADS; t++)
+    for (n = 0; n < ROUNDS * nfiles; n++)
+      {
+	asection *sec;
+
+	for (sec = threads[t].bfds[n]->sections; sec != NULL; sec = sec->next)
+	  ids[nids++] = sec->id;
+      }
+  qsort (ids, nids, sizeof (*ids), compare_ids);
+  for (i = 1; i < nids; i++)
+    if (ids[i] == ids[i - 1])
+      die ("section ids are not unique");
+  free (ids);
+
+  for (t = 0; t < NTHREADS; t++)
+    {
+      for (n = 0; n < ROUNDS * nfiles; n++)
+	if (!bfd_close (threads[t].bfds[n]))
+	  die ("error closing file");
+      free (threads[t].bfds);
+    }
+  free (threads);
+#else
+  (void) argc;
+  (void) argv;
+  printf ("no threads\n");
+#endif
+
+  return 0;
+}
@@ -0,0 +1,150 @@
+/* A program to test reading parts of compressed sections.
+   Copyright (C) 2023 Free Software Foundation, Inc.
+
+   This file is part of the GNU Binutils.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+   MA 02110-1301, USA.  */
+
+/* Usage: bfdtest4 FILE COPY SECTION
+
+   COPY is FILE with SECTION compressed.  Read SECTION of COPY, which
+   BFD decompresses on reading, with bfd_get_section_contents: all of
+   it at once, a piece at a time from start to end, in pieces around
+   each 4MB boundary where a large section is split, and at some
+   pseudo-random places.  Each read must match SECTION of FILE.  */
+
+#include "sysdep.h"
+#include "bfd.h"
+
+#define CHUNK 0x400000
+
+static int errors;
+
+static void
+die (const char *s)
+{
+  printf ("oops: %s\n", s);
+  exit (1);
+}
+
+static bfd *
+open_file (const char *name, bool decompress)
+{
+  bfd *abfd = bfd_openr (name, NULL);
+
+  if (abfd == NULL)
+    die ("error opening file");
+  if (decompress)
+    abfd->flags |= BFD_DECOMPRESS;
+  if (!bfd_check_format (abfd, bfd_object))
+    die ("not an object file");
+  return abfd;
+}
+
+/* Read COUNT bytes at OFFSET in SEC and compare them with EXPECT.  */
+
+static void
+check_read (bfd *abfd, asection *sec, bfd_byte *buf,
+	    const bfd_byte *expect, bfd_size_type offset, bfd_size_type count)
+{
+  if (!bfd_get_section_contents (abfd, sec, buf, offset, count))
+    {
+      printf ("read of %#lx bytes at %#lx failed: %s\n",
+	      (unsigned long) count, (unsigned long) offset,
+	      bfd_errmsg (bfd_get_error ()));
+      errors++;
+    }
+  else if (memcmp (buf, expect + offset, count) != 0)
+    {
+      printf ("read of %#lx bytes at %#lx differs\n",
+	      (unsigned long) count, (unsigned long) offset);
+      errors++;
+    }
+}
+
+int
+main (int argc, const char **argv)
+{
+  bfd *ref, *abfd;
+  asection *rsec, *sec;
+  bfd_byte *expect, *buf;
+  bfd_size_type size, offset, count;
+  unsigned int seed = 1;
+  int i;
+
+  if (argc != 4)
+    die ("Usage: bfdtest4 FILE COPY SECTION");
+
+  if (bfd_init () != BFD_INIT_MAGIC)
+    die ("BFD version mismatch");
+
+  ref = open_file (argv[1], false);
+  rsec = bfd_get_section_by_name (ref, argv[3]);
+  if (rsec == NULL
+      || !bfd_malloc_and_get_section (ref, rsec, &expect))
+    die ("cannot read section of FILE");
+  size = bfd_section_size (rsec);
+
+  abfd = open_file (argv[2], true);
+  sec = bfd_get_section_by_name (abfd, argv[3]);
+  if (sec == NULL)
+    die ("no section in COPY");
+  if (sec->compress_status != DECOMPRESS_SECTION_ZLIB
+      && sec->compress_status != DECOMPRESS_SECTION_ZSTD)
+    die ("section of COPY is not compressed");
+  if (bfd_section_size (sec) != size)
+    die ("section sizes differ");
+
+  buf = malloc (size);
+  if (buf == NULL)
+    die ("out of memory");
+  check_read (abfd, sec, buf, expect, 0, size);
+
+  for (offset = 0; offset < size; offset += count)
+    {
+      count = 0x10001;
+      if (count > size - offset)
+	count = size - offset;
+      check_read (abfd, sec, buf, expect, offset, count);
+    }
+
+  for (offset = CHUNK; offset < size; offset += CHUNK)
+    {
+      check_read (abfd, sec, buf, expect, offset - 1, 1);
+      check_read (abfd, sec, buf, expect, offset, 1);
+      count = size - offset < 0x100 ? size - offset : 0x100;
+      check_read (abfd, sec, buf, expect, offset - 0x100, 0x100 + count);
+      if (offset + CHUNK < size)
+	check_read (abfd, sec, buf, expect, offset - 0x100, CHUNK + 0x200);
+    }
+
+  for (i = 0; i < 200; i++)
+    {
+      seed = seed * 1103515245 + 12345;
+      offset = ((bfd_size_type) seed << 8) % size;
+      seed = seed * 1103515245 + 12345;
+      count = 1 + (seed >> 4) % (size - offset < 0x10000
+				 ? size - offset : 0x10000);
+      check_read (abfd, sec, buf, expect, offset, count);
+    }
+
+  free (buf);
+  free (expect);
+  if (!bfd_close (abfd) || !bfd_close (ref))
+    die ("error closing files");
+
+  return errors != 0;
+}
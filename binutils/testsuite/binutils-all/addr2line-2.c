@@ -0,0 +1,13 @@
+/* A second compilation unit for the addr2line tests.  */
+
+int
+unit_fn (int x)
+{
+  return x + 1;
+}
+
+int
+unit_fn2 (int x)
+{
+  return unit_fn (x) * 2;
+}
@@ -0,0 +1,9 @@
+	# A debug section of a little over 9MB, which is compressed in
+	# several pieces.
+	.section	.debug_large,"",%progbits
+	.set	n, 0
+	.rept	0x120000
+	.long	n, n ^ 0x5a5a5a5a
+	.set	n, n + 1
+	.endr
+	.byte	1, 2, 3
@@ -0,0 +1,91 @@
+# A C++ function without a linkage name in its debug info, whose code
+# is split into hot and cold parts with a symbol for each.  addr2line
+# must name it the same way whichever part is looked up first.
+
+	.text
+.Ltext0:
+	.globl	_Z8split_fni
+	.type	_Z8split_fni, @function
+_Z8split_fni:
+	.file 1 "addr2line-cold.cc"
+	.loc 1 5 0
+	nop
+	nop
+	.loc 1 7 0
+	nop
+	ret
+	.size	_Z8split_fni, .-_Z8split_fni
+	.type	_Z8split_fni.cold, @function
+_Z8split_fni.cold:
+	.loc 1 6 0
+	nop
+	nop
+	nop
+	ret
+	.size	_Z8split_fni.cold, .-_Z8split_fni.cold
+.Letext0:
+
+	.section	.debug_info,"",@progbits
+.Ldebug_info0:
+	.long	.Linfo_end - .Linfo_start	# Length
+.Linfo_start:
+	.value	0x4		# DWARF version
+	.long	.Ldebug_abbrev0	# Abbrev offset
+	.byte	0x8		# Pointer size
+	.uleb128 0x1		# DW_TAG_compile_unit
+	.byte	0x4		# DW_AT_language: DW_LANG_C_plus_plus
+	.string	"addr2line-cold.cc"	# DW_AT_name
+	.quad	.Ltext0		# DW_AT_low_pc
+	.quad	.Letext0	# DW_AT_high_pc
+	.long	.Ldebug_line0	# DW_AT_stmt_list
+	.uleb128 0x2		# DW_TAG_subprogram
+	.string	"split_fn"	# DW_AT_name
+	.byte	0x1		# DW_AT_decl_file
+	.byte	0x4		# DW_AT_decl_line
+	.long	.Ldebug_ranges0	# DW_AT_ranges
+	.byte	0		# End of children
+.Linfo_end:
+
+	.section	.debug_abbrev,"",@progbits
+.Ldebug_abbrev0:
+	.uleb128 0x1		# Abbrev code
+	.uleb128 0x11		# DW_TAG_compile_unit
+	.byte	0x1		# DW_CHILDREN_yes
+	.uleb128 0x13		# DW_AT_language
+	.uleb128 0xb		# DW_FORM_data1
+	.uleb128 0x3		# DW_AT_name
+	.uleb128 0x8		# DW_FORM_string
+	.uleb128 0x11		# DW_AT_low_pc
+	.uleb128 0x1		# DW_FORM_addr
+	.uleb128 0x12		# DW_AT_high_pc
+	.uleb128 0x1		# DW_FORM_addr
+	.uleb128 0x10		# DW_AT_stmt_list
+	.uleb128 0x17		# DW_FORM_sec_offset
+	.byte	0
+	.byte	0
+	.uleb128 0x2		# Abbrev code
+	.uleb128 0x2e		# DW_TAG_subprogram
+	.byte	0x0		# DW_CHILDREN_no
+	.uleb128 0x3		# DW_AT_name
+	.uleb128 0x8		# DW_FORM_string
+	.uleb128 0x3a		# DW_AT_decl_file
+	.uleb128 0xb		# DW_FORM_data1
+	.uleb128 0x3b		# DW_AT_decl_line
+	.uleb128 0xb		# DW_FORM_data1
+	.uleb128 0x55		# DW_AT_ranges
+	.uleb128 0x17		# DW_FORM_sec_offset
+	.byte	0
+	.byte	0
+	.byte	0
+
+	.section	.debug_ranges,"",@progbits
+.Ldebug_ranges0:
+	.quad	_Z8split_fni - .Ltext0
+	.quad	_Z8split_fni.cold - .Ltext0
+	.quad	_Z8split_fni.cold - .Ltext0
+	.quad	.Letext0 - .Ltext0
+	.quad	0
+	.quad	0
+
+	.section	.debug_line,"",@progbits
+.Ldebug_line0:
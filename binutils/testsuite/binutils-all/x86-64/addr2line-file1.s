@@ -0,0 +1,23 @@
+# A DWARF 5 line table whose file 1, the initial value of the file
+# register, is not the primary source file in entry 0.  Lines before
+# the first DW_LNS_set_file must be reported against file 1.
+
+	.text
+	.file 0 "/src" "addr2line-file1.c"
+	.file 1 "addr2line-file1.h"
+	.file 2 "addr2line-file1.c"
+	.globl	hfn
+	.type	hfn, @function
+hfn:
+	.loc 1 3 0
+	nop
+	.loc 1 4 0
+	ret
+	.size	hfn, .-hfn
+	.globl	main
+	.type	main, @function
+main:
+	.loc 2 2 0
+	nop
+	ret
+	.size	main, .-main
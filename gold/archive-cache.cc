@@ -0,0 +1,443 @@
+// archive-cache.cc -- persistent archive symbol cache for gold
+
+// Copyright (C) 2023 Free Software Foundation, Inc.
+
+// This file is part of gold.
+
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+// MA 02110-1301, USA.
+
+#include "gold.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#ifdef HAVE_SYS_MMAN_H
+#include <sys/mman.h>
+#endif
+
+#include "xxh3.h"
+
+#include "parameters.h"
+#include "options.h"
+#include "gold-threads.h"
+#include "descriptors.h"
+#include "archive-cache.h"
+#include "binary-io.h"
+
+namespace gold
+{
+
+// The magic string at the start of a cache file.  The last character
+// is the version of the format.
+
+const char Archive_symbol_cache::magic[8] =
+{
+  'g', 'o', 'l', 'd', 'a', 'r', 'c', '2'
+};
+
+// The header of a cache file is HEADER_WORDS words:
+//   0-1    the magic string
+//   2      the number of entries in the archive symbol table
+//   3      the number of members
+//   4      the number of words in the lists of symbol table entries
+//   5      the length of the archive name in bytes
+//   6-7    the size of the archive, low word first
+//   8-9    the seconds of the archive modification time, low word first
+//   10     the nanoseconds of the archive modification time
+//   11     the nanoseconds of the archive status change time
+//   12-13  the seconds of the archive status change time, low word first
+//   14-15  the device of the archive, low word first
+//   16-17  the inode number of the archive, low word first
+//   18-21  the hash of the archive contents
+// The archive name follows, padded with zeroes to a word boundary.
+// Each entry in the member table holds a flags word, in which bit 0 is
+// set if the undefined symbols of the member are known, the position
+// in the lists of the symbols the member defines, the number of
+// symbols it defines, and the number of symbols it refers to, which
+// follow the symbols it defines.
+
+Archive_symbol_cache::Archive_symbol_cache(const std::string& archive_name,
+					   const Key& key,
+					   unsigned int nsyms)
+  : archive_name_(archive_name), key_(key), have_hash_(false), nsyms_(nsyms), contents_(NULL), contents_words_(0),
+    is_mapped_(false), members_(0), symbols_(0), lists_(0)
+{
+}
+
+Archive_symbol_cache::~Archive_symbol_cache()
+{
+  this->clear_contents();
+}
+
+// Free the contents.
+
+void
+Archive_symbol_cache::clear_contents()
+{
+  if (this->contents_ == NULL)
+    return;
+#ifdef HAVE_MMAP
+  if (this->is_mapped_)
+    ::munmap(const_cast<elfcpp::Elf_Word*>(this->contents_),
+	     this->contents_words_ * 4);
+  else
+#endif
+    delete[] this->contents_;
+  this->contents_ = NULL;
+  this->contents_words_ = 0;
+  this->is_mapped_ = false;
+}
+
+// Return the hash of the archive contents, computing it with HASHER
+// the first time.
+
+const unsigned char*
+Archive_symbol_cache::contents_hash(Hasher* hasher)
+{
+  if (!this->have_hash_)
+    {
+      hasher->hash(this->hash_);
+      this->have_hash_ = true;
+    }
+  return this->hash_;
+}
+
+// Write the Key and the hash of the contents to the header at BUF.
+
+void
+Archive_symbol_cache::write_key(elfcpp::Elf_Word* buf, Hasher* hasher)
+{
+  typedef elfcpp::Swap<32, false> Swap;
+  uint64_t size = this->key_.size;
+  Swap::writeval(buf + 6, size & 0xffffffff);
+  Swap::writeval(buf + 7, size >> 32);
+  uint64_t sec = this->key_.mtime.seconds;
+  Swap::writeval(buf + 8, sec & 0xffffffff);
+  Swap::writeval(buf + 9, sec >> 32);
+  Swap::writeval(buf + 10, this->key_.mtime.nanoseconds);
+  Swap::writeval(buf + 11, this->key_.ctime.nanoseconds);
+  sec = this->key_.ctime.seconds;
+  Swap::writeval(buf + 12, sec & 0xffffffff);
+  Swap::writeval(buf + 13, sec >> 32);
+  Swap::writeval(buf + 14, this->key_.device & 0xffffffff);
+  Swap::writeval(buf + 15, this->key_.device >> 32);
+  Swap::writeval(buf + 16, this->key_.inode & 0xffffffff);
+  Swap::writeval(buf + 17, this->key_.inode >> 32);
+  memcpy(reinterpret_cast<unsigned char*>(buf) + 18 * 4,
+	 this->contents_hash(hasher), hash_size);
+}
+
+// Return the name of the cache file.  It is named for the hash of the
+// archive name, so that different archives with the same base name
+// get different cache files.
+
+std::string
+Archive_symbol_cache::cache_file_name() const
+{
+  unsigned char hash[XXH3_128_DIGEST_SIZE];
+  xxh3_128_buffer(this->archive_name_.data(), this->archive_name_.size(),
+		  hash);
+  std::string ret(parameters->options().archive_symbol_cache());
+  ret += '/';
+  for (size_t i = 0; i < sizeof hash; ++i)
+    {
+      char buf[3];
+      snprintf(buf, sizeof buf, "%02x", hash[i]);
+      ret += buf;
+    }
+  ret += ".cache";
+  return ret;
+}
+
+// Read the cache file.  Return true if it exists and matches the
+// archive.  If it only matches the contents of the archive, because
+// the archive has been copied or touched since it was written, write
+// it again with the new Key so that later links need not hash the
+// archive.
+
+bool
+Archive_symbol_cache::load(Hasher* hasher)
+{
+  this->clear_contents();
+
+  std::string name = this->cache_file_name();
+  int o = open_descriptor(-1, name.c_str(), O_RDONLY);
+  if (o < 0)
+    return false;
+
+  struct stat s;
+  if (::fstat(o, &s) < 0
+      || s.st_size < static_cast<off_t>(header_words * 4)
+      || s.st_size % 4 != 0)
+    {
+      release_descriptor(o, true);
+      return false;
+    }
+  size_t bytes = s.st_size;
+
+#ifdef HAVE_MMAP
+  void* base = ::mmap(NULL, bytes, PROT_READ, MAP_PRIVATE, o, 0);
+  if (base != MAP_FAILED)
+    {
+      this->contents_ = static_cast<const elfcpp::Elf_Word*>(base);
+      this->is_mapped_ = true;
+    }
+  else
+#endif
+    {
+      elfcpp::Elf_Word* buf = new elfcpp::Elf_Word[bytes / 4];
+      unsigned char* p = reinterpret_cast<unsigned char*>(buf);
+      size_t got = 0;
+      while (got < bytes)
+	{
+	  ssize_t r = ::read(o, p + got, bytes - got);
+	  if (r <= 0)
+	    break;
+	  got += r;
+	}
+      this->contents_ = buf;
+      if (got < bytes)
+	{
+	  this->contents_words_ = bytes / 4;
+	  this->clear_contents();
+	  release_descriptor(o, true);
+	  return false;
+	}
+    }
+  release_descriptor(o, true);
+  this->contents_words_ = bytes / 4;
+
+  bool key_matches;
+  if (!this->check_contents(hasher, &key_matches))
+    {
+      this->clear_contents();
+      return false;
+    }
+
+  if (!key_matches)
+    {
+      size_t words = this->contents_words_;
+      elfcpp::Elf_Word* buf = new elfcpp::Elf_Word[words];
+      memcpy(buf, this->contents_, words * 4);
+      this->clear_contents();
+      this->write_key(buf, hasher);
+      this->contents_ = buf;
+      this->contents_words_ = words;
+      this->save();
+    }
+  return true;
+}
+
+// Check that the contents describe this archive, and set the
+// positions of the tables.  Return false if they do not.  Set
+// *KEY_MATCHES to whether the Key in the header is this archive's.  The
+// cache file may have been written by a different version of gold, or
+// damaged, so check everything we will use.
+
+bool
+Archive_symbol_cache::check_contents(Hasher* hasher, bool* key_matches)
+{
+  const unsigned char* p =
+    reinterpret_cast<const unsigned char*>(this->contents_);
+  if (memcmp(p, Archive_symbol_cache::magic, sizeof magic) != 0)
+    return false;
+
+  unsigned int nsyms = this->word(2);
+  unsigned int nmembers = this->word(3);
+  unsigned int nlist = this->word(4);
+  unsigned int name_len = this->word(5);
+  uint64_t size = this->word(6) | (static_cast<uint64_t>(this->word(7)) << 32);
+  uint64_t sec = this->word(8) | (static_cast<uint64_t>(this->word(9)) << 32);
+  unsigned int nsec = this->word(10);
+  uint64_t csec = (this->word(12)
+		  | (static_cast<uint64_t>(this->word(13)) << 32));
+  unsigned int cnsec = this->word(11);
+  uint64_t device = (this->word(14)
+		     | (static_cast<uint64_t>(this->word(15)) << 32));
+  uint64_t inode = (this->word(16)
+		    | (static_cast<uint64_t>(this->word(17)) << 32));
+  if (nsyms != this->nsyms_
+      || size != static_cast<uint64_t>(this->key_.size))
+    return false;
+
+  *key_matches = (sec == static_cast<uint64_t>(this->key_.mtime.seconds)
+		  && (nsec
+		      == static_cast<unsigned int>(this->key_.mtime.nanoseconds))
+		  && csec == static_cast<uint64_t>(this->key_.ctime.seconds)
+		  && (cnsec
+		      == static_cast<unsigned int>(this->key_.ctime.nanoseconds))
+		  && device == this->key_.device
+		  && inode == this->key_.inode);
+
+  size_t name_words = (static_cast<size_t>(name_len) + 3) / 4;
+  this->members_ = header_words + name_words;
+  this->symbols_ = this->members_ + static_cast<size_t>(nmembers) * member_words;
+  this->lists_ = this->symbols_ + nsyms;
+  if (name_len != this->archive_name_.size()
+      || nmembers > this->contents_words_
+      || this->lists_ + nlist != this->contents_words_
+      || memcmp(p + header_words * 4, this->archive_name_.data(),
+		name_len) != 0)
+    return false;
+
+  for (unsigned int m = 0; m < nmembers; ++m)
+    {
+      uint64_t first = this->word(this->members_ + m * member_words + 1);
+      uint64_t ndefs = this->word(this->members_ + m * member_words + 2);
+      uint64_t nrefs = this->word(this->members_ + m * member_words + 3);
+      if (first + ndefs + nrefs > nlist)
+	return false;
+    }
+  for (unsigned int i = 0; i < nsyms; ++i)
+    if (this->member_of_symbol(i) >= nmembers)
+      return false;
+  for (unsigned int i = 0; i < nlist; ++i)
+    if (this->symbol_list(i) >= nsyms)
+      return false;
+
+  // Only read the archive if the Key does not match.
+  if (!*key_matches
+      && memcmp(p + 18 * 4, this->contents_hash(hasher), hash_size) != 0)
+    return false;
+
+  return true;
+}
+
+// Set the contents of the cache from MEMBER_OF_SYMBOL and MEMBERS.
+
+void
+Archive_symbol_cache::build(const std::vector<unsigned int>& member_of_symbol,
+			    const std::vector<Member>& members,
+			    Hasher* hasher)
+{
+  gold_assert(member_of_symbol.size() == this->nsyms_);
+  this->clear_contents();
+
+  size_t nlist = 0;
+  for (std::vector<Member>::const_iterator p = members.begin();
+       p != members.end();
+       ++p)
+    nlist += p->defs.size() + p->refs.size();
+
+  size_t name_len = this->archive_name_.size();
+  this->members_ = header_words + (name_len + 3) / 4;
+  this->symbols_ = this->members_ + members.size() * member_words;
+  this->lists_ = this->symbols_ + this->nsyms_;
+  this->contents_words_ = this->lists_ + nlist;
+
+  elfcpp::Elf_Word* buf = new elfcpp::Elf_Word[this->contents_words_];
+  memset(buf, 0, this->contents_words_ * 4);
+  unsigned char* p = reinterpret_cast<unsigned char*>(buf);
+
+  typedef elfcpp::Swap<32, false> Swap;
+  memcpy(p, Archive_symbol_cache::magic, sizeof magic);
+  Swap::writeval(buf + 2, this->nsyms_);
+  Swap::writeval(buf + 3, members.size());
+  Swap::writeval(buf + 4, nlist);
+  Swap::writeval(buf + 5, name_len);
+  this->write_key(buf, hasher);
+  memcpy(p + header_words * 4, this->archive_name_.data(), name_len);
+
+  elfcpp::Elf_Word* pm = buf + this->members_;
+  elfcpp::Elf_Word* pl = buf + this->lists_;
+  unsigned int pos = 0;
+  for (std::vector<Member>::const_iterator m = members.begin();
+       m != members.end();
+       ++m, pm += member_words)
+    {
+      Swap::writeval(pm, m->undefs_known ? 1 : 0);
+      Swap::writeval(pm + 1, pos);
+      Swap::writeval(pm + 2, m->defs.size());
+      Swap::writeval(pm + 3, m->refs.size());
+      for (size_t i = 0; i < m->defs.size(); ++i, ++pos)
+	Swap::writeval(pl + pos, m->defs[i]);
+      for (size_t i = 0; i < m->refs.size(); ++i, ++pos)
+	Swap::writeval(pl + pos, m->refs[i]);
+    }
+
+  elfcpp::Elf_Word* ps = buf + this->symbols_;
+  for (unsigned int i = 0; i < this->nsyms_; ++i)
+    Swap::writeval(ps + i, member_of_symbol[i]);
+
+  this->contents_ = buf;
+  this->is_mapped_ = false;
+}
+
+// A lock for save_count.
+static Lock* save_count_lock = NULL;
+static Initialize_lock save_count_initialize_lock(&save_count_lock);
+
+// The number of cache files written so far by this process.
+static unsigned int save_count;
+
+// Write the cache to the cache directory.  Another link, or this one
+// if it names the archive twice, may be writing the same cache file,
+// so write a temporary file with a name used by no other writer and
+// rename it.  Failing to write the cache only costs time in later
+// links, so we only warn.
+
+void
+Archive_symbol_cache::save() const
+{
+  gold_assert(this->contents_ != NULL);
+
+  unsigned int count;
+  {
+    save_count_initialize_lock.initialize();
+    Hold_optional_lock hl(save_count_lock);
+    count = save_count++;
+  }
+
+  std::string name = this->cache_file_name();
+  char suffix[64];
+  snprintf(suffix, sizeof suffix, ".%ld.%u", static_cast<long>(getpid()),
+	   count);
+  std::string tmpname = name + suffix;
+
+  FILE* f = NULL;
+  int o = ::open(tmpname.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_BINARY,
+		 0666);
+  if (o >= 0)
+    {
+      f = fdopen(o, "wb");
+      if (f == NULL)
+	::close(o);
+    }
+  if (f == NULL)
+    {
+      gold_warning(_("cannot create archive symbol cache %s: %s"),
+		   tmpname.c_str(), strerror(errno));
+      return;
+    }
+  size_t bytes = this->contents_words_ * 4;
+  bool ok = fwrite(this->contents_, 1, bytes, f) == bytes;
+  if (fclose(f) != 0)
+    ok = false;
+  if (ok && ::rename(tmpname.c_str(), name.c_str()) < 0)
+    ok = false;
+  if (!ok)
+    {
+      gold_warning(_("cannot write archive symbol cache %s: %s"),
+		   name.c_str(), strerror(errno));
+      ::unlink(tmpname.c_str());
+    }
+}
+
+} // End namespace gold.
@@ -0,0 +1,242 @@
+// archive-cache.h -- persistent archive symbol cache for gold  -*- C++ -*-
+
+// Copyright (C) 2023 Free Software Foundation, Inc.
+
+// This file is part of gold.
+
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+// MA 02110-1301, USA.
+
+#ifndef GOLD_ARCHIVE_CACHE_H
+#define GOLD_ARCHIVE_CACHE_H
+
+#include <string>
+#include <vector>
+
+#include "elfcpp.h"
+#include "fileread.h"
+
+namespace gold
+{
+
+// A cache of the symbols of the members of an archive, stored in the
+// directory named by --archive-symbol-cache so that it can be reused
+// by later links with the same archive.
+
+// For each member named in the archive symbol table, the cache records
+// the entries of the symbol table which the member defines, and the
+// entries which name symbols the member refers to without defining
+// them.  When a member is included in the link, only the entries it
+// refers to can become newly undefined, so only those entries need to
+// be looked at again, rather than the whole symbol table.
+
+// The cache file is a sequence of little-endian 32-bit words, so that
+// it can be mapped and used in place.  It holds a header, the name of
+// the archive, a table of members, the member of each symbol table
+// entry, and the lists of symbol table entries for the members.  The
+// header records the size, modification and change times, device and
+// inode number of the archive, and a hash of its contents.  If they
+// all match other than the hash, the cache is used without reading
+// the archive.  Otherwise, if the size matches, the archive is hashed,
+// since it may only have been copied or touched; if the hash matches
+// the cache is used, and written again for the new file.
+
+class Archive_symbol_cache
+{
+ public:
+  // The size of the hash of the archive contents.
+  static const size_t hash_size = 16;
+
+  // What identifies an archive file without reading it.
+  struct Key
+  {
+    Key()
+      : size(0), mtime(), ctime(), device(0), inode(0)
+    { }
+
+    // The size of the archive.
+    off_t size;
+    // The modification time of the archive.
+    Timespec mtime;
+    // The status change time of the archive.  Unlike the modification
+    // time, this can not be set back after the file is changed.
+    Timespec ctime;
+    // The device and inode number of the archive.
+    uint64_t device;
+    uint64_t inode;
+  };
+
+  // Computes the XXH3 hash of the archive contents.  This is only done
+  // when the cache can not be matched to the archive by its Key, or
+  // when the cache is written.
+  class Hasher
+  {
+   public:
+    Hasher()
+    { }
+
+    virtual
+    ~Hasher()
+    { }
+
+    // Set HASH, which is hash_size bytes, to the hash of the archive
+    // contents.
+    virtual void
+    hash(unsigned char* hash) = 0;
+  };
+
+  // The symbols of a member, used when building a new cache.
+  struct Member
+  {
+    Member()
+      : undefs_known(false), defs(), refs()
+    { }
+
+    // Whether the undefined symbols of the member could be read.  If
+    // they could not, then including the member may make any symbol
+    // undefined.
+    bool undefs_known;
+    // The symbol table entries for the symbols the member defines.
+    std::vector<unsigned int> defs;
+    // The symbol table entries for the symbols the member refers to
+    // but does not define.
+    std::vector<unsigned int> refs;
+  };
+
+  // ARCHIVE_NAME is the absolute file name of the archive, KEY
+  // identifies the file, and NSYMS is the number of entries in its
+  // symbol table.
+  Archive_symbol_cache(const std::string& archive_name, const Key& key,
+		       unsigned int nsyms);
+
+  ~Archive_symbol_cache();
+
+  // Read the cache file from the cache directory.  Return true if it
+  // exists and matches the archive.  If it only matches the contents
+  // of the archive, as computed by HASHER, write it again with the
+  // new Key.
+  bool
+  load(Hasher* hasher);
+
+  // Set the contents of the cache.  MEMBER_OF_SYMBOL holds the member
+  // index of each entry in the archive symbol table.  HASHER computes
+  // the hash of the archive contents.
+  void
+  build(const std::vector<unsigned int>& member_of_symbol,
+	const std::vector<Member>& members, Hasher* hasher);
+
+  // Write the cache to the cache directory.
+  void
+  save() const;
+
+  // Return the index of the member which defines the symbol table
+  // entry I.
+  unsigned int
+  member_of_symbol(unsigned int i) const
+  { return this->word(this->symbols_ + i); }
+
+  // Return whether the undefined symbols of member M are known.
+  bool
+  undefs_known(unsigned int m) const
+  { return (this->word(this->members_ + m * member_words) & 1) != 0; }
+
+  // Return the number of symbol table entries defined by member M, and
+  // the position of the first of them for symbol_list.
+  unsigned int
+  defs(unsigned int m, unsigned int* first) const
+  {
+    *first = this->word(this->members_ + m * member_words + 1);
+    return this->word(this->members_ + m * member_words + 2);
+  }
+
+  // Return the number of symbol table entries referred to by member
+  // M, and the position of the first of them for symbol_list.
+  unsigned int
+  refs(unsigned int m, unsigned int* first) const
+  {
+    *first = (this->word(this->members_ + m * member_words + 1)
+	      + this->word(this->members_ + m * member_words + 2));
+    return this->word(this->members_ + m * member_words + 3);
+  }
+
+  // Return the symbol table entry at position I of the lists.
+  unsigned int
+  symbol_list(unsigned int i) const
+  { return this->word(this->lists_ + i); }
+
+ private:
+  Archive_symbol_cache(const Archive_symbol_cache&);
+  Archive_symbol_cache& operator=(const Archive_symbol_cache&);
+
+  // The magic string at the start of a cache file.
+  static const char magic[8];
+  // The number of words in the header.
+  static const unsigned int header_words = 22;
+  // The number of words in each entry of the member table.
+  static const unsigned int member_words = 4;
+
+  // Return the word at index I of the contents.
+  unsigned int
+  word(size_t i) const
+  { return elfcpp::Swap<32, false>::readval(this->contents_ + i); }
+
+  // Return the name of the cache file.
+  std::string
+  cache_file_name() const;
+
+  // Check that the contents describe this archive, and set the
+  // positions of the tables.  Return false if they do not.  Set
+  // *KEY_MATCHES to whether the Key in the header is this archive's.
+  bool
+  check_contents(Hasher* hasher, bool* key_matches);
+
+  // Return the hash of the archive contents, using HASHER.
+  const unsigned char*
+  contents_hash(Hasher* hasher);
+
+  // Write the Key and the hash of the contents to the header at BUF.
+  void
+  write_key(elfcpp::Elf_Word* buf, Hasher* hasher);
+
+  // Free the contents.
+  void
+  clear_contents();
+
+  // The name of the archive.
+  std::string archive_name_;
+  // The key of the archive file.
+  Key key_;
+  // The hash of the archive contents, if HAVE_HASH_.
+  unsigned char hash_[hash_size];
+  bool have_hash_;
+  // The number of entries in the archive symbol table.
+  unsigned int nsyms_;
+  // The contents of the cache file.
+  const elfcpp::Elf_Word* contents_;
+  // The size of the contents, in words.
+  size_t contents_words_;
+  // Whether the contents are mapped from the cache file, rather than
+  // allocated.
+  bool is_mapped_;
+  // The word positions of the member table, the member of each
+  // symbol and the lists of symbol table entries.
+  size_t members_;
+  size_t symbols_;
+  size_t lists_;
+};
+
+} // End namespace gold.
+
+#endif // !defined(GOLD_ARCHIVE_CACHE_H)
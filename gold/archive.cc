@@ -25,9 +25,12 @@
 #include <cerrno>
 #include <cstring>
 #include <climits>
+#include <set>
 #include <vector>
+#include <sys/stat.h>
 #include "libiberty.h"
 #include "filenames.h"
+#include "xxh3.h"
 
 #include "elfcpp.h"
 #include "options.h"
@@ -40,6 +43,7 @@
 #include "archive.h"
 #include "plugin.h"
 #include "incremental.h"
+#include "archive-cache.h"
 
 namespace gold
 {
@@ -171,6 +175,8 @@ struct Archive::Archive_header
 unsigned int Archive::total_archives;
 unsigned int Archive::total_members;
 unsigned int Archive::total_members_loaded;
+unsigned int Archive::total_symbol_caches_read;
+unsigned int Archive::total_symbol_caches_written;
 
 // Archive methods.
 
@@ -194,10 +200,17 @@ Archive::Archive(const std::string& name, Input_file* input_file,
     armap_names_(), extended_names_(), armap_checked_(), seen_offsets_(),
     members_(), is_thin_archive_(is_thin_archive), included_member_(false),
     nested_archives_(), dirpath_(dirpath), num_members_(0),
-    included_all_members_(false)
+    included_all_members_(false), symbol_cache_(NULL)
 {
   this->no_export_ =
     parameters->options().check_excluded_libs(input_file->found_name());
+  input_file->file().set_is_archive();
+}
+
+Archive::~Archive()
+{
+  if (this->symbol_cache_ != NULL)
+    delete this->symbol_cache_;
 }
 
 // Set up the archive: read the symbol map and the extended name
@@ -250,6 +263,14 @@ Archive::setup()
       const char* px = reinterpret_cast<const char*>(p);
       this->extended_names_.assign(px, extended_size);
     }
+
+  // The cache can not tell when the members of a thin archive change.
+  if (parameters->options().user_set_archive_symbol_cache()
+      && !this->armap_.empty()
+      && !this->is_thin_archive_
+      && !this->input_file_->options().whole_archive())
+    this->setup_symbol_cache();
+
   bool preread_syms = (parameters->options().threads()
                        && parameters->options().preread_archive_symbols());
 #ifndef ENABLE_THREADS
@@ -329,6 +350,315 @@ Archive::read_armap(off_t start, section_size_type size)
   this->armap_checked_.resize(nsyms);
 }
 
+// Hashes the contents of an archive for its symbol cache.
+
+class Archive_contents_hasher : public Archive_symbol_cache::Hasher
+{
+ public:
+  Archive_contents_hasher(Archive* archive, off_t size)
+    : archive_(archive), size_(size)
+  { }
+
+  void
+  hash(unsigned char* hash)
+  {
+    File_read& file(this->archive_->file());
+    const unsigned char* contents =
+      file.get_view(0, 0, convert_to_section_size_type(this->size_), false,
+		    false);
+    xxh3_128_buffer(reinterpret_cast<const char*>(contents), this->size_,
+		    hash);
+  }
+
+ private:
+  Archive* archive_;
+  off_t size_;
+};
+
+// Set up the archive symbol cache.  Use the cache file if it matches
+// the archive, otherwise build the cache from the symbol tables of the
+// members and write a new cache file.  The archive is only read in
+// full if the cache file was written for a different file, or to write
+// a new one.
+
+void
+Archive::setup_symbol_cache()
+{
+  File_read& file(this->input_file_->file());
+  Archive_symbol_cache::Key key;
+  key.size = file.filesize();
+  struct stat s;
+  if (::fstat(file.descriptor(), &s) < 0)
+    gold_fatal(_("%s: stat failed: %s"), file.filename().c_str(),
+	       strerror(errno));
+#ifdef HAVE_STAT_ST_MTIM
+  key.mtime = Timespec(s.st_mtim.tv_sec, s.st_mtim.tv_nsec);
+  key.ctime = Timespec(s.st_ctim.tv_sec, s.st_ctim.tv_nsec);
+#else
+  key.mtime = Timespec(s.st_mtime, 0);
+  key.ctime = Timespec(s.st_ctime, 0);
+#endif
+  key.device = s.st_dev;
+  key.inode = s.st_ino;
+
+  Archive_contents_hasher hasher(this, key.size);
+  char* path = lrealpath(file.filename().c_str());
+  Archive_symbol_cache* cache =
+    new Archive_symbol_cache(path, key, this->armap_.size());
+  free(path);
+
+  if (cache->load(&hasher))
+    ++Archive::total_symbol_caches_read;
+  else
+    {
+      this->build_symbol_cache(cache, &hasher);
+      cache->save();
+      ++Archive::total_symbol_caches_written;
+    }
+  this->symbol_cache_ = cache;
+}
+
+// Build the contents of the archive symbol cache CACHE by reading the
+// symbol tables of the members.
+
+void
+Archive::build_symbol_cache(Archive_symbol_cache* cache,
+			    Archive_symbol_cache::Hasher* hasher)
+{
+  const unsigned int nsyms = this->armap_.size();
+
+  // Number the members in the order of their file offsets.
+  std::map<off_t, unsigned int> member_index;
+  for (unsigned int i = 0; i < nsyms; ++i)
+    member_index[this->armap_[i].file_offset] = 0;
+  unsigned int nmembers = 0;
+  for (std::map<off_t, unsigned int>::iterator p = member_index.begin();
+       p != member_index.end();
+       ++p)
+    p->second = nmembers++;
+
+  // Record the symbols each member defines, and map each symbol name,
+  // without a version, to the symbol table entries for it.
+  std::vector<unsigned int> member_of_symbol(nsyms);
+  std::vector<Archive_symbol_cache::Member> members(nmembers);
+  Unordered_map<std::string, std::vector<unsigned int> > entries;
+  for (unsigned int i = 0; i < nsyms; ++i)
+    {
+      unsigned int m = member_index[this->armap_[i].file_offset];
+      member_of_symbol[i] = m;
+      members[m].defs.push_back(i);
+      const char* name = this->armap_names_.data() + this->armap_[i].name_offset;
+      entries[std::string(name, strcspn(name, "@"))].push_back(i);
+    }
+
+  // Record the symbol table entries for the undefined symbols of each
+  // member.  If a member can not be read, its undefined symbols are
+  // unknown; any error will be reported if it is included in the link.
+  std::vector<std::string> undefs;
+  for (std::map<off_t, unsigned int>::const_iterator p = member_index.begin();
+       p != member_index.end();
+       ++p)
+    {
+      std::string member_name;
+      off_t nested_off;
+      off_t memsize = this->read_header(p->first, false, &member_name,
+					&nested_off);
+      if (memsize == -1)
+	continue;
+      off_t memoff = p->first + static_cast<off_t>(sizeof(Archive_header));
+
+      Input_file* input_file = this->input_file_;
+      const unsigned char* ehdr;
+      int read_size;
+      if (!is_elf_object(input_file, memoff, &ehdr, &read_size))
+	continue;
+
+      undefs.clear();
+      bool ok = false;
+      bool big_endian = ehdr[elfcpp::EI_DATA] == elfcpp::ELFDATA2MSB;
+      if (ehdr[elfcpp::EI_CLASS] == elfcpp::ELFCLASS32)
+	{
+#if defined(HAVE_TARGET_32_BIG) || defined(HAVE_TARGET_32_LITTLE)
+	  if (big_endian)
+	    {
+#ifdef HAVE_TARGET_32_BIG
+	      ok = this->read_member_undefs<32, true>(memoff, memsize,
+						      &undefs);
+#endif
+	    }
+	  else
+	    {
+#ifdef HAVE_TARGET_32_LITTLE
+	      ok = this->read_member_undefs<32, false>(memoff, memsize,
+						       &undefs);
+#endif
+	    }
+#endif
+	}
+      else if (ehdr[elfcpp::EI_CLASS] == elfcpp::ELFCLASS64)
+	{
+#if defined(HAVE_TARGET_64_BIG) || defined(HAVE_TARGET_64_LITTLE)
+	  if (big_endian)
+	    {
+#ifdef HAVE_TARGET_64_BIG
+	      ok = this->read_member_undefs<64, true>(memoff, memsize,
+						      &undefs);
+#endif
+	    }
+	  else
+	    {
+#ifdef HAVE_TARGET_64_LITTLE
+	      ok = this->read_member_undefs<64, false>(memoff, memsize,
+						       &undefs);
+#endif
+	    }
+#endif
+	}
+      if (!ok)
+	continue;
+
+      Archive_symbol_cache::Member* member = &members[p->second];
+      member->undefs_known = true;
+      for (std::vector<std::string>::const_iterator u = undefs.begin();
+	   u != undefs.end();
+	   ++u)
+	{
+	  Unordered_map<std::string, std::vector<unsigned int> >::const_iterator
+	    e = entries.find(u->substr(0, u->find('@')));
+	  if (e != entries.end())
+	    member->refs.insert(member->refs.end(), e->second.begin(),
+				e->second.end());
+	}
+      std::sort(member->refs.begin(), member->refs.end());
+      member->refs.erase(std::unique(member->refs.begin(),
+				     member->refs.end()),
+			 member->refs.end());
+    }
+
+  cache->build(member_of_symbol, members, hasher);
+}
+
+// Read the names of the undefined global symbols of the ELF object at
+// MEMOFF into *NAMES.  This reads only the section headers and the
+// symbol table, so it is much cheaper than creating an Object.  Return
+// false for an object with LTO intermediate code: if a plugin claims
+// it, its symbols will come from the plugin, not the symbol table.
+
+template<int size, bool big_endian>
+bool
+Archive::read_member_undefs(off_t memoff, off_t memsize,
+			    std::vector<std::string>* names)
+{
+  const int ehdr_size = elfcpp::Elf_sizes<size>::ehdr_size;
+  const int shdr_size = elfcpp::Elf_sizes<size>::shdr_size;
+  const int sym_size = elfcpp::Elf_sizes<size>::sym_size;
+  typedef typename elfcpp::Elf_types<size>::Elf_Off Elf_Off;
+
+  if (memsize < ehdr_size)
+    return false;
+  elfcpp::Ehdr<size, big_endian> ehdr(this->get_view(memoff, ehdr_size,
+						     true, false));
+  if (ehdr.get_e_type() != elfcpp::ET_REL)
+    return false;
+  Elf_Off shoff = ehdr.get_e_shoff();
+  if (shoff == 0
+      || shoff + shdr_size < shoff
+      || shoff + shdr_size > static_cast<Elf_Off>(memsize))
+    return false;
+
+  uint64_t shnum = ehdr.get_e_shnum();
+  if (shnum == 0)
+    {
+      elfcpp::Shdr<size, big_endian> shdr0(this->get_view(memoff + shoff,
+							  shdr_size,
+							  true, false));
+      shnum = shdr0.get_sh_size();
+    }
+  if (shnum * shdr_size > static_cast<uint64_t>(memsize - shoff))
+    return false;
+  const unsigned char* pshdrs = this->get_view(memoff + shoff,
+					       shnum * shdr_size, true, false);
+
+  unsigned int shstrndx = ehdr.get_e_shstrndx();
+  if (shstrndx == elfcpp::SHN_XINDEX)
+    {
+      elfcpp::Shdr<size, big_endian> shdr0(pshdrs);
+      shstrndx = shdr0.get_sh_link();
+    }
+  if (shstrndx == 0 || shstrndx >= shnum)
+    return false;
+  elfcpp::Shdr<size, big_endian> shstrshdr(pshdrs + shstrndx * shdr_size);
+  uint64_t shstroff = shstrshdr.get_sh_offset();
+  uint64_t shstrsize = shstrshdr.get_sh_size();
+  if (shstroff > static_cast<uint64_t>(memsize)
+      || shstrsize > static_cast<uint64_t>(memsize) - shstroff)
+    return false;
+  const char* pshnames =
+    reinterpret_cast<const char*>(this->get_view(memoff + shstroff,
+						 shstrsize, false, false));
+
+  unsigned int symtab_shndx = 0;
+  for (unsigned int i = 1; i < shnum; ++i)
+    {
+      elfcpp::Shdr<size, big_endian> shdr(pshdrs + i * shdr_size);
+      if (shdr.get_sh_type() == elfcpp::SHT_SYMTAB && symtab_shndx == 0)
+	symtab_shndx = i;
+      unsigned int sh_name = shdr.get_sh_name();
+      if (sh_name >= shstrsize)
+	return false;
+      const char* name = pshnames + sh_name;
+      size_t len = strnlen(name, shstrsize - sh_name);
+      if ((len > 9 && strncmp(name, ".gnu.lto_", 9) == 0)
+	  || (len == 9 && strncmp(name, ".llvm.lto", 9) == 0))
+	return false;
+    }
+  if (symtab_shndx == 0)
+    return true;
+
+  elfcpp::Shdr<size, big_endian> symtabshdr(pshdrs
+					    + symtab_shndx * shdr_size);
+  unsigned int strtab_shndx = symtabshdr.get_sh_link();
+  if (strtab_shndx == 0 || strtab_shndx >= shnum)
+    return false;
+  elfcpp::Shdr<size, big_endian> strtabshdr(pshdrs
+					    + strtab_shndx * shdr_size);
+
+  uint64_t symoff = symtabshdr.get_sh_offset();
+  uint64_t symsize = symtabshdr.get_sh_size();
+  uint64_t stroff = strtabshdr.get_sh_offset();
+  uint64_t strsize = strtabshdr.get_sh_size();
+  if (symoff > static_cast<uint64_t>(memsize)
+      || symsize > static_cast<uint64_t>(memsize) - symoff
+      || stroff > static_cast<uint64_t>(memsize)
+      || strsize > static_cast<uint64_t>(memsize) - stroff
+      || strsize == 0)
+    return false;
+
+  size_t nsyms = symsize / sym_size;
+  size_t first_global = symtabshdr.get_sh_info();
+  if (first_global >= nsyms)
+    return true;
+
+  const unsigned char* psyms = this->get_view(memoff + symoff, symsize,
+					      true, false);
+  const char* pnames =
+    reinterpret_cast<const char*>(this->get_view(memoff + stroff, strsize,
+						 false, false));
+  for (size_t i = first_global; i < nsyms; ++i)
+    {
+      elfcpp::Sym<size, big_endian> sym(psyms + i * sym_size);
+      if (sym.get_st_shndx() != elfcpp::SHN_UNDEF
+	  || sym.get_st_bind() == elfcpp::STB_LOCAL)
+	continue;
+      unsigned int st_name = sym.get_st_name();
+      if (st_name == 0 || st_name >= strsize)
+	continue;
+      size_t len = strnlen(pnames + st_name, strsize - st_name);
+      names->push_back(std::string(pnames + st_name, len));
+    }
+  return true;
+}
+
 // Read the header of an archive member at OFF.  Fail if something
 // goes wrong.  Return the size of the member.  Set *PNAME to the name
 // of the member.
@@ -793,14 +1123,46 @@ Archive::add_symbols(Symbol_table* symtab, Layout* layout,
   // Track which symbols in the symbol table we've already found to be
   // defined.
 
+  // With an archive symbol cache, including a member can only change
+  // the entries for the symbols the member refers to, so after the
+  // first pass we only look at those entries.  RECHECK holds the
+  // entries still to be looked at in this pass, and NEXT_RECHECK the
+  // entries to look at in the next pass.  They are visited in the same
+  // order as a full scan would visit them, so the same members are
+  // included in the same order.
+  const Archive_symbol_cache* cache = this->symbol_cache_;
+  bool full_scan = true;
+  std::set<unsigned int> recheck;
+  std::set<unsigned int> next_recheck;
+
   char* tmpbuf = NULL;
   size_t tmpbuflen = 0;
   bool added_new_object;
   do
     {
       added_new_object = false;
-      for (size_t i = 0; i < armap_size; ++i)
+      bool scan_all = full_scan;
+      full_scan = (cache == NULL);
+      recheck.swap(next_recheck);
+      next_recheck.clear();
+      size_t next = 0;
+      while (true)
 	{
+	  size_t i;
+	  if (scan_all)
+	    {
+	      if (next >= armap_size)
+		break;
+	      i = next++;
+	    }
+	  else
+	    {
+	      if (recheck.empty())
+		break;
+	      i = *recheck.begin();
+	      recheck.erase(recheck.begin());
+	    }
+
           if (this->armap_checked_[i])
             continue;
 	  if (this->armap_[i].file_offset == last_seen_offset)
@@ -846,6 +1208,10 @@ Archive::add_symbols(Symbol_table* symtab, Layout* layout,
 	    }
 
 	  added_new_object = true;
+
+	  if (cache != NULL)
+	    this->note_included_member(cache, i, scan_all, &full_scan,
+				       &recheck, &next_recheck);
 	}
     }
   while (added_new_object);
@@ -858,6 +1224,57 @@ Archive::add_symbols(Symbol_table* symtab, Layout* layout,
   return true;
 }
 
+// Record that the member defining the archive symbol table entry I was
+// included in the link, using the archive symbol cache CACHE.  Mark
+// the entries of the symbols it defines as checked, and add the
+// entries of the symbols it refers to to *RECHECK if they come after I
+// and to *NEXT_RECHECK if they do not.  If the symbols the member
+// refers to are not known, every entry must be looked at again: set
+// *FULL_SCAN, and if this pass is not SCAN_ALL add the rest of the
+// entries to *RECHECK.
+
+void
+Archive::note_included_member(const Archive_symbol_cache* cache,
+			      unsigned int i, bool scan_all, bool* full_scan,
+			      std::set<unsigned int>* recheck,
+			      std::set<unsigned int>* next_recheck)
+{
+  unsigned int m = cache->member_of_symbol(i);
+  unsigned int first;
+  unsigned int count = cache->defs(m, &first);
+  for (unsigned int j = 0; j < count; ++j)
+    this->armap_checked_[cache->symbol_list(first + j)] = true;
+
+  if (!cache->undefs_known(m))
+    {
+      *full_scan = true;
+      if (!scan_all)
+	{
+	  const unsigned int armap_size = this->armap_.size();
+	  for (unsigned int j = i + 1; j < armap_size; ++j)
+	    if (!this->armap_checked_[j])
+	      recheck->insert(j);
+	}
+      return;
+    }
+
+  count = cache->refs(m, &first);
+  for (unsigned int j = 0; j < count; ++j)
+    {
+      unsigned int k = cache->symbol_list(first + j);
+      if (this->armap_checked_[k])
+	continue;
+      if (k > i)
+	{
+	  // A full scan will reach K later in this pass.
+	  if (!scan_all)
+	    recheck->insert(k);
+	}
+      else
+	next_recheck->insert(k);
+    }
+}
+
 // Return whether the archive includes a member which defines the
 // symbol SYM.
 
@@ -1089,6 +1506,13 @@ Archive::print_stats()
           program_name, Archive::total_members);
   fprintf(stderr, _("%s: loaded archive members: %u\n"),
           program_name, Archive::total_members_loaded);
+  if (parameters->options().user_set_archive_symbol_cache())
+    {
+      fprintf(stderr, _("%s: archive symbol caches read: %u\n"),
+	      program_name, Archive::total_symbol_caches_read);
+      fprintf(stderr, _("%s: archive symbol caches written: %u\n"),
+	      program_name, Archive::total_symbol_caches_written);
+    }
 }
 
 // Add_archive_symbols methods.
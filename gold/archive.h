@@ -23,11 +23,13 @@
 #ifndef GOLD_ARCHIVE_H
 #define GOLD_ARCHIVE_H
 
+#include <set>
 #include <string>
 #include <vector>
 
 #include "fileread.h"
 #include "workqueue.h"
+#include "archive-cache.h"
 
 namespace gold
 {
@@ -165,6 +167,8 @@ class Archive : public Library_base
   Archive(const std::string& name, Input_file* input_file,
           bool is_thin_archive, Dirsearch* dirpath, Task* task);
 
+  ~Archive();
+
   // The length of the magic string at the start of an archive.
   static const int sarmag = 8;
 
@@ -286,6 +290,10 @@ class Archive : public Library_base
   static unsigned int total_members;
   // Number of archive members loaded.
   static unsigned int total_members_loaded;
+  // Number of archive symbol caches read from the cache directory.
+  static unsigned int total_symbol_caches_read;
+  // Number of archive symbol caches built and written.
+  static unsigned int total_symbol_caches_written;
 
   // Get a view into the underlying file.
   const unsigned char*
@@ -297,6 +305,33 @@ class Archive : public Library_base
   void
   read_armap(off_t start, section_size_type size);
 
+  // Set up the archive symbol cache for --archive-symbol-cache.
+  void
+  setup_symbol_cache();
+
+  // Read the symbols of the archive members, and use them to build
+  // the contents of CACHE.  HASHER computes the hash of the archive
+  // contents.
+  void
+  build_symbol_cache(Archive_symbol_cache* cache,
+		     Archive_symbol_cache::Hasher* hasher);
+
+  // Read the names of the undefined symbols of the ELF object at
+  // MEMOFF, which is MEMSIZE bytes long, into *NAMES.  Return false
+  // if the symbol table can not be read.
+  template<int size, bool big_endian>
+  bool
+  read_member_undefs(off_t memoff, off_t memsize,
+		     std::vector<std::string>* names);
+
+  // Record that the member defining the archive symbol table entry I
+  // was included, and note the entries to look at again.
+  void
+  note_included_member(const Archive_symbol_cache* cache, unsigned int i,
+		       bool scan_all, bool* full_scan,
+		       std::set<unsigned int>* recheck,
+		       std::set<unsigned int>* next_recheck);
+
   // Read an archive member header at OFF.  CACHE is whether to cache
   // the file view.  Return the size of the member, and set *PNAME to
   // the name.
@@ -411,6 +446,8 @@ class Archive : public Library_base
   bool no_export_;
   // True if this library has been included as a --whole-archive.
   bool included_all_members_;
+  // The archive symbol cache, if --archive-symbol-cache was used.
+  Archive_symbol_cache* symbol_cache_;
 };
 
 // This class is used to read an archive and pick out the desired
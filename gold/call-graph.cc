@@ -0,0 +1,488 @@
+// call-graph.cc -- order functions using a call graph profile for gold
+
+// Copyright (C) 2023 Free Software Foundation, Inc.
+
+// This file is part of gold.
+
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+// MA 02110-1301, USA.
+
+#include "gold.h"
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <fstream>
+
+#include "elfcpp.h"
+#include "fileread.h"
+#include "symtab.h"
+#include "object.h"
+#include "call-graph.h"
+
+namespace gold
+{
+
+// Clusters are not grown beyond this size, so that the functions in
+// a cluster share a few pages.
+const uint64_t max_cluster_size = 1024 * 1024;
+
+// A function is not appended to the cluster of its caller if that
+// would reduce the density of the cluster by more than this factor.
+const uint64_t max_density_degradation = 8;
+
+// A cluster of sections, linked in a circular list through the
+// indexes NEXT and PREV.  A cluster which has been merged into
+// another has a size and weight of zero.
+
+struct Call_graph_profile::Cluster
+{
+  Cluster(int index, uint64_t size)
+    : next(index), prev(index), size(size), weight(0), initial_weight(0),
+      best_pred(-1), best_pred_weight(0)
+  { }
+
+  // The number of calls per byte of code.
+  double
+  density() const
+  {
+    if (this->size == 0)
+      return 0;
+    return static_cast<double>(this->weight) / this->size;
+  }
+
+  int next;
+  int prev;
+  // The total size of the sections in the cluster.
+  uint64_t size;
+  // The total number of calls to the sections in the cluster.
+  uint64_t weight;
+  // The number of calls to the first section of the cluster.
+  uint64_t initial_weight;
+  // The section which calls the first section most often, or -1.
+  int best_pred;
+  // The number of calls from BEST_PRED.
+  uint64_t best_pred_weight;
+};
+
+// Split LINE into tokens separated by white space.
+
+static void
+split_line(const std::string& line, std::vector<std::string>* tokens)
+{
+  tokens->clear();
+  size_t pos = 0;
+  while (true)
+    {
+      pos = line.find_first_not_of(" \t\r\f\v", pos);
+      if (pos == std::string::npos)
+	break;
+      size_t end = line.find_first_of(" \t\r\f\v", pos);
+      if (end == std::string::npos)
+	end = line.length();
+      tokens->push_back(line.substr(pos, end - pos));
+      pos = end;
+    }
+}
+
+// Return whether TOKEN is one of the numeric columns of a gprof call
+// graph, such as "0.00", "12", "3+4" or "1/10".
+
+static bool
+is_gprof_number(const std::string& token)
+{
+  return (!token.empty()
+	  && token.find_first_not_of("0123456789.+/") == std::string::npos);
+}
+
+// Return the function name in TOKENS, a line of a gprof call graph
+// which has been split into tokens.  The name follows the numeric
+// columns and precedes the "[N]" index, and may be followed by
+// "<cycle N>".  Set *CALLS to the number of calls from the first
+// "N/M" column, or 0 if there is none.  Return an empty string if the
+// line does not name a function.
+
+static std::string
+gprof_function_name(const std::vector<std::string>& tokens,
+		    uint64_t* calls)
+{
+  *calls = 0;
+  if (tokens.size() < 2)
+    return "";
+  const std::string& last = tokens.back();
+  if (last.length() < 3
+      || last[0] != '['
+      || last[last.length() - 1] != ']')
+    return "";
+
+  size_t first = 0;
+  if (tokens[0][0] == '[')
+    ++first;
+  while (first < tokens.size() - 1 && is_gprof_number(tokens[first]))
+    {
+      size_t slash = tokens[first].find('/');
+      if (slash != std::string::npos && *calls == 0)
+	*calls = strtoull(tokens[first].c_str(), NULL, 10);
+      ++first;
+    }
+
+  size_t end = tokens.size() - 1;
+  if (end >= first + 3
+      && tokens[end - 2] == "<cycle"
+      && tokens[end - 1][tokens[end - 1].length() - 1] == '>')
+    end -= 2;
+  if (first >= end)
+    return "";
+
+  // C++ names printed without --no-demangle may contain spaces.
+  std::string name(tokens[first]);
+  for (size_t i = first + 1; i < end; ++i)
+    name += " " + tokens[i];
+
+  // Skip "<spontaneous>" and "<cycle N as a whole>".
+  if (name[0] == '<')
+    return "";
+  return name;
+}
+
+// Read the call graph printed by gprof.  Each entry of the graph is
+// a primary line, which starts with "[N]" and names a function, after
+// the lines naming its callers and before the lines naming its
+// callees.  The entries are separated by lines of dashes.  We record
+// an edge for each caller line, with the number of calls from that
+// caller.
+
+void
+Call_graph_profile::read_gprof_call_graph(
+    const std::vector<std::string>& lines,
+    size_t start)
+{
+  std::vector<std::string> tokens;
+  std::vector<std::pair<std::string, uint64_t> > callers;
+  bool seen_primary = false;
+  for (size_t i = start; i < lines.size(); ++i)
+    {
+      const std::string& line(lines[i]);
+
+      // The index of function names follows the graph.
+      if (line.find('\f') != std::string::npos
+	  || line.find("Index by function name") != std::string::npos)
+	break;
+
+      if (line.compare(0, 3, "---") == 0)
+	{
+	  callers.clear();
+	  seen_primary = false;
+	  continue;
+	}
+
+      split_line(line, &tokens);
+      uint64_t calls;
+      std::string name(gprof_function_name(tokens, &calls));
+      if (!tokens.empty() && tokens[0][0] == '[')
+	{
+	  seen_primary = true;
+	  if (name.empty())
+	    continue;
+	  for (size_t j = 0; j < callers.size(); ++j)
+	    this->edges_.push_back(Edge(callers[j].first, name,
+					callers[j].second));
+	}
+      else if (!seen_primary && !name.empty() && calls > 0)
+	callers.push_back(std::make_pair(name, calls));
+    }
+}
+
+// Read a list of edges.
+
+void
+Call_graph_profile::read_edge_list(const std::vector<std::string>& lines,
+				   const char* filename)
+{
+  std::vector<std::string> tokens;
+  for (size_t i = 0; i < lines.size(); ++i)
+    {
+      split_line(lines[i], &tokens);
+      if (tokens.empty() || tokens[0][0] == '#')
+	continue;
+
+      char* end;
+      uint64_t weight = 0;
+      if (tokens.size() == 3)
+	weight = strtoull(tokens[2].c_str(), &end, 10);
+      if (tokens.size() != 3 || *end != '\0')
+	{
+	  gold_error(_("%s:%zu: expected CALLER CALLEE COUNT"),
+		     filename, i + 1);
+	  continue;
+	}
+      this->edges_.push_back(Edge(tokens[0], tokens[1], weight));
+    }
+}
+
+// Read the profile from FILENAME.
+
+void
+Call_graph_profile::read(const char* filename)
+{
+  std::ifstream in;
+  in.open(filename);
+  if (!in)
+    gold_fatal(_("unable to open --call-graph-profile file %s: %s"),
+	       filename, strerror(errno));
+
+  File_read::record_file_read(filename);
+
+  std::vector<std::string> lines;
+  std::string line;
+  size_t gprof_start = 0;
+  while (std::getline(in, line))
+    {
+      lines.push_back(line);
+      if (gprof_start == 0
+	  && line.find("index % time") != std::string::npos)
+	gprof_start = lines.size();
+    }
+
+  if (gprof_start != 0)
+    this->read_gprof_call_graph(lines, gprof_start);
+  else
+    this->read_edge_list(lines, filename);
+}
+
+// Return the section which defines the function NAME.
+
+Section_id
+Call_graph_profile::function_section(const Symbol_table* symtab,
+				     const char* name)
+{
+  Symbol* sym = symtab->lookup(name);
+  if (sym == NULL)
+    return Section_id(NULL, 0);
+  if (sym->is_forwarder())
+    sym = symtab->resolve_forwards(sym);
+
+  if (sym->source() != Symbol::FROM_OBJECT
+      || sym->object()->is_dynamic()
+      || sym->object()->pluginobj() != NULL)
+    return Section_id(NULL, 0);
+
+  bool is_ordinary;
+  unsigned int shndx = sym->shndx(&is_ordinary);
+  if (!is_ordinary || shndx == elfcpp::SHN_UNDEF)
+    return Section_id(NULL, 0);
+
+  return Section_id(static_cast<Relobj*>(sym->object()), shndx);
+}
+
+// Add the section SECN to the graph.
+
+int
+Call_graph_profile::find_or_add_node(const Task* task, Section_id secn,
+				     std::map<Section_id, int>* nodes,
+				     std::vector<Section_id>* sections,
+				     std::vector<Cluster>* clusters)
+{
+  std::map<Section_id, int>::const_iterator p = nodes->find(secn);
+  if (p != nodes->end())
+    return p->second;
+
+  int index = -1;
+  Relobj* relobj = secn.first;
+  unsigned int shndx = secn.second;
+  if (relobj->is_section_included(shndx))
+    {
+      uint64_t flags;
+      uint64_t size;
+      {
+	Task_lock_obj<Object> tl(task, relobj);
+	flags = relobj->section_flags(shndx);
+	size = relobj->section_size(shndx);
+      }
+      if ((flags & elfcpp::SHF_EXECINSTR) != 0)
+	{
+	  index = clusters->size();
+	  sections->push_back(secn);
+	  clusters->push_back(Cluster(index, size));
+	}
+    }
+  (*nodes)[secn] = index;
+  return index;
+}
+
+// Sort clusters by decreasing density.  The sort must be stable so
+// that the order does not depend on the sort implementation.
+
+class Cluster_density_compare
+{
+ public:
+  Cluster_density_compare(const std::vector<double>& density)
+    : density_(density)
+  { }
+
+  bool
+  operator()(int a, int b) const
+  { return this->density_[a] > this->density_[b]; }
+
+ private:
+  const std::vector<double>& density_;
+};
+
+// Return the leader of the cluster containing section INDEX.
+
+static int
+cluster_leader(std::vector<int>* leaders, int index)
+{
+  while ((*leaders)[index] != index)
+    {
+      (*leaders)[index] = (*leaders)[(*leaders)[index]];
+      index = (*leaders)[index];
+    }
+  return index;
+}
+
+// Compute the order of the sections in the profile.
+
+void
+Call_graph_profile::compute_order(const Task* task,
+				  const Symbol_table* symtab,
+				  Section_order* order) const
+{
+  std::map<Section_id, int> nodes;
+  std::vector<Section_id> sections;
+  std::vector<Cluster> clusters;
+
+  for (std::vector<Edge>::const_iterator p = this->edges_.begin();
+       p != this->edges_.end();
+       ++p)
+    {
+      Section_id from_secn = function_section(symtab, p->caller.c_str());
+      Section_id to_secn = function_section(symtab, p->callee.c_str());
+      if (from_secn.first == NULL || to_secn.first == NULL)
+	continue;
+
+      // Sections in different output sections can't be placed
+      // together.
+      if (from_secn.first->output_section(from_secn.second)
+	  != to_secn.first->output_section(to_secn.second))
+	continue;
+
+      int from = find_or_add_node(task, from_secn, &nodes, &sections,
+				  &clusters);
+      int to = find_or_add_node(task, to_secn, &nodes, &sections,
+				&clusters);
+      if (from < 0 || to < 0)
+	continue;
+
+      Cluster& to_cluster(clusters[to]);
+      to_cluster.weight += p->weight;
+      if (from == to)
+	continue;
+      if (to_cluster.best_pred < 0
+	  || to_cluster.best_pred_weight < p->weight)
+	{
+	  to_cluster.best_pred = from;
+	  to_cluster.best_pred_weight = p->weight;
+	}
+    }
+
+  if (clusters.empty())
+    return;
+
+  const int count = clusters.size();
+  std::vector<double> density(count);
+  std::vector<int> sorted(count);
+  std::vector<int> leaders(count);
+  for (int i = 0; i < count; ++i)
+    {
+      clusters[i].initial_weight = clusters[i].weight;
+      density[i] = clusters[i].density();
+      sorted[i] = i;
+      leaders[i] = i;
+    }
+
+  // Visit the sections from the densest, and append each to the
+  // cluster of its most frequent caller.
+  std::stable_sort(sorted.begin(), sorted.end(),
+		   Cluster_density_compare(density));
+  for (int i = 0; i < count; ++i)
+    {
+      int l = sorted[i];
+      Cluster& c(clusters[l]);
+
+      // Skip sections whose most frequent caller accounts for few of
+      // their calls.
+      if (c.best_pred < 0 || c.best_pred_weight * 10 <= c.initial_weight)
+	continue;
+
+      int pred_l = cluster_leader(&leaders, c.best_pred);
+      if (l == pred_l)
+	continue;
+      Cluster& pred(clusters[pred_l]);
+      if (c.size + pred.size > max_cluster_size)
+	continue;
+
+      // Don't merge if it would make the cluster of the caller much
+      // less dense.
+      double new_density = (static_cast<double>(pred.weight + c.weight)
+			    / (pred.size + c.size));
+      if (new_density < pred.density() / max_density_degradation)
+	continue;
+
+      // Append the list of C to the list of PRED.
+      leaders[l] = pred_l;
+      int pred_tail = pred.prev;
+      int c_tail = c.prev;
+      pred.prev = c_tail;
+      clusters[c_tail].next = pred_l;
+      c.prev = pred_tail;
+      clusters[pred_tail].next = l;
+      pred.size += c.size;
+      pred.weight += c.weight;
+      c.size = 0;
+      c.weight = 0;
+    }
+
+  // Sort the remaining clusters by density, and assign the order of
+  // their sections.
+  sorted.clear();
+  for (int i = 0; i < count; ++i)
+    {
+      if (leaders[i] == i)
+	{
+	  density[i] = clusters[i].density();
+	  sorted.push_back(i);
+	}
+    }
+  std::stable_sort(sorted.begin(), sorted.end(),
+		   Cluster_density_compare(density));
+
+  unsigned int index = 1;
+  for (std::vector<int>::const_iterator p = sorted.begin();
+       p != sorted.end();
+       ++p)
+    {
+      int i = *p;
+      do
+	{
+	  (*order)[sections[i]] = index++;
+	  i = clusters[i].next;
+	}
+      while (i != *p);
+    }
+}
+
+} // End namespace gold.
@@ -0,0 +1,124 @@
+// call-graph.h -- order functions using a call graph profile for gold
+
+// Copyright (C) 2023 Free Software Foundation, Inc.
+
+// This file is part of gold.
+
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+// MA 02110-1301, USA.
+
+#ifndef GOLD_CALL_GRAPH_H
+#define GOLD_CALL_GRAPH_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "object.h"
+
+namespace gold
+{
+
+class Symbol_table;
+class Task;
+
+// A call graph profile, read from the file named by
+// --call-graph-profile.  The file is either the call graph printed by
+// "gprof --graph --brief --no-demangle", or a list of edges.  In a
+// list of edges, each line names a calling function, a called
+// function and the number of calls, separated by white space, and
+// lines which are empty or start with '#' are ignored.  Other
+// profilers, such as gprofng, can export their caller/callee data in
+// that form.
+
+// The profile is used to order the input sections which contain the
+// functions, so that functions which call each other often are placed
+// near each other.  This reduces instruction cache and TLB misses.
+// The order is computed with the C3 heuristic described in "Optimizing
+// function placement for large-scale data-center applications" by
+// Ottoni and Maher (CGO 2017): each function is appended to the cluster
+// of its most frequent caller, as long as the cluster stays small and
+// dense, and the clusters are then sorted by density.
+
+class Call_graph_profile
+{
+ public:
+  typedef std::map<Section_id, unsigned int> Section_order;
+
+  Call_graph_profile()
+    : edges_()
+  { }
+
+  // Read the profile from FILENAME.
+  void
+  read(const char* filename);
+
+  // Compute the order of the input sections of the functions in the
+  // profile, and store it in ORDER as indexes starting at 1.  TASK is
+  // used to lock the objects while reading their section headers.
+  void
+  compute_order(const Task* task, const Symbol_table* symtab,
+		Section_order* order) const;
+
+ private:
+  // An edge of the call graph.
+  struct Edge
+  {
+    Edge(const std::string& caller, const std::string& callee,
+	 uint64_t weight)
+      : caller(caller), callee(callee), weight(weight)
+    { }
+
+    std::string caller;
+    std::string callee;
+    uint64_t weight;
+  };
+
+  // A cluster of sections which will be placed together.
+  struct Cluster;
+
+  // Return the section which defines the function NAME, or a section
+  // with a NULL object if it is not a function in an input object.
+  static Section_id
+  function_section(const Symbol_table*, const char* name);
+
+  // Add the section SECN to the graph if it is not already there, and
+  // return its index.  Return -1 if the section is not code or is
+  // not included in the link.
+  static int
+  find_or_add_node(const Task*, Section_id secn,
+		   std::map<Section_id, int>* nodes,
+		   std::vector<Section_id>* sections,
+		   std::vector<Cluster>* clusters);
+
+  // Read the call graph printed by gprof, starting after its header
+  // line at index START of LINES, into edges_.
+  void
+  read_gprof_call_graph(const std::vector<std::string>& lines,
+			size_t start);
+
+  // Read a list of edges from LINES into edges_.  FILENAME is used in
+  // error messages.
+  void
+  read_edge_list(const std::vector<std::string>& lines,
+		 const char* filename);
+
+  // The edges of the call graph, in the order they were read.
+  std::vector<Edge> edges_;
+};
+
+} // End namespace gold.
+
+#endif // !defined(GOLD_CALL_GRAPH_H)
@@ -744,7 +744,7 @@ Dwarf_pubnames_table::read_header(off_t offset)
 // Read the next name from the set.
 
 const char*
-Dwarf_pubnames_table::next_name(uint8_t* flag_byte)
+Dwarf_pubnames_table::next_name(uint8_t* flag_byte, off_t* die_offset)
 {
   const unsigned char* pinfo = this->pinfo_;
 
@@ -753,11 +753,14 @@ Dwarf_pubnames_table::next_name(uint8_t* flag_byte)
   if (pinfo + this->offset_size_ >= this->end_of_table_)
     return NULL;
 
-  // Skip the offset within the CU.  If this is zero, but we're not
+  // Read the offset within the CU.  If this is zero, but we're not
   // at the end of the table, then we have a real pubnames entry
-  // whose DIE offset is 0 (likely to be a GCC bug).  Since we
-  // don't actually use the DIE offset in building .gdb_index,
-  // it's harmless.
+  // whose DIE offset is 0 (likely to be a GCC bug).  The DIE offset
+  // is only used in .debug_names, so it's harmless.
+  if (this->offset_size_ == 4)
+    *die_offset = this->dwinfo_->read_from_pointer<32>(pinfo);
+  else
+    *die_offset = this->dwinfo_->read_from_pointer<64>(pinfo);
   pinfo += this->offset_size_;
 
   if (this->is_gnu_style_)
@@ -442,10 +442,17 @@ class Dwarf_pubnames_table
   subsection_size()
   { return this->unit_length_; }
 
+  // Return whether this is a gnu-style table, which has the kind of
+  // each name.
+  bool
+  is_gnu_style() const
+  { return this->is_gnu_style_; }
+
   // Read the next name from the set.  If the pubname table is gnu-style,
   // FLAG_BYTE is set to the high-byte of a gdb_index version 7 cu_index.
+  // DIE_OFFSET is set to the offset of the DIE within the CU.
   const char*
-  next_name(uint8_t* flag_byte);
+  next_name(uint8_t* flag_byte, off_t* die_offset);
 
  private:
   // The Dwarf_info_reader, for reading data.
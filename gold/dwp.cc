@@ -45,6 +45,8 @@
 #include "compressed_output.h"
 #include "stringpool.h"
 #include "dwarf_reader.h"
+#include "output.h"
+#include "workqueue.h"
 
 static void
 usage(FILE* fd, int) ATTRIBUTE_NORETURN;
@@ -99,6 +101,29 @@ struct Unit_set
   { }
 };
 
+// A compilation unit or type unit found in an input file, before it
+// is added to the output file.
+
+struct Input_unit
+{
+  // A column of a row of a .dwp index: a DW_SECT value, and the offset
+  // and size of the unit's contribution to that input section.
+  typedef std::pair<unsigned int, Section_bounds> Index_column;
+
+  uint64_t signature;
+  // The offset and size of the unit in its .debug_info.dwo or
+  // .debug_types.dwo section.
+  Section_bounds bounds;
+  // For a unit read from the index of a .dwp file, the contributions
+  // of the unit to the related sections.
+  std::vector<Index_column> columns;
+
+  Input_unit(uint64_t sig, section_offset_type offset, section_size_type size)
+    : signature(sig), bounds(offset, size), columns()
+  { }
+};
+typedef std::vector<Input_unit> Input_unit_list;
+
 // An input file.
 // This class may represent a .dwo file, a .dwp file
 // produced by an earlier run, or an executable file whose
@@ -108,20 +133,40 @@ class Dwo_file
 {
  public:
   Dwo_file(const char* name)
-    : name_(name), obj_(NULL), input_file_(NULL), is_compressed_(),
-      sect_offsets_(), str_offset_map_()
+    : name_(name), obj_(NULL), input_file_(NULL), machine_(0), osabi_(0),
+      abiversion_(0), is_compressed_(), sect_offsets_(), debug_str_(0),
+      unit_groups_(), contributions_(), str_offset_map_()
   { }
 
   ~Dwo_file();
 
+  // Return the filename.
+  const char*
+  name() const
+  { return this->name_; }
+
   // Read the input executable file and extract the list of .dwo files
   // that it references.
   void
   read_executable(File_list* files);
 
-  // Read the input file and send its contents to OUTPUT_FILE.
+  // Read the input file and find the compilation and type units that
+  // it contains.  This may run in parallel for different files.
+  void
+  read();
+
+  // Add the strings and the units found by read() to OUTPUT_FILE, in
+  // the order in which they are found, and close the input file.
+  // This records the contributions of the file to the output sections,
+  // but does not copy their contents.
+  void
+  add_to_output(Dwp_output_file* output_file);
+
+  // Copy the contributions recorded by add_to_output into OUTPUT_FILE,
+  // which must have been opened.  This may run in parallel for
+  // different files.
   void
-  read(Dwp_output_file* output_file);
+  write(Dwp_output_file* output_file);
 
   // Verify a .dwp file given a list of .dwo files referenced by the
   // corresponding executable file.  Returns true if no problems
@@ -144,16 +189,41 @@ class Dwo_file
     { return i1.first < i2.first; }
   };
 
-  // Create a Sized_relobj_dwo of the given size and endianness,
-  // and record the target info.  P is a pointer to the ELF header
-  // in memory.
+  // A set of units found by read() which share the same related
+  // sections: the units in a .debug_info.dwo or .debug_types.dwo
+  // section, or the units listed in the index of a .dwp file.
+  struct Unit_group
+  {
+    bool is_debug_types;
+    bool is_from_index;
+    unsigned int debug_shndx[elfcpp::DW_SECT_MAX + 1];
+    Input_unit_list units;
+  };
+
+  // A contribution of an input section to an output section, recorded
+  // by add_to_output and copied by write().
+  struct Contribution
+  {
+    elfcpp::DW_SECT section_id;
+    unsigned int shndx;
+    section_offset_type input_offset;
+    section_size_type size;
+    section_offset_type output_offset;
+  };
+
+  // Open the input file and create a Sized_relobj_dwo of the
+  // appropriate size and endianness.  Record the target info from
+  // the ELF header.
   Relobj*
-  make_object(Dwp_output_file* output_file);
+  make_object();
 
   template <int size, bool big_endian>
   Relobj*
-  sized_make_object(const unsigned char* p, Input_file* input_file,
-		    Dwp_output_file* output_file);
+  sized_make_object(const unsigned char* p, Input_file* input_file);
+
+  // Close the input file.
+  void
+  close_object();
 
   // Return the number of sections in the input object file.
   unsigned int
@@ -170,6 +240,16 @@ class Dwo_file
   section_name(unsigned int shndx)
   { return this->obj_->section_name(shndx); }
 
+  // Return the size of a section, after decompression.
+  section_size_type
+  section_size(unsigned int shndx)
+  {
+    section_size_type len;
+    if (!this->obj_->section_is_compressed(shndx, &len))
+      len = convert_to_section_size_type(this->obj_->section_size(shndx));
+    return len;
+  }
+
   // Return a view of the contents of a section, decompressed if necessary.
   // Set *PLEN to the size.  Set *IS_NEW to true if the contents need to be
   // deleted by the caller.
@@ -178,15 +258,13 @@ class Dwo_file
   { return this->obj_->decompressed_section_contents(shndx, plen, is_new); }
 
   // Read the .debug_cu_index or .debug_tu_index section of a .dwp file,
-  // and process the CU or TU sets.
+  // and record the CU or TU sets.
   void
-  read_unit_index(unsigned int, unsigned int *, Dwp_output_file*,
-		  bool is_tu_index);
+  read_unit_index(unsigned int, unsigned int *, bool is_tu_index);
 
   template <bool big_endian>
   void
-  sized_read_unit_index(unsigned int, unsigned int *, Dwp_output_file*,
-			bool is_tu_index);
+  sized_read_unit_index(unsigned int, unsigned int *, bool is_tu_index);
 
   // Verify the .debug_cu_index section of a .dwp file, comparing it
   // against the list of .dwo files referenced by the corresponding
@@ -202,29 +280,49 @@ class Dwo_file
   void
   add_strings(Dwp_output_file*, unsigned int);
 
-  // Copy a section from the input file to the output file.
+  // Add the units of a group found by read() to OUTPUT_FILE.
+  void
+  add_unit_group(Dwp_output_file* output_file, const Unit_group& group);
+
+  // Add a section of the input file to the output file, unless it has
+  // already been added.  Return the offset and length of this input
+  // section's contribution in the output section.
   Section_bounds
   copy_section(Dwp_output_file* output_file, unsigned int shndx,
 	       elfcpp::DW_SECT section_id);
 
-  // Remap the string offsets in the .debug_str_offsets.dwo section.
-  const unsigned char*
-  remap_str_offsets(const unsigned char* contents, section_size_type len);
+  // Add a contribution of LEN bytes at INPUT_OFFSET in section SHNDX
+  // to the output section for SECTION_ID, and return its offset in
+  // the output section.
+  section_offset_type
+  add_contribution(Dwp_output_file* output_file, elfcpp::DW_SECT section_id,
+		   unsigned int shndx, section_offset_type input_offset,
+		   section_size_type len);
+
+  // Build the map from input string offsets to output string offsets.
+  void
+  read_str_offset_map(const Dwp_output_file* output_file);
+
+  // Remap the string offsets in the .debug_str_offsets.dwo section
+  // while copying them from CONTENTS to OUT.
+  void
+  remap_str_offsets(const unsigned char* contents, section_size_type len,
+		    unsigned char* out);
 
   template <bool big_endian>
-  const unsigned char*
-  sized_remap_str_offsets(const unsigned char* contents, section_size_type len);
+  void
+  sized_remap_str_offsets(const unsigned char* contents,
+			  section_size_type len, unsigned char* out);
 
   // Remap a single string offsets from an offset in the input string table
   // to an offset in the output string table.
   unsigned int
   remap_str_offset(section_offset_type val);
 
-  // Add a set of .debug_info.dwo or .debug_types.dwo and related sections
-  // to OUTPUT_FILE.
+  // Find the units in a .debug_info.dwo or .debug_types.dwo section,
+  // and record them with the related sections.
   void
-  add_unit_set(Dwp_output_file* output_file, unsigned int *debug_shndx,
-	       bool is_debug_types);
+  read_unit_set(unsigned int *debug_shndx, bool is_debug_types);
 
   // The filename.
   const char* name_;
@@ -232,10 +330,20 @@ class Dwo_file
   Relobj* obj_;
   // The Input_file object.
   Input_file* input_file_;
+  // Target info from the ELF header.
+  int machine_;
+  int osabi_;
+  int abiversion_;
   // Flags indicating which sections are compressed.
   std::vector<bool> is_compressed_;
   // Map input section index onto output section offset and size.
   std::vector<Section_bounds> sect_offsets_;
+  // The index of the .debug_str.dwo section.
+  unsigned int debug_str_;
+  // The units found by read(), until they are added to the output file.
+  std::vector<Unit_group> unit_groups_;
+  // The contributions to the output file.
+  std::vector<Contribution> contributions_;
   // Map input string offsets to output string offsets.
   Str_offset_map str_offset_map_;
 };
@@ -449,10 +557,10 @@ class Dwp_output_file
  public:
   Dwp_output_file(const char* name)
     : name_(name), machine_(0), size_(0), big_endian_(false), osabi_(0),
-      abiversion_(0), fd_(NULL), next_file_offset_(0), shnum_(1), sections_(),
-      section_id_map_(), shoff_(0), shstrndx_(0), have_strings_(false),
-      stringpool_(), shstrtab_(), cu_index_(), tu_index_(), last_type_sig_(0),
-      last_tu_slot_(0)
+      abiversion_(0), output_(NULL), view_(NULL), next_file_offset_(0),
+      shnum_(1), sections_(), section_id_map_(), shoff_(0), shstrndx_(0),
+      have_strings_(false), stringpool_(), shstrtab_(), cu_index_(),
+      tu_index_(), last_type_sig_(0), last_tu_slot_(0)
   {
     this->section_id_map_.resize(elfcpp::DW_SECT_MAX + 1);
     this->stringpool_.set_no_zero_null();
@@ -467,10 +575,18 @@ class Dwp_output_file
   section_offset_type
   add_string(const char* str, size_t len);
 
-  // Add a section to the output file, and return the new section offset.
+  // Return the offset of a string in the debug strings section.  This
+  // may be called concurrently once the output file has been opened.
+  section_offset_type
+  string_offset(const char* str, size_t len) const
+  { return this->stringpool_.get_offset_with_length(str, len); }
+
+  // Add LEN bytes to a section of the output file, and return their
+  // offset in the section.  The contents are copied when the output
+  // file has been opened.
   section_offset_type
-  add_contribution(elfcpp::DW_SECT section_id, const unsigned char* contents,
-		   section_size_type len, int align);
+  add_contribution(elfcpp::DW_SECT section_id, section_size_type len,
+		   int align);
 
   // Add a set of .debug_info and related sections to the output file.
   void
@@ -484,20 +600,22 @@ class Dwp_output_file
   void
   add_tu_set(Unit_set* tu_set);
 
-  // Finalize the file, write the string tables and index sections,
-  // and close the file.
+  // Lay out the file, create it, and write the string tables, index
+  // sections and headers.  The contributions of the input files are
+  // copied into the file afterwards.
   void
-  finalize();
+  open();
 
- private:
-  // Contributions to output sections.
-  struct Contribution
-  {
-    section_offset_type output_offset;
-    section_size_type size;
-    const unsigned char* contents;
-  };
+  // Return a pointer to the contents of the output section for
+  // SECTION_ID in the opened file.
+  unsigned char*
+  section_view(elfcpp::DW_SECT section_id) const;
 
+  // Close the file.
+  void
+  close();
+
+ private:
   // Sections in the output file.
   struct Section
   {
@@ -505,10 +623,11 @@ class Dwp_output_file
     off_t offset;
     section_size_type size;
     int align;
-    std::vector<Contribution> contributions;
+    // The contents of a section created by add_new_section.
+    unsigned char* contents;
 
     Section(const char* n, int a)
-      : name(n), offset(0), size(0), align(a), contributions()
+      : name(n), offset(0), size(0), align(a), contents(NULL)
     { }
   };
 
@@ -605,10 +724,11 @@ class Dwp_output_file
   unsigned int
   add_output_section(const char* section_name, int align);
 
-  // Write a new section to the output file.
+  // Add a new section with the given contents, which the output file
+  // takes ownership of, after the sections laid out so far.
   void
-  write_new_section(const char* section_name, const unsigned char* contents,
-		    section_size_type len, int align);
+  add_new_section(const char* section_name, unsigned char* contents,
+		  section_size_type len, int align);
 
   // Write the ELF header.
   void
@@ -618,28 +738,25 @@ class Dwp_output_file
   void
   sized_write_ehdr();
 
-  // Write a section header.
-  void
-  write_shdr(const char* name, unsigned int type, unsigned int flags,
-	     uint64_t addr, off_t offset, section_size_type sect_size,
-	     unsigned int link, unsigned int info,
-	     unsigned int align, unsigned int ent_size);
+  // Write a section header at POV, and return the position after it.
+  unsigned char*
+  write_shdr(unsigned char* pov, const char* name, unsigned int type,
+	     unsigned int flags, uint64_t addr, off_t offset,
+	     section_size_type sect_size, unsigned int link,
+	     unsigned int info, unsigned int align, unsigned int ent_size);
 
   template<unsigned int size, bool big_endian>
-  void
-  sized_write_shdr(const char* name, unsigned int type, unsigned int flags,
-		   uint64_t addr, off_t offset, section_size_type sect_size,
-		   unsigned int link, unsigned int info,
-		   unsigned int align, unsigned int ent_size);
-
-  // Write the contributions to an output section.
-  void
-  write_contributions(const Section& sect);
-
-  // Write a CU or TU index section.
+  unsigned char*
+  sized_write_shdr(unsigned char* pov, const char* name, unsigned int type,
+		   unsigned int flags, uint64_t addr, off_t offset,
+		   section_size_type sect_size, unsigned int link,
+		   unsigned int info, unsigned int align,
+		   unsigned int ent_size);
+
+  // Build a CU or TU index section.
   template<bool big_endian>
   void
-  write_index(const char* sect_name, const Dwp_index& index);
+  make_index(const char* sect_name, const Dwp_index& index);
 
   // The output filename.
   const char* name_;
@@ -649,8 +766,10 @@ class Dwp_output_file
   int big_endian_;
   int osabi_;
   int abiversion_;
-  // The output file descriptor.
-  FILE* fd_;
+  // The output file, once it has been opened.
+  Output_file* output_;
+  // The contents of the output file.
+  unsigned char* view_;
   // Next available file offset.
   off_t next_file_offset_;
   // The number of sections.
@@ -711,23 +830,23 @@ class Dwo_name_info_reader : public Dwarf_info_reader
   File_list* files_;
 };
 
-// A specialization of Dwarf_info_reader, for reading DWARF CUs and TUs
-// and adding them to the output file.
+// A specialization of Dwarf_info_reader, for finding the DWARF CUs
+// and TUs in a section.
 
 class Unit_reader : public Dwarf_info_reader
 {
  public:
   Unit_reader(bool is_type_unit, Relobj* object, unsigned int shndx)
     : Dwarf_info_reader(is_type_unit, object, NULL, 0, shndx, 0, 0),
-      output_file_(NULL), sections_(NULL)
+      units_(NULL)
   { }
 
   ~Unit_reader()
   { }
 
-  // Read the CUs or TUs and add them to the output file.
+  // Read the CUs or TUs and add them to UNITS.
   void
-  add_units(Dwp_output_file*, unsigned int debug_abbrev, Section_bounds*);
+  read_units(unsigned int debug_abbrev, Input_unit_list* units);
 
  protected:
   // Visit a compilation unit.
@@ -740,8 +859,51 @@ class Unit_reader : public Dwarf_info_reader
 		  uint64_t signature, Dwarf_die*);
 
  private:
+  // The list of units to populate.
+  Input_unit_list* units_;
+};
+
+// This class reads the input files and writes them to the output
+// file.  The input files are read in parallel, but each one is added
+// to the output file in turn, so that the output file does not depend
+// on the order in which the files were read.  Once all the files have
+// been added, the output file is laid out, and the contents of the
+// input files are copied into it in parallel.
+
+class Dwp_packager
+{
+ public:
+  // At most MAX_OPEN_FILES input files will be open at once while
+  // they are read.
+  Dwp_packager(const File_list& files, Dwp_output_file* output_file,
+	       unsigned int max_open_files, bool verbose);
+
+  ~Dwp_packager();
+
+  // Queue the initial tasks.
+  void
+  queue_tasks(Workqueue*);
+
+  // Add input file INDEX to the output file.  This is called by
+  // Dwo_add_task.
+  void
+  add_file(Workqueue*, unsigned int index);
+
+ private:
+  // Queue a task to read input file INDEX.
+  void
+  queue_read_task(Workqueue*, unsigned int index);
+
+  // The input files.
+  std::vector<Dwo_file*> files_;
+  // The blockers which are released when each input file is read.
+  std::vector<Task_token*> read_blockers_;
+  // The output file.
   Dwp_output_file* output_file_;
-  Section_bounds* sections_;
+  // The number of input files to read ahead.
+  unsigned int max_open_files_;
+  // Whether to print the name of each input file.
+  bool verbose_;
 };
 
 // Return the name of a DWARF .dwo section.
@@ -827,11 +989,21 @@ Sized_relobj_dwo<size, big_endian>::do_section_contents(
 // Class Dwo_file.
 
 Dwo_file::~Dwo_file()
+{
+  this->close_object();
+}
+
+// Close the input file.
+
+void
+Dwo_file::close_object()
 {
   if (this->obj_ != NULL)
     delete this->obj_;
   if (this->input_file_ != NULL)
     delete this->input_file_;
+  this->obj_ = NULL;
+  this->input_file_ = NULL;
 }
 
 // Read the input executable file and extract the list of .dwo files
@@ -840,7 +1012,7 @@ Dwo_file::~Dwo_file()
 void
 Dwo_file::read_executable(File_list* files)
 {
-  this->obj_ = this->make_object(NULL);
+  this->obj_ = this->make_object();
 
   unsigned int shnum = this->shnum();
   this->is_compressed_.resize(shnum);
@@ -880,23 +1052,22 @@ Dwo_file::read_executable(File_list* files)
     }
 }
 
-// Read the input file and send its contents to OUTPUT_FILE.
+// Read the input file and find the units that it contains.  The
+// input file stays open until add_to_output is called.
 
 void
-Dwo_file::read(Dwp_output_file* output_file)
+Dwo_file::read()
 {
-  this->obj_ = this->make_object(output_file);
+  this->obj_ = this->make_object();
 
   unsigned int shnum = this->shnum();
   this->is_compressed_.resize(shnum);
-  this->sect_offsets_.resize(shnum);
 
   typedef std::vector<unsigned int> Types_list;
   Types_list debug_types;
   unsigned int debug_shndx[elfcpp::DW_SECT_MAX + 1];
   for (unsigned int i = 0; i <= elfcpp::DW_SECT_MAX; i++)
     debug_shndx[i] = 0;
-  unsigned int debug_str = 0;
   unsigned int debug_cu_index = 0;
   unsigned int debug_tu_index = 0;
 
@@ -928,7 +1099,7 @@ Dwo_file::read(Dwp_output_file* output_file)
       else if (strcmp(suffix, "loc.dwo") == 0)
 	debug_shndx[elfcpp::DW_SECT_LOC] = i;
       else if (strcmp(suffix, "str.dwo") == 0)
-	debug_str = i;
+	this->debug_str_ = i;
       else if (strcmp(suffix, "str_offsets.dwo") == 0)
 	debug_shndx[elfcpp::DW_SECT_STR_OFFSETS] = i;
       else if (strcmp(suffix, "macinfo.dwo") == 0)
@@ -941,15 +1112,12 @@ Dwo_file::read(Dwp_output_file* output_file)
 	debug_tu_index = i;
     }
 
-  // Merge the input string table into the output string table.
-  this->add_strings(output_file, debug_str);
-
-  // If we found any .dwp index sections, read those and add the section
-  // sets to the output file.
+  // If we found any .dwp index sections, read those and record the
+  // section sets.
   if (debug_cu_index > 0 || debug_tu_index > 0)
     {
       if (debug_cu_index > 0)
-	this->read_unit_index(debug_cu_index, debug_shndx, output_file, false);
+	this->read_unit_index(debug_cu_index, debug_shndx, false);
       if (debug_tu_index > 0)
         {
 	  if (debug_types.size() > 1)
@@ -959,14 +1127,14 @@ Dwo_file::read(Dwp_output_file* output_file)
             debug_shndx[elfcpp::DW_SECT_TYPES] = debug_types[0];
           else
             debug_shndx[elfcpp::DW_SECT_TYPES] = 0;
-	  this->read_unit_index(debug_tu_index, debug_shndx, output_file, true);
+	  this->read_unit_index(debug_tu_index, debug_shndx, true);
 	}
       return;
     }
 
   // If we found no index sections, this is a .dwo file.
   if (debug_shndx[elfcpp::DW_SECT_INFO] > 0)
-    this->add_unit_set(output_file, debug_shndx, false);
+    this->read_unit_set(debug_shndx, false);
 
   debug_shndx[elfcpp::DW_SECT_INFO] = 0;
   for (Types_list::const_iterator tp = debug_types.begin();
@@ -974,10 +1142,95 @@ Dwo_file::read(Dwp_output_file* output_file)
        ++tp)
     {
       debug_shndx[elfcpp::DW_SECT_TYPES] = *tp;
-      this->add_unit_set(output_file, debug_shndx, true);
+      this->read_unit_set(debug_shndx, true);
     }
 }
 
+// Add the strings and units found by read() to OUTPUT_FILE.  This
+// must be called for each input file in turn, so that the layout of
+// the output file does not depend on the order in which the files
+// were read.
+
+void
+Dwo_file::add_to_output(Dwp_output_file* output_file)
+{
+  output_file->record_target_info(this->name_, this->machine_,
+				  this->obj_->elfsize(),
+				  this->obj_->is_big_endian(),
+				  this->osabi_, this->abiversion_);
+
+  this->sect_offsets_.resize(this->shnum());
+
+  // Merge the input string table into the output string table.
+  this->add_strings(output_file, this->debug_str_);
+
+  for (unsigned int i = 0; i < this->unit_groups_.size(); ++i)
+    this->add_unit_group(output_file, this->unit_groups_[i]);
+
+  // We reopen the file to copy the contributions once the output file
+  // has been laid out.  Release everything else now, so that we only
+  // keep a few input files open at once.
+  std::vector<Unit_group>().swap(this->unit_groups_);
+  std::vector<Section_bounds>().swap(this->sect_offsets_);
+  std::vector<bool>().swap(this->is_compressed_);
+  this->close_object();
+}
+
+// Copy the contributions of this file into OUTPUT_FILE, straight from
+// the views of the input sections.
+
+void
+Dwo_file::write(Dwp_output_file* output_file)
+{
+  if (this->contributions_.empty())
+    return;
+
+  this->obj_ = this->make_object();
+
+  unsigned int shnum = this->shnum();
+  std::vector<const unsigned char*> views(shnum);
+  std::vector<section_size_type> lens(shnum);
+  std::vector<bool> views_are_new(shnum);
+
+  for (unsigned int i = 0; i < this->contributions_.size(); ++i)
+    {
+      const Contribution& c = this->contributions_[i];
+      if (views[c.shndx] == NULL)
+	{
+	  bool is_new;
+	  views[c.shndx] = this->section_contents(c.shndx, &lens[c.shndx],
+						  &is_new);
+	  views_are_new[c.shndx] = is_new;
+	}
+
+      if (c.input_offset < 0
+	  || static_cast<section_size_type>(c.input_offset) > lens[c.shndx]
+	  || c.size > lens[c.shndx] - c.input_offset)
+	gold_fatal(_("%s: section %s is corrupt"), this->name_,
+		   this->section_name(c.shndx).c_str());
+
+      const unsigned char* contents = views[c.shndx] + c.input_offset;
+      unsigned char* out = (output_file->section_view(c.section_id)
+			    + c.output_offset);
+      if (c.section_id == elfcpp::DW_SECT_STR_OFFSETS)
+	{
+	  if (this->str_offset_map_.empty())
+	    this->read_str_offset_map(output_file);
+	  this->remap_str_offsets(contents, c.size, out);
+	}
+      else
+	memcpy(out, contents, c.size);
+    }
+
+  for (unsigned int i = 0; i < shnum; ++i)
+    if (views_are_new[i])
+      delete[] views[i];
+
+  std::vector<Contribution>().swap(this->contributions_);
+  Str_offset_map().swap(this->str_offset_map_);
+  this->close_object();
+}
+
 // Verify a .dwp file given a list of .dwo files referenced by the
 // corresponding executable file.  Returns true if no problems
 // were found.
@@ -985,7 +1238,7 @@ Dwo_file::read(Dwp_output_file* output_file)
 bool
 Dwo_file::verify(const File_list& files)
 {
-  this->obj_ = this->make_object(NULL);
+  this->obj_ = this->make_object();
 
   unsigned int shnum = this->shnum();
   this->is_compressed_.resize(shnum);
@@ -1024,7 +1277,7 @@ Dwo_file::verify(const File_list& files)
 // and record the target info.
 
 Relobj*
-Dwo_file::make_object(Dwp_output_file* output_file)
+Dwo_file::make_object()
 {
   // Open the input file.
   Input_file* input_file = new Input_file(this->name_);
@@ -1045,8 +1298,8 @@ Dwo_file::make_object(Dwp_output_file* output_file)
     gold_fatal(_("%s: not an ELF object file"), this->name_);
   
   // Get the size, endianness, machine, etc. info from the header,
-  // make an appropriately-sized Relobj, and pass the target info
-  // to the output object.
+  // make an appropriately-sized Relobj, and record the target info
+  // for the output file.
   int size;
   bool big_endian;
   std::string error;
@@ -1058,15 +1311,13 @@ Dwo_file::make_object(Dwp_output_file* output_file)
     {
       if (big_endian)
 #ifdef HAVE_TARGET_32_BIG
-	return this->sized_make_object<32, true>(elf_header, input_file,
-						 output_file);
+	return this->sized_make_object<32, true>(elf_header, input_file);
 #else
 	gold_unreachable();
 #endif
       else
 #ifdef HAVE_TARGET_32_LITTLE
-	return this->sized_make_object<32, false>(elf_header, input_file,
-						  output_file);
+	return this->sized_make_object<32, false>(elf_header, input_file);
 #else
 	gold_unreachable();
 #endif
@@ -1075,15 +1326,13 @@ Dwo_file::make_object(Dwp_output_file* output_file)
     {
       if (big_endian)
 #ifdef HAVE_TARGET_64_BIG
-	return this->sized_make_object<64, true>(elf_header, input_file,
-						 output_file);
+	return this->sized_make_object<64, true>(elf_header, input_file);
 #else
 	gold_unreachable();
 #endif
       else
 #ifdef HAVE_TARGET_64_LITTLE
-	return this->sized_make_object<64, false>(elf_header, input_file,
-						  output_file);
+	return this->sized_make_object<64, false>(elf_header, input_file);
 #else
 	gold_unreachable();
 #endif
@@ -1097,41 +1346,35 @@ Dwo_file::make_object(Dwp_output_file* output_file)
 
 template <int size, bool big_endian>
 Relobj*
-Dwo_file::sized_make_object(const unsigned char* p, Input_file* input_file,
-			    Dwp_output_file* output_file)
+Dwo_file::sized_make_object(const unsigned char* p, Input_file* input_file)
 {
   elfcpp::Ehdr<size, big_endian> ehdr(p);
   Sized_relobj_dwo<size, big_endian>* obj =
       new Sized_relobj_dwo<size, big_endian>(this->name_, input_file, ehdr);
   obj->setup();
-  if (output_file != NULL)
-    output_file->record_target_info(
-	this->name_, ehdr.get_e_machine(), size, big_endian,
-	ehdr.get_ei_osabi(),
-	ehdr.get_ei_abiversion());
+  this->machine_ = ehdr.get_e_machine();
+  this->osabi_ = ehdr.get_ei_osabi();
+  this->abiversion_ = ehdr.get_ei_abiversion();
   return obj;
 }
 
 // Read the .debug_cu_index or .debug_tu_index section of a .dwp file,
-// and process the CU or TU sets.
+// and record the CU or TU sets.
 
 void
 Dwo_file::read_unit_index(unsigned int shndx, unsigned int *debug_shndx,
-			  Dwp_output_file* output_file, bool is_tu_index)
+			  bool is_tu_index)
 {
   if (this->obj_->is_big_endian())
-    this->sized_read_unit_index<true>(shndx, debug_shndx, output_file,
-				      is_tu_index);
+    this->sized_read_unit_index<true>(shndx, debug_shndx, is_tu_index);
   else
-    this->sized_read_unit_index<false>(shndx, debug_shndx, output_file,
-				       is_tu_index);
+    this->sized_read_unit_index<false>(shndx, debug_shndx, is_tu_index);
 }
 
 template <bool big_endian>
 void
 Dwo_file::sized_read_unit_index(unsigned int shndx,
 				unsigned int *debug_shndx,
-				Dwp_output_file* output_file,
 				bool is_tu_index)
 {
   elfcpp::DW_SECT info_sect = (is_tu_index
@@ -1182,20 +1425,14 @@ Dwo_file::sized_read_unit_index(unsigned int shndx,
     gold_fatal(_("%s: section %s is corrupt"), this->name_,
 	       this->section_name(shndx).c_str());
 
-  // Copy the related sections and track the section offsets and sizes.
-  Section_bounds sections[elfcpp::DW_SECT_MAX + 1];
-  for (int i = elfcpp::DW_SECT_ABBREV; i <= elfcpp::DW_SECT_MAX; ++i)
-    {
-      if (debug_shndx[i] > 0)
-	sections[i] = this->copy_section(output_file, debug_shndx[i],
-					 static_cast<elfcpp::DW_SECT>(i));
-    }
-
-  // Get the contents of the .debug_info.dwo or .debug_types.dwo section.
-  section_size_type info_len;
-  bool info_is_new;
-  const unsigned char* info_contents =
-      this->section_contents(info_shndx, &info_len, &info_is_new);
+  // The related sections are copied as a whole, and the contributions
+  // of each unit are located within them.
+  this->unit_groups_.push_back(Unit_group());
+  Unit_group& group(this->unit_groups_.back());
+  group.is_debug_types = is_tu_index;
+  group.is_from_index = true;
+  for (unsigned int i = 0; i <= elfcpp::DW_SECT_MAX; ++i)
+    group.debug_shndx[i] = debug_shndx[i];
 
   // Loop over the slots of the hash table.
   for (unsigned int i = 0; i < nslots; ++i)
@@ -1204,18 +1441,17 @@ Dwo_file::sized_read_unit_index(unsigned int shndx,
           elfcpp::Swap_unaligned<64, big_endian>::readval(phash);
       unsigned int index =
 	  elfcpp::Swap_unaligned<32, big_endian>::readval(pindex);
-      if (index != 0 && (!is_tu_index || !output_file->lookup_tu(signature)))
+      if (index != 0)
 	{
-	  Unit_set* unit_set = new Unit_set();
-	  unit_set->signature = signature;
+	  Input_unit unit(signature, 0, 0);
 	  const unsigned char* pch = pcolhdrs;
 	  const unsigned char* porow =
 	      poffsets + (index - 1) * ncols * sizeof(uint32_t);
 	  const unsigned char* psrow =
 	      psizes + (index - 1) * ncols * sizeof(uint32_t);
 
-	  // Adjust the offset of each contribution within the input section
-	  // by the offset of the input section within the output section.
+	  // Record the offset of each contribution within the input
+	  // section.
 	  for (unsigned int j = 0; j <= ncols; j++)
 	    {
 	      unsigned int dw_sect =
@@ -1224,35 +1460,16 @@ Dwo_file::sized_read_unit_index(unsigned int shndx,
 		  elfcpp::Swap_unaligned<64, big_endian>::readval(porow);
 	      unsigned int size =
 		  elfcpp::Swap_unaligned<64, big_endian>::readval(psrow);
-	      unit_set->sections[dw_sect].offset = (sections[dw_sect].offset
-						    + offset);
-	      unit_set->sections[dw_sect].size = size;
+	      unit.columns.push_back(
+		  std::make_pair(dw_sect, Section_bounds(offset, size)));
+	      if (dw_sect == static_cast<unsigned int>(info_sect))
+		unit.bounds = Section_bounds(offset, size);
 	      pch += sizeof(uint32_t);
 	      porow += sizeof(uint32_t);
 	      psrow += sizeof(uint32_t);
 	    }
 
-	  const unsigned char* unit_start =
-	      info_contents + unit_set->sections[info_sect].offset;
-	  section_size_type unit_length = unit_set->sections[info_sect].size;
-
-	  // Dwp_output_file::add_contribution writes the .debug_info.dwo
-	  // section directly to the output file, so we only need to
-	  // duplicate contributions for .debug_types.dwo section.
-	  if (is_tu_index)
-	    {
-	      unsigned char *copy = new unsigned char[unit_length];
-	      memcpy(copy, unit_start, unit_length);
-	      unit_start = copy;
-	    }
-	  section_offset_type off =
-	      output_file->add_contribution(info_sect, unit_start,
-					    unit_length, 1);
-	  unit_set->sections[info_sect].offset = off;
-	  if (is_tu_index)
-	    output_file->add_tu_set(unit_set);
-	  else
-	    output_file->add_cu_set(unit_set);
+	  group.units.push_back(unit);
 	}
       phash += sizeof(uint64_t);
       pindex += sizeof(uint32_t);
@@ -1260,8 +1477,6 @@ Dwo_file::sized_read_unit_index(unsigned int shndx,
 
   if (index_is_new)
     delete[] contents;
-  if (info_is_new)
-    delete[] info_contents;
 }
 
 // Verify the .debug_cu_index section of a .dwp file, comparing it
@@ -1378,34 +1593,85 @@ Dwo_file::add_strings(Dwp_output_file* output_file, unsigned int debug_str)
 	       this->name_,
 	       this->section_name(debug_str).c_str());
 
-  // Count the number of strings in the section, and size the map.
-  size_t count = 0;
-  for (const char* pt = p; pt < pend; pt += strlen(pt) + 1)
-    ++count;
-  this->str_offset_map_.reserve(count + 1);
-
-  // Add the strings to the output string table, and record the new offsets
-  // in the map.
-  section_offset_type i = 0;
-  section_offset_type new_offset;
+  // Add the strings to the output string table.  The offsets of the
+  // strings in the output string table are looked up again when the
+  // string offsets are remapped.
   while (p < pend)
     {
       size_t len = strlen(p);
-      new_offset = output_file->add_string(p, len);
-      this->str_offset_map_.push_back(std::make_pair(i, new_offset));
+      output_file->add_string(p, len);
       p += len + 1;
-      i += len + 1;
     }
-  new_offset = 0;
-  this->str_offset_map_.push_back(std::make_pair(i, new_offset));
   if (is_new)
     delete[] pdata;
 }
 
-// Copy a section from the input file to the output file.
+// Add the units of GROUP to OUTPUT_FILE, along with the contributions
+// to the related sections.
+
+void
+Dwo_file::add_unit_group(Dwp_output_file* output_file,
+			 const Unit_group& group)
+{
+  elfcpp::DW_SECT info_sect = (group.is_debug_types
+			       ? elfcpp::DW_SECT_TYPES
+			       : elfcpp::DW_SECT_INFO);
+  unsigned int info_shndx = group.debug_shndx[info_sect];
+
+  // Copy the related sections and track the section offsets and sizes.
+  Section_bounds sections[elfcpp::DW_SECT_MAX + 1];
+  for (int i = elfcpp::DW_SECT_ABBREV; i <= elfcpp::DW_SECT_MAX; ++i)
+    {
+      if (group.debug_shndx[i] > 0)
+	sections[i] = this->copy_section(output_file, group.debug_shndx[i],
+					 static_cast<elfcpp::DW_SECT>(i));
+    }
+
+  for (Input_unit_list::const_iterator p = group.units.begin();
+       p != group.units.end();
+       ++p)
+    {
+      if (group.is_debug_types && output_file->lookup_tu(p->signature))
+	continue;
+
+      Unit_set* unit_set = new Unit_set();
+      unit_set->signature = p->signature;
+      if (group.is_from_index)
+	{
+	  // Adjust the offset of each contribution within the input
+	  // section by the offset of the input section within the output
+	  // section.
+	  for (unsigned int j = 0; j < p->columns.size(); ++j)
+	    {
+	      unsigned int dw_sect = p->columns[j].first;
+	      const Section_bounds& b(p->columns[j].second);
+	      unit_set->sections[dw_sect].offset = (sections[dw_sect].offset
+						    + b.offset);
+	      unit_set->sections[dw_sect].size = b.size;
+	    }
+	}
+      else
+	{
+	  for (unsigned int i = elfcpp::DW_SECT_ABBREV;
+	       i <= elfcpp::DW_SECT_MAX;
+	       ++i)
+	    unit_set->sections[i] = sections[i];
+	}
+
+      section_offset_type off =
+	  this->add_contribution(output_file, info_sect, info_shndx,
+				 p->bounds.offset, p->bounds.size);
+      unit_set->sections[info_sect] = Section_bounds(off, p->bounds.size);
+      if (group.is_debug_types)
+	output_file->add_tu_set(unit_set);
+      else
+	output_file->add_cu_set(unit_set);
+    }
+}
+
+// Add a section from the input file to the output file.
 // Return the offset and length of this input section's contribution
-// in the output section.  If copying .debug_str_offsets.dwo, remap
-// the string offsets for the output string table.
+// in the output section.
 
 Section_bounds
 Dwo_file::copy_section(Dwp_output_file* output_file, unsigned int shndx,
@@ -1416,32 +1682,9 @@ Dwo_file::copy_section(Dwp_output_file* output_file, unsigned int shndx,
   if (this->sect_offsets_[shndx].size > 0)
     return this->sect_offsets_[shndx];
 
-  // Get the section contents. Upon return, if IS_NEW is true, the memory
-  // has been allocated via new; if false, the memory is part of the mapped
-  // input file, and we will need to duplicate it so that it will persist
-  // after we close the input file.
-  section_size_type len;
-  bool is_new;
-  const unsigned char* contents = this->section_contents(shndx, &len, &is_new);
-
-  if (section_id == elfcpp::DW_SECT_STR_OFFSETS)
-    {
-      const unsigned char* remapped = this->remap_str_offsets(contents, len);
-      if (is_new)
-	delete[] contents;
-      contents = remapped;
-    }
-  else if (!is_new)
-    {
-      unsigned char* copy = new unsigned char[len];
-      memcpy(copy, contents, len);
-      contents = copy;
-    }
-
-  // Add the contents of the input section to the output section.
-  // The output file takes ownership of the memory pointed to by CONTENTS.
-  section_offset_type off = output_file->add_contribution(section_id, contents,
-							  len, 1);
+  section_size_type len = this->section_size(shndx);
+  section_offset_type off = this->add_contribution(output_file, section_id,
+						   shndx, 0, len);
 
   // Store the output section bounds.
   Section_bounds bounds(off, len);
@@ -1450,29 +1693,81 @@ Dwo_file::copy_section(Dwp_output_file* output_file, unsigned int shndx,
   return bounds;
 }
 
-// Remap the 
-const unsigned char*
+// Add a contribution from the input file to the output file, and
+// record where to copy it from.
+
+section_offset_type
+Dwo_file::add_contribution(Dwp_output_file* output_file,
+			   elfcpp::DW_SECT section_id, unsigned int shndx,
+			   section_offset_type input_offset,
+			   section_size_type len)
+{
+  section_offset_type off = output_file->add_contribution(section_id, len, 1);
+  Contribution c = { section_id, shndx, input_offset, len, off };
+  this->contributions_.push_back(c);
+  return off;
+}
+
+// Build the map from offsets in the input string table to offsets in
+// the output string table.
+
+void
+Dwo_file::read_str_offset_map(const Dwp_output_file* output_file)
+{
+  section_size_type len;
+  bool is_new;
+  const unsigned char* pdata = this->section_contents(this->debug_str_, &len,
+						      &is_new);
+  const char* p = reinterpret_cast<const char*>(pdata);
+  const char* pend = p + len;
+
+  // Count the number of strings in the section, and size the map.
+  size_t count = 0;
+  for (const char* pt = p; pt < pend; pt += strlen(pt) + 1)
+    ++count;
+  this->str_offset_map_.reserve(count + 1);
+
+  // Look up the output offset of each string, and record it in the map.
+  section_offset_type i = 0;
+  section_offset_type new_offset;
+  while (p < pend)
+    {
+      size_t len = strlen(p);
+      new_offset = output_file->string_offset(p, len);
+      this->str_offset_map_.push_back(std::make_pair(i, new_offset));
+      p += len + 1;
+      i += len + 1;
+    }
+  new_offset = 0;
+  this->str_offset_map_.push_back(std::make_pair(i, new_offset));
+  if (is_new)
+    delete[] pdata;
+}
+
+// Remap the string offsets in the .debug_str_offsets.dwo section
+// while copying them to the output file.
+
+void
 Dwo_file::remap_str_offsets(const unsigned char* contents,
-			    section_size_type len)
+			    section_size_type len, unsigned char* out)
 {
   if ((len & 3) != 0)
     gold_fatal(_("%s: .debug_str_offsets.dwo section size not a multiple of 4"),
 	       this->name_);
 
   if (this->obj_->is_big_endian())
-    return this->sized_remap_str_offsets<true>(contents, len);
+    this->sized_remap_str_offsets<true>(contents, len, out);
   else
-    return this->sized_remap_str_offsets<false>(contents, len);
+    this->sized_remap_str_offsets<false>(contents, len, out);
 }
 
 template <bool big_endian>
-const unsigned char*
+void
 Dwo_file::sized_remap_str_offsets(const unsigned char* contents,
-				  section_size_type len)
+				  section_size_type len, unsigned char* out)
 {
-  unsigned char* remapped = new unsigned char[len];
   const unsigned char* p = contents;
-  unsigned char* q = remapped;
+  unsigned char* q = out;
   while (len > 0)
     {
       unsigned int val = elfcpp::Swap_unaligned<32, big_endian>::readval(p);
@@ -1482,7 +1777,6 @@ Dwo_file::sized_remap_str_offsets(const unsigned char* contents,
       p += 4;
       q += 4;
     }
-  return remapped;
 }
 
 unsigned int
@@ -1507,12 +1801,11 @@ Dwo_file::remap_str_offset(section_offset_type val)
   return p->second + (val - p->first);
 }
 
-// Add a set of .debug_info.dwo or .debug_types.dwo and related sections
-// to OUTPUT_FILE.
+// Find the units in a .debug_info.dwo or .debug_types.dwo section, and
+// record them along with the related sections.
 
 void
-Dwo_file::add_unit_set(Dwp_output_file* output_file, unsigned int *debug_shndx,
-		       bool is_debug_types)
+Dwo_file::read_unit_set(unsigned int *debug_shndx, bool is_debug_types)
 {
   unsigned int shndx = (is_debug_types
 			? debug_shndx[elfcpp::DW_SECT_TYPES]
@@ -1523,20 +1816,17 @@ Dwo_file::add_unit_set(Dwp_output_file* output_file, unsigned int *debug_shndx,
   if (debug_shndx[elfcpp::DW_SECT_ABBREV] == 0)
     gold_fatal(_("%s: no .debug_abbrev.dwo section found"), this->name_);
 
-  // Copy the related sections and track the section offsets and sizes.
-  Section_bounds sections[elfcpp::DW_SECT_MAX + 1];
-  for (int i = elfcpp::DW_SECT_ABBREV; i <= elfcpp::DW_SECT_MAX; ++i)
-    {
-      if (debug_shndx[i] > 0)
-	sections[i] = this->copy_section(output_file, debug_shndx[i],
-					 static_cast<elfcpp::DW_SECT>(i));
-    }
+  this->unit_groups_.push_back(Unit_group());
+  Unit_group& group(this->unit_groups_.back());
+  group.is_debug_types = is_debug_types;
+  group.is_from_index = false;
+  for (unsigned int i = 0; i <= elfcpp::DW_SECT_MAX; ++i)
+    group.debug_shndx[i] = debug_shndx[i];
 
-  // Parse the .debug_info or .debug_types section and add each compilation
-  // or type unit to the output file, along with the contributions to the
-  // related sections.
+  // Parse the .debug_info or .debug_types section and record each
+  // compilation or type unit.
   Unit_reader reader(is_debug_types, this->obj_, shndx);
-  reader.add_units(output_file, debug_shndx[elfcpp::DW_SECT_ABBREV], sections);
+  reader.read_units(debug_shndx[elfcpp::DW_SECT_ABBREV], &group.units);
 }
 
 // Class Dwp_output_file.
@@ -1566,17 +1856,6 @@ Dwp_output_file::record_target_info(const char*, int machine,
     this->next_file_offset_ = elfcpp::Elf_sizes<64>::ehdr_size;
   else
     gold_unreachable();
-
-  this->fd_ = ::fopen(this->name_, "wb");
-  if (this->fd_ == NULL)
-    gold_fatal(_("%s: %s"), this->name_, strerror(errno));
-
-  // Write zeroes for the ELF header initially.  We'll write
-  // the actual header during finalize().
-  static const char buf[elfcpp::Elf_sizes<64>::ehdr_size] = { 0 };
-  if (::fwrite(buf, 1, this->next_file_offset_, this->fd_)
-      < (size_t) this->next_file_offset_)
-    gold_fatal(_("%s: %s"), this->name_, strerror(errno));
 }
 
 // Add a string to the debug strings section.
@@ -1613,14 +1892,12 @@ Dwp_output_file::add_output_section(const char* section_name, int align)
 
 // Add a contribution to a section in the output file, and return the offset
 // of the contribution within the output section.  The .debug_info.dwo section
-// is expected to be the largest one, so we will write the contents of this
-// section directly to the output file as we receive contributions, allowing
-// us to free that memory as soon as possible. We will save the remaining
-// contributions until we finalize the layout of the output file.
+// is expected to be the largest one, so we place it directly after the ELF
+// header as we receive contributions.  The remaining sections are placed
+// when we lay out the output file.
 
 section_offset_type
 Dwp_output_file::add_contribution(elfcpp::DW_SECT section_id,
-				  const unsigned char* contents,
 				  section_size_type len,
 				  int align)
 {
@@ -1644,8 +1921,7 @@ Dwp_output_file::add_contribution(elfcpp::DW_SECT section_id,
 
   if (section_id == elfcpp::DW_SECT_INFO)
     {
-      // Write the .debug_info.dwo section directly.
-      // We do not need to free the memory in this case.
+      // Place the .debug_info.dwo section directly.
       off_t file_offset = this->next_file_offset_;
       gold_assert(this->size_ > 0 && file_offset > 0);
 
@@ -1667,22 +1943,15 @@ Dwp_output_file::add_contribution(elfcpp::DW_SECT section_id,
 
       section_offset = file_offset - section.offset;
       section.size = file_offset + len - section.offset;
-
-      ::fseek(this->fd_, file_offset, SEEK_SET);
-      if (::fwrite(contents, 1, len, this->fd_) < len)
-	gold_fatal(_("%s: error writing section '%s'"), this->name_,
-		   section_name);
       this->next_file_offset_ = file_offset + len;
     }
   else
     {
-      // Collect the contributions and keep track of the total size.
+      // Keep track of the total size.
       if (align > section.align)
 	section.align = align;
       section_offset = align_offset(section.size, align);
       section.size = section_offset + len;
-      Contribution contrib = { section_offset, len, contents };
-      section.contributions.push_back(contrib);
     }
 
   return section_offset;
@@ -1830,124 +2099,145 @@ Dwp_output_file::Dwp_index::grow()
   delete[] old_index_table;
 }
 
-// Finalize the file, write the string tables and index sections,
-// and close the file.
+// Lay out the file and create it.  Write the string tables, the index
+// sections and the headers.  The contributions of the input files
+// are copied by Dwo_file::write, which may run in parallel.
 
 void
-Dwp_output_file::finalize()
+Dwp_output_file::open()
 {
-  unsigned char* buf;
+  gold_assert(this->size_ > 0);
 
-  // Write the accumulated output sections.
+  // Place the accumulated output sections.
   for (unsigned int i = 0; i < this->sections_.size(); i++)
     {
       Section& sect = this->sections_[i];
-      // If the offset has already been assigned, the section has been written.
+      // If the offset has already been assigned, the section has been placed.
       if (sect.offset > 0 || sect.size == 0)
 	continue;
       off_t file_offset = this->next_file_offset_;
       file_offset = align_offset(file_offset, sect.align);
       sect.offset = file_offset;
-      this->write_contributions(sect);
       this->next_file_offset_ = file_offset + sect.size;
     }
 
-  // Write the debug string table.
+  // Build the debug string table.
   if (this->have_strings_)
     {
       this->stringpool_.set_string_offsets();
       section_size_type len = this->stringpool_.get_strtab_size();
-      buf = new unsigned char[len];
+      unsigned char* buf = new unsigned char[len];
       this->stringpool_.write_to_buffer(buf, len);
-      this->write_new_section(".debug_str.dwo", buf, len, 1);
-      delete[] buf;
+      this->add_new_section(".debug_str.dwo", buf, len, 1);
     }
 
-  // Write the CU and TU indexes.
+  // Build the CU and TU indexes.
   if (this->big_endian_)
     {
-      this->write_index<true>(".debug_cu_index", this->cu_index_);
-      this->write_index<true>(".debug_tu_index", this->tu_index_);
+      this->make_index<true>(".debug_cu_index", this->cu_index_);
+      this->make_index<true>(".debug_tu_index", this->tu_index_);
     }
   else
     {
-      this->write_index<false>(".debug_cu_index", this->cu_index_);
-      this->write_index<false>(".debug_tu_index", this->tu_index_);
+      this->make_index<false>(".debug_cu_index", this->cu_index_);
+      this->make_index<false>(".debug_tu_index", this->tu_index_);
     }
 
   off_t file_offset = this->next_file_offset_;
 
-  // Write the section string table.
+  // Place the section string table.
   this->shstrndx_ = this->shnum_++;
   const char* shstrtab_name =
       this->shstrtab_.add_with_length(".shstrtab", sizeof(".shstrtab") - 1,
 				      false, NULL);
   this->shstrtab_.set_string_offsets();
   section_size_type shstrtab_len = this->shstrtab_.get_strtab_size();
-  buf = new unsigned char[shstrtab_len];
-  this->shstrtab_.write_to_buffer(buf, shstrtab_len);
   off_t shstrtab_off = file_offset;
-  ::fseek(this->fd_, file_offset, 0);
-  if (::fwrite(buf, 1, shstrtab_len, this->fd_) < shstrtab_len)
-    gold_fatal(_("%s: error writing section '.shstrtab'"), this->name_);
-  delete[] buf;
   file_offset += shstrtab_len;
 
+  // Place the section header table.
+  const int shdr_size = (this->size_ == 32
+			 ? elfcpp::Elf_sizes<32>::shdr_size
+			 : elfcpp::Elf_sizes<64>::shdr_size);
+  file_offset = align_offset(file_offset, this->size_ == 32 ? 4 : 8);
+  this->shoff_ = file_offset;
+  file_offset += this->shnum_ * shdr_size;
+
+  // Create the file at its final size, so that the contents of the
+  // input sections can be copied straight into the mapped file.
+  this->output_ = new Output_file(this->name_);
+  this->output_->open(file_offset);
+  this->view_ = this->output_->get_output_view(0, file_offset);
+
+  // Write the sections we have built.
+  for (unsigned int i = 0; i < this->sections_.size(); i++)
+    {
+      Section& sect = this->sections_[i];
+      if (sect.contents == NULL)
+	continue;
+      memcpy(this->view_ + sect.offset, sect.contents, sect.size);
+      delete[] sect.contents;
+      sect.contents = NULL;
+    }
+
+  // Write the section string table.
+  this->shstrtab_.write_to_buffer(this->view_ + shstrtab_off, shstrtab_len);
+
   // Write the section header table.  The first entry is a NULL entry.
   // This is followed by the debug sections, and finally we write the
   // .shstrtab section header.
-  file_offset = align_offset(file_offset, this->size_ == 32 ? 4 : 8);
-  this->shoff_ = file_offset;
-  ::fseek(this->fd_, file_offset, 0);
+  unsigned char* pov = this->view_ + this->shoff_;
   section_size_type sh0_size = 0;
   unsigned int sh0_link = 0;
   if (this->shnum_ >= elfcpp::SHN_LORESERVE)
     sh0_size = this->shnum_;
   if (this->shstrndx_ >= elfcpp::SHN_LORESERVE)
     sh0_link = this->shstrndx_;
-  this->write_shdr(NULL, 0, 0, 0, 0, sh0_size, sh0_link, 0, 0, 0);
+  pov = this->write_shdr(pov, NULL, 0, 0, 0, 0, sh0_size, sh0_link, 0, 0, 0);
   for (unsigned int i = 0; i < this->sections_.size(); ++i)
     {
       Section& sect = this->sections_[i];
-      this->write_shdr(sect.name, elfcpp::SHT_PROGBITS, 0, 0, sect.offset,
-		       sect.size, 0, 0, sect.align, 0);
+      pov = this->write_shdr(pov, sect.name, elfcpp::SHT_PROGBITS, 0, 0,
+			     sect.offset, sect.size, 0, 0, sect.align, 0);
     }
-  this->write_shdr(shstrtab_name, elfcpp::SHT_STRTAB, 0, 0,
-		   shstrtab_off, shstrtab_len, 0, 0, 1, 0);
+  pov = this->write_shdr(pov, shstrtab_name, elfcpp::SHT_STRTAB, 0, 0,
+			 shstrtab_off, shstrtab_len, 0, 0, 1, 0);
+  gold_assert(pov == this->view_ + file_offset);
 
   // Write the ELF header.
   this->write_ehdr();
+}
 
-  // Close the file.
-  if (this->fd_ != NULL)
-    {
-      if (::fclose(this->fd_) != 0)
-	gold_fatal(_("%s: %s"), this->name_, strerror(errno));
-    }
-  this->fd_ = NULL;
+// Return a pointer to the contents of the output section for SECTION_ID.
+
+unsigned char*
+Dwp_output_file::section_view(elfcpp::DW_SECT section_id) const
+{
+  gold_assert(this->view_ != NULL);
+  unsigned int shndx = this->section_id_map_[section_id];
+  gold_assert(shndx > 0);
+  return this->view_ + this->sections_[shndx - 1].offset;
 }
 
-// Write the contributions to an output section.
+// Close the file.
 
 void
-Dwp_output_file::write_contributions(const Section& sect)
+Dwp_output_file::close()
 {
-  for (unsigned int i = 0; i < sect.contributions.size(); ++i)
-    {
-      const Contribution& c = sect.contributions[i];
-      ::fseek(this->fd_, sect.offset + c.output_offset, SEEK_SET);
-      if (::fwrite(c.contents, 1, c.size, this->fd_) < c.size)
-	gold_fatal(_("%s: error writing section '%s'"), this->name_, sect.name);
-      delete[] c.contents;
-    }
+  if (this->output_ == NULL)
+    return;
+  this->output_->close();
+  delete this->output_;
+  this->output_ = NULL;
+  this->view_ = NULL;
 }
 
-// Write a new section to the output file.
+// Add a new section to the output file.
 
 void
-Dwp_output_file::write_new_section(const char* section_name,
-				   const unsigned char* contents,
-				   section_size_type len, int align)
+Dwp_output_file::add_new_section(const char* section_name,
+				 unsigned char* contents,
+				 section_size_type len, int align)
 {
   section_name = this->shstrtab_.add_with_length(section_name,
 						 strlen(section_name),
@@ -1958,17 +2248,15 @@ Dwp_output_file::write_new_section(const char* section_name,
   file_offset = align_offset(file_offset, align);
   section.offset = file_offset;
   section.size = len;
-  ::fseek(this->fd_, file_offset, SEEK_SET);
-  if (::fwrite(contents, 1, len, this->fd_) < len)
-    gold_fatal(_("%s: error writing section '%s'"), this->name_, section_name);
+  section.contents = contents;
   this->next_file_offset_ = file_offset + len;
 }
 
-// Write a CU or TU index section.
+// Build a CU or TU index section.
 
 template<bool big_endian>
 void
-Dwp_output_file::write_index(const char* sect_name, const Dwp_index& index)
+Dwp_output_file::make_index(const char* sect_name, const Dwp_index& index)
 {
   const unsigned int nslots = index.hash_table_total_slots();
   const unsigned int nused = index.hash_table_used_slots();
@@ -2067,9 +2355,7 @@ Dwp_output_file::write_index(const char* sect_name, const Dwp_index& index)
 
   gold_assert(p == buf + index_size);
 
-  this->write_new_section(sect_name, buf, index_size, sizeof(uint64_t));
-
-  delete[] buf;
+  this->add_new_section(sect_name, buf, index_size, sizeof(uint64_t));
 }
 
 // Write the ELF header.
@@ -2099,9 +2385,7 @@ template<unsigned int size, bool big_endian>
 void
 Dwp_output_file::sized_write_ehdr()
 {
-  const unsigned int ehdr_size = elfcpp::Elf_sizes<size>::ehdr_size;
-  unsigned char buf[ehdr_size];
-  elfcpp::Ehdr_write<size, big_endian> ehdr(buf);
+  elfcpp::Ehdr_write<size, big_endian> ehdr(this->view_);
 
   unsigned char e_ident[elfcpp::EI_NIDENT];
   memset(e_ident, 0, elfcpp::EI_NIDENT);
@@ -2136,17 +2420,14 @@ Dwp_output_file::sized_write_ehdr()
   ehdr.put_e_shstrndx(this->shstrndx_ < elfcpp::SHN_LORESERVE
 		      ? this->shstrndx_
 		      : static_cast<unsigned int>(elfcpp::SHN_XINDEX));
-
-  ::fseek(this->fd_, 0, 0);
-  if (::fwrite(buf, 1, ehdr_size, this->fd_) < ehdr_size)
-    gold_fatal(_("%s: error writing ELF header"), this->name_);
 }
 
-// Write a section header.
+// Write a section header at POV, and return the position after it.
 
-void
-Dwp_output_file::write_shdr(const char* name, unsigned int type,
-			    unsigned int flags, uint64_t addr, off_t offset,
+unsigned char*
+Dwp_output_file::write_shdr(unsigned char* pov, const char* name,
+			    unsigned int type, unsigned int flags,
+			    uint64_t addr, off_t offset,
 			    section_size_type sect_size, unsigned int link,
 			    unsigned int info, unsigned int align,
 			    unsigned int ent_size)
@@ -2154,22 +2435,22 @@ Dwp_output_file::write_shdr(const char* name, unsigned int type,
   if (this->size_ == 32)
     {
       if (this->big_endian_)
-	return this->sized_write_shdr<32, true>(name, type, flags, addr,
+	return this->sized_write_shdr<32, true>(pov, name, type, flags, addr,
 						offset, sect_size, link, info,
 						align, ent_size);
       else
-	return this->sized_write_shdr<32, false>(name, type, flags, addr,
+	return this->sized_write_shdr<32, false>(pov, name, type, flags, addr,
 						 offset, sect_size, link, info,
 						 align, ent_size);
     }
   else if (this->size_ == 64)
     {
       if (this->big_endian_)
-	return this->sized_write_shdr<64, true>(name, type, flags, addr,
+	return this->sized_write_shdr<64, true>(pov, name, type, flags, addr,
 						offset, sect_size, link, info,
 						align, ent_size);
       else
-	return this->sized_write_shdr<64, false>(name, type, flags, addr,
+	return this->sized_write_shdr<64, false>(pov, name, type, flags, addr,
 						 offset, sect_size, link, info,
 						 align, ent_size);
     }
@@ -2178,16 +2459,15 @@ Dwp_output_file::write_shdr(const char* name, unsigned int type,
 }
 
 template<unsigned int size, bool big_endian>
-void
-Dwp_output_file::sized_write_shdr(const char* name, unsigned int type,
-				  unsigned int flags, uint64_t addr,
-				  off_t offset, section_size_type sect_size,
+unsigned char*
+Dwp_output_file::sized_write_shdr(unsigned char* pov, const char* name,
+				  unsigned int type, unsigned int flags,
+				  uint64_t addr, off_t offset,
+				  section_size_type sect_size,
 				  unsigned int link, unsigned int info,
 				  unsigned int align, unsigned int ent_size)
 {
-  const unsigned int shdr_size = elfcpp::Elf_sizes<size>::shdr_size;
-  unsigned char buf[shdr_size];
-  elfcpp::Shdr_write<size, big_endian> shdr(buf);
+  elfcpp::Shdr_write<size, big_endian> shdr(pov);
 
   shdr.put_sh_name(name == NULL ? 0 : this->shstrtab_.get_offset(name));
   shdr.put_sh_type(type);
@@ -2199,8 +2479,7 @@ Dwp_output_file::sized_write_shdr(const char* name, unsigned int type,
   shdr.put_sh_info(info);
   shdr.put_sh_addralign(align);
   shdr.put_sh_entsize(ent_size);
-  if (::fwrite(buf, 1, shdr_size, this->fd_) < shdr_size)
-    gold_fatal(_("%s: error writing section header table"), this->name_);
+  return pov + elfcpp::Elf_sizes<size>::shdr_size;
 }
 
 // Class Dwo_name_info_reader.
@@ -2220,15 +2499,12 @@ Dwo_name_info_reader::visit_compilation_unit(off_t, off_t, Dwarf_die* die)
 
 // Class Unit_reader.
 
-// Read the CUs or TUs and add them to the output file.
+// Read the CUs or TUs and add them to UNITS.
 
 void
-Unit_reader::add_units(Dwp_output_file* output_file,
-		       unsigned int debug_abbrev,
-		       Section_bounds* sections)
+Unit_reader::read_units(unsigned int debug_abbrev, Input_unit_list* units)
 {
-  this->output_file_ = output_file;
-  this->sections_ = sections;
+  this->units_ = units;
   this->set_abbrev_shndx(debug_abbrev);
   this->parse();
 }
@@ -2236,52 +2512,202 @@ Unit_reader::add_units(Dwp_output_file* output_file,
 // Visit a compilation unit.
 
 void
-Unit_reader::visit_compilation_unit(off_t, off_t cu_length, Dwarf_die* die)
+Unit_reader::visit_compilation_unit(off_t cu_offset, off_t cu_length,
+				    Dwarf_die* die)
 {
   if (cu_length == 0)
     return;
 
-  Unit_set* unit_set = new Unit_set();
-  unit_set->signature = die->uint_attribute(elfcpp::DW_AT_GNU_dwo_id);
-  for (unsigned int i = elfcpp::DW_SECT_ABBREV; i <= elfcpp::DW_SECT_MAX; ++i)
-    unit_set->sections[i] = this->sections_[i];
-
-  // Dwp_output_file::add_contribution writes the .debug_info.dwo section
-  // directly to the output file, so we do not need to duplicate the
-  // section contents, and add_contribution does not need to free the memory.
-  section_offset_type off =
-      this->output_file_->add_contribution(elfcpp::DW_SECT_INFO,
-					   this->buffer_at_offset(0),
-					   cu_length, 1);
-  Section_bounds bounds(off, cu_length);
-  unit_set->sections[elfcpp::DW_SECT_INFO] = bounds;
-  this->output_file_->add_cu_set(unit_set);
+  uint64_t dwo_id = die->uint_attribute(elfcpp::DW_AT_GNU_dwo_id);
+  this->units_->push_back(Input_unit(dwo_id, cu_offset, cu_length));
 }
 
 // Visit a type unit.
 
 void
-Unit_reader::visit_type_unit(off_t, off_t tu_length, off_t,
+Unit_reader::visit_type_unit(off_t tu_offset, off_t tu_length, off_t,
 			     uint64_t signature, Dwarf_die*)
 {
   if (tu_length == 0)
     return;
-  if (this->output_file_->lookup_tu(signature))
-    return;
 
-  Unit_set* unit_set = new Unit_set();
-  unit_set->signature = signature;
-  for (unsigned int i = elfcpp::DW_SECT_ABBREV; i <= elfcpp::DW_SECT_MAX; ++i)
-    unit_set->sections[i] = this->sections_[i];
-
-  unsigned char* contents = new unsigned char[tu_length];
-  memcpy(contents, this->buffer_at_offset(0), tu_length);
-  section_offset_type off =
-      this->output_file_->add_contribution(elfcpp::DW_SECT_TYPES, contents,
-					   tu_length, 1);
-  Section_bounds bounds(off, tu_length);
-  unit_set->sections[elfcpp::DW_SECT_TYPES] = bounds;
-  this->output_file_->add_tu_set(unit_set);
+  this->units_->push_back(Input_unit(signature, tu_offset, tu_length));
+}
+
+// Class Dwp_packager.
+
+// This task reads an input file.
+
+class Dwo_read_task : public Task
+{
+ public:
+  Dwo_read_task(Dwo_file* dwo_file, Task_token* this_blocker)
+    : dwo_file_(dwo_file), this_blocker_(this_blocker)
+  { }
+
+  Task_token*
+  is_runnable()
+  { return NULL; }
+
+  // Unblock THIS_BLOCKER_ when done.
+  void
+  locks(Task_locker* tl)
+  { tl->add(this, this->this_blocker_); }
+
+  void
+  run(Workqueue*)
+  { this->dwo_file_->read(); }
+
+  std::string
+  get_name() const
+  { return std::string("Dwo_read_task ") + this->dwo_file_->name(); }
+
+ private:
+  Dwo_file* dwo_file_;
+  Task_token* this_blocker_;
+};
+
+// This task runs after an input file has been read, and after the
+// previous input file has been added to the output file.  It adds the
+// input file to the output file.
+
+class Dwo_add_task : public Task
+{
+ public:
+  Dwo_add_task(Dwp_packager* packager, unsigned int index,
+	       Task_token* read_blocker)
+    : packager_(packager), index_(index), read_blocker_(read_blocker)
+  { }
+
+  ~Dwo_add_task()
+  { delete this->read_blocker_; }
+
+  Task_token*
+  is_runnable()
+  {
+    if (this->read_blocker_->is_blocked())
+      return this->read_blocker_;
+    return NULL;
+  }
+
+  void
+  locks(Task_locker*)
+  { }
+
+  void
+  run(Workqueue* workqueue)
+  { this->packager_->add_file(workqueue, this->index_); }
+
+  std::string
+  get_name() const
+  { return "Dwo_add_task"; }
+
+ private:
+  Dwp_packager* packager_;
+  unsigned int index_;
+  Task_token* read_blocker_;
+};
+
+// This task copies the contributions of an input file into the
+// output file.
+
+class Dwo_write_task : public Task
+{
+ public:
+  Dwo_write_task(Dwo_file* dwo_file, Dwp_output_file* output_file)
+    : dwo_file_(dwo_file), output_file_(output_file)
+  { }
+
+  Task_token*
+  is_runnable()
+  { return NULL; }
+
+  void
+  locks(Task_locker*)
+  { }
+
+  void
+  run(Workqueue*)
+  { this->dwo_file_->write(this->output_file_); }
+
+  std::string
+  get_name() const
+  { return std::string("Dwo_write_task ") + this->dwo_file_->name(); }
+
+ private:
+  Dwo_file* dwo_file_;
+  Dwp_output_file* output_file_;
+};
+
+Dwp_packager::Dwp_packager(const File_list& files,
+			   Dwp_output_file* output_file,
+			   unsigned int max_open_files, bool verbose)
+  : files_(), read_blockers_(files.size()), output_file_(output_file),
+    max_open_files_(std::max(max_open_files, 1U)), verbose_(verbose)
+{
+  this->files_.reserve(files.size());
+  for (File_list::const_iterator f = files.begin(); f != files.end(); ++f)
+    this->files_.push_back(new Dwo_file(f->dwo_name.c_str()));
+}
+
+Dwp_packager::~Dwp_packager()
+{
+  for (unsigned int i = 0; i < this->files_.size(); ++i)
+    delete this->files_[i];
+}
+
+// Queue the tasks to read the first input files, and the task to add
+// the first input file to the output file.
+
+void
+Dwp_packager::queue_tasks(Workqueue* workqueue)
+{
+  gold_assert(!this->files_.empty());
+  unsigned int count = std::min(this->max_open_files_,
+				static_cast<unsigned int>(this->files_.size()));
+  for (unsigned int i = 0; i < count; ++i)
+    this->queue_read_task(workqueue, i);
+  workqueue->queue(new Dwo_add_task(this, 0, this->read_blockers_[0]));
+}
+
+// Queue a task to read input file INDEX.
+
+void
+Dwp_packager::queue_read_task(Workqueue* workqueue, unsigned int index)
+{
+  Task_token* blocker = new Task_token(true);
+  blocker->add_blocker();
+  this->read_blockers_[index] = blocker;
+  workqueue->queue(new Dwo_read_task(this->files_[index], blocker));
+}
+
+// Add input file INDEX to the output file, and queue the tasks for the
+// following files.  After the last file, open the output file and
+// queue the tasks to copy the contents of the input files.
+
+void
+Dwp_packager::add_file(Workqueue* workqueue, unsigned int index)
+{
+  Dwo_file* dwo_file = this->files_[index];
+  if (this->verbose_)
+    fprintf(stderr, "%s\n", dwo_file->name());
+  dwo_file->add_to_output(this->output_file_);
+
+  // The input file has been closed, so we may read another one.
+  unsigned int next_read = index + this->max_open_files_;
+  if (next_read < this->files_.size())
+    this->queue_read_task(workqueue, next_read);
+
+  if (index + 1 < this->files_.size())
+    {
+      workqueue->queue(new Dwo_add_task(this, index + 1,
+					this->read_blockers_[index + 1]));
+      return;
+    }
+
+  this->output_file_->open();
+  for (unsigned int i = 0; i < this->files_.size(); ++i)
+    workqueue->queue(new Dwo_write_task(this->files_[i], this->output_file_));
 }
 
 }; // End namespace gold
@@ -2290,8 +2716,14 @@ using namespace gold;
 
 // Options.
 
+// The number of threads to use with --threads if --thread-count is
+// not given.
+static const size_t default_thread_count = 16;
+
 enum Dwp_options {
   VERIFY_ONLY = 0x101,
+  THREADS,
+  THREAD_COUNT
 };
 
 struct option dwp_options[] =
@@ -2299,6 +2731,8 @@ struct option dwp_options[] =
     { "exec", required_argument, NULL, 'e' },
     { "help", no_argument, NULL, 'h' },
     { "output", required_argument, NULL, 'o' },
+    { "threads", no_argument, NULL, THREADS },
+    { "thread-count", required_argument, NULL, THREAD_COUNT },
     { "verbose", no_argument, NULL, 'v' },
     { "verify-only", no_argument, NULL, VERIFY_ONLY },
     { "version", no_argument, NULL, 'V' },
@@ -2315,6 +2749,9 @@ usage(FILE* fd, int exit_status)
   fprintf(fd, _("  -e EXE, --exec EXE       Get list of dwo files from EXE"
 					   " (defaults output to EXE.dwp)\n"));
   fprintf(fd, _("  -o FILE, --output FILE   Set output dwp file name\n"));
+  fprintf(fd, _("  --threads                Read and write files in"
+					   " parallel\n"));
+  fprintf(fd, _("  --thread-count COUNT     Number of threads to use\n"));
   fprintf(fd, _("  -v, --verbose            Verbose output\n"));
   fprintf(fd, _("  --verify-only            Verify output file against"
 					   " exec file\n"));
@@ -2363,12 +2800,6 @@ main(int argc, char** argv)
   Errors errors(program_name);
   set_parameters_errors(&errors);
 
-  // Initialize gold's global options.  We don't use these in
-  // this program, but they need to be initialized so that
-  // functions we call from libgold work properly.
-  General_options options;
-  set_parameters_options(&options);
-
   // In libiberty; expands @filename to the args in "filename".
   expandargv(&argc, &argv);
 
@@ -2378,6 +2809,8 @@ main(int argc, char** argv)
   const char* exe_filename = NULL;
   bool verbose = false;
   bool verify_only = false;
+  bool threads = false;
+  std::string thread_count_option;
   int c;
   while ((c = getopt_long(argc, argv, "e:ho:vV", dwp_options, NULL)) != -1)
     {
@@ -2397,6 +2830,13 @@ main(int argc, char** argv)
 	  case VERIFY_ONLY:
 	    verify_only = true;
 	    break;
+	  case THREADS:
+	    threads = true;
+	    break;
+	  case THREAD_COUNT:
+	    thread_count_option.assign("--thread-count=");
+	    thread_count_option.append(optarg);
+	    break;
 	  case 'V':
 	    print_version();
 	  case '?':
@@ -2413,6 +2853,28 @@ main(int argc, char** argv)
       output_filename.append(".dwp");
     }
 
+  // Initialize gold's global options.  We don't use most of these in
+  // this program, but they need to be initialized so that functions
+  // we call from libgold work properly.  Pass on the thread options,
+  // so that libgold uses locks when we use threads.  A .dwp file is a
+  // relocatable object file, which is not made executable.  Unless we
+  // are only verifying it, name it as the output file, so that it is
+  // removed if we fail.
+  std::vector<const char*> gold_args;
+  gold_args.push_back("-r");
+  if (!verify_only)
+    {
+      gold_args.push_back("-o");
+      gold_args.push_back(output_filename.c_str());
+    }
+  if (threads)
+    gold_args.push_back("--threads");
+  if (!thread_count_option.empty())
+    gold_args.push_back(thread_count_option.c_str());
+  Command_line command_line;
+  command_line.process(gold_args.size(), &gold_args[0]);
+  set_parameters_options(&command_line.options());
+
   // Get list of .dwo files from the executable.
   if (exe_filename != NULL)
     {
@@ -2436,16 +2898,26 @@ main(int argc, char** argv)
       return ok ? EXIT_SUCCESS : EXIT_FAILURE;
     }
 
+  if (files.empty())
+    gold_fatal(_("%s: no .dwo files found"), exe_filename);
+
   // Process each file, adding its contents to the output file.
-  Dwp_output_file output_file(output_filename.c_str());
-  for (File_list::const_iterator f = files.begin(); f != files.end(); ++f)
+  Workqueue workqueue(command_line.options());
+  unsigned int thread_count = 1;
+  if (command_line.options().threads())
     {
-      if (verbose)
-	fprintf(stderr, "%s\n", f->dwo_name.c_str());
-      Dwo_file dwo_file(f->dwo_name.c_str());
-      dwo_file.read(&output_file);
+      thread_count = command_line.options().thread_count();
+      if (thread_count == 0)
+	thread_count = std::min(files.size(), default_thread_count);
     }
-  output_file.finalize();
+  workqueue.set_thread_count(thread_count);
+
+  Dwp_output_file output_file(output_filename.c_str());
+  Dwp_packager packager(files, &output_file, 4 * thread_count, verbose);
+  packager.queue_tasks(&workqueue);
+  workqueue.process(0);
+  output_file.close();
 
-  return EXIT_SUCCESS;
+  // Exit without waiting for the worker threads to finish.
+  gold_exit(errors.error_count() == 0 ? GOLD_OK : GOLD_ERR);
 }
@@ -24,9 +24,11 @@
 
 #include <vector>
 #include <cstring>
+#include <limits>
 
 #include "elfcpp.h"
 #include "parameters.h"
+#include "gold-threads.h"
 #include "script.h"
 #include "symtab.h"
 #include "dynobj.h"
@@ -850,6 +852,56 @@ Sized_dynobj<size, big_endian>::do_get_global_symbol_counts(
   *used = count;
 }
 
+// The minimum number of symbols each thread hashes when hashing the
+// names of the dynamic symbols in parallel.  Hashing a name is cheap,
+// so this only pays off for very large dynamic symbol tables.
+
+static const size_t min_parallel_hash_symbols = 16384;
+
+// Compute the hash codes of the names of some dynamic symbols.  Each
+// piece writes its own range of the hash codes.
+
+class Dynsym_hash_work : public Parallel_work
+{
+ public:
+  Dynsym_hash_work(const std::vector<Symbol*>& dynsyms,
+		   bool for_gnu_hash_table, std::vector<uint32_t>* hashvals)
+    : dynsyms_(dynsyms), for_gnu_hash_table_(for_gnu_hash_table),
+      hashvals_(hashvals)
+  { }
+
+  void
+  run_piece(unsigned int, size_t start, size_t end)
+  {
+    for (size_t i = start; i < end; ++i)
+      {
+	const char* name = this->dynsyms_[i]->name();
+	(*this->hashvals_)[i] = (this->for_gnu_hash_table_
+				 ? Dynobj::gnu_hash(name)
+				 : Dynobj::elf_hash(name));
+      }
+  }
+
+ private:
+  const std::vector<Symbol*>& dynsyms_;
+  bool for_gnu_hash_table_;
+  std::vector<uint32_t>* hashvals_;
+};
+
+// Set *HASHVALS to the hash codes of the names of DYNSYMS.
+
+void
+Dynobj::compute_hash_codes(const std::vector<Symbol*>& dynsyms,
+			   bool for_gnu_hash_table,
+			   std::vector<uint32_t>* hashvals)
+{
+  hashvals->resize(dynsyms.size());
+  Dynsym_hash_work work(dynsyms, for_gnu_hash_table, hashvals);
+  run_in_parallel(&work, dynsyms.size(),
+		  parallel_piece_count(dynsyms.size(),
+				       min_parallel_hash_symbols));
+}
+
 // Given a vector of hash codes, compute the number of hash buckets to
 // use.
 
@@ -857,7 +909,9 @@ unsigned int
 Dynobj::compute_bucket_count(const std::vector<uint32_t>& hashcodes,
 			     bool for_gnu_hash_table)
 {
-  // FIXME: Implement optional hash table optimization.
+  if (parameters->options().optimize() >= 1
+      && !parameters->options().user_set_hash_bucket_empty_fraction())
+    return Dynobj::optimize_bucket_count(hashcodes, for_gnu_hash_table);
 
   // Array used to determine the number of hash table buckets to use
   // based on the number of symbols there are.  If there are fewer
@@ -889,6 +943,131 @@ Dynobj::compute_bucket_count(const std::vector<uint32_t>& hashcodes,
   return ret;
 }
 
+// Return whether N is prime.
+
+static bool
+is_prime(uint64_t n)
+{
+  if (n < 4)
+    return n >= 2;
+  if (n % 2 == 0)
+    return false;
+  for (uint64_t d = 3; d * d <= n; d += 2)
+    if (n % d == 0)
+      return false;
+  return true;
+}
+
+// Compute the number of hash buckets to use with -O1 and above.  Like
+// the GNU linker, we weigh the sum of the squares of the chain
+// lengths, which favors short chains, plus the size of the table, by
+// the square of the number of pages the buckets occupy.  The GNU
+// linker counts the chain lengths for every candidate size, which is
+// slow for large tables.  Instead we estimate the sum for each size,
+// assuming the hash codes are spread evenly.  For a fixed number of
+// pages the estimate falls as the size grows, so we only consider the
+// largest size that fits in each number of pages.  We then count the
+// real chain lengths for the few sizes with the lowest estimates,
+// rounded down to a prime.
+
+unsigned int
+Dynobj::optimize_bucket_count(const std::vector<uint32_t>& hashcodes,
+			      bool for_gnu_hash_table)
+{
+  const uint64_t nsyms = hashcodes.size();
+  const uint64_t entsize = (for_gnu_hash_table
+			    ? 4
+			    : parameters->target().hash_entry_size() / 8);
+  uint64_t page_entries = parameters->target().common_pagesize() / entsize;
+  if (page_entries < 2)
+    page_entries = 2;
+
+  uint64_t minsize = nsyms / 4;
+  if (minsize < 1)
+    minsize = 1;
+  uint64_t maxsize = nsyms * 2;
+  if (maxsize < minsize)
+    maxsize = minsize;
+  if (maxsize > 0xffffffff)
+    maxsize = 0xffffffff;
+
+  const double n = nsyms;
+  const double table_size = (2 + n) * entsize;
+
+  // The sizes with the lowest estimated costs, lowest first.
+  const int ncandidates = 3;
+  uint64_t candidates[ncandidates];
+  double estimates[ncandidates];
+  for (int i = 0; i < ncandidates; ++i)
+    {
+      candidates[i] = 0;
+      estimates[i] = std::numeric_limits<double>::max();
+    }
+
+  for (uint64_t pages = 1; ; ++pages)
+    {
+      uint64_t m = pages * page_entries - 1;
+      if (m > maxsize)
+	m = maxsize;
+      if (m >= minsize)
+	{
+	  double fact = m / page_entries + 1;
+	  double sumsq = n + n * (n - 1) / m;
+	  double estimate = (table_size + sumsq) * fact * fact;
+	  for (int i = 0; i < ncandidates; ++i)
+	    {
+	      if (estimate < estimates[i])
+		{
+		  for (int j = ncandidates - 1; j > i; --j)
+		    {
+		      candidates[j] = candidates[j - 1];
+		      estimates[j] = estimates[j - 1];
+		    }
+		  candidates[i] = m;
+		  estimates[i] = estimate;
+		  break;
+		}
+	    }
+	}
+      if (m >= maxsize)
+	break;
+    }
+
+  unsigned int ret = 1;
+  double best_cost = std::numeric_limits<double>::max();
+  std::vector<uint32_t> counts;
+  for (int i = 0; i < ncandidates && candidates[i] != 0; ++i)
+    {
+      uint64_t m = candidates[i];
+      while (m > minsize && !is_prime(m))
+	--m;
+      if (!is_prime(m))
+	m = candidates[i];
+
+      counts.assign(m, 0);
+      for (std::vector<uint32_t>::const_iterator p = hashcodes.begin();
+	   p != hashcodes.end();
+	   ++p)
+	++counts[*p % m];
+      double sumsq = 0;
+      for (uint64_t j = 0; j < m; ++j)
+	sumsq += static_cast<double>(counts[j]) * counts[j];
+
+      double fact = m / page_entries + 1;
+      double cost = (table_size + sumsq) * fact * fact;
+      if (cost < best_cost)
+	{
+	  best_cost = cost;
+	  ret = m;
+	}
+    }
+
+  if (for_gnu_hash_table && ret < 2)
+    ret = 2;
+
+  return ret;
+}
+
 // The standard ELF hash function.  This hash function must not
 // change, as the dynamic linker uses it also.
 
@@ -928,9 +1107,8 @@ Dynobj::create_elf_hash_table(const std::vector<Symbol*>& dynsyms,
   unsigned int dynsym_count = dynsyms.size();
 
   // Get the hash values for all the symbols.
-  std::vector<uint32_t> dynsym_hashvals(dynsym_count);
-  for (unsigned int i = 0; i < dynsym_count; ++i)
-    dynsym_hashvals[i] = Dynobj::elf_hash(dynsyms[i]->name());
+  std::vector<uint32_t> dynsym_hashvals;
+  Dynobj::compute_hash_codes(dynsyms, false, &dynsym_hashvals);
 
   const unsigned int bucketcount =
     Dynobj::compute_bucket_count(dynsym_hashvals, false);
@@ -1080,9 +1258,6 @@ Dynobj::create_gnu_hash_table(const std::vector<Symbol*>& dynsyms,
   std::vector<Symbol*> hashed_dynsyms;
   hashed_dynsyms.reserve(count);
 
-  std::vector<uint32_t> dynsym_hashvals;
-  dynsym_hashvals.reserve(count);
-  
   for (unsigned int i = 0; i < count; ++i)
     {
       Symbol* sym = dynsyms[i];
@@ -1093,12 +1268,12 @@ Dynobj::create_gnu_hash_table(const std::vector<Symbol*>& dynsyms,
 	      || sym->is_forced_local()))
 	unhashed_dynsyms.push_back(sym);
       else
-	{
-	  hashed_dynsyms.push_back(sym);
-	  dynsym_hashvals.push_back(Dynobj::gnu_hash(sym->name()));
-	}
+	hashed_dynsyms.push_back(sym);
     }
 
+  std::vector<uint32_t> dynsym_hashvals;
+  Dynobj::compute_hash_codes(hashed_dynsyms, true, &dynsym_hashvals);
+
   // Put the unhashed symbols at the start of the global portion of
   // the dynamic symbol table.
   const unsigned int unhashed_count = unhashed_dynsyms.size();
@@ -1171,8 +1346,69 @@ Dynobj::create_gnu_hash_table(const std::vector<Symbol*>& dynsyms,
     gold_unreachable();
 }
 
+// The minimum number of symbols each thread adds to the bloom filter
+// of a GNU hash table when building it in parallel.
+
+static const size_t min_parallel_bloom_symbols = 65536;
+
+// Build the bloom filter of a GNU hash table.  Each piece sets the
+// bits for its own range of the hash codes in a private copy of the
+// filter, and the copies are combined when all the pieces are done.
+
+template<typename Word>
+class Gnu_hash_bloom_work : public Parallel_work
+{
+ public:
+  Gnu_hash_bloom_work(const std::vector<uint32_t>& hashvals,
+		      unsigned int pieces, uint32_t maskwords,
+		      uint32_t shift1, uint32_t shift2)
+    : hashvals_(hashvals), bitmasks_(pieces), maskwords_(maskwords),
+      shift1_(shift1), shift2_(shift2)
+  { }
+
+  void
+  run_piece(unsigned int piece, size_t start, size_t end)
+  {
+    std::vector<Word>& bitmask(this->bitmasks_[piece]);
+    bitmask.resize(this->maskwords_);
+    const uint32_t mask = (1U << this->shift1_) - 1U;
+    for (size_t i = start; i < end; ++i)
+      {
+	uint32_t hashval = this->hashvals_[i];
+	uint32_t val = (hashval >> this->shift1_) & (this->maskwords_ - 1);
+	bitmask[val] |= (static_cast<Word>(1U)) << (hashval & mask);
+	bitmask[val] |= ((static_cast<Word>(1U))
+			 << ((hashval >> this->shift2_) & mask));
+      }
+  }
+
+  // Return the combined filter.  This is a simple loop over whole
+  // words, which the compiler can vectorize.
+  const std::vector<Word>&
+  bitmask()
+  {
+    std::vector<Word>& ret(this->bitmasks_[0]);
+    for (size_t j = 1; j < this->bitmasks_.size(); ++j)
+      {
+	const Word* in = &this->bitmasks_[j][0];
+	Word* out = &ret[0];
+	for (uint32_t i = 0; i < this->maskwords_; ++i)
+	  out[i] |= in[i];
+      }
+    return ret;
+  }
+
+ private:
+  const std::vector<uint32_t>& hashvals_;
+  std::vector<std::vector<Word> > bitmasks_;
+  uint32_t maskwords_;
+  uint32_t shift1_;
+  uint32_t shift2_;
+};
+
 // Create the actual data for a GNU hash table.  This is just a copy
-// of the code from the old GNU linker.
+// of the code from the old GNU linker, except that the bloom filter
+// may be built in parallel.
 
 template<int size, bool big_endian>
 void
@@ -1235,13 +1471,11 @@ Dynobj::sized_create_gnu_hash_table(
 	maskbitslog2 = 6;
       shift1 = 6;
     }
-  uint32_t mask = (1U << shift1) - 1U;
   uint32_t shift2 = maskbitslog2;
   uint32_t maskbits = 1U << maskbitslog2;
   uint32_t maskwords = 1U << (maskbitslog2 - shift1);
 
   typedef typename elfcpp::Elf_types<size>::Elf_WXword Word;
-  std::vector<Word> bitmask(maskwords);
   std::vector<uint32_t> counts(bucketcount);
   std::vector<uint32_t> indx(bucketcount);
   uint32_t symindx = unhashed_dynsym_count;
@@ -1282,11 +1516,7 @@ Dynobj::sized_create_gnu_hash_table(
       uint32_t hashval = dynsym_hashvals[i];
 
       unsigned int bucket = hashval % bucketcount;
-      unsigned int val = ((hashval >> shift1)
-			  & ((maskbits >> shift1) - 1));
-      bitmask[val] |= (static_cast<Word>(1U)) << (hashval & mask);
-      bitmask[val] |= (static_cast<Word>(1U)) << ((hashval >> shift2) & mask);
-      val = hashval & ~ 1U;
+      unsigned int val = hashval & ~ 1U;
       if (counts[bucket] == 1)
 	{
 	  // Last element terminates the chain.
@@ -1300,6 +1530,13 @@ Dynobj::sized_create_gnu_hash_table(
       ++indx[bucket];
     }
 
+  unsigned int pieces = parallel_piece_count(nsyms,
+					     min_parallel_bloom_symbols);
+  Gnu_hash_bloom_work<Word> bloom(dynsym_hashvals, pieces, maskwords,
+				  shift1, shift2);
+  run_in_parallel(&bloom, nsyms, pieces);
+  const std::vector<Word>& bitmask(bloom.bitmask());
+
   p = phash + 16;
   for (unsigned int i = 0; i < maskwords; ++i)
     {
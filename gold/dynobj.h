@@ -86,6 +86,10 @@ class Dynobj : public Object
   static uint32_t
   elf_hash(const char*);
 
+  // Compute the GNU hash code for a string.
+  static uint32_t
+  gnu_hash(const char*);
+
   // Create a standard ELF hash table, setting *PPHASH and *PHASHLEN.
   // DYNSYMS is the global dynamic symbols.  LOCAL_DYNSYM_COUNT is the
   // number of local dynamic symbols, which is the index of the first
@@ -122,15 +126,24 @@ class Dynobj : public Object
   { this->needed_.push_back(std::string(s)); }
 
  private:
-  // Compute the GNU hash code for a string.
-  static uint32_t
-  gnu_hash(const char*);
+  // Set *HASHVALS to the hash codes of the names of DYNSYMS, using
+  // the GNU hash function if FOR_GNU_HASH_TABLE, otherwise the ELF
+  // hash function.
+  static void
+  compute_hash_codes(const std::vector<Symbol*>& dynsyms,
+		     bool for_gnu_hash_table,
+		     std::vector<uint32_t>* hashvals);
 
   // Compute the number of hash buckets to use.
   static unsigned int
   compute_bucket_count(const std::vector<uint32_t>& hashcodes,
 		       bool for_gnu_hash_table);
 
+  // Compute the number of hash buckets to use when optimizing.
+  static unsigned int
+  optimize_bucket_count(const std::vector<uint32_t>& hashcodes,
+			bool for_gnu_hash_table);
+
   // Sized version of create_elf_hash_table.
   template<int size, bool big_endian>
   static void
@@ -29,6 +29,7 @@
 #include "dwarf.h"
 #include "symtab.h"
 #include "reloc.h"
+#include "gold-threads.h"
 #include "ehframe.h"
 
 namespace gold
@@ -185,11 +186,7 @@ Eh_frame_hdr::do_sized_write(Output_file* of)
       // PC values.  Then we sort the list and write it out.
 
       Fde_addresses<size> fde_addresses(this->fde_offsets_.size());
-      this->get_fde_addresses<size, big_endian>(of, &this->fde_offsets_,
-						&fde_addresses);
-
-      std::sort(fde_addresses.begin(), fde_addresses.end(),
-		Fde_address_compare<size>());
+      this->get_sorted_fde_addresses<size, big_endian>(of, &fde_addresses);
 
       typename elfcpp::Elf_types<size>::Elf_Addr output_address;
       output_address = this->address();
@@ -290,17 +287,101 @@ Eh_frame_hdr::get_fde_pc(
   return pc;
 }
 
-// Given an array of FDE offsets in the .eh_frame section, return an
-// array of offsets from the exception frame header to the FDE's
-// output PC and to the output address of the FDE itself.  We get the
-// FDE's PC by actually looking in the .eh_frame section we just wrote
-// to the output file.
+// Find the output PC and the output address of the FDEs in a range
+// of fde_offsets_, and sort them by PC.  We get the FDE's PC by
+// actually looking in the .eh_frame section we just wrote to the
+// output file.
+
+template<int size, bool big_endian>
+class Eh_frame_hdr::Fde_addresses_work : public Parallel_work
+{
+ public:
+  typedef typename elfcpp::Elf_types<size>::Elf_Addr Address;
+
+  Fde_addresses_work(Eh_frame_hdr* hdr, Address eh_frame_address,
+		     const unsigned char* eh_frame_contents,
+		     Fde_addresses<size>* fde_addresses)
+    : hdr_(hdr), eh_frame_address_(eh_frame_address),
+      eh_frame_contents_(eh_frame_contents), fde_addresses_(fde_addresses)
+  { }
+
+  void
+  run_piece(unsigned int, size_t start, size_t end)
+  {
+    for (size_t i = start; i < end; ++i)
+      {
+	const Fde_offset& fo(this->hdr_->fde_offsets_[i]);
+	Address fde_pc;
+	fde_pc = this->hdr_->template get_fde_pc<size, big_endian>(
+	    this->eh_frame_address_, this->eh_frame_contents_,
+	    fo.first, fo.second);
+	this->fde_addresses_->set(i, fde_pc,
+				  this->eh_frame_address_ + fo.first);
+      }
+    std::sort(this->fde_addresses_->begin() + start,
+	      this->fde_addresses_->begin() + end,
+	      Fde_address_compare<size>());
+  }
+
+ private:
+  Eh_frame_hdr* hdr_;
+  Address eh_frame_address_;
+  const unsigned char* eh_frame_contents_;
+  Fde_addresses<size>* fde_addresses_;
+};
+
+// Merge pairs of adjacent sorted runs of FDE addresses from one list
+// into another.  Piece I merges runs 2*I and 2*I+1; an odd run at the
+// end is copied.
+
+template<int size>
+class Eh_frame_hdr::Fde_merge_work : public Parallel_work
+{
+ public:
+  Fde_merge_work(const std::vector<size_t>& runs, Fde_addresses<size>* from,
+		 Fde_addresses<size>* to)
+    : runs_(runs), from_(from), to_(to)
+  { }
+
+  void
+  run_piece(unsigned int, size_t start, size_t end)
+  {
+    for (size_t i = start; i < end; ++i)
+      {
+	size_t r = 2 * i;
+	typename Fde_addresses<size>::iterator pfrom = this->from_->begin();
+	typename Fde_addresses<size>::iterator pto = this->to_->begin();
+	if (r + 2 >= this->runs_.size())
+	  std::copy(pfrom + this->runs_[r], pfrom + this->runs_[r + 1],
+		    pto + this->runs_[r]);
+	else
+	  std::merge(pfrom + this->runs_[r], pfrom + this->runs_[r + 1],
+		     pfrom + this->runs_[r + 1], pfrom + this->runs_[r + 2],
+		     pto + this->runs_[r], Fde_address_compare<size>());
+      }
+  }
+
+ private:
+  const std::vector<size_t>& runs_;
+  Fde_addresses<size>* from_;
+  Fde_addresses<size>* to_;
+};
+
+// Below this number of FDEs we do not bother to use more than one
+// thread.
+
+static const size_t min_parallel_fdes = 16384;
+
+// Set FDE_ADDRESSES, which has one entry for each FDE in fde_offsets_,
+// to the offsets from the exception frame header to the FDE's output
+// PC and to the output address of the FDE itself, sorted by PC.  With
+// several threads, each sorts a part of the list, and the parts are
+// then merged in pairs.
 
 template<int size, bool big_endian>
 void
-Eh_frame_hdr::get_fde_addresses(Output_file* of,
-				const Fde_offsets* fde_offsets,
-				Fde_addresses<size>* fde_addresses)
+Eh_frame_hdr::get_sorted_fde_addresses(Output_file* of,
+				       Fde_addresses<size>* fde_addresses)
 {
   typename elfcpp::Elf_types<size>::Elf_Addr eh_frame_address;
   eh_frame_address = this->eh_frame_section_->address();
@@ -309,18 +390,46 @@ Eh_frame_hdr::get_fde_addresses(Output_file* of,
   const unsigned char* eh_frame_contents = of->get_input_view(eh_frame_offset,
 							      eh_frame_size);
 
-  for (Fde_offsets::const_iterator p = fde_offsets->begin();
-       p != fde_offsets->end();
-       ++p)
+  const size_t count = this->fde_offsets_.size();
+  gold_assert(fde_addresses->count() == count);
+  unsigned int pieces = parallel_piece_count(count, min_parallel_fdes);
+
+  Fde_addresses_work<size, big_endian> work(this, eh_frame_address,
+					    eh_frame_contents,
+					    fde_addresses);
+  run_in_parallel(&work, count, pieces);
+
+  of->free_input_view(eh_frame_offset, eh_frame_size, eh_frame_contents);
+
+  if (pieces == 1)
+    return;
+
+  // RUNS holds the boundaries of the sorted runs, which are the
+  // pieces chosen by run_in_parallel.
+  std::vector<size_t> runs(pieces + 1);
+  for (unsigned int i = 0; i <= pieces; ++i)
+    runs[i] = count * i / pieces;
+
+  Fde_addresses<size> other(count);
+  Fde_addresses<size>* from = fde_addresses;
+  Fde_addresses<size>* to = &other;
+  while (runs.size() > 2)
     {
-      typename elfcpp::Elf_types<size>::Elf_Addr fde_pc;
-      fde_pc = this->get_fde_pc<size, big_endian>(eh_frame_address,
-						  eh_frame_contents,
-						  p->first, p->second);
-      fde_addresses->push_back(fde_pc, eh_frame_address + p->first);
+      size_t merges = runs.size() / 2;
+      Fde_merge_work<size> merge(runs, from, to);
+      run_in_parallel(&merge, merges, merges);
+
+      std::vector<size_t> next_runs;
+      for (size_t i = 0; i < runs.size(); i += 2)
+	next_runs.push_back(runs[i]);
+      if (next_runs.back() != count)
+	next_runs.push_back(count);
+      runs.swap(next_runs);
+      std::swap(from, to);
     }
 
-  of->free_input_view(eh_frame_offset, eh_frame_size, eh_frame_contents);
+  if (from != fde_addresses)
+    fde_addresses->swap(*from);
 }
 
 // Class Fde.
@@ -525,6 +634,22 @@ operator<(const Cie& cie1, const Cie& cie2)
   return cie1.contents_ < cie2.contents_;
 }
 
+// Class Eh_frame_input.
+
+// Delete any CIEs and FDEs which were not added to an Eh_frame.
+
+Eh_frame_input::~Eh_frame_input()
+{
+  for (std::vector<Input_fde>::iterator p = this->fdes_.begin();
+       p != this->fdes_.end();
+       ++p)
+    delete p->fde;
+  for (std::vector<Input_cie>::iterator p = this->cies_.begin();
+       p != this->cies_.end();
+       ++p)
+    delete p->cie;
+}
+
 // Class Eh_frame.
 
 Eh_frame::Eh_frame()
@@ -577,6 +702,33 @@ Eh_frame::add_ehframe_input_section(
     unsigned int shndx,
     unsigned int reloc_shndx,
     unsigned int reloc_type)
+{
+  // The section may have been read along with the object's symbols.
+  Eh_frame_input* input = object->release_eh_frame_input(shndx);
+  if (input == NULL)
+    input = Eh_frame::read_ehframe_input_section(object, symbols,
+						 symbols_size, symbol_names,
+						 symbol_names_size, shndx,
+						 reloc_shndx, reloc_type);
+  Eh_frame_section_disposition disposition = this->add_input(object, input);
+  delete input;
+  return disposition;
+}
+
+// Read input section SHNDX in OBJECT into an Eh_frame_input.  The
+// arguments are as for add_ehframe_input_section.
+
+template<int size, bool big_endian>
+Eh_frame_input*
+Eh_frame::read_ehframe_input_section(
+    Sized_relobj_file<size, big_endian>* object,
+    const unsigned char* symbols,
+    section_size_type symbols_size,
+    const unsigned char* symbol_names,
+    section_size_type symbol_names_size,
+    unsigned int shndx,
+    unsigned int reloc_shndx,
+    unsigned int reloc_type)
 {
   // Get the section contents.
   section_size_type contents_len;
@@ -584,7 +736,7 @@ Eh_frame::add_ehframe_input_section(
 							    &contents_len,
 							    false);
   if (contents_len == 0)
-    return EH_EMPTY_SECTION;
+    return new Eh_frame_input(shndx, EH_EMPTY_SECTION);
 
   // If this is the marker section for the end of the data, then
   // return false to force it to be handled as an ordinary input
@@ -592,57 +744,113 @@ Eh_frame::add_ehframe_input_section(
   // of unrecognized .eh_frame sections.
   if (contents_len == 4
       && elfcpp::Swap<32, big_endian>::readval(pcontents) == 0)
-    return EH_END_MARKER_SECTION;
-
-  New_cies new_cies;
-  if (!this->do_add_ehframe_input_section(object, symbols, symbols_size,
-					  symbol_names, symbol_names_size,
-					  shndx, reloc_shndx,
-					  reloc_type, pcontents,
-					  contents_len, &new_cies))
+    return new Eh_frame_input(shndx, EH_END_MARKER_SECTION);
+
+  Eh_frame_input* input = new Eh_frame_input(shndx, EH_OPTIMIZABLE_SECTION);
+  if (!Eh_frame::do_read_ehframe_input_section(object, symbols, symbols_size,
+					       symbol_names, symbol_names_size,
+					       reloc_shndx, reloc_type,
+					       pcontents, contents_len, input))
+    {
+      delete input;
+      input = new Eh_frame_input(shndx, EH_UNRECOGNIZED_SECTION);
+    }
+  return input;
+}
+
+// Merge the CIEs and FDEs in INPUT, read from OBJECT, into the
+// output data.  This is done in the order in which the input sections
+// are laid out, so the result does not depend on the order in which
+// the sections were read.
+
+Eh_frame::Eh_frame_section_disposition
+Eh_frame::add_input(Relobj* object, Eh_frame_input* input)
+{
+  if (input->disposition() != EH_OPTIMIZABLE_SECTION)
     {
-      if (this->eh_frame_hdr_ != NULL)
+      if (input->disposition() == EH_UNRECOGNIZED_SECTION
+	  && this->eh_frame_hdr_ != NULL)
 	this->eh_frame_hdr_->found_unrecognized_eh_frame_section();
+      return input->disposition();
+    }
 
-      for (New_cies::iterator p = new_cies.begin();
-	   p != new_cies.end();
-	   ++p)
-	delete p->first;
+  const unsigned int shndx = input->shndx();
+
+  // Record the new CIEs, replacing any which we have already seen.
+  // We are deleting the replaced CIEs, and the FDEs for discarded
+  // sections.  Record that in our mapping from input sections to the
+  // output section.  At this point we don't know for sure that we
+  // are doing a special mapping for this input section, but that's
+  // OK--if we don't do a special mapping, nobody will ever ask for the
+  // mapping we add here.
+  std::vector<Cie*> cies;
+  cies.reserve(input->cies_.size());
+  for (std::vector<Eh_frame_input::Input_cie>::const_iterator p =
+	 input->cies_.begin();
+       p != input->cies_.end();
+       ++p)
+    {
+      if (!p->mergeable)
+	{
+	  this->unmergeable_cie_offsets_.push_back(p->cie);
+	  cies.push_back(p->cie);
+	  continue;
+	}
 
-      return EH_UNRECOGNIZED_SECTION;
+      std::pair<Cie_offsets::iterator, bool> ins =
+	this->cie_offsets_.insert(p->cie);
+      if (!ins.second)
+	{
+	  object->add_merge_mapping(this, shndx, p->offset, p->length, -1);
+	  delete p->cie;
+	}
+      cies.push_back(*ins.first);
     }
 
-  // Now that we know we are using this section, record any new CIEs
-  // that we found.
-  for (New_cies::const_iterator p = new_cies.begin();
-       p != new_cies.end();
+  for (std::vector<Eh_frame_input::Input_fde>::const_iterator p =
+	 input->fdes_.begin();
+       p != input->fdes_.end();
        ++p)
     {
-      if (p->second)
-	this->cie_offsets_.insert(p->first);
+      // If we have discarded the section for the code, we can also
+      // discard the FDE.
+      if (p->fde_shndx != 0 && !object->is_section_included(p->fde_shndx))
+	{
+	  p->fde->add_mapping(-1, this);
+	  delete p->fde;
+	}
       else
-	this->unmergeable_cie_offsets_.push_back(p->first);
+	cies[p->cie]->add_fde(p->fde);
     }
 
+  for (std::vector<Eh_frame_input::Discard>::const_iterator p =
+	 input->discards_.begin();
+       p != input->discards_.end();
+       ++p)
+    object->add_merge_mapping(this, shndx, p->first, p->second, -1);
+
+  // All the CIEs and FDEs now belong to us.
+  input->cies_.clear();
+  input->fdes_.clear();
+
   return EH_OPTIMIZABLE_SECTION;
 }
 
-// The bulk of the implementation of add_ehframe_input_section.
+// The bulk of the implementation of read_ehframe_input_section.
 
 template<int size, bool big_endian>
 bool
-Eh_frame::do_add_ehframe_input_section(
+Eh_frame::do_read_ehframe_input_section(
     Sized_relobj_file<size, big_endian>* object,
     const unsigned char* symbols,
     section_size_type symbols_size,
     const unsigned char* symbol_names,
     section_size_type symbol_names_size,
-    unsigned int shndx,
     unsigned int reloc_shndx,
     unsigned int reloc_type,
     const unsigned char* pcontents,
     section_size_type contents_len,
-    New_cies* new_cies)
+    Eh_frame_input* input)
 {
   Track_relocs<size, big_endian> relocs;
 
@@ -694,17 +902,18 @@ Eh_frame::do_add_ehframe_input_section(
       if (id == 0)
 	{
 	  // CIE.
-	  if (!this->read_cie(object, shndx, symbols, symbols_size,
-			      symbol_names, symbol_names_size,
-			      pcontents, p, pentend, &relocs, &cies,
-			      new_cies))
+	  if (!Eh_frame::read_cie(object, symbols, symbols_size,
+				  symbol_names, symbol_names_size,
+				  pcontents, p, pentend, &relocs, &cies,
+				  input))
 	    return false;
 	}
       else
 	{
 	  // FDE.
-	  if (!this->read_fde(object, shndx, symbols, symbols_size,
-			      pcontents, id, p, pentend, &relocs, &cies))
+	  if (!Eh_frame::read_fde(object, symbols, symbols_size,
+				  pcontents, id, p, pentend, &relocs, &cies,
+				  input))
 	    return false;
 	}
 
@@ -719,7 +928,6 @@ Eh_frame::do_add_ehframe_input_section(
 template<int size, bool big_endian>
 bool
 Eh_frame::read_cie(Sized_relobj_file<size, big_endian>* object,
-		   unsigned int shndx,
 		   const unsigned char* symbols,
 		   section_size_type symbols_size,
 		   const unsigned char* symbol_names,
@@ -729,7 +937,7 @@ Eh_frame::read_cie(Sized_relobj_file<size, big_endian>* object,
 		   const unsigned char* pcieend,
 		   Track_relocs<size, big_endian>* relocs,
 		   Offsets_to_cie* cies,
-		   New_cies* new_cies)
+		   Eh_frame_input* input)
 {
   bool mergeable = true;
 
@@ -922,48 +1130,38 @@ Eh_frame::read_cie(Sized_relobj_file<size, big_endian>* object,
   if (relocs->advance(pcieend - pcontents) > 0)
     return false;
 
-  Cie cie(object, shndx, (pcie - 8) - pcontents, fde_encoding, 
-	  personality_name, pcie, pcieend - pcie);
-  Cie* cie_pointer = NULL;
+  const unsigned int shndx = input->shndx();
+  const section_offset_type cie_offset = (pcie - 8) - pcontents;
+  const section_size_type cie_length = pcieend - (pcie - 8);
+  Cie cie(object, shndx, cie_offset, fde_encoding, personality_name, pcie,
+	  pcieend - pcie);
+
+  // See if we already saw this CIE in this section.  Eh_frame::add_input
+  // will look for it among the CIEs from other sections.
+  unsigned int cie_index = input->cies_.size();
   if (mergeable)
     {
-      Cie_offsets::iterator find_cie = this->cie_offsets_.find(&cie);
-      if (find_cie != this->cie_offsets_.end())
-	cie_pointer = *find_cie;
-      else
+      for (unsigned int i = 0; i < input->cies_.size(); ++i)
 	{
-	  // See if we already saw this CIE in this object file.
-	  for (New_cies::const_iterator pc = new_cies->begin();
-	       pc != new_cies->end();
-	       ++pc)
+	  if (input->cies_[i].mergeable && *input->cies_[i].cie == cie)
 	    {
-	      if (*(pc->first) == cie)
-		{
-		  cie_pointer = pc->first;
-		  break;
-		}
+	      cie_index = i;
+	      break;
 	    }
 	}
     }
 
-  if (cie_pointer == NULL)
-    {
-      cie_pointer = new Cie(cie);
-      new_cies->push_back(std::make_pair(cie_pointer, mergeable));
-    }
+  if (cie_index == input->cies_.size())
+    input->cies_.push_back(Eh_frame_input::Input_cie(new Cie(cie), mergeable,
+						     cie_offset, cie_length));
   else
     {
-      // We are deleting this CIE.  Record that in our mapping from
-      // input sections to the output section.  At this point we don't
-      // know for sure that we are doing a special mapping for this
-      // input section, but that's OK--if we don't do a special
-      // mapping, nobody will ever ask for the mapping we add here.
-      object->add_merge_mapping(this, shndx, (pcie - 8) - pcontents,
-                                pcieend - (pcie - 8), -1);
+      // We are deleting this CIE.
+      input->discards_.push_back(std::make_pair(cie_offset, cie_length));
     }
 
   // Record this CIE plus the offset in the input section.
-  cies->insert(std::make_pair(pcie - pcontents, cie_pointer));
+  cies->insert(std::make_pair(pcie - pcontents, cie_index));
 
   return true;
 }
@@ -973,7 +1171,6 @@ Eh_frame::read_cie(Sized_relobj_file<size, big_endian>* object,
 template<int size, bool big_endian>
 bool
 Eh_frame::read_fde(Sized_relobj_file<size, big_endian>* object,
-		   unsigned int shndx,
 		   const unsigned char* symbols,
 		   section_size_type symbols_size,
 		   const unsigned char* pcontents,
@@ -981,7 +1178,8 @@ Eh_frame::read_fde(Sized_relobj_file<size, big_endian>* object,
 		   const unsigned char* pfde,
 		   const unsigned char* pfdeend,
 		   Track_relocs<size, big_endian>* relocs,
-		   Offsets_to_cie* cies)
+		   Offsets_to_cie* cies,
+		   Eh_frame_input* input)
 {
   // OFFSET is the distance between the 4 bytes before PFDE to the
   // start of the CIE.  The offset we recorded for the CIE is 8 bytes
@@ -990,7 +1188,8 @@ Eh_frame::read_fde(Sized_relobj_file<size, big_endian>* object,
   Offsets_to_cie::const_iterator pcie = cies->find(cie_offset);
   if (pcie == cies->end())
     return false;
-  Cie* cie = pcie->second;
+  unsigned int cie_index = pcie->second;
+  const Cie* cie = input->cies_[cie_index].cie;
 
   int pc_size = 0;
   switch (cie->fde_encoding() & 7)
@@ -1046,8 +1245,8 @@ Eh_frame::read_fde(Sized_relobj_file<size, big_endian>* object,
 	{
 	  // This FDE applies to a discarded function.  We
 	  // can discard this FDE.
-	  object->add_merge_mapping(this, shndx, (pfde - 8) - pcontents,
-				    pfdeend - (pfde - 8), -1);
+	  input->discards_.push_back(std::make_pair((pfde - 8) - pcontents,
+						    pfdeend - (pfde - 8)));
 	  return true;
 	}
 
@@ -1065,8 +1264,9 @@ Eh_frame::read_fde(Sized_relobj_file<size, big_endian>* object,
   // pointer to a PC relative offset when generating a shared library.
   relocs->advance(pfdeend - pcontents);
 
-  // Find the section index for code that this FDE describes.
-  // If we have discarded the section, we can also discard the FDE.
+  // Find the section index for code that this FDE describes.  If we
+  // discard the section, we can also discard the FDE; we don't know
+  // that yet, so Eh_frame::add_input checks.
   unsigned int fde_shndx;
   const int sym_size = elfcpp::Elf_sizes<size>::sym_size;
   if (symndx >= symbols_size / sym_size)
@@ -1075,10 +1275,8 @@ Eh_frame::read_fde(Sized_relobj_file<size, big_endian>* object,
   bool is_ordinary;
   fde_shndx = object->adjust_sym_shndx(symndx, sym.get_st_shndx(),
 				       &is_ordinary);
-  bool is_discarded = (is_ordinary
-		       && fde_shndx != elfcpp::SHN_UNDEF
-		       && fde_shndx < object->shnum()
-		       && !object->is_section_included(fde_shndx));
+  if (!is_ordinary || fde_shndx >= object->shnum())
+    fde_shndx = 0;
 
   // Fetch the address range field from the FDE. The offset and size
   // of the field depends on the PC encoding given in the CIE, but
@@ -1101,17 +1299,19 @@ Eh_frame::read_fde(Sized_relobj_file<size, big_endian>* object,
       gold_unreachable();
     }
 
-  if (is_discarded || address_range == 0)
+  if (address_range == 0)
     {
       // This FDE applies to a discarded function.  We
       // can discard this FDE.
-      object->add_merge_mapping(this, shndx, (pfde - 8) - pcontents,
-                                pfdeend - (pfde - 8), -1);
+      input->discards_.push_back(std::make_pair((pfde - 8) - pcontents,
+						pfdeend - (pfde - 8)));
       return true;
     }
 
-  cie->add_fde(new Fde(object, shndx, (pfde - 8) - pcontents,
-		       pfde, pfdeend - pfde));
+  Fde* fde = new Fde(object, input->shndx(), (pfde - 8) - pcontents,
+		     pfde, pfdeend - pfde);
+  input->fdes_.push_back(Eh_frame_input::Input_fde(fde, cie_index,
+						   fde_shndx));
 
   return true;
 }
@@ -1322,6 +1522,18 @@ Eh_frame::add_ehframe_input_section<32, false>(
     unsigned int shndx,
     unsigned int reloc_shndx,
     unsigned int reloc_type);
+
+template
+Eh_frame_input*
+Eh_frame::read_ehframe_input_section<32, false>(
+    Sized_relobj_file<32, false>* object,
+    const unsigned char* symbols,
+    section_size_type symbols_size,
+    const unsigned char* symbol_names,
+    section_size_type symbol_names_size,
+    unsigned int shndx,
+    unsigned int reloc_shndx,
+    unsigned int reloc_type);
 #endif
 
 #ifdef HAVE_TARGET_32_BIG
@@ -1336,6 +1548,18 @@ Eh_frame::add_ehframe_input_section<32, true>(
     unsigned int shndx,
     unsigned int reloc_shndx,
     unsigned int reloc_type);
+
+template
+Eh_frame_input*
+Eh_frame::read_ehframe_input_section<32, true>(
+    Sized_relobj_file<32, true>* object,
+    const unsigned char* symbols,
+    section_size_type symbols_size,
+    const unsigned char* symbol_names,
+    section_size_type symbol_names_size,
+    unsigned int shndx,
+    unsigned int reloc_shndx,
+    unsigned int reloc_type);
 #endif
 
 #ifdef HAVE_TARGET_64_LITTLE
@@ -1350,6 +1574,18 @@ Eh_frame::add_ehframe_input_section<64, false>(
     unsigned int shndx,
     unsigned int reloc_shndx,
     unsigned int reloc_type);
+
+template
+Eh_frame_input*
+Eh_frame::read_ehframe_input_section<64, false>(
+    Sized_relobj_file<64, false>* object,
+    const unsigned char* symbols,
+    section_size_type symbols_size,
+    const unsigned char* symbol_names,
+    section_size_type symbol_names_size,
+    unsigned int shndx,
+    unsigned int reloc_shndx,
+    unsigned int reloc_type);
 #endif
 
 #ifdef HAVE_TARGET_64_BIG
@@ -1364,6 +1600,18 @@ Eh_frame::add_ehframe_input_section<64, true>(
     unsigned int shndx,
     unsigned int reloc_shndx,
     unsigned int reloc_type);
+
+template
+Eh_frame_input*
+Eh_frame::read_ehframe_input_section<64, true>(
+    Sized_relobj_file<64, true>* object,
+    const unsigned char* symbols,
+    section_size_type symbols_size,
+    const unsigned char* symbol_names,
+    section_size_type symbol_names_size,
+    unsigned int shndx,
+    unsigned int reloc_shndx,
+    unsigned int reloc_type);
 #endif
 
 } // End namespace gold.
@@ -102,14 +102,14 @@ class Eh_frame_hdr : public Output_section_data
     typedef typename std::vector<Fde_address> Fde_address_list;
     typedef typename Fde_address_list::iterator iterator;
 
-    Fde_addresses(unsigned int reserve)
-      : fde_addresses_()
-    { this->fde_addresses_.reserve(reserve); }
+    Fde_addresses(unsigned int count)
+      : fde_addresses_(count)
+    { }
 
     void
-    push_back(Address pc_address, Address fde_address)
+    set(unsigned int i, Address pc_address, Address fde_address)
     {
-      this->fde_addresses_.push_back(std::make_pair(pc_address, fde_address));
+      this->fde_addresses_[i] = std::make_pair(pc_address, fde_address);
     }
 
     iterator
@@ -120,20 +120,43 @@ class Eh_frame_hdr : public Output_section_data
     end()
     { return this->fde_addresses_.end(); }
 
+    size_t
+    count() const
+    { return this->fde_addresses_.size(); }
+
+    // Exchange the contents with another list of the same size.
+    void
+    swap(Fde_addresses& other)
+    { this->fde_addresses_.swap(other.fde_addresses_); }
+
    private:
     Fde_address_list fde_addresses_;
   };
 
-  // Compare Fde_address objects.
+  // Compare Fde_address objects.  FDEs for the same PC are ordered by
+  // address, so that the result does not depend on how the sort was
+  // divided among threads.
   template<int size>
   struct Fde_address_compare
   {
     bool
     operator()(const typename Fde_addresses<size>::Fde_address& f1,
 	       const typename Fde_addresses<size>::Fde_address& f2) const
-    { return f1.first < f2.first; }
+    {
+      if (f1.first != f2.first)
+	return f1.first < f2.first;
+      return f1.second < f2.second;
+    }
   };
 
+  // Work to find and sort the addresses of some of the FDEs.
+  template<int size, bool big_endian>
+  class Fde_addresses_work;
+
+  // Work to merge sorted runs of FDE addresses.
+  template<int size>
+  class Fde_merge_work;
+
   // Return the PC to which an FDE refers.
   template<int size, bool big_endian>
   typename elfcpp::Elf_types<size>::Elf_Addr
@@ -141,12 +164,12 @@ class Eh_frame_hdr : public Output_section_data
 	     const unsigned char* eh_frame_contents,
 	     section_offset_type fde_offset, unsigned char fde_encoding);
 
-  // Convert Fde_offsets to Fde_addresses.
+  // Convert Fde_offsets to Fde_addresses sorted by PC.
   template<int size, bool big_endian>
   void
-  get_fde_addresses(Output_file* of,
-		    const Fde_offsets* fde_offsets,
-		    Fde_addresses<size>* fde_addresses);
+  get_sorted_fde_addresses(Output_file* of,
+			   Fde_addresses<size>* fde_addresses);
+
 
   // The .eh_frame section.
   Output_section* eh_frame_section_;
@@ -373,6 +396,8 @@ class Cie
 extern bool operator<(const Cie&, const Cie&);
 extern bool operator==(const Cie&, const Cie&);
 
+class Eh_frame_input;
+
 // This class manages .eh_frame sections.  It discards duplicate
 // exception information.
 
@@ -411,6 +436,21 @@ class Eh_frame : public Output_section_data
 			    unsigned int shndx, unsigned int reloc_shndx,
 			    unsigned int reloc_type);
 
+  // Read the input section SHNDX in OBJECT, with arguments as for
+  // add_ehframe_input_section.  This does not look at anything shared
+  // with other objects, so different objects may be read at the same
+  // time.  The result may be passed to add_ehframe_input_section
+  // later by way of Sized_relobj_file::release_eh_frame_input.
+  template<int size, bool big_endian>
+  static Eh_frame_input*
+  read_ehframe_input_section(Sized_relobj_file<size, big_endian>* object,
+			     const unsigned char* symbols,
+			     section_size_type symbols_size,
+			     const unsigned char* symbol_names,
+			     section_size_type symbol_names_size,
+			     unsigned int shndx, unsigned int reloc_shndx,
+			     unsigned int reloc_type);
+
   // Add a CIE and an FDE for a PLT section, to permit unwinding
   // through a PLT.  The FDE data should start with 8 bytes of zero,
   // which will be replaced by a 4 byte PC relative reference to the
@@ -464,38 +504,32 @@ class Eh_frame : public Output_section_data
   // A list of unmergeable CIEs.
   typedef std::vector<Cie*> Unmergeable_cie_offsets;
 
-  // A mapping from offsets to CIEs.  This is used while reading an
-  // input section.
-  typedef std::map<uint64_t, Cie*> Offsets_to_cie;
-
-  // A list of CIEs, and a bool indicating whether the CIE is
-  // mergeable.
-  typedef std::vector<std::pair<Cie*, bool> > New_cies;
+  // A mapping from offsets to the index of a CIE in an Eh_frame_input.
+  // This is used while reading an input section.
+  typedef std::map<uint64_t, unsigned int> Offsets_to_cie;
 
   // Skip an LEB128.
   static bool
   skip_leb128(const unsigned char**, const unsigned char*);
 
-  // The implementation of add_ehframe_input_section.
+  // The bulk of read_ehframe_input_section.
   template<int size, bool big_endian>
-  bool
-  do_add_ehframe_input_section(Sized_relobj_file<size, big_endian>* object,
-			       const unsigned char* symbols,
-			       section_size_type symbols_size,
-			       const unsigned char* symbol_names,
-			       section_size_type symbol_names_size,
-			       unsigned int shndx,
-			       unsigned int reloc_shndx,
-			       unsigned int reloc_type,
-			       const unsigned char* pcontents,
-			       section_size_type contents_len,
-			       New_cies*);
+  static bool
+  do_read_ehframe_input_section(Sized_relobj_file<size, big_endian>* object,
+				const unsigned char* symbols,
+				section_size_type symbols_size,
+				const unsigned char* symbol_names,
+				section_size_type symbol_names_size,
+				unsigned int reloc_shndx,
+				unsigned int reloc_type,
+				const unsigned char* pcontents,
+				section_size_type contents_len,
+				Eh_frame_input*);
 
   // Read a CIE.
   template<int size, bool big_endian>
-  bool
+  static bool
   read_cie(Sized_relobj_file<size, big_endian>* object,
-	   unsigned int shndx,
 	   const unsigned char* symbols,
 	   section_size_type symbols_size,
 	   const unsigned char* symbol_names,
@@ -505,13 +539,12 @@ class Eh_frame : public Output_section_data
 	   const unsigned char* pcieend,
 	   Track_relocs<size, big_endian>* relocs,
 	   Offsets_to_cie* cies,
-	   New_cies* new_cies);
+	   Eh_frame_input* input);
 
   // Read an FDE.
   template<int size, bool big_endian>
-  bool
+  static bool
   read_fde(Sized_relobj_file<size, big_endian>* object,
-	   unsigned int shndx,
 	   const unsigned char* symbols,
 	   section_size_type symbols_size,
 	   const unsigned char* pcontents,
@@ -519,7 +552,13 @@ class Eh_frame : public Output_section_data
 	   const unsigned char* pfde,
 	   const unsigned char* pfdeend,
 	   Track_relocs<size, big_endian>* relocs,
-	   Offsets_to_cie* cies);
+	   Offsets_to_cie* cies,
+	   Eh_frame_input* input);
+
+  // Merge the CIEs and FDEs read from an input section of OBJECT into
+  // the output data.
+  Eh_frame_section_disposition
+  add_input(Relobj* object, Eh_frame_input* input);
 
   // Template version of write function.
   template<int size, bool big_endian>
@@ -541,6 +580,83 @@ class Eh_frame : public Output_section_data
   section_size_type final_data_size_;
 };
 
+// The CIEs and FDEs read from one input .eh_frame section, before
+// they are merged into the Eh_frame data.
+
+class Eh_frame_input
+{
+ public:
+  Eh_frame_input(unsigned int shndx,
+		 Eh_frame::Eh_frame_section_disposition disposition)
+    : shndx_(shndx), disposition_(disposition), cies_(), fdes_(),
+      discards_()
+  { }
+
+  ~Eh_frame_input();
+
+  // The index of the input section.
+  unsigned int
+  shndx() const
+  { return this->shndx_; }
+
+  // What to do with the input section.
+  Eh_frame::Eh_frame_section_disposition
+  disposition() const
+  { return this->disposition_; }
+
+  void
+  set_disposition(Eh_frame::Eh_frame_section_disposition disposition)
+  { this->disposition_ = disposition; }
+
+ private:
+  friend class Eh_frame;
+
+  // A CIE, with its location in the input section.  Identical
+  // mergeable CIEs within one section have already been combined.
+  struct Input_cie
+  {
+    Input_cie(Cie* c, bool m, section_offset_type o, section_size_type l)
+      : cie(c), mergeable(m), offset(o), length(l)
+    { }
+
+    Cie* cie;
+    bool mergeable;
+    section_offset_type offset;
+    section_size_type length;
+  };
+
+  // An FDE, with the index of its CIE in cies_.  FDE_SHNDX is the
+  // section the FDE describes, or 0 if it need not be checked: the
+  // FDE is dropped if that section turns out not to be included.
+  struct Input_fde
+  {
+    Input_fde(Fde* f, unsigned int c, unsigned int s)
+      : fde(f), cie(c), fde_shndx(s)
+    { }
+
+    Fde* fde;
+    unsigned int cie;
+    unsigned int fde_shndx;
+  };
+
+  // A range of the input section which is dropped from the output.
+  typedef std::pair<section_offset_type, section_size_type> Discard;
+
+  Eh_frame_input(const Eh_frame_input&);
+  Eh_frame_input& operator=(const Eh_frame_input&);
+
+  // The input section index.
+  unsigned int shndx_;
+  // What to do with the section.
+  Eh_frame::Eh_frame_section_disposition disposition_;
+  // The CIEs, in the order in which they were seen.
+  std::vector<Input_cie> cies_;
+  // The FDEs, in the order in which they were seen.
+  std::vector<Input_fde> fdes_;
+  // Duplicate CIEs and FDEs for discarded code.
+  std::vector<Discard> discards_;
+};
+
 } // End namespace gold.
 
 #endif // !defined(GOLD_EHFRAME_H)
@@ -124,6 +124,7 @@ static Initialize_lock file_counts_initialize_lock(&file_counts_lock);
 unsigned long long File_read::total_mapped_bytes;
 unsigned long long File_read::current_mapped_bytes;
 unsigned long long File_read::maximum_mapped_bytes;
+unsigned int File_read::total_released_files;
 std::vector<std::string> File_read::files_read;
 
 // Class File_read::View.
@@ -153,6 +154,46 @@ File_read::View::~View()
     }
 }
 
+// Give the system advice ADVICE about the data in the view from file
+// offset START for SIZE bytes.
+
+#if defined(HAVE_MMAP) && defined(MADV_NORMAL)
+
+void
+File_read::View::advise(off_t start, section_size_type size,
+			int advice) const
+{
+  if (this->data_ownership_ != DATA_MMAPPED)
+    return;
+
+  off_t end = start + static_cast<off_t>(size);
+  off_t view_end = this->start_ + static_cast<off_t>(this->size_);
+  if (start < this->start_)
+    start = this->start_;
+  if (end > view_end)
+    end = view_end;
+  if (end <= start)
+    return;
+
+  // The mapping starts on a page boundary, and madvise requires that
+  // the address it is passed does too.
+  static const long sys_page_size = ::sysconf(_SC_PAGESIZE);
+  off_t offset = start - this->start_;
+  if (sys_page_size > 0)
+    offset &= ~ static_cast<off_t>(sys_page_size - 1);
+  ::madvise(const_cast<unsigned char*>(this->data_) + offset,
+	    end - this->start_ - offset, advice);
+}
+
+#else // !(defined(HAVE_MMAP) && defined(MADV_NORMAL))
+
+void
+File_read::View::advise(off_t, section_size_type, int) const
+{
+}
+
+#endif // !(defined(HAVE_MMAP) && defined(MADV_NORMAL))
+
 void
 File_read::View::lock()
 {
@@ -288,6 +329,28 @@ File_read::release()
 	}
     }
 
+#ifdef MADV_DONTNEED
+  // The last object which reads the file is done with it, so let the
+  // system reclaim the memory of a mapping of the whole file.  If we
+  // do read it again, the data is read back from the file.
+  if (this->release_pages_)
+    {
+      this->release_pages_ = false;
+      if (this->whole_file_view_ != NULL
+	  && this->object_count_ <= 1
+	  && !this->is_archive_)
+	{
+	  this->whole_file_view_->advise(0, this->size_, MADV_DONTNEED);
+	  if (!parameters->options_valid() || parameters->options().stats())
+	    {
+	      file_counts_initialize_lock.initialize();
+	      Hold_optional_lock hl(file_counts_lock);
+	      ++File_read::total_released_files;
+	    }
+	}
+    }
+#endif
+
   this->released_ = true;
 }
 
@@ -324,6 +387,41 @@ File_read::is_locked() const
   return false;
 }
 
+// Return whether to give the system hints about reading input files.
+// Options may not yet be ready, e.g., when reading a version script.
+
+bool
+File_read::use_access_hints()
+{
+  return (parameters->options_valid()
+	  && parameters->options().file_access_hints());
+}
+
+// Tell the system that we will soon read SIZE bytes starting at file
+// offset START.  If the whole file is mapped, advise the mapping;
+// otherwise advise the file, so that the data is in the page cache
+// by the time we map or read it.
+
+void
+File_read::will_need(off_t start, section_size_type size)
+{
+  if (size == 0 || !File_read::use_access_hints())
+    return;
+
+  if (this->whole_file_view_ != NULL)
+    {
+#ifdef MADV_WILLNEED
+      this->whole_file_view_->advise(start, size, MADV_WILLNEED);
+#endif
+      return;
+    }
+
+#ifdef POSIX_FADV_WILLNEED
+  this->reopen_descriptor();
+  ::posix_fadvise(this->descriptor_, start, size, POSIX_FADV_WILLNEED);
+#endif
+}
+
 // See if we have a view which covers the file starting at START for
 // SIZE bytes.  Return a pointer to the View if found, NULL if not.
 // If BYTESHIFT is not -1U, the returned View must have the specified
@@ -614,9 +712,18 @@ File_read::find_or_make_view(off_t offset, off_t start,
 
   // Make a new view.  If we don't need an aligned view, use a
   // byteshift of 0, so that we can use mmap.
-  return this->make_view(offset + start, size,
-			 aligned ? byteshift : 0,
-			 cache);
+  v = this->make_view(offset + start, size, aligned ? byteshift : 0, cache);
+
+#ifdef MADV_SEQUENTIAL
+  // Data which is not cached is normally read once, from start to
+  // end, so the system can read ahead and drop the pages behind.
+  if (!cache
+      && size >= File_read::min_sequential_view_size
+      && File_read::use_access_hints())
+    v->advise(v->start(), v->size(), MADV_SEQUENTIAL);
+#endif
+
+  return v;
 }
 
 // Get a view into the file.
@@ -791,6 +898,12 @@ File_read::clear_view_cache_marks()
        p != this->saved_views_.end();
        ++p)
     (*p)->clear_cache();
+
+  // Members of an archive share its mapping, so only a file read by
+  // one object is given back to the system, and only once the object
+  // releases it.
+  if (!this->is_archive_ && File_read::use_access_hints())
+    this->release_pages_ = true;
 }
 
 // Remove all the file views.  For a file which has multiple
@@ -866,6 +979,8 @@ File_read::print_stats()
 	  program_name, File_read::total_mapped_bytes);
   fprintf(stderr, _("%s: maximum bytes mapped for read at one time: %llu\n"),
 	  program_name, File_read::maximum_mapped_bytes);
+  fprintf(stderr, _("%s: files released after reading: %u\n"),
+	  program_name, File_read::total_released_files);
 }
 
 // Class File_view.
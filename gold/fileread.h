@@ -72,7 +72,8 @@ class File_read
   File_read()
     : name_(), descriptor_(-1), is_descriptor_opened_(false), object_count_(0),
       size_(0), token_(false), views_(), saved_views_(), mapped_bytes_(0),
-      released_(true), whole_file_view_(NULL)
+      released_(true), whole_file_view_(NULL), is_archive_(false),
+      release_pages_(false)
   { }
 
   ~File_read();
@@ -103,6 +104,12 @@ class File_read
   remove_object()
   { --this->object_count_; }
 
+  // Record that the file is an archive, whose members may share its
+  // views.
+  void
+  set_is_archive()
+  { this->is_archive_ = true; }
+
   // Lock the file for exclusive access within a particular Task::run
   // execution.  This routine may only be called when the workqueue
   // lock is held.
@@ -168,10 +175,19 @@ class File_read
   get_lasting_view(off_t offset, off_t start, section_size_type size,
 		   bool aligned, bool cache);
 
-  // Mark all views as no longer cached.
+  // Mark all views as no longer cached.  Unless the file is an
+  // archive, this also means that the object is done reading the
+  // file, so the memory of a mapping of the whole file is given back
+  // to the system when the object releases the file.
   void
   clear_view_cache_marks();
 
+  // Tell the system that we will soon read SIZE bytes of the file
+  // starting at file offset START, so that it can start reading them
+  // in the background.  This is only a hint.
+  void
+  will_need(off_t start, section_size_type size);
+
   // Discard all uncached views.  This is normally done by release(),
   // but not for objects in archives.  FIXME: This is a complicated
   // interface, and it would be nice to have something more automatic.
@@ -256,6 +272,10 @@ class File_read
   // --stats.
   static unsigned long long maximum_mapped_bytes;
 
+  // Number of files whose whole file mapping was given back to the
+  // system with MADV_DONTNEED if --stats.
+  static unsigned int total_released_files;
+
   // Set of names of all files read.
   static std::vector<std::string> files_read;
 
@@ -339,6 +359,16 @@ class File_read
     is_permanent_view() const
     { return this->data_ownership_ == DATA_NOT_OWNED; }
 
+    // Returns TRUE if the data is mapped from the file.
+    bool
+    is_mapped() const
+    { return this->data_ownership_ == DATA_MMAPPED; }
+
+    // Give the system advice ADVICE about how the data will be used,
+    // as for madvise.  Does nothing if the data is not mapped.
+    void
+    advise(off_t start, section_size_type size, int advice) const;
+
    private:
     View(const View&);
     View& operator=(const View&);
@@ -407,6 +437,14 @@ class File_read
   // The size of a file page for buffering data.
   static const off_t page_size = 8192;
 
+  // The size of the smallest uncached view for which we tell the
+  // system that the data will be read sequentially.
+  static const section_size_type min_sequential_view_size = 65536;
+
+  // Return whether to give the system hints about reading the file.
+  static bool
+  use_access_hints();
+
   // Given a file offset, return the page offset.
   static off_t
   page_offset(off_t file_offset)
@@ -454,6 +492,11 @@ class File_read
   // - The contents was specified in the constructor.  Used only for
   //   testing purposes).
   View* whole_file_view_;
+  // Whether the file is an archive.
+  bool is_archive_;
+  // Whether to give the memory of the whole file view back to the
+  // system when the file is released.
+  bool release_pages_;
 };
 
 // A view of file data that persists even when the file is unlocked.
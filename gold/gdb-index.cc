@@ -28,6 +28,8 @@
 #include "object.h"
 #include "output.h"
 #include "demangle.h"
+#include "workqueue.h"
+#include "int_encoding.h"
 
 namespace gold
 {
@@ -171,6 +173,264 @@ mapped_index_string_hash(const unsigned char* str)
   return r;
 }
 
+class Gdb_index_info_reader;
+
+// The results of scanning the .debug_info and .debug_types sections
+// of one input object.  The objects are scanned in parallel, so
+// everything found in an object is collected here, with CU and TU
+// indexes relative to the object, and Gdb_index::merge_scan then adds
+// it to the .gdb_index and .debug_names sections in input order.  The
+// symbol names are entered in a Stringpool local to the object, whose
+// keys are assigned in the order in which the names are first seen.
+// That is the order in which a single-threaded scan would add them to
+// the index, so the index does not depend on how the scans were
+// scheduled.
+
+class Gdb_index_scan
+{
+ public:
+  Gdb_index_scan(Relobj* object, bool build_gdb_index, bool build_debug_names)
+    : object_(object), build_gdb_index_(build_gdb_index),
+      build_debug_names_(build_debug_names), sections_(), comp_units_(),
+      type_units_(), ranges_(), symbols_(), stringpool_(), cu_pubname_map_(),
+      cu_pubtype_map_(), pubnames_table_(NULL), pubtypes_table_(NULL),
+      pubnames_mapped_(false), stmt_list_offset_(-1), cu_count_(0),
+      cu_nopubnames_count_(0), tu_count_(0), tu_nopubnames_count_(0)
+  { }
+
+  ~Gdb_index_scan();
+
+  // Return the object being scanned.
+  Relobj*
+  object() const
+  { return this->object_; }
+
+  // Return whether the results are for a .gdb_index section.  The
+  // address ranges are only needed for that.
+  bool
+  build_gdb_index() const
+  { return this->build_gdb_index_; }
+
+  // Return whether the results are for a .debug_names section.
+  bool
+  build_debug_names() const
+  { return this->build_debug_names_; }
+
+  // Record a .debug_info or .debug_types section to be scanned by
+  // scan_sections.
+  void
+  add_section(bool is_type_unit, unsigned int shndx, unsigned int reloc_shndx,
+	      unsigned int reloc_type)
+  {
+    Debug_section sec(is_type_unit, shndx, reloc_shndx, reloc_type);
+    this->sections_.push_back(sec);
+  }
+
+  // Return whether there are any sections recorded by add_section.
+  bool
+  has_sections() const
+  { return !this->sections_.empty(); }
+
+  // Scan the sections recorded by add_section.  The object must be
+  // locked.
+  void
+  scan_sections();
+
+  // Scan a .debug_info or .debug_types section.
+  void
+  scan(bool is_type_unit, const unsigned char* symbols, off_t symbols_size,
+       unsigned int shndx, unsigned int reloc_shndx, unsigned int reloc_type);
+
+  // Add a compilation unit.
+  int
+  add_comp_unit(off_t cu_offset, off_t cu_length)
+  {
+    ++this->cu_count_;
+    this->comp_units_.push_back(Gdb_index::Comp_unit(cu_offset, cu_length));
+    return this->comp_units_.size() - 1;
+  }
+
+  // Add a type unit.
+  int
+  add_type_unit(off_t tu_offset, off_t type_offset, uint64_t signature)
+  {
+    ++this->tu_count_;
+    this->type_units_.push_back(Gdb_index::Type_unit(tu_offset, type_offset,
+						     signature));
+    return this->type_units_.size() - 1;
+  }
+
+  // Record that a CU or TU has no pubnames or pubtypes.
+  void
+  add_nopubnames_unit(bool is_type_unit)
+  {
+    if (is_type_unit)
+      ++this->tu_nopubnames_count_;
+    else
+      ++this->cu_nopubnames_count_;
+  }
+
+  // Add an address range.
+  void
+  add_address_range_list(unsigned int cu_index, Dwarf_range_list* ranges)
+  {
+    this->ranges_.push_back(Gdb_index::Per_cu_range_list(this->object_,
+							 cu_index, ranges));
+  }
+
+  // Add a symbol.  FLAGS are the gdb_index version 7 flags to be stored in
+  // the high-byte of the cu_index field.  DIE_OFFSET is the offset
+  // within the unit of the DIE which defines the symbol, and TAG is
+  // the tag to use for it in .debug_names.
+  void
+  add_symbol(int cu_index, const char* sym_name, uint8_t flags,
+	     off_t die_offset, unsigned int tag);
+
+  // Return the offset into the pubnames table for the cu at the given
+  // offset.
+  off_t
+  find_pubname_offset(off_t cu_offset);
+
+  // Return the offset into the pubtypes table for the cu at the
+  // given offset.
+  off_t
+  find_pubtype_offset(off_t cu_offset);
+
+  // Return TRUE if we have already processed the pubnames and types
+  // set of the CUs and TUS associated with the statement list at
+  // OFFSET.
+  bool
+  pubnames_read(off_t offset) const
+  { return this->stmt_list_offset_ == offset; }
+
+  // Record that we have already read the pubnames associated with
+  // OFFSET.
+  void
+  set_pubnames_read(off_t offset)
+  { this->stmt_list_offset_ = offset; }
+
+  // Return a pointer to the given table.
+  Dwarf_pubnames_table*
+  pubnames_table()
+  { return pubnames_table_; }
+
+  Dwarf_pubnames_table*
+  pubtypes_table()
+  { return pubtypes_table_; }
+
+  // Add the statistics for this object to the totals.
+  void
+  add_stats() const;
+
+  // Print usage statistics.
+  static void
+  print_stats();
+
+ private:
+  friend class Gdb_index;
+
+  // A .debug_info or .debug_types section to scan.
+  struct Debug_section
+  {
+    Debug_section(bool is_tu, unsigned int index, unsigned int rel_index,
+		  unsigned int rel_type)
+      : is_type_unit(is_tu), shndx(index), reloc_shndx(rel_index),
+	reloc_type(rel_type)
+    { }
+
+    bool is_type_unit;
+    unsigned int shndx;
+    unsigned int reloc_shndx;
+    unsigned int reloc_type;
+  };
+
+  // A symbol found in this object.
+  struct Scanned_symbol
+  {
+    // The name, which is in stringpool_.
+    const char* name;
+    // The hash value computed by mapped_index_string_hash.
+    unsigned int hashval;
+    // The hash value computed by Debug_names::hash.
+    uint32_t names_hashval;
+    // The CUs and TUs in this object which define the symbol, for
+    // .gdb_index.
+    Gdb_index::Cu_vector* cu_vec;
+    // The DIEs in this object which define the symbol, for
+    // .debug_names.
+    Debug_names::Entry_vector* entries;
+  };
+
+  typedef Unordered_map<off_t, off_t> Pubname_offset_map;
+
+  // Create a map from dies to pubnames.
+  Dwarf_pubnames_table*
+  map_pubtable_to_dies(unsigned int attr,
+                       Gdb_index_info_reader* dwinfo,
+                       const unsigned char* symbols,
+                       off_t symbols_size);
+
+  // Wrapper for map_pubtable_to_dies
+  void
+  map_pubnames_and_types_to_dies(Gdb_index_info_reader* dwinfo,
+                                 const unsigned char* symbols,
+                                 off_t symbols_size);
+
+  // The object being scanned.
+  Relobj* object_;
+  // Whether we are building .gdb_index and .debug_names sections.
+  bool build_gdb_index_;
+  bool build_debug_names_;
+  // The sections waiting to be scanned.
+  std::vector<Debug_section> sections_;
+  // The DWARF compilation units.
+  std::vector<Gdb_index::Comp_unit> comp_units_;
+  // The DWARF type units.
+  std::vector<Gdb_index::Type_unit> type_units_;
+  // The address ranges.
+  std::vector<Gdb_index::Per_cu_range_list> ranges_;
+  // The symbols, indexed by their key in stringpool_ minus one.
+  std::vector<Scanned_symbol> symbols_;
+  // The names of the symbols.
+  Stringpool stringpool_;
+  // Maps from CU offsets to offsets in the pubnames and pubtypes
+  // tables.
+  Pubname_offset_map cu_pubname_map_;
+  Pubname_offset_map cu_pubtype_map_;
+  // Tables to store the pubnames section of the object.
+  Dwarf_pubnames_table* pubnames_table_;
+  Dwarf_pubnames_table* pubtypes_table_;
+  // Whether the pubnames and pubtypes tables have been read.
+  bool pubnames_mapped_;
+  // Stmt list offset of the CUs and TUs associated with the last read
+  // pubnames and pubtypes.
+  off_t stmt_list_offset_;
+  // Statistics for this object.
+  unsigned int cu_count_;
+  unsigned int cu_nopubnames_count_;
+  unsigned int tu_count_;
+  unsigned int tu_nopubnames_count_;
+
+  // Statistics.
+  // Total number of DWARF compilation units processed.
+  static unsigned int dwarf_cu_count;
+  // Number of DWARF compilation units with pubnames/pubtypes.
+  static unsigned int dwarf_cu_nopubnames_count;
+  // Total number of DWARF type units processed.
+  static unsigned int dwarf_tu_count;
+  // Number of DWARF type units with pubnames/pubtypes.
+  static unsigned int dwarf_tu_nopubnames_count;
+};
+
+// Total number of DWARF compilation units processed.
+unsigned int Gdb_index_scan::dwarf_cu_count = 0;
+// Number of DWARF compilation units without pubnames/pubtypes.
+unsigned int Gdb_index_scan::dwarf_cu_nopubnames_count = 0;
+// Total number of DWARF type units processed.
+unsigned int Gdb_index_scan::dwarf_tu_count = 0;
+// Number of DWARF type units without pubnames/pubtypes.
+unsigned int Gdb_index_scan::dwarf_tu_nopubnames_count = 0;
+
 // A specialization of Dwarf_info_reader, for building the .gdb_index.
 
 class Gdb_index_info_reader : public Dwarf_info_reader
@@ -183,19 +443,15 @@ class Gdb_index_info_reader : public Dwarf_info_reader
 			unsigned int shndx,
 			unsigned int reloc_shndx,
 			unsigned int reloc_type,
-			Gdb_index* gdb_index)
+			Gdb_index_scan* scan)
     : Dwarf_info_reader(is_type_unit, object, symbols, symbols_size, shndx,
 			reloc_shndx, reloc_type),
-      gdb_index_(gdb_index), cu_index_(0), cu_language_(0)
+      scan_(scan), cu_index_(0), cu_language_(0)
   { }
 
   ~Gdb_index_info_reader()
   { this->clear_declarations(); }
 
-  // Print usage statistics.
-  static void
-  print_stats();
-
  protected:
   // Visit a compilation unit.
   virtual void
@@ -279,14 +535,14 @@ class Gdb_index_info_reader : public Dwarf_info_reader
 
   // Read the .debug_pubnames and .debug_pubtypes tables.
   bool
-  read_pubtable(Dwarf_pubnames_table* table, off_t offset);
+  read_pubtable(Dwarf_pubnames_table* table, off_t offset, bool is_pubtypes);
 
   // Clear the declarations map.
   void
   clear_declarations();
 
-  // The Gdb_index section.
-  Gdb_index* gdb_index_;
+  // The results of the scan of the object.
+  Gdb_index_scan* scan_;
   // The current CU index (negative for a TU).
   int cu_index_;
   // The language of the current CU or TU.
@@ -294,35 +550,15 @@ class Gdb_index_info_reader : public Dwarf_info_reader
   // Map from DIE offset to (parent offset, name) pair,
   // for DW_AT_specification.
   Declaration_map declarations_;
-
-  // Statistics.
-  // Total number of DWARF compilation units processed.
-  static unsigned int dwarf_cu_count;
-  // Number of DWARF compilation units with pubnames/pubtypes.
-  static unsigned int dwarf_cu_nopubnames_count;
-  // Total number of DWARF type units processed.
-  static unsigned int dwarf_tu_count;
-  // Number of DWARF type units with pubnames/pubtypes.
-  static unsigned int dwarf_tu_nopubnames_count;
 };
 
-// Total number of DWARF compilation units processed.
-unsigned int Gdb_index_info_reader::dwarf_cu_count = 0;
-// Number of DWARF compilation units without pubnames/pubtypes.
-unsigned int Gdb_index_info_reader::dwarf_cu_nopubnames_count = 0;
-// Total number of DWARF type units processed.
-unsigned int Gdb_index_info_reader::dwarf_tu_count = 0;
-// Number of DWARF type units without pubnames/pubtypes.
-unsigned int Gdb_index_info_reader::dwarf_tu_nopubnames_count = 0;
-
 // Process a compilation unit and parse its child DIE.
 
 void
 Gdb_index_info_reader::visit_compilation_unit(off_t cu_offset, off_t cu_length,
 					      Dwarf_die* root_die)
 {
-  ++Gdb_index_info_reader::dwarf_cu_count;
-  this->cu_index_ = this->gdb_index_->add_comp_unit(cu_offset, cu_length);
+  this->cu_index_ = this->scan_->add_comp_unit(cu_offset, cu_length);
   this->visit_top_die(root_die);
 }
 
@@ -333,10 +569,9 @@ Gdb_index_info_reader::visit_type_unit(off_t tu_offset, off_t,
 				       off_t type_offset, uint64_t signature,
 				       Dwarf_die* root_die)
 {
-  ++Gdb_index_info_reader::dwarf_tu_count;
   // Use a negative index to flag this as a TU instead of a CU.
-  this->cu_index_ = -1 - this->gdb_index_->add_type_unit(tu_offset, type_offset,
-							 signature);
+  this->cu_index_ = -1 - this->scan_->add_type_unit(tu_offset, type_offset,
+						    signature);
   this->visit_top_die(root_die);
 }
 
@@ -375,15 +610,15 @@ Gdb_index_info_reader::visit_top_die(Dwarf_die* die)
 		|| this->cu_language_ == elfcpp::DW_LANG_Fortran03
 		|| this->cu_language_ == elfcpp::DW_LANG_Fortran08)
 	      {
-		gold_warning(_("%s: --gdb-index currently supports "
+		gold_warning(_("%s: %s currently supports "
 			       "only C and C++ languages"),
-			     this->object()->name().c_str());
+			     this->object()->name().c_str(),
+			     (this->scan_->build_gdb_index()
+			      ? "--gdb-index" : "--debug-names"));
 		return;
 	      }
-	    if (die->tag() == elfcpp::DW_TAG_compile_unit)
-	      ++Gdb_index_info_reader::dwarf_cu_nopubnames_count;
-	    else
-	      ++Gdb_index_info_reader::dwarf_tu_nopubnames_count;
+	    this->scan_->add_nopubnames_unit(die->tag()
+					     != elfcpp::DW_TAG_compile_unit);
 	    this->visit_children(die, NULL);
 	  }
 	break;
@@ -437,8 +672,9 @@ Gdb_index_info_reader::visit_die(Dwarf_die* die, Dwarf_die* context)
 	    // If the DIE is not a declaration, add it to the index.
 	    std::string full_name = this->get_qualified_name(die, context);
 	    if (!full_name.empty())
-	      this->gdb_index_->add_symbol(this->cu_index_,
-                                           full_name.c_str(), 0);
+	      this->scan_->add_symbol(this->cu_index_, full_name.c_str(), 0,
+				      die->offset(),
+				      Debug_names::index_tag(die->tag()));
 	  }
 	break;
       case elfcpp::DW_TAG_typedef:
@@ -477,8 +713,9 @@ Gdb_index_info_reader::visit_die(Dwarf_die* die, Dwarf_die* context)
 	      if (full_name.empty())
 		full_name = this->get_qualified_name(die, context);
 	      if (!full_name.empty())
-		this->gdb_index_->add_symbol(this->cu_index_,
-					     full_name.c_str(), 0);
+		this->scan_->add_symbol(this->cu_index_, full_name.c_str(), 0,
+					die->offset(),
+					Debug_names::index_tag(die->tag()));
 	    }
 
 	  // We're interested in the children only for namespaces and
@@ -817,6 +1054,10 @@ Gdb_index_info_reader::get_qualified_name(Dwarf_die* die, Dwarf_die* context)
 void
 Gdb_index_info_reader::record_cu_ranges(Dwarf_die* die)
 {
+  // Only the .gdb_index section has an address table.
+  if (!this->scan_->build_gdb_index())
+    return;
+
   unsigned int shndx;
   unsigned int shndx2;
 
@@ -825,8 +1066,7 @@ Gdb_index_info_reader::record_cu_ranges(Dwarf_die* die)
     {
       Dwarf_range_list* ranges = this->read_range_list(shndx, ranges_offset);
       if (ranges != NULL)
-	this->gdb_index_->add_address_range_list(this->object(),
-						 this->cu_index_, ranges);
+	this->scan_->add_address_range_list(this->cu_index_, ranges);
       return;
     }
 
@@ -851,17 +1091,39 @@ Gdb_index_info_reader::record_cu_ranges(Dwarf_die* die)
         {
 	  Dwarf_range_list* ranges = new Dwarf_range_list();
 	  ranges->add(shndx, low_pc, high_pc);
-	  this->gdb_index_->add_address_range_list(this->object(),
-						   this->cu_index_, ranges);
+	  this->scan_->add_address_range_list(this->cu_index_, ranges);
         }
     }
 }
 
+// Return the tag to use in .debug_names for a name in a pubnames
+// table, given the flags from a gnu-style table.  IS_PUBTYPES is true
+// for a pubtypes table.
+
+static unsigned int
+pubname_tag(uint8_t flag_byte, bool is_pubtypes)
+{
+  switch ((flag_byte >> 4) & 7)
+    {
+    case 1:	// GDB_INDEX_SYMBOL_KIND_TYPE
+      return elfcpp::DW_TAG_structure_type;
+    case 2:	// GDB_INDEX_SYMBOL_KIND_VARIABLE
+      return elfcpp::DW_TAG_variable;
+    case 3:	// GDB_INDEX_SYMBOL_KIND_FUNCTION
+      return elfcpp::DW_TAG_subprogram;
+    default:
+      return (is_pubtypes
+	      ? elfcpp::DW_TAG_structure_type
+	      : elfcpp::DW_TAG_variable);
+    }
+}
+
 // Read table and add the relevant names to the index.  Returns true
 // if any names were added.
 
 bool
-Gdb_index_info_reader::read_pubtable(Dwarf_pubnames_table* table, off_t offset)
+Gdb_index_info_reader::read_pubtable(Dwarf_pubnames_table* table, off_t offset,
+				     bool is_pubtypes)
 {
   // If we couldn't read the section when building the cu_pubname_map,
   // then we won't find any pubnames now.
@@ -873,11 +1135,13 @@ Gdb_index_info_reader::read_pubtable(Dwarf_pubnames_table* table, off_t offset)
   while (true)
     {
       uint8_t flag_byte;
-      const char* name = table->next_name(&flag_byte);
+      off_t die_offset;
+      const char* name = table->next_name(&flag_byte, &die_offset);
       if (name == NULL)
         break;
 
-      this->gdb_index_->add_symbol(this->cu_index_, name, flag_byte);
+      this->scan_->add_symbol(this->cu_index_, name, flag_byte, die_offset,
+			      pubname_tag(flag_byte, is_pubtypes));
     }
   return true;
 }
@@ -896,6 +1160,13 @@ Gdb_index_info_reader::read_pubnames_and_pubtypes(Dwarf_die* die)
       && die->string_attribute(elfcpp::DW_AT_GNU_dwo_name))
     return true;
 
+  // The .debug_names section needs the kind of each name, which only
+  // the gnu-style tables record.  For other tables, read the DIEs.
+  if (this->scan_->build_debug_names()
+      && this->scan_->pubnames_table() != NULL
+      && !this->scan_->pubnames_table()->is_gnu_style())
+    return false;
+
   // We use stmt_list_off as a unique identifier for the
   // compilation unit and its associated type units.
   unsigned int shndx;
@@ -916,8 +1187,7 @@ Gdb_index_info_reader::read_pubnames_and_pubtypes(Dwarf_die* die)
           // have read. If it does, then no need to read the pubnames.
           // If it doesn't, then the caller will have to parse the
           // dies manually to find the names.
-          return this->gdb_index_->pubnames_read(this->object(),
-                                                 stmt_list_off);
+          return this->scan_->pubnames_read(stmt_list_off);
         }
       else
         {
@@ -928,10 +1198,10 @@ Gdb_index_info_reader::read_pubnames_and_pubtypes(Dwarf_die* die)
 
   // We found the attribute, so we can check if the corresponding
   // pubnames have been read.
-  if (this->gdb_index_->pubnames_read(this->object(), stmt_list_off))
+  if (this->scan_->pubnames_read(stmt_list_off))
     return true;
 
-  this->gdb_index_->set_pubnames_read(this->object(), stmt_list_off);
+  this->scan_->set_pubnames_read(stmt_list_off);
 
   // We have an attribute, and the pubnames haven't been read, so read
   // them.
@@ -939,12 +1209,12 @@ Gdb_index_info_reader::read_pubnames_and_pubtypes(Dwarf_die* die)
   // In some of the cases, we could rely on the previous value of
   // offset here, but sorting out which cases complicates the logic
   // enough that it isn't worth it. So just look up the offset again.
-  offset = this->gdb_index_->find_pubname_offset(this->cu_offset());
-  names = this->read_pubtable(this->gdb_index_->pubnames_table(), offset);
+  offset = this->scan_->find_pubname_offset(this->cu_offset());
+  names = this->read_pubtable(this->scan_->pubnames_table(), offset, false);
 
   bool types = false;
-  offset = this->gdb_index_->find_pubtype_offset(this->cu_offset());
-  types = this->read_pubtable(this->gdb_index_->pubtypes_table(), offset);
+  offset = this->scan_->find_pubtype_offset(this->cu_offset());
+  types = this->read_pubtable(this->scan_->pubtypes_table(), offset, true);
   return names || types;
 }
 
@@ -964,67 +1234,29 @@ Gdb_index_info_reader::clear_declarations()
   this->declarations_.clear();
 }
 
-// Print usage statistics.
-void
-Gdb_index_info_reader::print_stats()
-{
-  fprintf(stderr, _("%s: DWARF CUs: %u\n"),
-          program_name, Gdb_index_info_reader::dwarf_cu_count);
-  fprintf(stderr, _("%s: DWARF CUs without pubnames/pubtypes: %u\n"),
-          program_name, Gdb_index_info_reader::dwarf_cu_nopubnames_count);
-  fprintf(stderr, _("%s: DWARF TUs: %u\n"),
-          program_name, Gdb_index_info_reader::dwarf_tu_count);
-  fprintf(stderr, _("%s: DWARF TUs without pubnames/pubtypes: %u\n"),
-          program_name, Gdb_index_info_reader::dwarf_tu_nopubnames_count);
-}
-
-// Class Gdb_index.
-
-// Construct the .gdb_index section.
+// Class Gdb_index_scan.
 
-Gdb_index::Gdb_index(Output_section* gdb_index_section)
-  : Output_section_data(4),
-    pubnames_table_(NULL),
-    pubtypes_table_(NULL),
-    gdb_index_section_(gdb_index_section),
-    comp_units_(),
-    type_units_(),
-    ranges_(),
-    cu_vector_list_(),
-    cu_vector_offsets_(NULL),
-    stringpool_(),
-    tu_offset_(0),
-    addr_offset_(0),
-    symtab_offset_(0),
-    cu_pool_offset_(0),
-    stringpool_offset_(0),
-    pubnames_object_(NULL),
-    stmt_list_offset_(-1)
-{
-  this->gdb_symtab_ = new Gdb_hashtab<Gdb_symbol>();
-}
-
-Gdb_index::~Gdb_index()
+Gdb_index_scan::~Gdb_index_scan()
 {
-  // Free the memory used by the symbol table.
-  delete this->gdb_symtab_;
-  // Free the memory used by the CU vectors.
-  for (unsigned int i = 0; i < this->cu_vector_list_.size(); ++i)
-    delete this->cu_vector_list_[i];
+  delete this->pubnames_table_;
+  delete this->pubtypes_table_;
+  for (unsigned int i = 0; i < this->symbols_.size(); ++i)
+    {
+      delete this->symbols_[i].cu_vec;
+      delete this->symbols_[i].entries;
+    }
 }
 
-
 // Scan the pubnames and pubtypes sections and build a map of the
 // various cus and tus they refer to, so we can process the entries
 // when we encounter the die for that cu or tu.
 // Return the just-read table so it can be cached.
 
 Dwarf_pubnames_table*
-Gdb_index::map_pubtable_to_dies(unsigned int attr,
-                                Gdb_index_info_reader* dwinfo,
-                                Relobj* object,
-                                const unsigned char* symbols,
-                                off_t symbols_size)
+Gdb_index_scan::map_pubtable_to_dies(unsigned int attr,
+				     Gdb_index_info_reader* dwinfo,
+				     const unsigned char* symbols,
+				     off_t symbols_size)
 {
   uint64_t section_offset = 0;
   Dwarf_pubnames_table* table;
@@ -1042,7 +1274,7 @@ Gdb_index::map_pubtable_to_dies(unsigned int attr,
     }
 
   map->clear();
-  if (!table->read_section(object, symbols, symbols_size))
+  if (!table->read_section(this->object_, symbols, symbols_size))
     return NULL;
 
   while (table->read_header(section_offset))
@@ -1057,30 +1289,28 @@ Gdb_index::map_pubtable_to_dies(unsigned int attr,
 // Wrapper for map_pubtable_to_dies
 
 void
-Gdb_index::map_pubnames_and_types_to_dies(Gdb_index_info_reader* dwinfo,
-                                          Relobj* object,
-                                          const unsigned char* symbols,
-                                          off_t symbols_size)
+Gdb_index_scan::map_pubnames_and_types_to_dies(Gdb_index_info_reader* dwinfo,
+					       const unsigned char* symbols,
+					       off_t symbols_size)
 {
-  // This is a new object, so reset the relevant variables.
-  this->pubnames_object_ = object;
+  this->pubnames_mapped_ = true;
   this->stmt_list_offset_ = -1;
 
   delete this->pubnames_table_;
   this->pubnames_table_
       = this->map_pubtable_to_dies(elfcpp::DW_AT_GNU_pubnames, dwinfo,
-                                   object, symbols, symbols_size);
+                                   symbols, symbols_size);
   delete this->pubtypes_table_;
   this->pubtypes_table_
       = this->map_pubtable_to_dies(elfcpp::DW_AT_GNU_pubtypes, dwinfo,
-                                   object, symbols, symbols_size);
+                                   symbols, symbols_size);
 }
 
 // Given a cu_offset, find the associated section of the pubnames
 // table.
 
 off_t
-Gdb_index::find_pubname_offset(off_t cu_offset)
+Gdb_index_scan::find_pubname_offset(off_t cu_offset)
 {
   Pubname_offset_map::iterator it = this->cu_pubname_map_.find(cu_offset);
   if (it != this->cu_pubname_map_.end())
@@ -1092,7 +1322,7 @@ Gdb_index::find_pubname_offset(off_t cu_offset)
 // table.
 
 off_t
-Gdb_index::find_pubtype_offset(off_t cu_offset)
+Gdb_index_scan::find_pubtype_offset(off_t cu_offset)
 {
   Pubname_offset_map::iterator it = this->cu_pubtype_map_.find(cu_offset);
   if (it != this->cu_pubtype_map_.end())
@@ -1100,81 +1330,426 @@ Gdb_index::find_pubtype_offset(off_t cu_offset)
   return -1;
 }
 
+// Scan the sections recorded by add_section.  This is called by a
+// Gdb_index_scan_task with the object locked.
+
+void
+Gdb_index_scan::scan_sections()
+{
+  Relobj* object = this->object_;
+
+  // We need the symbol table to interpret the relocations.
+  bool need_symbols = false;
+  for (unsigned int i = 0; i < this->sections_.size(); ++i)
+    if (this->sections_[i].reloc_shndx != 0)
+      need_symbols = true;
+
+  const unsigned char* symbols = NULL;
+  section_size_type symbols_size = 0;
+  if (need_symbols)
+    {
+      for (unsigned int shndx = 0; shndx < object->shnum(); ++shndx)
+	if (object->section_type(shndx) == elfcpp::SHT_SYMTAB)
+	  {
+	    symbols = object->section_contents(shndx, &symbols_size, false);
+	    break;
+	  }
+    }
+
+  for (unsigned int i = 0; i < this->sections_.size(); ++i)
+    {
+      const Debug_section& sec(this->sections_[i]);
+      this->scan(sec.is_type_unit, symbols, symbols_size, sec.shndx,
+		 sec.reloc_shndx, sec.reloc_type);
+    }
+  this->sections_.clear();
+}
+
 // Scan a .debug_info or .debug_types input section.
 
 void
-Gdb_index::scan_debug_info(bool is_type_unit,
-			   Relobj* object,
-			   const unsigned char* symbols,
-			   off_t symbols_size,
-			   unsigned int shndx,
-			   unsigned int reloc_shndx,
-			   unsigned int reloc_type)
+Gdb_index_scan::scan(bool is_type_unit,
+		     const unsigned char* symbols,
+		     off_t symbols_size,
+		     unsigned int shndx,
+		     unsigned int reloc_shndx,
+		     unsigned int reloc_type)
 {
-  Gdb_index_info_reader dwinfo(is_type_unit, object,
+  Gdb_index_info_reader dwinfo(is_type_unit, this->object_,
 			       symbols, symbols_size,
 			       shndx, reloc_shndx,
 			       reloc_type, this);
-  if (object != this->pubnames_object_)
-    map_pubnames_and_types_to_dies(&dwinfo, object, symbols, symbols_size);
+  if (!this->pubnames_mapped_)
+    this->map_pubnames_and_types_to_dies(&dwinfo, symbols, symbols_size);
   dwinfo.parse();
 }
 
-// Add a symbol.
+// Add a symbol.  The name is hashed here, rather than when the symbol
+// is added to the index, so that the hashing is done in parallel.
 
 void
-Gdb_index::add_symbol(int cu_index, const char* sym_name, uint8_t flags)
+Gdb_index_scan::add_symbol(int cu_index, const char* sym_name, uint8_t flags,
+			   off_t die_offset, unsigned int tag)
 {
-  unsigned int hash = mapped_index_string_hash(
-      reinterpret_cast<const unsigned char*>(sym_name));
-  Gdb_symbol* sym = new Gdb_symbol();
-  this->stringpool_.add(sym_name, true, &sym->name_key);
-  sym->hashval = hash;
-  sym->cu_vector_index = 0;
-
-  Gdb_symbol* found = this->gdb_symtab_->add(sym);
-  if (found == sym)
+  Stringpool::Key key;
+  const char* name = this->stringpool_.add(sym_name, true, &key);
+  if (key > this->symbols_.size())
     {
       // New symbol -- allocate a new CU index vector.
-      found->cu_vector_index = this->cu_vector_list_.size();
-      this->cu_vector_list_.push_back(new Cu_vector());
-    }
-  else
-    {
-      // Found an existing symbol -- append to the existing
-      // CU index vector.
-      delete sym;
+      gold_assert(key == this->symbols_.size() + 1);
+      Scanned_symbol sym;
+      sym.name = name;
+      sym.hashval = 0;
+      sym.names_hashval = 0;
+      sym.cu_vec = NULL;
+      sym.entries = NULL;
+      if (this->build_gdb_index_)
+	{
+	  sym.hashval = mapped_index_string_hash(
+	      reinterpret_cast<const unsigned char*>(name));
+	  sym.cu_vec = new Gdb_index::Cu_vector();
+	}
+      if (this->build_debug_names_)
+	{
+	  sym.names_hashval = Debug_names::hash(name);
+	  sym.entries = new Debug_names::Entry_vector();
+	}
+      this->symbols_.push_back(sym);
     }
 
   // Add the CU index to the vector list for this symbol,
   // if it's not already on the list.  We only need to
   // check the last added entry.
-  Cu_vector* cu_vec = this->cu_vector_list_[found->cu_vector_index];
-  if (cu_vec->size() == 0
-      || cu_vec->back().first != cu_index
-      || cu_vec->back().second != flags)
+  Gdb_index::Cu_vector* cu_vec = this->symbols_[key - 1].cu_vec;
+  if (cu_vec != NULL
+      && (cu_vec->size() == 0
+	  || cu_vec->back().first != cu_index
+	  || cu_vec->back().second != flags))
     cu_vec->push_back(std::make_pair(cu_index, flags));
+
+  // Likewise for the DIE.  The kind of symbol is only known if the
+  // flags came from a gnu-style pubnames table.
+  Debug_names::Entry_vector* entries = this->symbols_[key - 1].entries;
+  if (entries != NULL)
+    {
+      Debug_names::Linkage linkage = Debug_names::LINKAGE_UNKNOWN;
+      if (((flags >> 4) & 7) != 0)
+	linkage = ((flags & 0x80) != 0
+		   ? Debug_names::LINKAGE_INTERNAL
+		   : Debug_names::LINKAGE_EXTERNAL);
+      Debug_names::Entry entry(cu_index, die_offset, tag, linkage);
+      if (entries->empty() || !(entries->back() == entry))
+	entries->push_back(entry);
+    }
 }
 
-// Return TRUE if we have already processed the pubnames associated
-// with the statement list at the given OFFSET.
+// Add the statistics for this object to the totals.
 
-bool
-Gdb_index::pubnames_read(const Relobj* object, off_t offset)
+void
+Gdb_index_scan::add_stats() const
 {
-  bool ret = (this->pubnames_object_ == object
-	      && this->stmt_list_offset_ == offset);
-  return ret;
+  Gdb_index_scan::dwarf_cu_count += this->cu_count_;
+  Gdb_index_scan::dwarf_cu_nopubnames_count += this->cu_nopubnames_count_;
+  Gdb_index_scan::dwarf_tu_count += this->tu_count_;
+  Gdb_index_scan::dwarf_tu_nopubnames_count += this->tu_nopubnames_count_;
+}
+
+// Print usage statistics.
+void
+Gdb_index_scan::print_stats()
+{
+  fprintf(stderr, _("%s: DWARF CUs: %u\n"),
+          program_name, Gdb_index_scan::dwarf_cu_count);
+  fprintf(stderr, _("%s: DWARF CUs without pubnames/pubtypes: %u\n"),
+          program_name, Gdb_index_scan::dwarf_cu_nopubnames_count);
+  fprintf(stderr, _("%s: DWARF TUs: %u\n"),
+          program_name, Gdb_index_scan::dwarf_tu_count);
+  fprintf(stderr, _("%s: DWARF TUs without pubnames/pubtypes: %u\n"),
+          program_name, Gdb_index_scan::dwarf_tu_nopubnames_count);
 }
 
-// Record that we have processed the pubnames associated with the
-// statement list for OBJECT at the given OFFSET.
+// This task scans the .debug_info and .debug_types sections of one
+// input object for the .gdb_index section.
+
+class Gdb_index_scan_task : public Task
+{
+ public:
+  Gdb_index_scan_task(Gdb_index_scan* scan, Task_token* scan_blocker)
+    : scan_(scan), scan_blocker_(scan_blocker)
+  { }
+
+  Task_token*
+  is_runnable()
+  {
+    Relobj* object = this->scan_->object();
+    return object->is_locked() ? object->token() : NULL;
+  }
+
+  // Lock the object, and unblock SCAN_BLOCKER_ when done.
+  void
+  locks(Task_locker* tl)
+  {
+    Task_token* token = this->scan_->object()->token();
+    if (token != NULL)
+      tl->add(this, token);
+    tl->add(this, this->scan_blocker_);
+  }
+
+  void
+  run(Workqueue*)
+  {
+    this->scan_->scan_sections();
+    this->scan_->object()->release();
+  }
+
+  std::string
+  get_name() const
+  { return "Gdb_index_scan_task " + this->scan_->object()->name(); }
+
+ private:
+  Gdb_index_scan* scan_;
+  Task_token* scan_blocker_;
+};
+
+// This task runs after the Gdb_index_scan_tasks and the task which
+// releases THIS_BLOCKER.  It adds the results of the scans to the
+// index, and then unblocks NEXT_BLOCKER.
+
+class Gdb_index_merge_task : public Task
+{
+ public:
+  Gdb_index_merge_task(Gdb_index* gdb_index, Task_token* this_blocker,
+		       Task_token* scan_blocker, Task_token* next_blocker)
+    : gdb_index_(gdb_index), this_blocker_(this_blocker),
+      scan_blocker_(scan_blocker), next_blocker_(next_blocker)
+  { }
+
+  ~Gdb_index_merge_task()
+  {
+    if (this->this_blocker_ != NULL)
+      delete this->this_blocker_;
+    delete this->scan_blocker_;
+  }
+
+  Task_token*
+  is_runnable()
+  {
+    if (this->this_blocker_ != NULL && this->this_blocker_->is_blocked())
+      return this->this_blocker_;
+    if (this->scan_blocker_->is_blocked())
+      return this->scan_blocker_;
+    return NULL;
+  }
+
+  void
+  locks(Task_locker* tl)
+  { tl->add(this, this->next_blocker_); }
+
+  void
+  run(Workqueue*)
+  { this->gdb_index_->merge_scans(); }
+
+  std::string
+  get_name() const
+  { return "Gdb_index_merge_task"; }
+
+ private:
+  Gdb_index* gdb_index_;
+  Task_token* this_blocker_;
+  Task_token* scan_blocker_;
+  Task_token* next_blocker_;
+};
+
+// Class Gdb_index.
+
+// Construct the .gdb_index section.
+
+Gdb_index::Gdb_index(Output_section* gdb_index_section)
+  : Output_section_data(4),
+    gdb_index_section_(gdb_index_section),
+    debug_names_(NULL),
+    scans_(),
+    scan_tasks_queued_(false),
+    comp_units_(),
+    type_units_(),
+    ranges_(),
+    cu_vector_list_(),
+    cu_vector_offsets_(NULL),
+    stringpool_(),
+    tu_offset_(0),
+    addr_offset_(0),
+    symtab_offset_(0),
+    cu_pool_offset_(0),
+    stringpool_offset_(0)
+{
+  this->gdb_symtab_ = new Gdb_hashtab<Gdb_symbol>();
+}
+
+Gdb_index::~Gdb_index()
+{
+  // Free the memory used by the symbol table.
+  delete this->gdb_symtab_;
+  // Free the memory used by the CU vectors.
+  for (unsigned int i = 0; i < this->cu_vector_list_.size(); ++i)
+    delete this->cu_vector_list_[i];
+  for (unsigned int i = 0; i < this->scans_.size(); ++i)
+    delete this->scans_[i];
+}
+
+// Scan a .debug_info or .debug_types input section.  The sections of
+// an object are passed consecutively.  For an incremental link the
+// section is scanned now, since the scan tasks are not used.
 
 void
-Gdb_index::set_pubnames_read(const Relobj* object, off_t offset)
+Gdb_index::scan_debug_info(bool is_type_unit,
+			   Relobj* object,
+			   const unsigned char* symbols,
+			   off_t symbols_size,
+			   unsigned int shndx,
+			   unsigned int reloc_shndx,
+			   unsigned int reloc_type)
+{
+  gold_assert(!this->scan_tasks_queued_);
+  if (this->scans_.empty() || this->scans_.back()->object() != object)
+    this->scans_.push_back(new Gdb_index_scan(object,
+					      this->gdb_index_section_ != NULL,
+					      this->debug_names_ != NULL));
+  Gdb_index_scan* scan = this->scans_.back();
+
+  if (parameters->incremental())
+    scan->scan(is_type_unit, symbols, symbols_size, shndx, reloc_shndx,
+	       reloc_type);
+  else
+    scan->add_section(is_type_unit, shndx, reloc_shndx, reloc_type);
+}
+
+// Queue a task to scan each object with recorded sections, and a task
+// to merge the results once they and THIS_BLOCKER are done.
+
+Task_token*
+Gdb_index::queue_scan_tasks(Workqueue* workqueue, Task_token* this_blocker)
 {
-  this->pubnames_object_ = object;
-  this->stmt_list_offset_ = offset;
+  gold_assert(!this->scan_tasks_queued_);
+  this->scan_tasks_queued_ = true;
+
+  // Set the count before queuing any task, since the tasks may start
+  // running immediately.
+  Task_token* scan_blocker = new Task_token(true);
+  unsigned int count = 0;
+  for (unsigned int i = 0; i < this->scans_.size(); ++i)
+    if (this->scans_[i]->has_sections())
+      ++count;
+  scan_blocker->add_blockers(count);
+
+  for (unsigned int i = 0; i < this->scans_.size(); ++i)
+    if (this->scans_[i]->has_sections())
+      workqueue->queue(new Gdb_index_scan_task(this->scans_[i],
+					       scan_blocker));
+
+  Task_token* next_blocker = new Task_token(true);
+  next_blocker->add_blocker();
+  workqueue->queue(new Gdb_index_merge_task(this, this_blocker, scan_blocker,
+					    next_blocker));
+  return next_blocker;
+}
+
+// Add the results of all the scans to the index, in input order.
+
+void
+Gdb_index::merge_scans()
+{
+  for (unsigned int i = 0; i < this->scans_.size(); ++i)
+    {
+      this->merge_scan(this->scans_[i]);
+      delete this->scans_[i];
+    }
+  this->scans_.clear();
+}
+
+// Add the results of scanning one object to the .gdb_index and
+// .debug_names sections.  The CU and TU indexes in SCAN are relative
+// to the object.
+
+void
+Gdb_index::merge_scan(Gdb_index_scan* scan)
+{
+  gold_assert(!scan->has_sections());
+
+  const int cu_base = this->comp_units_.size();
+  const int tu_base = this->type_units_.size();
+  this->comp_units_.insert(this->comp_units_.end(),
+			   scan->comp_units_.begin(),
+			   scan->comp_units_.end());
+  this->type_units_.insert(this->type_units_.end(),
+			   scan->type_units_.begin(),
+			   scan->type_units_.end());
+
+  Debug_names* debug_names = this->debug_names_;
+  if (debug_names != NULL)
+    {
+      for (unsigned int i = 0; i < scan->comp_units_.size(); ++i)
+	debug_names->add_comp_unit(scan->comp_units_[i].cu_offset);
+      for (unsigned int i = 0; i < scan->type_units_.size(); ++i)
+	debug_names->add_type_unit(scan->type_units_[i].tu_offset);
+    }
+
+  for (unsigned int i = 0; i < scan->ranges_.size(); ++i)
+    {
+      const Per_cu_range_list& r(scan->ranges_[i]);
+      int cu_index = r.cu_index;
+      if (cu_index >= 0)
+	cu_index += cu_base;
+      else
+	cu_index -= tu_base;
+      this->ranges_.push_back(Per_cu_range_list(r.object, cu_index,
+						r.ranges));
+    }
+
+  for (unsigned int i = 0; i < scan->symbols_.size(); ++i)
+    {
+      const Gdb_index_scan::Scanned_symbol& ssym(scan->symbols_[i]);
+      if (debug_names != NULL)
+	debug_names->add_name(ssym.name, ssym.names_hashval, *ssym.entries,
+			      cu_base, tu_base);
+      if (ssym.cu_vec == NULL)
+	continue;
+
+      Gdb_symbol* sym = new Gdb_symbol();
+      this->stringpool_.add(ssym.name, true, &sym->name_key);
+      sym->hashval = ssym.hashval;
+      sym->cu_vector_index = 0;
+
+      Gdb_symbol* found = this->gdb_symtab_->add(sym);
+      if (found == sym)
+	{
+	  // New symbol -- allocate a new CU index vector.
+	  found->cu_vector_index = this->cu_vector_list_.size();
+	  this->cu_vector_list_.push_back(new Cu_vector());
+	}
+      else
+	{
+	  // Found an existing symbol -- append to the existing
+	  // CU index vector.
+	  delete sym;
+	}
+
+      // Add the CU indexes from this object, translated to
+      // indexes in the full CU and TU lists.  Different objects
+      // never have a CU index in common, so there are no
+      // duplicates to remove.
+      Cu_vector* cu_vec = this->cu_vector_list_[found->cu_vector_index];
+      for (unsigned int j = 0; j < ssym.cu_vec->size(); ++j)
+	{
+	  int cu_index = (*ssym.cu_vec)[j].first;
+	  if (cu_index >= 0)
+	    cu_index += cu_base;
+	  else
+	    cu_index -= tu_base;
+	  cu_vec->push_back(std::make_pair(cu_index, (*ssym.cu_vec)[j].second));
+	}
+    }
+
+  scan->add_stats();
 }
 
 // Set the size of the .gdb_index section.
@@ -1182,6 +1757,9 @@ Gdb_index::set_pubnames_read(const Relobj* object, off_t offset)
 void
 Gdb_index::set_final_data_size()
 {
+  // Add anything which was scanned without the scan tasks.
+  this->merge_scans();
+
   // Finalize the string pool.
   this->stringpool_.set_string_offsets();
 
@@ -1352,8 +1930,427 @@ Gdb_index::do_write(Output_file* of)
 void
 Gdb_index::print_stats()
 {
-  if (parameters->options().gdb_index())
-    Gdb_index_info_reader::print_stats();
+  if (parameters->options().debug_index())
+    Gdb_index_scan::print_stats();
+}
+
+// Class Debug_names.
+
+// The header of the .debug_names section, up to and including the
+// augmentation string.
+const int debug_names_hdr_size = 40;
+
+// The augmentation string which tells gdb that the DW_IDX_GNU_*
+// attributes are used.
+static const char debug_names_augmentation[4] = { 'G', 'D', 'B', '\0' };
+
+// The names in the .debug_names section, which are written at the end
+// of the .debug_str section.
+
+class Debug_names_strings : public Output_section_data
+{
+ public:
+  Debug_names_strings(Stringpool* stringpool)
+    : Output_section_data(1), stringpool_(stringpool), buffer_offset_(-1)
+  { }
+
+  // Return the offset of the names in the .debug_str section.  That
+  // section is not allocated, so this is our address.  If the section
+  // is compressed, we have no address, but we know where we were
+  // written in the uncompressed contents.
+  uint64_t
+  section_offset() const
+  {
+    if (this->is_address_valid())
+      return this->address();
+    gold_assert(this->buffer_offset_ >= 0);
+    return this->buffer_offset_;
+  }
+
+ protected:
+  // Set the final data size.
+  void
+  set_final_data_size()
+  {
+    this->stringpool_->set_string_offsets();
+    this->set_data_size(this->stringpool_->get_strtab_size());
+  }
+
+  // Write the data to the file.
+  void
+  do_write(Output_file* of)
+  { this->stringpool_->write(of, this->offset()); }
+
+  // Write the data to a buffer, for a compressed .debug_str section.
+  void
+  do_write_to_buffer(unsigned char* buffer)
+  {
+    Output_section* os = this->output_section();
+    this->buffer_offset_ = buffer - os->postprocessing_buffer();
+    this->stringpool_->write_to_buffer(buffer, this->data_size());
+  }
+
+  // Write to a map file.
+  void
+  do_print_to_mapfile(Mapfile* mapfile) const
+  { mapfile->print_output_data(this, _("** debug_names strings")); }
+
+ private:
+  // The names.
+  Stringpool* stringpool_;
+  // Our offset in the uncompressed contents of the .debug_str
+  // section, once we have been written to it, or -1.
+  off_t buffer_offset_;
+};
+
+Debug_names::Debug_names()
+  : Output_section_data(4),
+    comp_units_(),
+    type_units_(),
+    stringpool_(),
+    names_(),
+    strings_(NULL),
+    bucket_count_(0),
+    name_order_(),
+    entry_offsets_(),
+    abbrev_table_(),
+    entry_pool_()
+{
+  this->stringpool_.set_no_zero_null();
+  this->strings_ = new Debug_names_strings(&this->stringpool_);
+}
+
+// Return the data to add to the end of the .debug_str section.
+
+Output_section_data*
+Debug_names::strings() const
+{ return this->strings_; }
+
+Debug_names::~Debug_names()
+{
+  for (unsigned int i = 0; i < this->names_.size(); ++i)
+    delete this->names_[i];
+}
+
+// The hash function for names in the .debug_names section.  This is
+// the DJB hash described in the DWARF 5 standard, with the case
+// folding which gdb uses.
+
+uint32_t
+Debug_names::hash(const char* name)
+{
+  const unsigned char* str = reinterpret_cast<const unsigned char*>(name);
+  uint32_t r = 5381;
+  unsigned char c;
+
+  while ((c = *str++) != 0)
+    r = r * 33 + tolower(c);
+
+  return r;
+}
+
+// Return the tag to use in the index for a DIE with tag TAG.  When gdb
+// searches the index, it only looks for the tags which it uses in the
+// .debug_names sections it writes itself, where all types except
+// typedefs are DW_TAG_structure_type, and all constants are
+// DW_TAG_variable.  So we do the same.
+
+unsigned int
+Debug_names::index_tag(unsigned int tag)
+{
+  switch (tag)
+    {
+    case elfcpp::DW_TAG_subprogram:
+    case elfcpp::DW_TAG_typedef:
+      return tag;
+    case elfcpp::DW_TAG_variable:
+    case elfcpp::DW_TAG_constant:
+    case elfcpp::DW_TAG_enumerator:
+      return elfcpp::DW_TAG_variable;
+    default:
+      return elfcpp::DW_TAG_structure_type;
+    }
+}
+
+// Add NAME and the entries for it found in one input object.
+
+void
+Debug_names::add_name(const char* name, uint32_t hashval,
+		      const Entry_vector& entries, int cu_base, int tu_base)
+{
+  Stringpool::Key key;
+  this->stringpool_.add(name, true, &key);
+  if (key > this->names_.size())
+    {
+      gold_assert(key == this->names_.size() + 1);
+      this->names_.push_back(new Name(hashval));
+    }
+
+  // Translate the CU and TU indexes from this object to indexes in
+  // the full CU and TU lists.
+  Entry_vector& name_entries(this->names_[key - 1]->entries);
+  for (Entry_vector::const_iterator p = entries.begin();
+       p != entries.end();
+       ++p)
+    {
+      Entry entry(*p);
+      if (entry.cu_index >= 0)
+	entry.cu_index += cu_base;
+      else
+	entry.cu_index -= tu_base;
+      name_entries.push_back(entry);
+    }
+}
+
+// Build the abbreviation table and the entry pool.  There is an
+// abbreviation for each combination of tag, kind of unit, and
+// linkage, numbered in the order in which they are first used.
+
+void
+Debug_names::build_entry_pool()
+{
+  typedef Unordered_map<unsigned int, unsigned int> Abbrev_map;
+  Abbrev_map abbrevs;
+
+  this->entry_offsets_.reserve(this->name_order_.size());
+  for (unsigned int i = 0; i < this->name_order_.size(); ++i)
+    {
+      this->entry_offsets_.push_back(this->entry_pool_.size());
+      const Entry_vector& entries(this->names_[this->name_order_[i]]->entries);
+      for (Entry_vector::const_iterator p = entries.begin();
+	   p != entries.end();
+	   ++p)
+	{
+	  bool is_type_unit = p->cu_index < 0;
+	  unsigned int abbrev_key = ((p->tag << 3)
+				     | (is_type_unit ? 4 : 0)
+				     | p->linkage);
+	  unsigned int abbrev;
+	  Abbrev_map::const_iterator pa = abbrevs.find(abbrev_key);
+	  if (pa != abbrevs.end())
+	    abbrev = pa->second;
+	  else
+	    {
+	      abbrev = abbrevs.size() + 1;
+	      abbrevs[abbrev_key] = abbrev;
+
+	      std::vector<unsigned char>* table = &this->abbrev_table_;
+	      write_unsigned_LEB_128(table, abbrev);
+	      write_unsigned_LEB_128(table, p->tag);
+	      write_unsigned_LEB_128(table, (is_type_unit
+					     ? elfcpp::DW_IDX_type_unit
+					     : elfcpp::DW_IDX_compile_unit));
+	      write_unsigned_LEB_128(table, elfcpp::DW_FORM_udata);
+	      write_unsigned_LEB_128(table, elfcpp::DW_IDX_die_offset);
+	      write_unsigned_LEB_128(table, elfcpp::DW_FORM_ref4);
+	      if (p->linkage != LINKAGE_UNKNOWN)
+		{
+		  write_unsigned_LEB_128(table,
+					 (p->linkage == LINKAGE_INTERNAL
+					  ? elfcpp::DW_IDX_GNU_internal
+					  : elfcpp::DW_IDX_GNU_external));
+		  write_unsigned_LEB_128(table, elfcpp::DW_FORM_flag_present);
+		}
+	      write_unsigned_LEB_128(table, 0);
+	      write_unsigned_LEB_128(table, 0);
+	    }
+
+	  write_unsigned_LEB_128(&this->entry_pool_, abbrev);
+	  write_unsigned_LEB_128(&this->entry_pool_,
+				 (is_type_unit
+				  ? -1 - p->cu_index
+				  : p->cu_index));
+	  insert_into_vector<32>(&this->entry_pool_, p->die_offset);
+	}
+      // Terminate the list of entries.
+      write_unsigned_LEB_128(&this->entry_pool_, 0);
+    }
+
+  // Terminate the abbreviation table.
+  write_unsigned_LEB_128(&this->abbrev_table_, 0);
+}
+
+// Set the size of the .debug_names section.
+
+void
+Debug_names::set_final_data_size()
+{
+  // We only write a 32-bit DWARF index.
+  for (unsigned int i = 0; i < this->comp_units_.size(); ++i)
+    if (this->comp_units_[i] > 0xffffffffU)
+      gold_fatal(_("--debug-names: .debug_info is too large"));
+  for (unsigned int i = 0; i < this->type_units_.size(); ++i)
+    if (this->type_units_[i] > 0xffffffffU)
+      gold_fatal(_("--debug-names: .debug_types is too large"));
+
+  // Use a power of two number of hash buckets, with at most three
+  // names for each four buckets.
+  const unsigned int name_count = this->names_.size();
+  unsigned int bucket_count = 0;
+  if (name_count > 0)
+    {
+      bucket_count = 1;
+      while (static_cast<uint64_t>(bucket_count) * 3
+	     < static_cast<uint64_t>(name_count) * 4)
+	bucket_count *= 2;
+    }
+  this->bucket_count_ = bucket_count;
+
+  // The names of each bucket must be consecutive in the name table.
+  // Sort them by bucket, keeping the order in which they were added
+  // within each bucket.
+  std::vector<unsigned int> bucket_start(bucket_count + 1, 0);
+  for (unsigned int i = 0; i < name_count; ++i)
+    ++bucket_start[this->names_[i]->hashval % bucket_count + 1];
+  for (unsigned int i = 0; i < bucket_count; ++i)
+    bucket_start[i + 1] += bucket_start[i];
+  this->name_order_.resize(name_count);
+  for (unsigned int i = 0; i < name_count; ++i)
+    {
+      unsigned int bucket = this->names_[i]->hashval % bucket_count;
+      this->name_order_[bucket_start[bucket]++] = i;
+    }
+
+  this->build_entry_pool();
+
+  section_size_type data_size = debug_names_hdr_size;
+  data_size += 4 * this->comp_units_.size();
+  data_size += 4 * this->type_units_.size();
+  data_size += 4 * bucket_count;
+  data_size += 3 * 4 * name_count;
+  data_size += this->abbrev_table_.size();
+  data_size += this->entry_pool_.size();
+  this->set_data_size(data_size);
+}
+
+// Write the data to the file.
+
+void
+Debug_names::do_write(Output_file* of)
+{
+  const off_t off = this->offset();
+  const section_size_type oview_size = this->data_size();
+  unsigned char* const oview = of->get_output_view(off, oview_size);
+  this->do_write_to_buffer(oview);
+  of->write_output_view(off, oview_size, oview);
+}
+
+// Write the data to a buffer.
+
+void
+Debug_names::do_write_to_buffer(unsigned char* buffer)
+{
+  if (parameters->target().is_big_endian())
+    this->write_sized<true>(buffer);
+  else
+    this->write_sized<false>(buffer);
+}
+
+// Write the contents of the .debug_names section to POV.
+
+template<bool big_endian>
+void
+Debug_names::write_sized(unsigned char* pov)
+{
+  unsigned char* const oview = pov;
+  const unsigned int name_count = this->names_.size();
+
+  // The names are at the end of the .debug_str section.
+  const uint64_t strings_offset = this->strings_->section_offset();
+  if (strings_offset + this->strings_->data_size() > 0xffffffffU)
+    gold_fatal(_("--debug-names: .debug_str is too large"));
+
+  // Write the header.
+  // (1) unit_length, which does not include its own size.
+  elfcpp::Swap_unaligned<32, big_endian>::writeval(pov,
+						   this->data_size() - 4);
+  pov += 4;
+  // (2) version and padding.
+  elfcpp::Swap_unaligned<16, big_endian>::writeval(pov, 5);
+  elfcpp::Swap_unaligned<16, big_endian>::writeval(pov + 2, 0);
+  pov += 4;
+  // (3) comp_unit_count, local_type_unit_count and
+  // foreign_type_unit_count.
+  elfcpp::Swap_unaligned<32, big_endian>::writeval(pov,
+						   this->comp_units_.size());
+  elfcpp::Swap_unaligned<32, big_endian>::writeval(pov + 4,
+						   this->type_units_.size());
+  elfcpp::Swap_unaligned<32, big_endian>::writeval(pov + 8, 0);
+  pov += 12;
+  // (4) bucket_count and name_count.
+  elfcpp::Swap_unaligned<32, big_endian>::writeval(pov, this->bucket_count_);
+  elfcpp::Swap_unaligned<32, big_endian>::writeval(pov + 4, name_count);
+  pov += 8;
+  // (5) abbrev_table_size.
+  elfcpp::Swap_unaligned<32, big_endian>::writeval(pov,
+						   this->abbrev_table_.size());
+  pov += 4;
+  // (6) augmentation_string_size and augmentation_string.
+  elfcpp::Swap_unaligned<32, big_endian>::writeval(
+      pov, sizeof(debug_names_augmentation));
+  memcpy(pov + 4, debug_names_augmentation, sizeof(debug_names_augmentation));
+  pov += 4 + sizeof(debug_names_augmentation);
+
+  gold_assert(pov - oview == debug_names_hdr_size);
+
+  // Write the CU and TU lists.
+  for (unsigned int i = 0; i < this->comp_units_.size(); ++i)
+    {
+      elfcpp::Swap_unaligned<32, big_endian>::writeval(pov,
+						       this->comp_units_[i]);
+      pov += 4;
+    }
+  for (unsigned int i = 0; i < this->type_units_.size(); ++i)
+    {
+      elfcpp::Swap_unaligned<32, big_endian>::writeval(pov,
+						       this->type_units_[i]);
+      pov += 4;
+    }
+
+  // Write the hash buckets, which hold the index, starting at 1, of
+  // the first name in the bucket, or 0 if the bucket is empty.
+  std::vector<uint32_t> buckets(this->bucket_count_, 0);
+  for (unsigned int i = name_count; i > 0; --i)
+    {
+      const Name* name = this->names_[this->name_order_[i - 1]];
+      buckets[name->hashval % this->bucket_count_] = i;
+    }
+  for (unsigned int i = 0; i < this->bucket_count_; ++i)
+    {
+      elfcpp::Swap_unaligned<32, big_endian>::writeval(pov, buckets[i]);
+      pov += 4;
+    }
+
+  // Write the hash values, the string offsets and the entry offsets.
+  for (unsigned int i = 0; i < name_count; ++i)
+    {
+      const Name* name = this->names_[this->name_order_[i]];
+      elfcpp::Swap_unaligned<32, big_endian>::writeval(pov, name->hashval);
+      pov += 4;
+    }
+  for (unsigned int i = 0; i < name_count; ++i)
+    {
+      Stringpool::Key key = this->name_order_[i] + 1;
+      uint64_t str_offset = (strings_offset
+			     + this->stringpool_.get_offset_from_key(key));
+      elfcpp::Swap_unaligned<32, big_endian>::writeval(pov, str_offset);
+      pov += 4;
+    }
+  for (unsigned int i = 0; i < name_count; ++i)
+    {
+      elfcpp::Swap_unaligned<32, big_endian>::writeval(pov,
+						       this->entry_offsets_[i]);
+      pov += 4;
+    }
+
+  // Write the abbreviation table and the entry pool.
+  memcpy(pov, &this->abbrev_table_[0], this->abbrev_table_.size());
+  pov += this->abbrev_table_.size();
+  if (!this->entry_pool_.empty())
+    memcpy(pov, &this->entry_pool_[0], this->entry_pool_.size());
+  pov += this->entry_pool_.size();
+
+  gold_assert(pov - oview == this->data_size());
 }
 
 } // End namespace gold.
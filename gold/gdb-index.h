@@ -37,26 +37,40 @@ namespace gold
 class Output_section;
 class Output_file;
 class Mapfile;
+class Workqueue;
+class Task_token;
 template<int size, bool big_endian>
 class Sized_relobj;
 class Dwarf_range_list;
 template <typename T>
 class Gdb_hashtab;
-class Gdb_index_info_reader;
-class Dwarf_pubnames_table;
+class Gdb_index_scan;
+class Debug_names;
+class Debug_names_strings;
 
 // This class manages the .gdb_index section, which is a fast
 // lookup table for DWARF information used by the gdb debugger.
 // The format of this section is described in gdb/doc/gdb.texinfo.
+// It also scans the debug information for the .debug_names section.
 
 class Gdb_index : public Output_section_data
 {
  public:
+  // GDB_INDEX_SECTION is NULL if we are only building a .debug_names
+  // section.
   Gdb_index(Output_section* gdb_index_section);
 
   ~Gdb_index();
 
-  // Scan a .debug_info or .debug_types input section.
+  // Add the names found by the scans to DEBUG_NAMES as well.
+  void
+  set_debug_names(Debug_names* debug_names)
+  { this->debug_names_ = debug_names; }
+
+  // Scan a .debug_info or .debug_types input section.  Unless this
+  // is an incremental link, this just records the section, and the
+  // sections are scanned later by the tasks queued by
+  // queue_scan_tasks.
   void scan_debug_info(bool is_type_unit,
 		       Relobj* object,
 		       const unsigned char* symbols,
@@ -65,64 +79,18 @@ class Gdb_index : public Output_section_data
 		       unsigned int reloc_shndx,
 		       unsigned int reloc_type);
 
-  // Add a compilation unit.
-  int
-  add_comp_unit(off_t cu_offset, off_t cu_length)
-  {
-    this->comp_units_.push_back(Comp_unit(cu_offset, cu_length));
-    return this->comp_units_.size() - 1;
-  }
-
-  // Add a type unit.
-  int
-  add_type_unit(off_t tu_offset, off_t type_offset, uint64_t signature)
-  {
-    this->type_units_.push_back(Type_unit(tu_offset, type_offset, signature));
-    return this->type_units_.size() - 1;
-  }
+  // Queue tasks to scan the sections recorded by scan_debug_info, one
+  // task per input object.  THIS_BLOCKER is the blocker which the
+  // layout task waits for.  Return a blocker which is released when
+  // THIS_BLOCKER has been released and all the sections have been
+  // scanned.
+  Task_token*
+  queue_scan_tasks(Workqueue*, Task_token* this_blocker);
 
-  // Add an address range.
-  void
-  add_address_range_list(Relobj* object, unsigned int cu_index,
-			 Dwarf_range_list* ranges)
-  {
-    this->ranges_.push_back(Per_cu_range_list(object, cu_index, ranges));
-  }
-
-  // Add a symbol.  FLAGS are the gdb_index version 7 flags to be stored in
-  // the high-byte of the cu_index field.
-  void
-  add_symbol(int cu_index, const char* sym_name, uint8_t flags);
-
-  // Return the offset into the pubnames table for the cu at the given
-  // offset.
-  off_t
-  find_pubname_offset(off_t cu_offset);
-
-  // Return the offset into the pubtypes table for the cu at the
-  // given offset.
-  off_t
-  find_pubtype_offset(off_t cu_offset);
-
-  // Return TRUE if we have already processed the pubnames and types
-  // set for OBJECT of the CUs and TUS associated with the statement
-  // list at OFFSET.
-  bool
-  pubnames_read(const Relobj* object, off_t offset);
-
-  // Record that we have already read the pubnames associated with
-  // OBJECT and OFFSET.
+  // Add the results of the scans to the index.  This is called after
+  // all the scan tasks have completed.
   void
-  set_pubnames_read(const Relobj* object, off_t offset);
-
-  // Return a pointer to the given table.
-  Dwarf_pubnames_table*
-  pubnames_table()
-  { return pubnames_table_; }
-
-  Dwarf_pubnames_table*
-  pubtypes_table()
-  { return pubtypes_table_; }
+  merge_scans();
 
   // Print usage statistics.
   static void
@@ -148,22 +116,9 @@ class Gdb_index : public Output_section_data
   do_print_to_mapfile(Mapfile* mapfile) const
   { mapfile->print_output_data(this, _("** gdb_index")); }
 
-  // Create a map from dies to pubnames.
-  Dwarf_pubnames_table*
-  map_pubtable_to_dies(unsigned int attr,
-                       Gdb_index_info_reader* dwinfo,
-                       Relobj* object,
-                       const unsigned char* symbols,
-                       off_t symbols_size);
-
-  // Wrapper for map_pubtable_to_dies
-  void
-  map_pubnames_and_types_to_dies(Gdb_index_info_reader* dwinfo,
-                                 Relobj* object,
-                                 const unsigned char* symbols,
-                                 off_t symbols_size);
-
  private:
+  friend class Gdb_index_scan;
+
   // An entry in the compilation unit list.
   struct Comp_unit
   {
@@ -216,23 +171,19 @@ class Gdb_index : public Output_section_data
 
   typedef std::vector<std::pair<int, uint8_t> > Cu_vector;
 
-  typedef Unordered_map<off_t, off_t> Pubname_offset_map;
-  Pubname_offset_map cu_pubname_map_;
-  Pubname_offset_map cu_pubtype_map_;
-
-  // Scan the given pubtable and build a map of the various dies it
-  // refers to, so we can process the entries when we encounter the
-  // die.
+  // Add the results of scanning one input object to the index.
   void
-  map_pubtable_to_dies(Dwarf_pubnames_table* table,
-                       Pubname_offset_map* map);
-
-  // Tables to store the pubnames section of the current object.
-  Dwarf_pubnames_table* pubnames_table_;
-  Dwarf_pubnames_table* pubtypes_table_;
+  merge_scan(Gdb_index_scan*);
 
-  // The .gdb_index section.
+  // The .gdb_index section, or NULL if we are not building one.
   Output_section* gdb_index_section_;
+  // The .debug_names section data, or NULL if we are not building one.
+  Debug_names* debug_names_;
+  // The debug information of each input object, in input order,
+  // which has not yet been added to the index.
+  std::vector<Gdb_index_scan*> scans_;
+  // Whether the scan tasks have been queued.
+  bool scan_tasks_queued_;
   // The list of DWARF compilation units.
   std::vector<Comp_unit> comp_units_;
   // The list of DWARF type units.
@@ -253,10 +204,149 @@ class Gdb_index : public Output_section_data
   off_t symtab_offset_;
   off_t cu_pool_offset_;
   off_t stringpool_offset_;
-  // Object, stmt list offset of the CUs and TUs associated with the
-  // last read pubnames and pubtypes sections.
-  const Relobj* pubnames_object_;
-  off_t stmt_list_offset_;
+};
+
+// This class manages the .debug_names section, the DWARF 5 name
+// index.  It is built from the same scan of the debug information as
+// the .gdb_index section, and uses the augmentation string and the
+// DW_IDX_GNU_* attributes which gdb uses for its own .debug_names.
+// The names themselves go in the .debug_str section.
+
+class Debug_names : public Output_section_data
+{
+ public:
+  Debug_names();
+
+  ~Debug_names();
+
+  // The linkage of the entity named by an index entry, if known.
+  enum Linkage
+  {
+    LINKAGE_UNKNOWN,
+    LINKAGE_EXTERNAL,
+    LINKAGE_INTERNAL
+  };
+
+  // An index entry, which refers to a DIE defining a name.
+  struct Entry
+  {
+    Entry(int cu, uint32_t die, unsigned int t, Linkage l)
+      : cu_index(cu), die_offset(die), tag(t), linkage(l)
+    { }
+
+    bool
+    operator==(const Entry& e) const
+    {
+      return (this->cu_index == e.cu_index
+	      && this->die_offset == e.die_offset
+	      && this->tag == e.tag
+	      && this->linkage == e.linkage);
+    }
+
+    // The CU index, or -1 minus the TU index for a type unit.
+    int cu_index;
+    // The offset of the DIE within its unit.
+    uint32_t die_offset;
+    // The DWARF tag of the DIE.
+    unsigned int tag;
+    // The linkage of the entity.
+    Linkage linkage;
+  };
+
+  typedef std::vector<Entry> Entry_vector;
+
+  // Return the hash value of NAME.
+  static uint32_t
+  hash(const char* name);
+
+  // Return the tag to use in the index for a DIE with tag TAG.
+  static unsigned int
+  index_tag(unsigned int tag);
+
+  // Return the data to add to the end of the .debug_str section,
+  // which holds the names.
+  Output_section_data*
+  strings() const;
+
+  // Add a compilation unit at offset CU_OFFSET in .debug_info.
+  void
+  add_comp_unit(uint64_t cu_offset)
+  { this->comp_units_.push_back(cu_offset); }
+
+  // Add a type unit at offset TU_OFFSET in .debug_info or .debug_types.
+  void
+  add_type_unit(uint64_t tu_offset)
+  { this->type_units_.push_back(tu_offset); }
+
+  // Add NAME, with hash value HASHVAL, and the ENTRIES for it found in
+  // one input object.  The CU and TU indexes in ENTRIES are relative
+  // to the object; CU_BASE and TU_BASE are the number of CUs and TUs
+  // in the previous objects.
+  void
+  add_name(const char* name, uint32_t hashval, const Entry_vector& entries,
+	   int cu_base, int tu_base);
+
+ protected:
+  // Set the final data size.
+  void
+  set_final_data_size();
+
+  // Write the data to the file.
+  void
+  do_write(Output_file*);
+
+  // Write the data to a buffer, for a compressed section.
+  void
+  do_write_to_buffer(unsigned char*);
+
+  // Write to a map file.
+  void
+  do_print_to_mapfile(Mapfile* mapfile) const
+  { mapfile->print_output_data(this, _("** debug_names")); }
+
+ private:
+  // A name in the index.
+  struct Name
+  {
+    Name(uint32_t h)
+      : hashval(h), entries()
+    { }
+
+    uint32_t hashval;
+    Entry_vector entries;
+  };
+
+  // Write the section contents to POV.
+  template<bool big_endian>
+  void
+  write_sized(unsigned char* pov);
+
+  // Build the abbreviation table and the entry pool.
+  void
+  build_entry_pool();
+
+  // The compilation unit offsets.
+  std::vector<uint64_t> comp_units_;
+  // The type unit offsets.
+  std::vector<uint64_t> type_units_;
+  // The names, whose keys are assigned in the order the names are
+  // added, and which are written to .debug_str.
+  Stringpool stringpool_;
+  // The names, indexed by their key in stringpool_ minus one.
+  std::vector<Name*> names_;
+  // The data in the .debug_str section.
+  Debug_names_strings* strings_;
+  // The number of hash buckets.
+  unsigned int bucket_count_;
+  // The indexes in names_ of the names, sorted by bucket.
+  std::vector<unsigned int> name_order_;
+  // The offset in the entry pool of the entries for each name, in
+  // the order of name_order_.
+  std::vector<uint32_t> entry_offsets_;
+  // The abbreviation table.
+  std::vector<unsigned char> abbrev_table_;
+  // The entry pool.
+  std::vector<unsigned char> entry_pool_;
 };
 
 } // End namespace gold.
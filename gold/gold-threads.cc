@@ -23,6 +23,7 @@
 #include "gold.h"
 
 #include <cstring>
+#include <unistd.h>
 
 #ifdef ENABLE_THREADS
 #include <pthread.h>
@@ -31,6 +32,7 @@
 #include "options.h"
 #include "parameters.h"
 #include "gold-threads.h"
+#include "workqueue.h"
 
 namespace gold
 {
@@ -447,4 +449,57 @@ Initialize_lock::do_run_once(void*)
   *this->pplock_ = new Lock();
 }
 
+// Parallel work.
+
+// Return the number of pieces to use for work on ITEMS items.
+
+unsigned int
+parallel_piece_count(size_t items, size_t min_items)
+{
+#ifndef ENABLE_THREADS
+  return 1;
+#else
+  if (!parameters->options().threads() || items < 2 * min_items)
+    return 1;
+
+  // Use the thread count for the final part of the link, which is
+  // when this kind of work is done.  If it was not given, use the
+  // number of processors.
+  unsigned int threads = parameters->options().thread_count_final();
+#ifdef _SC_NPROCESSORS_ONLN
+  if (threads == 0)
+    {
+      long n = sysconf(_SC_NPROCESSORS_ONLN);
+      if (n > 0)
+	threads = n;
+    }
+#endif
+  if (threads == 0)
+    threads = 2;
+
+  size_t pieces = items / min_items;
+  if (pieces > threads)
+    pieces = threads;
+  return pieces;
+#endif
+}
+
+// Run WORK on ITEMS items divided into PIECES pieces.
+
+void
+run_in_parallel(Parallel_work* work, size_t items, unsigned int pieces)
+{
+  gold_assert(pieces > 0);
+
+  Workqueue* workqueue = parameters->workqueue();
+  if (pieces > 1 && workqueue != NULL)
+    {
+      workqueue->run_in_parallel(work, items, pieces);
+      return;
+    }
+
+  for (unsigned int i = 0; i < pieces; ++i)
+    work->run_piece(i, items * i / pieces, items * (i + 1) / pieces);
+}
+
 } // End namespace gold.
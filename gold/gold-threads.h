@@ -262,6 +262,39 @@ class Initialize_lock : public Once
   Lock** const pplock_;
 };
 
+// Work which is done inside a single task, but which is large enough
+// to be worth dividing among several threads.  The work is divided
+// into pieces which cover ranges of items; different pieces may run
+// at the same time.
+
+class Parallel_work
+{
+ public:
+  virtual
+  ~Parallel_work()
+  { }
+
+  // Do piece PIECE of the work, which covers the items from START up
+  // to but not including END.
+  virtual void
+  run_piece(unsigned int piece, size_t start, size_t end) = 0;
+};
+
+// Return the number of pieces to use for work on ITEMS items, giving
+// each piece at least MIN_ITEMS items.  This is 1 if we are not
+// running multi-threaded.
+
+extern unsigned int
+parallel_piece_count(size_t items, size_t min_items);
+
+// Run WORK on ITEMS items divided into PIECES pieces of nearly equal
+// size, and return when all the pieces are done.  This is called from
+// a running Task.  Idle workqueue threads may run some of the pieces;
+// the calling thread runs the rest.
+
+extern void
+run_in_parallel(Parallel_work* work, size_t items, unsigned int pieces);
+
 } // End namespace gold.
 
 #endif // !defined(GOLD_THREADS_H)
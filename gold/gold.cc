@@ -523,6 +523,27 @@ queue_middle_tasks(const General_options& options,
       gold_assert(symtab->gc() != NULL);
       // Do a transitive closure on all references to determine the worklist.
       symtab->gc()->do_transitive_closure();
+
+      // In an incremental update, the unchanged objects keep the layout
+      // of the previous link, so we cannot bring back a section that
+      // was removed then.
+      if (parameters->incremental_update())
+	{
+	  Garbage_collection::Sections_reachable& referenced =
+	      symtab->gc()->referenced_list();
+	  for (Garbage_collection::Sections_reachable::const_iterator p =
+		 referenced.begin();
+	       p != referenced.end();
+	       ++p)
+	    {
+	      if (p->first->is_incremental()
+		  && p->first->output_section(p->second) == NULL)
+		gold_fallback(_("%s: section removed by --gc-sections "
+				"is now referenced; "
+				"relink with --incremental-full"),
+			      p->first->name().c_str());
+	    }
+	}
     }
 
   // If identical code folding (--icf) is chosen it makes sense to do it
@@ -547,6 +568,10 @@ queue_middle_tasks(const General_options& options,
 	   p != input_objects->relobj_end();
 	   ++p)
 	{
+	  // Unchanged objects in an incremental update keep their
+	  // previous layout, which was recorded in the first pass.
+	  if ((*p)->is_incremental())
+	    continue;
 	  Task_lock_obj<Object> tlo(task, *p);
 	  (*p)->layout(symtab, layout, NULL);
 	}
@@ -577,6 +602,11 @@ queue_middle_tasks(const General_options& options,
 	(*p)->update_section_layout(layout->get_section_order_map());
     }
 
+  // If a call graph profile was given, order the input sections of the
+  // functions that it names.
+  if (parameters->options().call_graph_profile())
+    layout->apply_call_graph_profile(task, symtab);
+
   if (parameters->options().gc_sections()
       || parameters->options().icf_enabled())
     {
@@ -777,6 +807,10 @@ queue_middle_tasks(const General_options& options,
 	}
     }
 
+  // Scan the debug information for the .gdb_index section.  This
+  // runs in parallel with the relocation scanning.
+  this_blocker = layout->queue_gdb_index_tasks(workqueue, this_blocker);
+
   // When all those tasks are complete, we can start laying out the
   // output file.
   workqueue->queue(new Task_function(new Layout_task_runner(options,
@@ -885,8 +919,10 @@ queue_final_tasks(const General_options& options,
       final_blocker = new_final_blocker;
     }
 
-  // Create tasks for tree-style build ID computation, if necessary.
-  if (strcmp(options.build_id(), "tree") == 0)
+  // Create tasks for tree-style or xxhash build ID computation, if
+  // necessary.
+  if (strcmp(options.build_id(), "tree") == 0
+      || strcmp(options.build_id(), "xxhash") == 0)
     {
       // Queue a task to compute the build id.  This will be blocked by
       // FINAL_BLOCKER, and will in turn schedule the task to close
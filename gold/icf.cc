@@ -868,7 +868,7 @@ Icf::add_ehframe_links(Relobj* object, unsigned int ehframe_shndx,
     read_swap_32 = &elfcpp::Swap<32, false>::readval;
 
   // TODO: The logic for parsing the CIE/FDE framing is copied from
-  // Eh_frame::do_add_ehframe_input_section() and might want to be
+  // Eh_frame::do_read_ehframe_input_section() and might want to be
   // factored into a shared helper function.
   while (p < pend)
     {
@@ -967,6 +967,11 @@ Icf::find_identical_sections(const Input_objects* input_objects,
       // Lock the object so we can read from it.  This is only called
       // single-threaded from queue_middle_tasks, so it is OK to lock.
       // Unfortunately we have no way to pass in a Task token.
+      // In an incremental update, the sections of unchanged objects
+      // keep their previous layout and cannot be folded again.
+      if ((*p)->is_incremental())
+	continue;
+
       const Task* dummy_task = reinterpret_cast<const Task*>(-1);
       Task_lock_obj<Object> tl(dummy_task, *p);
       std::vector<unsigned int> eh_frame_ind;
@@ -96,7 +96,7 @@ dump_incremental_inputs(const char* argv0, const char* filename,
   Incremental_inputs_reader<size, big_endian>
       incremental_inputs(inc->inputs_reader());
 
-  if (incremental_inputs.version() != 2)
+  if (incremental_inputs.version() != 3)
     {
       fprintf(stderr, "%s: %s: unknown incremental version %d\n", argv0,
               filename, incremental_inputs.version());
@@ -159,6 +159,8 @@ dump_incremental_inputs(const char* argv0, const char* filename,
 		 input_file.get_dyn_reloc_count());
 	  printf("    COMDAT group count: %d\n",
 		 input_file.get_comdat_group_count());
+	  printf("    Folded section count: %d\n",
+		 input_file.get_folded_section_count());
 	  break;
 	case INCREMENTAL_INPUT_ARCHIVE:
 	  printf("Archive\n");
@@ -223,6 +225,11 @@ dump_incremental_inputs(const char* argv0, const char* filename,
       for (unsigned int i = 0; i < ncomdat; ++i)
 	printf("    Comdat group: %s\n",
 	       input_file.get_comdat_group_signature(i));
+
+      unsigned int nfolded = input_file.get_folded_section_count();
+      for (unsigned int i = 0; i < nfolded; ++i)
+	printf("    Folded section: %d\n",
+	       input_file.get_folded_section(i) + 1);
     }
 
   // Get a view of the .symtab section.
@@ -319,6 +326,23 @@ dump_incremental_inputs(const char* argv0, const char* filename,
 	      Incremental_global_symbol_reader<big_endian> info(
 		  input_file.get_global_symbol_reader(symndx));
 	      unsigned int output_symndx = info.output_symndx();
+	      if (output_symndx == -1U)
+		{
+		  // The symbol is not in the output symbol table.
+		  const char* symname =
+		      input_file.get_global_symbol_name(symndx);
+		  if (symname == NULL)
+		    symname = "<unknown>";
+		  printf("    %6d  %6d  %8d  %8s  %8s  %8s  %-5s  %s\n",
+			 -1,
+			 info.shndx() == -1U ? -1 : info.shndx(),
+			 input_file.get_symbol_offset(symndx),
+			 "", "", "",
+			 (info.shndx() == 0 || info.shndx() == -1U
+			  ? "UNDEF" : "GC"),
+			 symname);
+		  continue;
+		}
 	      sym_p = symtab_view.data() + output_symndx * sym_size;
 	      elfcpp::Sym<size, big_endian> sym(sym_p);
 	      const char* symname;
@@ -37,13 +37,16 @@
 #include "target.h"
 #include "fileread.h"
 #include "script.h"
+#include "icf.h"
 
 namespace gold {
 
 // Version number for the .gnu_incremental_inputs section.
 // Version 1 was the initial checkin.
 // Version 2 adds some padding to ensure 8-byte alignment where necessary.
-const unsigned int INCREMENTAL_LINK_VERSION = 2;
+// Version 3 records symbols removed by --gc-sections and sections folded
+// by --icf.
+const unsigned int INCREMENTAL_LINK_VERSION = 3;
 
 // This class manages the .gnu_incremental_inputs section, which holds
 // the header information, a directory of input files, and separate
@@ -467,6 +470,115 @@ Sized_incremental_binary<size, big_endian>::do_check_inputs(
 	}
     }
 
+  // A section folded by --icf shares the output location of the section
+  // it was folded into.  That is only still valid if the file that holds
+  // the kept section is unchanged.
+  if (!this->check_folded_sections())
+    return false;
+
+  return true;
+}
+
+// Return TRUE if the contributions of object file or archive member N
+// will be replaced in this incremental update.
+
+template<int size, bool big_endian>
+bool
+Sized_incremental_binary<size, big_endian>::object_has_changed(
+    unsigned int n) const
+{
+  Input_entry_reader input_file = this->inputs_reader_.input_file(n);
+  if (input_file.type() == INCREMENTAL_INPUT_ARCHIVE_MEMBER)
+    {
+      // For archive members, check the timestamp of the containing
+      // archive, as process_incremental_input does.
+      Incremental_library* lib = this->get_library(n);
+      gold_assert(lib != NULL);
+      if (lib->filename() != "/group/")
+	return this->do_file_has_changed(lib->input_file_index());
+    }
+  return this->do_file_has_changed(n);
+}
+
+// Check that no section folded by --icf in an unchanged object refers
+// to a kept section in an object that has changed.  Returns FALSE if
+// an incremental update is not possible.
+
+template<int size, bool big_endian>
+bool
+Sized_incremental_binary<size, big_endian>::check_folded_sections() const
+{
+  const Incremental_inputs_reader<size, big_endian>& inputs =
+      this->inputs_reader_;
+  unsigned int count = inputs.input_file_count();
+
+  // Find the unchanged objects with folded sections first, so that
+  // links without --icf do not pay for the map below.
+  std::vector<unsigned int> folding_objects;
+  for (unsigned int i = 0; i < count; i++)
+    {
+      Input_entry_reader input_file = inputs.input_file(i);
+      if (input_file.type() != INCREMENTAL_INPUT_OBJECT
+	  && input_file.type() != INCREMENTAL_INPUT_ARCHIVE_MEMBER)
+	continue;
+      if (input_file.get_folded_section_count() > 0
+	  && !this->object_has_changed(i))
+	folding_objects.push_back(i);
+    }
+  if (folding_objects.empty())
+    return true;
+
+  // Map the output location of each section that was kept to the
+  // input file that contributed it.
+  typedef std::pair<unsigned int, off_t> Location;
+  typedef std::map<Location, unsigned int> Owner_map;
+  Owner_map owners;
+  std::vector<bool> is_folded;
+  for (unsigned int i = 0; i < count; i++)
+    {
+      Input_entry_reader input_file = inputs.input_file(i);
+      if (input_file.type() != INCREMENTAL_INPUT_OBJECT
+	  && input_file.type() != INCREMENTAL_INPUT_ARCHIVE_MEMBER)
+	continue;
+      unsigned int nsections = input_file.get_input_section_count();
+      is_folded.assign(nsections, false);
+      unsigned int nfolded = input_file.get_folded_section_count();
+      for (unsigned int j = 0; j < nfolded; j++)
+	is_folded[input_file.get_folded_section(j)] = true;
+      for (unsigned int j = 0; j < nsections; j++)
+	{
+	  if (is_folded[j])
+	    continue;
+	  typename Input_entry_reader::Input_section_info sect =
+	      input_file.get_input_section(j);
+	  if (sect.output_shndx == 0 || sect.sh_offset == -1)
+	    continue;
+	  owners[Location(sect.output_shndx, sect.sh_offset)] = i;
+	}
+    }
+
+  for (std::vector<unsigned int>::const_iterator p = folding_objects.begin();
+       p != folding_objects.end();
+       ++p)
+    {
+      Input_entry_reader input_file = inputs.input_file(*p);
+      unsigned int nfolded = input_file.get_folded_section_count();
+      for (unsigned int j = 0; j < nfolded; j++)
+	{
+	  typename Input_entry_reader::Input_section_info sect =
+	      input_file.get_input_section(input_file.get_folded_section(j));
+	  Owner_map::const_iterator q =
+	      owners.find(Location(sect.output_shndx, sect.sh_offset));
+	  if (q == owners.end() || this->object_has_changed(q->second))
+	    {
+	      explain_no_incremental(_("%s: section %s was folded into a "
+				       "section of a changed file"),
+				     input_file.filename(), sect.name);
+	      return false;
+	    }
+	}
+    }
+
   return true;
 }
 
@@ -1176,6 +1288,20 @@ Incremental_inputs::report_comdat_group(Object* obj, const char* name)
   this->current_object_entry_->add_comdat_group(key);
 }
 
+// Record that input section SHNDX of object file OBJ was folded by
+// --icf in the link that produced the incremental base file.
+
+void
+Incremental_inputs::report_folded_section(Object* obj, unsigned int shndx)
+{
+  gold_assert(obj == this->current_object_);
+  gold_assert(this->current_object_entry_ != NULL);
+  Incremental_object_entry* entry = this->current_object_entry_;
+  unsigned int n = entry->get_input_section_count();
+  gold_assert(n > 0 && entry->get_input_section_index(n - 1) == shndx);
+  entry->add_folded_section(n - 1);
+}
+
 // Record that the input argument INPUT is a script SCRIPT.  This is
 // called by read_script after parsing the script and reading the list
 // of inputs added by this script.
@@ -1195,11 +1321,50 @@ Incremental_inputs::report_script(Script_info* script,
 }
 
 // Finalize the incremental link information.  Called from
-// Layout::finalize.
+// Layout::finalize, after the symbol table has been finalized.
 
 void
-Incremental_inputs::finalize()
+Incremental_inputs::finalize(const Symbol_table* symtab)
 {
+  for (Input_list::const_iterator p = this->inputs_.begin();
+       p != this->inputs_.end();
+       ++p)
+    {
+      Incremental_object_entry* entry = (*p)->object_entry();
+      if (entry == NULL)
+	continue;
+      Object* obj = entry->object();
+
+      // Record the sections that --icf folded into other sections.
+      // Unchanged objects have already reported them from the
+      // previous link.
+      if (parameters->options().icf_enabled() && !obj->is_incremental())
+	{
+	  Relobj* relobj = static_cast<Relobj*>(obj);
+	  unsigned int nsections = entry->get_input_section_count();
+	  for (unsigned int i = 0; i < nsections; ++i)
+	    {
+	      unsigned int shndx = entry->get_input_section_index(i);
+	      if (relobj->output_section(shndx) == NULL
+		  && symtab->is_section_folded(relobj, shndx))
+		entry->add_folded_section(i);
+	    }
+	}
+
+      // Symbols that are not in the output symbol table (e.g., those
+      // defined in sections removed by --gc-sections) are recorded by
+      // name in the incremental string table.
+      const Object::Symbols* syms = obj->get_global_symbols();
+      for (unsigned int i = 0; i < syms->size(); ++i)
+	{
+	  const Symbol* sym = (*syms)[i];
+	  if (sym->is_forwarder())
+	    sym = symtab->resolve_forwards(sym);
+	  if (sym->symtab_index() == -1U)
+	    this->strtab_->add(sym->name(), false, NULL);
+	}
+    }
+
   // Finalize the string table.
   this->strtab_->set_string_offsets();
 }
@@ -1319,6 +1484,8 @@ Output_section_incremental_inputs<size, big_endian>::set_final_data_size()
 	    info_offset += syms->size() * this->global_sym_entry_size;
 	    // Each comdat group.
 	    info_offset += entry->get_comdat_group_count() * 4;
+	    // Each folded section.
+	    info_offset += entry->get_folded_section_count() * 4;
 	  }
 	  break;
 	case INCREMENTAL_INPUT_SHARED_LIBRARY:
@@ -1569,6 +1736,7 @@ Output_section_incremental_inputs<size, big_endian>::write_info_blocks(
 	    unsigned int first_dynrel = relobj->first_dyn_reloc();
 	    unsigned int ndynrel = relobj->dyn_reloc_count();
 	    unsigned int ncomdat = entry->get_comdat_group_count();
+	    unsigned int nfolded = entry->get_folded_section_count();
 	    Swap32::writeval(pov, nsections);
 	    Swap32::writeval(pov + 4, nsyms);
 	    Swap32::writeval(pov + 8, static_cast<unsigned int>(locals_offset));
@@ -1576,7 +1744,7 @@ Output_section_incremental_inputs<size, big_endian>::write_info_blocks(
 	    Swap32::writeval(pov + 16, first_dynrel);
 	    Swap32::writeval(pov + 20, ndynrel);
 	    Swap32::writeval(pov + 24, ncomdat);
-	    Swap32::writeval(pov + 28, 0);
+	    Swap32::writeval(pov + 28, nfolded);
 	    gold_assert(this->object_info_size == 32);
 	    pov += this->object_info_size;
 
@@ -1606,6 +1774,19 @@ Output_section_incremental_inputs<size, big_endian>::write_info_blocks(
 		    out_offset = obj->output_section_offset(shndx);
 		    sh_size = entry->get_input_section_size(i);
 		  }
+		else if (this->symtab_->is_section_folded(
+			     static_cast<Relobj*>(entry->object()), shndx))
+		  {
+		    // Record the location of the section that this one
+		    // was folded into.
+		    Section_id kept = this->symtab_->icf()->get_folded_section(
+			static_cast<Relobj*>(entry->object()), shndx);
+		    os = kept.first->output_section(kept.second);
+		    gold_assert(os != NULL);
+		    out_shndx = os->out_shndx();
+		    out_offset = kept.first->output_section_offset(kept.second);
+		    sh_size = entry->get_input_section_size(i);
+		  }
 		Swap32::writeval(pov, name_offset);
 		Swap32::writeval(pov + 4, out_shndx);
 		Swap::writeval(pov + 8, out_offset);
@@ -1649,22 +1830,37 @@ Output_section_incremental_inputs<size, big_endian>::write_info_blocks(
 		unsigned int chain = 0;
 		unsigned int first_reloc = 0;
 		unsigned int nrelocs = obj->get_incremental_reloc_count(i);
-		if (nrelocs > 0)
+		unsigned int reloc_off;
+		if (symtab_index == -1U)
 		  {
-		    gold_assert(symtab_index != -1U
-				&& (symtab_index - first_global_index
-				    < global_sym_count));
-		    first_reloc = obj->get_incremental_reloc_base(i);
-		    chain = global_syms[symtab_index - first_global_index];
-		    global_syms[symtab_index - first_global_index] =
-			pov - oview;
+		    // The symbol is not in the output symbol table, so
+		    // record its name and attributes here instead.
+		    gold_assert(nrelocs == 0);
+		    chain = strtab->get_offset(sym->name());
+		    reloc_off = (elfcpp::elf_st_info(sym->binding(),
+						     sym->type())
+				 | (elfcpp::elf_st_other(sym->visibility(),
+							 sym->nonvis())
+				    << 8));
+		  }
+		else
+		  {
+		    if (nrelocs > 0)
+		      {
+			gold_assert(symtab_index - first_global_index
+				    < global_sym_count);
+			first_reloc = obj->get_incremental_reloc_base(i);
+			chain = global_syms[symtab_index - first_global_index];
+			global_syms[symtab_index - first_global_index] =
+			    pov - oview;
+		      }
+		    reloc_off = first_reloc * (8 + 2 * sizeof_addr);
 		  }
 		Swap32::writeval(pov, symtab_index);
 		Swap32::writeval(pov + 4, shndx);
 		Swap32::writeval(pov + 8, chain);
 		Swap32::writeval(pov + 12, nrelocs);
-		Swap32::writeval(pov + 16,
-				 first_reloc * (8 + 2 * sizeof_addr));
+		Swap32::writeval(pov + 16, reloc_off);
 		gold_assert(this->global_sym_entry_size == 20);
 		pov += this->global_sym_entry_size;
 	      }
@@ -1680,6 +1876,14 @@ Output_section_incremental_inputs<size, big_endian>::write_info_blocks(
 		pov += 4;
 	      }
 
+	    // For each section folded by --icf, write its index in the
+	    // input section table.
+	    for (unsigned int i = 0; i < nfolded; i++)
+	      {
+		Swap32::writeval(pov, entry->get_folded_section(i));
+		pov += 4;
+	      }
+
 	    delete[] index_map;
 	  }
 	  break;
@@ -2053,6 +2257,14 @@ Sized_relobj_incr<size, big_endian>::do_layout(
   std::vector<unsigned int> debug_info_sections;
   std::vector<unsigned int> debug_types_sections;
 
+  // Keep track of the sections that --icf folded in the previous link.
+  // Their entries give the location of the kept section, which
+  // Incremental_binary::check_inputs has verified is unchanged.
+  std::vector<bool> is_folded(shnum, false);
+  unsigned int nfolded = this->input_reader_.get_folded_section_count();
+  for (unsigned int i = 0; i < nfolded; i++)
+    is_folded[this->input_reader_.get_folded_section(i) + 1] = true;
+
   for (unsigned int i = 1; i < shnum; i++)
     {
       typename Input_entry_reader::Input_section_info sect =
@@ -2060,6 +2272,8 @@ Sized_relobj_incr<size, big_endian>::do_layout(
       // Add the section to the incremental inputs layout.
       incremental_inputs->report_input_section(this, i, sect.name,
 					       sect.sh_size);
+      if (is_folded[i])
+	incremental_inputs->report_folded_section(this, i);
       if (sect.output_shndx == 0 || sect.sh_offset == -1)
 	continue;
       Output_section* os = this->ibase_->output_section(sect.output_shndx);
@@ -2157,6 +2371,13 @@ Sized_relobj_incr<size, big_endian>::do_add_symbols(
       Incremental_global_symbol_reader<big_endian> info =
 	  this->input_reader_.get_global_symbol_reader(i);
       unsigned int output_symndx = info.output_symndx();
+      if (output_symndx == -1U)
+	{
+	  this->symbols_[i] = this->add_unlisted_symbol(symtab, i, info);
+	  if (info.shndx() != 0 && info.shndx() != -1U)
+	    ++this->defined_count_;
+	  continue;
+	}
       sym_p = symtab_view.data() + output_symndx * sym_size;
       elfcpp::Sym<size, big_endian> gsym(sym_p);
       const char* name;
@@ -2242,6 +2463,47 @@ Sized_relobj_incr<size, big_endian>::do_add_symbols(
     }
 }
 
+// Add global symbol SYMNDX, which has no entry in the output symbol
+// table of the base file.  This happens when --gc-sections removed
+// the section that defined it, or every section that referred to it.
+// A symbol defined here keeps its input section index, but that
+// section has no output section, so the symbol gets no value.
+
+template<int size, bool big_endian>
+Symbol*
+Sized_relobj_incr<size, big_endian>::add_unlisted_symbol(
+    Symbol_table* symtab,
+    unsigned int symndx,
+    const Incremental_global_symbol_reader<big_endian>& info)
+{
+  const int sym_size = elfcpp::Elf_sizes<size>::sym_size;
+  unsigned char symbuf[sym_size];
+  elfcpp::Sym_write<size, big_endian> osym(symbuf);
+
+  const char* name = this->input_reader_.get_global_symbol_name(symndx);
+  if (name == NULL)
+    name = "";
+
+  elfcpp::STB st_bind = elfcpp::elf_st_bind(info.st_info());
+  elfcpp::STT st_type = elfcpp::elf_st_type(info.st_info());
+  if (st_bind == elfcpp::STB_LOCAL)
+    st_bind = elfcpp::STB_GLOBAL;
+
+  unsigned int shndx = info.shndx();
+  if (shndx == -1U)
+    shndx = elfcpp::SHN_UNDEF;
+
+  osym.put_st_name(0);
+  osym.put_st_value(0);
+  osym.put_st_size(0);
+  osym.put_st_info(st_bind, st_type);
+  osym.put_st_other(info.st_other());
+  osym.put_st_shndx(shndx);
+
+  elfcpp::Sym<size, big_endian> sym(symbuf);
+  return symtab->add_from_incrobj(this, name, NULL, &sym);
+}
+
 // Return TRUE if we should include this object from an archive library.
 
 template<int size, bool big_endian>
@@ -2314,9 +2576,18 @@ Sized_relobj_incr<size, big_endian>::do_section_contents(
 
 template<int size, bool big_endian>
 uint64_t
-Sized_relobj_incr<size, big_endian>::do_section_flags(unsigned int)
+Sized_relobj_incr<size, big_endian>::do_section_flags(unsigned int shndx)
 {
-  gold_unreachable();
+  // We don't track the flags of the input sections, so return those
+  // of the output section.  This is only needed when --icf looks at
+  // a relocation from a changed object to a section of this one; the
+  // merge flags are dropped since the section contents are not
+  // available.
+  Output_sections& out_sections(this->output_sections());
+  Output_section* os = out_sections[shndx];
+  if (os == NULL)
+    return 0;
+  return os->flags() & ~(elfcpp::SHF_MERGE | elfcpp::SHF_STRINGS);
 }
 
 // Return section entsize.
@@ -2417,11 +2688,31 @@ Sized_relobj_incr<size, big_endian>::do_read_relocs(Read_relocs_data*)
 
 template<int size, bool big_endian>
 void
-Sized_relobj_incr<size, big_endian>::do_gc_process_relocs(Symbol_table*,
+Sized_relobj_incr<size, big_endian>::do_gc_process_relocs(Symbol_table* symtab,
 							  Layout*,
 							  Read_relocs_data*)
 {
-  gold_unreachable();
+  if (!parameters->options().gc_sections())
+    return;
+
+  // The sections of this object are kept as they are, so any symbol
+  // they refer to must be kept as well.  The incremental relocations
+  // record exactly those references, so treat each symbol that has
+  // them as a root.
+  unsigned int nsyms = this->input_reader_.get_global_symbol_count();
+  for (unsigned int i = 0; i < nsyms; i++)
+    {
+      Incremental_global_symbol_reader<big_endian> info =
+	  this->input_reader_.get_global_symbol_reader(i);
+      if (info.output_symndx() == -1U || info.reloc_count() == 0)
+	continue;
+      Symbol* sym = this->symbols_[i];
+      if (sym->is_forwarder())
+	sym = symtab->resolve_forwards(sym);
+      if (sym->source() == Symbol::FROM_OBJECT
+	  && !sym->object()->is_dynamic())
+	symtab->gc_mark_symbol(sym);
+    }
 }
 
 // Scan the relocs and adjust the symbol table.
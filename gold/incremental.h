@@ -353,7 +353,7 @@ class Incremental_object_entry : public Incremental_input_entry
   Incremental_object_entry(Stringpool::Key filename_key, Object* obj,
 			   unsigned int arg_serial, Timespec mtime)
     : Incremental_input_entry(filename_key, arg_serial, mtime), obj_(obj),
-      is_member_(false), sections_(), groups_()
+      is_member_(false), sections_(), groups_(), folded_()
   { this->sections_.reserve(obj->shnum()); }
 
   // Get the object.
@@ -411,6 +411,23 @@ class Incremental_object_entry : public Incremental_input_entry
   get_comdat_signature_key(unsigned int n) const
   { return this->groups_[n]; }
 
+  // Record that the Nth input section was folded into another
+  // section by --icf.
+  void
+  add_folded_section(unsigned int n)
+  { this->folded_.push_back(n); }
+
+  // Return the number of input sections folded by --icf.
+  unsigned int
+  get_folded_section_count() const
+  { return this->folded_.size(); }
+
+  // Return the input section index (in this entry) of the Nth folded
+  // section.
+  unsigned int
+  get_folded_section(unsigned int n) const
+  { return this->folded_[n]; }
+
  protected:
   virtual Incremental_input_type
   do_type() const
@@ -446,6 +463,9 @@ class Incremental_object_entry : public Incremental_input_entry
 
   // COMDAT groups.
   std::vector<Stringpool::Key> groups_;
+
+  // Input sections folded into other sections by --icf.
+  std::vector<unsigned int> folded_;
 };
 
 // Class for recording shared library input files.
@@ -596,6 +616,11 @@ class Incremental_inputs
   void
   report_comdat_group(Object* obj, const char* name);
 
+  // Record that input section SHNDX of object file OBJ was folded
+  // by --icf in a previous link.  Used for unchanged objects.
+  void
+  report_folded_section(Object* obj, unsigned int shndx);
+
   // Record the info for input script SCRIPT.
   void
   report_script(Script_info* script, unsigned int arg_serial,
@@ -613,7 +638,7 @@ class Incremental_inputs
 
   // Prepare for layout.  Called from Layout::finalize.
   void
-  finalize();
+  finalize(const Symbol_table* symtab);
 
   // Create the .gnu_incremental_inputs and related sections.
   void
@@ -739,6 +764,25 @@ class Incremental_global_symbol_reader
   reloc_offset() const
   { return Swap32::readval(this->p_ + 16); }
 
+  // A symbol with no entry in the output symbol table (because
+  // --gc-sections removed the section that defined it, or every
+  // reference to it) has an OUTPUT_SYMNDX of -1U.  Its entry then
+  // holds the offset of the symbol name in the incremental string
+  // table in place of the chain pointer, and the symbol's st_info
+  // and st_other fields in place of the relocation offset.
+
+  unsigned int
+  name_offset() const
+  { return Swap32::readval(this->p_ + 8); }
+
+  unsigned char
+  st_info() const
+  { return Swap32::readval(this->p_ + 16) & 0xff; }
+
+  unsigned char
+  st_other() const
+  { return (Swap32::readval(this->p_ + 16) >> 8) & 0xff; }
+
  private:
   // Base address of the symbol entry.
   const unsigned char* p_;
@@ -1051,6 +1095,17 @@ class Incremental_inputs_reader
       return Incremental_global_symbol_reader<big_endian>(p);
     }
 
+    // Return the name of the Nth global symbol, for a symbol that has
+    // no entry in the output symbol table -- for objects only.
+    const char*
+    get_global_symbol_name(unsigned int n) const
+    {
+      Incremental_global_symbol_reader<big_endian> sym =
+	  this->get_global_symbol_reader(n);
+      gold_assert(sym.output_symndx() == -1U);
+      return this->inputs_->get_string(sym.name_offset());
+    }
+
     // Return the signature of the Nth comdat group -- for objects only.
     const char*
     get_comdat_group_signature(unsigned int n) const
@@ -1067,6 +1122,36 @@ class Incremental_inputs_reader
       return this->inputs_->get_string(name_offset);
     }
 
+    // Return the count of input sections folded by --icf -- for
+    // objects only.
+    unsigned int
+    get_folded_section_count() const
+    {
+      gold_assert(this->type() == INCREMENTAL_INPUT_OBJECT
+		  || this->type() == INCREMENTAL_INPUT_ARCHIVE_MEMBER);
+
+      return Swap32::readval(this->inputs_->p_ + this->info_offset_ + 28);
+    }
+
+    // Return the input section index of the Nth section folded by
+    // --icf -- for objects only.  A folded section's entry gives the
+    // output location of the section it was folded into.
+    unsigned int
+    get_folded_section(unsigned int n) const
+    {
+      unsigned int section_count = this->get_input_section_count();
+      unsigned int symbol_count = this->get_global_symbol_count();
+      unsigned int comdat_count = this->get_comdat_group_count();
+      const unsigned char* p = (this->inputs_->p_
+				+ this->info_offset_
+				+ this->object_info_size
+				+ section_count * this->input_section_entry_size
+				+ symbol_count * this->global_sym_entry_size
+				+ comdat_count * 4
+				+ n * 4);
+      return Swap32::readval(p);
+    }
+
     // Return the output symbol index for the Nth global symbol -- for shared
     // libraries only.  Sets *IS_DEF to TRUE if the symbol is defined in this
     // input file.  Sets *IS_COPY to TRUE if the symbol was copied from this
@@ -1785,6 +1870,15 @@ class Sized_incremental_binary : public Incremental_binary
   void
   setup_readers();
 
+  // Return TRUE if the contributions of object file or archive member N
+  // will be replaced in this incremental update.
+  bool
+  object_has_changed(unsigned int n) const;
+
+  // Check that no section folded by --icf depends on a changed file.
+  bool
+  check_folded_sections() const;
+
   // Output as an ELF file.
   elfcpp::Elf_file<size, big_endian, Incremental_binary> elf_file_;
 
@@ -2022,6 +2116,11 @@ class Sized_relobj_incr : public Sized_relobj<size, big_endian>
   void
   do_set_section_offset(unsigned int shndx, uint64_t off);
 
+  // Add a global symbol that is not in the output symbol table.
+  Symbol*
+  add_unlisted_symbol(Symbol_table* symtab, unsigned int symndx,
+		      const Incremental_global_symbol_reader<big_endian>& info);
+
   // The Incremental_binary base file.
   Sized_incremental_binary<size, big_endian>* ibase_;
   // The index of the object in the input file list.
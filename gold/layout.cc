@@ -34,6 +34,7 @@
 #include "libiberty.h"
 #include "md5.h"
 #include "sha1.h"
+#include "xxh3.h"
 #ifdef __MINGW32__
 #include <windows.h>
 #include <rpcdce.h>
@@ -52,6 +53,7 @@
 #include "dynobj.h"
 #include "ehframe.h"
 #include "gdb-index.h"
+#include "call-graph.h"
 #include "compressed_output.h"
 #include "reduced_debug_output.h"
 #include "object.h"
@@ -242,7 +244,13 @@ Free_list::print_stats()
 	  program_name, Free_list::num_allocate_visits);
 }
 
-// A Hash_task computes the MD5 checksum of an array of char.
+// The type of a function which computes the checksum of a buffer,
+// such as md5_buffer.
+
+typedef void* (*Hash_buffer_function)(const char*, size_t, void*);
+
+// A Hash_task computes the checksum of an array of char, using
+// HASH_BUFFER.
 
 class Hash_task : public Task
 {
@@ -251,9 +259,10 @@ class Hash_task : public Task
 	    size_t offset,
 	    size_t size,
 	    unsigned char* dst,
+	    Hash_buffer_function hash_buffer,
 	    Task_token* final_blocker)
     : of_(of), offset_(offset), size_(size), dst_(dst),
-      final_blocker_(final_blocker)
+      hash_buffer_(hash_buffer), final_blocker_(final_blocker)
   { }
 
   void
@@ -261,7 +270,8 @@ class Hash_task : public Task
   {
     const unsigned char* iv =
 	this->of_->get_input_view(this->offset_, this->size_);
-    md5_buffer(reinterpret_cast<const char*>(iv), this->size_, this->dst_);
+    this->hash_buffer_(reinterpret_cast<const char*>(iv), this->size_,
+		       this->dst_);
     this->of_->free_input_view(this->offset_, this->size_, iv);
   }
 
@@ -283,6 +293,7 @@ class Hash_task : public Task
   const size_t offset_;
   const size_t size_;
   unsigned char* const dst_;
+  const Hash_buffer_function hash_buffer_;
   Task_token* const final_blocker_;
 };
 
@@ -477,6 +488,7 @@ Layout::Layout(int number_of_input_files, Script_options* script_options)
     section_segment_map_(),
     input_section_position_(),
     input_section_glob_(),
+    call_graph_profile_(NULL),
     incremental_base_(NULL),
     free_list_(),
     gnu_properties_()
@@ -621,6 +633,22 @@ is_gdb_fast_lookup_section(const char* suffix)
   return false;
 }
 
+// Returns whether the given section is a fast-lookup section that
+// will not be needed when building a .gdb_index or .debug_names
+// section.  When building only a .debug_names section, we keep
+// .debug_aranges, which gdb uses along with it.  An input .debug_names
+// section is replaced by the one we build.
+
+static inline bool
+is_debug_index_lookup_section(const char* suffix)
+{
+  if (strcmp(suffix, "names") == 0)
+    return parameters->options().debug_names();
+  if (strcmp(suffix, "aranges") == 0 && !parameters->options().gdb_index())
+    return false;
+  return is_gdb_fast_lookup_section(suffix);
+}
+
 // Sometimes we compress sections.  This is typically done for
 // sections that are not part of normal program execution (such as
 // .debug_* sections), and where the readers of these sections know
@@ -726,16 +754,16 @@ Layout::include_section(Sized_relobj_file<size, big_endian>*, const char* name,
 	      && !is_gdb_debug_section(name + 8))
 	    return false;
 	}
-      if (parameters->options().gdb_index()
+      if (parameters->options().debug_index()
 	  && (shdr.get_sh_flags() & elfcpp::SHF_ALLOC) == 0)
 	{
 	  // When building .gdb_index, we can strip .debug_pubnames,
 	  // .debug_pubtypes, and .debug_aranges sections.
 	  if (is_prefix_of(".debug_", name)
-	      && is_gdb_fast_lookup_section(name + 7))
+	      && is_debug_index_lookup_section(name + 7))
 	    return false;
 	  if (is_prefix_of(".zdebug_", name)
-	      && is_gdb_fast_lookup_section(name + 8))
+	      && is_debug_index_lookup_section(name + 8))
 	    return false;
 	}
       if (parameters->options().strip_lto_sections()
@@ -1624,7 +1652,7 @@ Layout::remove_eh_frame_for_plt(Output_data* plt, const unsigned char* cie_data,
 }
 
 // Scan a .debug_info or .debug_types section, and add summary
-// information to the .gdb_index section.
+// information to the .gdb_index and .debug_names sections.
 
 template<int size, bool big_endian>
 void
@@ -1638,16 +1666,52 @@ Layout::add_to_gdb_index(bool is_type_unit,
 {
   if (this->gdb_index_data_ == NULL)
     {
-      Output_section* os = this->choose_output_section(NULL, ".gdb_index",
-						       elfcpp::SHT_PROGBITS, 0,
-						       false, ORDER_INVALID,
-						       false, false, false);
-      if (os == NULL)
+      Output_section* os = NULL;
+      if (parameters->options().gdb_index())
+	os = this->choose_output_section(NULL, ".gdb_index",
+					 elfcpp::SHT_PROGBITS, 0,
+					 false, ORDER_INVALID,
+					 false, false, false);
+
+      // The names in the .debug_names section are added to the
+      // .debug_str section.  We create that section first, so that
+      // if both are compressed, the names are written to it before
+      // the .debug_names section is written.
+      Output_section* names_os = NULL;
+      Output_section* str_os = NULL;
+      if (parameters->options().debug_names())
+	{
+	  str_os = this->choose_output_section(NULL, ".debug_str",
+					       elfcpp::SHT_PROGBITS,
+					       (elfcpp::SHF_MERGE
+						| elfcpp::SHF_STRINGS),
+					       false, ORDER_INVALID,
+					       false, false, false);
+	  if (str_os != NULL)
+	    names_os = this->choose_output_section(NULL, ".debug_names",
+						   elfcpp::SHT_PROGBITS, 0,
+						   false, ORDER_INVALID,
+						   false, false, false);
+	}
+
+      if (os == NULL && names_os == NULL)
 	return;
 
       this->gdb_index_data_ = new Gdb_index(os);
-      os->add_output_section_data(this->gdb_index_data_);
-      os->set_after_input_sections();
+      if (os != NULL)
+	{
+	  os->add_output_section_data(this->gdb_index_data_);
+	  os->set_after_input_sections();
+	}
+
+      if (names_os != NULL)
+	{
+	  Debug_names* debug_names = new Debug_names();
+	  names_os->add_output_section_data(debug_names);
+	  names_os->set_after_input_sections();
+	  str_os->add_output_section_data(debug_names->strings());
+	  this->gdb_index_data_->set_debug_names(debug_names);
+	}
     }
 
   this->gdb_index_data_->scan_debug_info(is_type_unit, object, symbols,
@@ -1655,6 +1719,17 @@ Layout::add_to_gdb_index(bool is_type_unit,
 					 reloc_type);
 }
 
+// Queue the tasks which scan the debug information for the .gdb_index
+// section.
+
+Task_token*
+Layout::queue_gdb_index_tasks(Workqueue* workqueue, Task_token* this_blocker)
+{
+  if (this->gdb_index_data_ == NULL)
+    return this_blocker;
+  return this->gdb_index_data_->queue_scan_tasks(workqueue, this_blocker);
+}
+
 // Add POSD to an output section using NAME, TYPE, and FLAGS.  Return
 // the output section.
 
@@ -2955,6 +3030,39 @@ Layout::read_layout_from_file()
     }
 }
 
+// Read the call graph profile from the file specified with option
+// --call-graph-profile.  The sections are ordered once they have all
+// been laid out, but we need to know now that they will be ordered,
+// so that the output sections keep track of their input sections.
+
+void
+Layout::read_call_graph_profile()
+{
+  this->call_graph_profile_ = new Call_graph_profile();
+  this->call_graph_profile_->read(
+      parameters->options().call_graph_profile());
+  this->set_section_ordering_specified();
+}
+
+// Order the input sections of the functions named in the call graph
+// profile.
+
+void
+Layout::apply_call_graph_profile(const Task* task,
+				 const Symbol_table* symtab)
+{
+  gold_assert(this->call_graph_profile_ != NULL);
+  Output_section::Section_layout_order order;
+  this->call_graph_profile_->compute_order(task, symtab, &order);
+  if (order.empty())
+    return;
+
+  for (Section_list::const_iterator p = this->section_list_.begin();
+       p != this->section_list_.end();
+       ++p)
+    (*p)->update_section_layout(&order);
+}
+
 // Finalize the layout.  When this is called, we have created all the
 // output sections and all the output segments which are based on
 // input sections.  We have several things to do, and we have to do
@@ -3124,7 +3232,7 @@ Layout::finalize(const Input_objects* input_objects, Symbol_table* symtab,
   // Create the incremental inputs sections.
   if (this->incremental_inputs_)
     {
-      this->incremental_inputs_->finalize();
+      this->incremental_inputs_->finalize(symtab);
       this->create_incremental_info_sections(symtab);
     }
 
@@ -3452,7 +3560,7 @@ Layout::create_build_id()
   // set DESC to the note descriptor contents.
   size_t descsz;
   std::string desc;
-  if (strcmp(style, "md5") == 0)
+  if (strcmp(style, "md5") == 0 || strcmp(style, "xxhash") == 0)
     descsz = 128 / 8;
   else if ((strcmp(style, "sha1") == 0) || (strcmp(style, "tree") == 0))
     descsz = 160 / 8;
@@ -5948,9 +6056,9 @@ Layout::write_sections_after_input_sections(Output_file* of)
   this->section_headers_->write(of);
 }
 
-// If a tree-style build ID was requested, the parallel part of that computation
-// is already done, and the final hash-of-hashes is computed here.  For other
-// types of build IDs, all the work is done here.
+// If a tree-style or xxhash build ID was requested, the parallel part of
+// that computation is already done, and the final hash-of-hashes is computed
+// here.  For other types of build IDs, all the work is done here.
 
 void
 Layout::write_build_id(Output_file* of, unsigned char* array_of_hashes,
@@ -5962,18 +6070,22 @@ Layout::write_build_id(Output_file* of, unsigned char* array_of_hashes,
   unsigned char* ov = of->get_output_view(this->build_id_note_->offset(),
 					  this->build_id_note_->data_size());
 
+  const char* style = parameters->options().build_id();
   if (array_of_hashes == NULL)
     {
       const size_t output_file_size = this->output_file_size();
       const unsigned char* iv = of->get_input_view(0, output_file_size);
-      const char* style = parameters->options().build_id();
 
       // If we get here with style == "tree" then the output must be
       // too small for chunking, and we use SHA-1 in that case.
+      // Likewise, with style == "xxhash" the output fits in one chunk.
       if ((strcmp(style, "sha1") == 0) || (strcmp(style, "tree") == 0))
 	sha1_buffer(reinterpret_cast<const char*>(iv), output_file_size, ov);
       else if (strcmp(style, "md5") == 0)
 	md5_buffer(reinterpret_cast<const char*>(iv), output_file_size, ov);
+      else if (strcmp(style, "xxhash") == 0)
+	xxh3_128_buffer(reinterpret_cast<const char*>(iv), output_file_size,
+			ov);
       else
 	gold_unreachable();
 
@@ -5982,9 +6094,14 @@ Layout::write_build_id(Output_file* of, unsigned char* array_of_hashes,
   else
     {
       // Non-overlapping substrings of the output file have been hashed.
-      // Compute SHA-1 hash of the hashes.
-      sha1_buffer(reinterpret_cast<const char*>(array_of_hashes),
-		  size_of_hashes, ov);
+      // Compute SHA-1 hash of the hashes, or for xxhash, the XXH3 hash
+      // of the hashes.
+      if (strcmp(style, "xxhash") == 0)
+	xxh3_128_buffer(reinterpret_cast<const char*>(array_of_hashes),
+			size_of_hashes, ov);
+      else
+	sha1_buffer(reinterpret_cast<const char*>(array_of_hashes),
+		    size_of_hashes, ov);
       delete[] array_of_hashes;
     }
 
@@ -6187,7 +6304,10 @@ Write_after_input_sections_task::run(Workqueue*)
 // Build IDs can be computed as a "flat" sha1 or md5 of a string of bytes,
 // or as a "tree" where each chunk of the string is hashed and then those
 // hashes are put into a (much smaller) string which is hashed with sha1.
-// We compute a checksum over the entire file because that is simplest.
+// The "xxhash" style is always a tree when the file is larger than one
+// chunk, using the much faster XXH3 hash both for the chunks and for
+// the string of their hashes.  We compute a checksum over the entire
+// file because that is simplest.
 
 void
 Build_id_task_runner::run(Workqueue* workqueue, const Task*)
@@ -6199,28 +6319,46 @@ Build_id_task_runner::run(Workqueue* workqueue, const Task*)
 			   : static_cast<size_t>(layout->output_file_size()));
   unsigned char* array_of_hashes = NULL;
   size_t size_of_hashes = 0;
-
-  if (strcmp(this->options_->build_id(), "tree") == 0
-      && this->options_->build_id_chunk_size_for_treehash() > 0
+  const char* style = this->options_->build_id();
+  const size_t chunk_size =
+      this->options_->build_id_chunk_size_for_treehash();
+
+  // The size of the hash of each chunk, and the function which
+  // computes it.  A zero size means that we don't use a tree.
+  size_t hash_size = 0;
+  Hash_buffer_function hash_buffer = NULL;
+  if (strcmp(style, "tree") == 0
+      && chunk_size > 0
       && filesize > 0
       && (filesize >= this->options_->build_id_min_file_size_for_treehash()))
     {
-      static const size_t MD5_OUTPUT_SIZE_IN_BYTES = 16;
-      const size_t chunk_size =
-	  this->options_->build_id_chunk_size_for_treehash();
+      hash_size = 16;
+      hash_buffer = md5_buffer;
+    }
+  else if (strcmp(style, "xxhash") == 0
+	   && chunk_size > 0
+	   && filesize > chunk_size)
+    {
+      hash_size = XXH3_128_DIGEST_SIZE;
+      hash_buffer = xxh3_128_buffer;
+    }
+
+  if (hash_size > 0)
+    {
       const size_t num_hashes = ((filesize - 1) / chunk_size) + 1;
       post_hash_tasks_blocker->add_blockers(num_hashes);
-      size_of_hashes = num_hashes * MD5_OUTPUT_SIZE_IN_BYTES;
+      size_of_hashes = num_hashes * hash_size;
       array_of_hashes = new unsigned char[size_of_hashes];
       unsigned char *dst = array_of_hashes;
       for (size_t i = 0, src_offset = 0; i < num_hashes;
-	   i++, dst += MD5_OUTPUT_SIZE_IN_BYTES, src_offset += chunk_size)
+	   i++, dst += hash_size, src_offset += chunk_size)
 	{
 	  size_t size = std::min(chunk_size, filesize - src_offset);
 	  workqueue->queue(new Hash_task(of,
 					 src_offset,
 					 size,
 					 dst,
+					 hash_buffer,
 					 post_hash_tasks_blocker));
 	}
     }
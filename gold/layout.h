@@ -40,6 +40,7 @@ namespace gold
 {
 
 class General_options;
+class Call_graph_profile;
 class Incremental_inputs;
 class Incremental_binary;
 class Input_objects;
@@ -620,6 +621,17 @@ class Layout
   void
   read_layout_from_file();
 
+  // Read the call graph profile from the file specified with linker
+  // option --call-graph-profile.
+  void
+  read_call_graph_profile();
+
+  // Order the input sections of the functions named in the call graph
+  // profile.  This is called after all input sections have been laid
+  // out.
+  void
+  apply_call_graph_profile(const Task*, const Symbol_table*);
+
   // Layout an input reloc section when doing a relocatable link.  The
   // section is RELOC_SHNDX in OBJECT, with data in SHDR.
   // DATA_SECTION is the reloc section to which it refers.  RR is the
@@ -685,7 +697,7 @@ class Layout
 			  size_t cie_length);
 
   // Scan a .debug_info or .debug_types section, and add summary
-  // information to the .gdb_index section.
+  // information to the .gdb_index and .debug_names sections.
   template<int size, bool big_endian>
   void
   add_to_gdb_index(bool is_type_unit,
@@ -696,6 +708,13 @@ class Layout
 		   unsigned int reloc_shndx,
 		   unsigned int reloc_type);
 
+  // Queue the tasks which scan the sections passed to
+  // add_to_gdb_index.  THIS_BLOCKER is the blocker which the layout
+  // task would wait for.  Return the blocker it should wait for
+  // instead.
+  Task_token*
+  queue_gdb_index_tasks(Workqueue*, Task_token* this_blocker);
+
   // Handle a GNU stack note.  This is called once per input object
   // file.  SEEN_GNU_STACK is true if the object file has a
   // .note.GNU-stack section.  GNU_STACK_FLAGS is the section flags
@@ -1454,7 +1473,7 @@ class Layout
   bool added_eh_frame_data_;
   // The exception frame header output section if there is one.
   Output_section* eh_frame_hdr_section_;
-  // The data for the .gdb_index section.
+  // The data for the .gdb_index and .debug_names sections.
   Gdb_index* gdb_index_data_;
   // The space for the build ID checksum if there is one.
   Output_section_data* build_id_note_;
@@ -1520,6 +1539,8 @@ class Layout
   Unordered_map<std::string, unsigned int> input_section_position_;
   // Vector of glob only patterns in the section_ordering file.
   std::vector<std::string> input_section_glob_;
+  // The call graph profile from --call-graph-profile, or NULL.
+  Call_graph_profile* call_graph_profile_;
   // For incremental links, the base file to be modified.
   Incremental_binary* incremental_base_;
   // For incremental links, a list of free space within the file.
@@ -1681,7 +1702,7 @@ class Write_after_input_sections_task : public Task
 };
 
 // This task function handles computation of the build id.
-// When using --build-id=tree, it schedules the tasks that
+// When using --build-id=tree or --build-id=xxhash, it schedules the tasks that
 // compute the hashes for each chunk of the file. This task
 // cannot run until we have finalized the size of the output
 // file, after the completion of Write_after_input_sections_task.
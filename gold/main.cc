@@ -133,6 +133,18 @@ write_debug_script(std::string, const char*, const char*)
 
 #endif // !defined(DEBUG)
 
+// Print the memory statistics for one pass, for --stats.
+
+static void
+print_pass_memory(const char* pass, const Timer::MemoryStats& memory)
+{
+  if (memory.peak_rss >= 0)
+    fprintf(stderr, _("%s: %s peak resident memory: %lld bytes\n"),
+	    program_name, pass, memory.peak_rss);
+  if (memory.malloc >= 0)
+    fprintf(stderr, _("%s: %s end space in use by malloc: %lld bytes\n"),
+	    program_name, pass, memory.malloc);
+}
 
 int
 main(int argc, char** argv)
@@ -202,6 +214,7 @@ main(int argc, char** argv)
 
   // The work queue.
   Workqueue workqueue(command_line.options());
+  set_parameters_workqueue(&workqueue);
 
   // The list of input objects.
   Input_objects input_objects;
@@ -235,6 +248,9 @@ main(int argc, char** argv)
   if (parameters->options().section_ordering_file())
     layout.read_layout_from_file();
 
+  if (parameters->options().call_graph_profile())
+    layout.read_call_graph_profile();
+
   // Load plugin libraries.
   if (command_line.options().has_plugins())
     command_line.options().plugins()->load_plugins(&layout);
@@ -251,6 +267,9 @@ main(int argc, char** argv)
   // Run the main task processing loop.
   workqueue.process(0);
 
+  if (command_line.options().user_set_task_trace())
+    workqueue.write_trace();
+
   if (command_line.options().print_output_format())
     print_output_format();
 
@@ -265,6 +284,7 @@ main(int argc, char** argv)
               elapsed.user / 1000, (elapsed.user % 1000) * 1000,
               elapsed.sys / 1000, (elapsed.sys % 1000) * 1000,
               elapsed.wall / 1000, (elapsed.wall % 1000) * 1000);
+      print_pass_memory(_("initial tasks"), timer.get_pass_memory(0));
       elapsed = timer.get_pass_time(1);
       fprintf(stderr,
              _("%s: middle tasks run time: " \
@@ -273,6 +293,7 @@ main(int argc, char** argv)
               elapsed.user / 1000, (elapsed.user % 1000) * 1000,
               elapsed.sys / 1000, (elapsed.sys % 1000) * 1000,
               elapsed.wall / 1000, (elapsed.wall % 1000) * 1000);
+      print_pass_memory(_("middle tasks"), timer.get_pass_memory(1));
       elapsed = timer.get_pass_time(2);
       fprintf(stderr,
              _("%s: final tasks run time: " \
@@ -281,6 +302,7 @@ main(int argc, char** argv)
               elapsed.user / 1000, (elapsed.user % 1000) * 1000,
               elapsed.sys / 1000, (elapsed.sys % 1000) * 1000,
               elapsed.wall / 1000, (elapsed.wall % 1000) * 1000);
+      print_pass_memory(_("final tasks"), timer.get_pass_memory(2));
       elapsed = timer.get_elapsed_time();
       fprintf(stderr,
              _("%s: total run time: " \
@@ -309,6 +331,7 @@ main(int argc, char** argv)
       layout.print_stats();
       Gdb_index::print_stats();
       Free_list::print_stats();
+      workqueue.print_stats();
     }
 
   // Issue defined symbol report.
@@ -25,6 +25,8 @@
 #include <cstdlib>
 #include <algorithm>
 
+#include "parameters.h"
+#include "options.h"
 #include "merge.h"
 #include "compressed_output.h"
 
@@ -80,6 +82,17 @@ Object_merge_map::get_or_make_input_merge_map(
   return new_map;
 }
 
+// Free the mappings for an input section.  We keep the
+// Input_merge_map itself so that find_merge_section still works.
+
+void
+Object_merge_map::release_input_merge_map(unsigned int shndx)
+{
+  Input_merge_map* map = this->get_input_merge_map(shndx);
+  if (map != NULL)
+    Input_merge_map::Entries().swap(map->entries);
+}
+
 // Add a mapping.
 
 void
@@ -601,6 +614,8 @@ void
 Output_merge_string<Char_type>::do_write(Output_file* of)
 {
   this->stringpool_.write(of, this->offset());
+  if (parameters->options().reduce_memory_overheads())
+    this->release_stringpool();
 }
 
 // Write a merged string section to a buffer.
@@ -610,6 +625,24 @@ void
 Output_merge_string<Char_type>::do_write_to_buffer(unsigned char* buffer)
 {
   this->stringpool_.write_to_buffer(buffer, this->data_size());
+  if (parameters->options().reduce_memory_overheads())
+    this->release_stringpool();
+}
+
+// Free the Stringpool.  The strings are only needed to write them
+// out; offsets are found through the merge maps of the input objects.
+// Keep its statistics, since --stats prints them after the section
+// has been written.
+
+template<typename Char_type>
+void
+Output_merge_string<Char_type>::release_stringpool()
+{
+  if (this->stringpool_released_)
+    return;
+  this->stringpool_stats_ = this->stringpool_.get_stats();
+  this->stringpool_released_ = true;
+  this->stringpool_.clear();
 }
 
 // Return the name of the types of string to use with
@@ -656,7 +689,10 @@ Output_merge_string<Char_type>::do_print_merge_stats(const char* section_name)
 	  program_name, buf, this->input_size_);
   fprintf(stderr, _("%s: %s input strings: %zu\n"),
 	  program_name, buf, this->input_count_);
-  this->stringpool_.print_stats(buf);
+  if (this->stringpool_released_)
+    Stringpool_template<Char_type>::print_stats(buf, this->stringpool_stats_);
+  else
+    this->stringpool_.print_stats(buf);
 }
 
 // Instantiate the templates we need.
@@ -72,6 +72,11 @@ class Object_merge_map
   const Output_section_data*
   find_merge_section(unsigned int shndx) const;
 
+  // Free the mappings for the input section SHNDX.  No offsets in the
+  // section may be looked up after this.
+  void
+  release_input_merge_map(unsigned int shndx);
+
   // Initialize an mapping from input offsets to output addresses for
   // section SHNDX.  STARTING_ADDRESS is the output address of the
   // merged section.
@@ -402,7 +407,8 @@ class Output_merge_string : public Output_merge_base
  public:
   Output_merge_string(uint64_t addralign)
     : Output_merge_base(sizeof(Char_type), addralign), stringpool_(addralign),
-      merged_strings_lists_(), input_count_(0), input_size_(0)
+      merged_strings_lists_(), input_count_(0), input_size_(0),
+      stringpool_stats_(), stringpool_released_(false)
   {
     this->stringpool_.set_no_zero_null();
   }
@@ -466,6 +472,11 @@ class Output_merge_string : public Output_merge_base
   const char*
   string_name();
 
+  // Free the Stringpool once the section has been written, under
+  // --reduce-memory-overheads.
+  void
+  release_stringpool();
+
   // As we see input sections, we build a mapping from object, section
   // index and offset to strings.
   struct Merged_string
@@ -507,6 +518,11 @@ class Output_merge_string : public Output_merge_base
   size_t input_count_;
   // The total size of input sections.
   size_t input_size_;
+  // The statistics of stringpool_, kept for --stats when it is freed
+  // by release_stringpool.
+  typename Stringpool_template<Char_type>::Stats stringpool_stats_;
+  // Whether release_stringpool has been called.
+  bool stringpool_released_;
 };
 
 } // End namespace gold.
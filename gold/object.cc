@@ -31,6 +31,7 @@
 #include "gc.h"
 #include "target-select.h"
 #include "dwarf_reader.h"
+#include "ehframe.h"
 #include "layout.h"
 #include "output.h"
 #include "symtab.h"
@@ -298,6 +299,14 @@ Relobj::merge_output_offset(unsigned int shndx, section_offset_type offset,
   return object_merge_map->get_output_offset(shndx, offset, poutput);
 }
 
+void
+Relobj::release_merge_map(unsigned int shndx)
+{
+  Object_merge_map* object_merge_map = this->object_merge_map_;
+  if (object_merge_map != NULL)
+    object_merge_map->release_input_merge_map(shndx);
+}
+
 const Output_section_data*
 Relobj::find_merge_section(unsigned int shndx) const {
   Object_merge_map* object_merge_map = this->object_merge_map_;
@@ -478,6 +487,7 @@ Sized_relobj_file<size, big_endian>::Sized_relobj_file(
     local_plt_offsets_(),
     kept_comdat_sections_(),
     has_eh_frame_(false),
+    eh_frame_inputs_(),
     is_deferred_layout_(false),
     deferred_layout_(),
     deferred_layout_relocs_(),
@@ -488,6 +498,7 @@ Sized_relobj_file<size, big_endian>::Sized_relobj_file(
 template<int size, bool big_endian>
 Sized_relobj_file<size, big_endian>::~Sized_relobj_file()
 {
+  this->free_eh_frame_inputs();
 }
 
 // Set up an object file based on the file header.  This sets up the
@@ -682,12 +693,12 @@ need_decompressed_section(const char* name)
       // We will need .zdebug_str if this is not an incremental link
       // (i.e., we are processing string merge sections) or if we need
       // to build a gdb index.
-      if ((!parameters->incremental() || parameters->options().gdb_index())
+      if ((!parameters->incremental() || parameters->options().debug_index())
 	  && strcmp(name, "str") == 0)
 	return true;
 
       // We will need these other sections when building a gdb index.
-      if (parameters->options().gdb_index()
+      if (parameters->options().debug_index()
 	  && (strcmp(name, "info") == 0
 	      || strcmp(name, "types") == 0
 	      || strcmp(name, "pubnames") == 0
@@ -703,7 +714,7 @@ need_decompressed_section(const char* name)
   // Otherwise, we would decompress the section twice: once for
   // string merge processing, and once for building the gdb index.
   if (!parameters->incremental()
-      && parameters->options().gdb_index()
+      && parameters->options().debug_index()
       && strcmp(name, "str") == 0)
     return true;
 
@@ -817,7 +828,7 @@ Sized_relobj_file<size, big_endian>::do_find_special_sections(
 
   return (this->has_eh_frame_
 	  || (!parameters->options().relocatable()
-	      && parameters->options().gdb_index()
+	      && parameters->options().debug_index()
 	      && (memmem(names, sd->section_names_size, "debug_info", 11) != NULL
 		  || memmem(names, sd->section_names_size,
 			    "debug_types", 12) != NULL)));
@@ -920,6 +931,123 @@ Sized_relobj_file<size, big_endian>::base_read_symbols(Read_symbols_data* sd)
   sd->symbol_names = fvstrtab;
   sd->symbol_names_size =
     convert_to_section_size_type(strtabshdr.get_sh_size());
+
+#ifdef ENABLE_THREADS
+  // Reading the .eh_frame sections now will help only if we're
+  // multithreaded, as the symbols of different objects are read in
+  // parallel, while the objects are laid out one at a time.
+  if (this->has_eh_frame_
+      && parameters->options().threads()
+      && !parameters->options().relocatable()
+      && !parameters->incremental()
+      && !this->input_file()->just_symbols())
+    this->read_eh_frame_sections(sd);
+#endif
+}
+
+// Read the .eh_frame sections into Eh_frame_input objects, which
+// Eh_frame::add_ehframe_input_section will pick up when the sections
+// are laid out.  SD holds the section headers and all the symbols.
+
+template<int size, bool big_endian>
+void
+Sized_relobj_file<size, big_endian>::read_eh_frame_sections(
+    Read_symbols_data* sd)
+{
+  const unsigned int shnum = this->shnum();
+  const unsigned char* const pshdrs = sd->section_headers->data();
+  const char* names =
+    reinterpret_cast<const char*>(sd->section_names->data());
+
+  // Find the .eh_frame sections, and the reloc section for each of
+  // them.  As in do_layout, a reloc section index of -1U means that
+  // there is more than one.
+  std::vector<unsigned int> reloc_shndx(shnum, 0);
+  std::vector<unsigned int> reloc_type(shnum, elfcpp::SHT_NULL);
+  std::vector<unsigned int> eh_frame_sections;
+  const unsigned char* p = pshdrs + This::shdr_size;
+  for (unsigned int i = 1; i < shnum; ++i, p += This::shdr_size)
+    {
+      typename This::Shdr shdr(p);
+      unsigned int sh_type = shdr.get_sh_type();
+      if (sh_type == elfcpp::SHT_REL || sh_type == elfcpp::SHT_RELA)
+	{
+	  unsigned int target_shndx = this->adjust_shndx(shdr.get_sh_info());
+	  if (target_shndx == 0 || target_shndx >= shnum)
+	    continue;
+	  if (reloc_shndx[target_shndx] != 0)
+	    reloc_shndx[target_shndx] = -1U;
+	  else
+	    {
+	      reloc_shndx[target_shndx] = i;
+	      reloc_type[target_shndx] = sh_type;
+	    }
+	}
+      else if (shdr.get_sh_name() < sd->section_names_size
+	       && this->check_eh_frame_flags(&shdr)
+	       && strcmp(names + shdr.get_sh_name(), ".eh_frame") == 0)
+	eh_frame_sections.push_back(i);
+    }
+
+  if (eh_frame_sections.empty() || sd->symbols == NULL)
+    return;
+
+  this->eh_frame_inputs_.reserve(eh_frame_sections.size());
+  for (std::vector<unsigned int>::const_iterator pe =
+	 eh_frame_sections.begin();
+       pe != eh_frame_sections.end();
+       ++pe)
+    {
+      unsigned int i = *pe;
+      Eh_frame_input* input =
+	Eh_frame::read_ehframe_input_section(this,
+					     sd->symbols->data(),
+					     sd->symbols_size,
+					     sd->symbol_names->data(),
+					     sd->symbol_names_size,
+					     i, reloc_shndx[i], reloc_type[i]);
+      this->eh_frame_inputs_.push_back(input);
+    }
+}
+
+// Free the .eh_frame sections read by read_eh_frame_sections which
+// layout did not use, such as those in a discarded output section.
+// This is called once all of the object's .eh_frame sections have
+// been laid out.
+
+template<int size, bool big_endian>
+void
+Sized_relobj_file<size, big_endian>::free_eh_frame_inputs()
+{
+  for (std::vector<Eh_frame_input*>::iterator p =
+	 this->eh_frame_inputs_.begin();
+       p != this->eh_frame_inputs_.end();
+       ++p)
+    delete *p;
+  std::vector<Eh_frame_input*>().swap(this->eh_frame_inputs_);
+}
+
+// Return the .eh_frame section SHNDX as read by
+// read_eh_frame_sections, or NULL.
+
+template<int size, bool big_endian>
+Eh_frame_input*
+Sized_relobj_file<size, big_endian>::release_eh_frame_input(
+    unsigned int shndx)
+{
+  for (std::vector<Eh_frame_input*>::iterator p =
+	 this->eh_frame_inputs_.begin();
+       p != this->eh_frame_inputs_.end();
+       ++p)
+    {
+      if ((*p)->shndx() == shndx)
+	{
+	  Eh_frame_input* ret = *p;
+	  this->eh_frame_inputs_.erase(p);
+	  return ret;
+	}
+    }
+  return NULL;
 }
 
 // Return the section index of symbol SYM.  Set *VALUE to its value in
@@ -1868,11 +1996,11 @@ Sized_relobj_file<size, big_endian>::do_layout(Symbol_table* symtab,
 	  this->layout_section(layout, i, name, shdr, sh_type, reloc_shndx[i],
 			       reloc_type[i]);
 
-	  // When generating a .gdb_index section, we do additional
-	  // processing of .debug_info and .debug_types sections after all
-	  // the other sections for the same reason as above.
+	  // When generating a .gdb_index or .debug_names section, we do
+	  // additional processing of .debug_info and .debug_types sections
+	  // after all the other sections for the same reason as above.
 	  if (!relocatable
-	      && parameters->options().gdb_index()
+	      && parameters->options().debug_index()
 	      && !(shdr.get_sh_flags() & elfcpp::SHF_ALLOC))
 	    {
 	      if (strcmp(name, ".debug_info") == 0
@@ -1930,6 +2058,11 @@ Sized_relobj_file<size, big_endian>::do_layout(Symbol_table* symtab,
 				    reloc_type[i]);
     }
 
+  // The .eh_frame sections are all laid out, unless that was put off
+  // until the second pass or until the deferred sections are laid out.
+  if (!is_pass_one && !this->is_deferred_layout())
+    this->free_eh_frame_inputs();
+
   // When doing a relocatable link handle the reloc sections at the
   // end.  Garbage collection  and Identical Code Folding is not
   // turned on for relocatable code.
@@ -1985,8 +2118,8 @@ Sized_relobj_file<size, big_endian>::do_layout(Symbol_table* symtab,
       out_section_offsets[i] = invalid_address;
     }
 
-  // When building a .gdb_index section, scan the .debug_info and
-  // .debug_types sections.
+  // When building a .gdb_index or .debug_names section, scan the
+  // .debug_info and .debug_types sections.
   gold_assert(!is_pass_one
 	      || (debug_info_sections.empty() && debug_types_sections.empty()));
   for (std::vector<unsigned int>::const_iterator p
@@ -2080,6 +2213,7 @@ Sized_relobj_file<size, big_endian>::do_layout_deferred_sections(Layout* layout)
     }
 
   this->deferred_layout_.clear();
+  this->free_eh_frame_inputs();
 
   // Now handle the deferred relocation sections.
 
@@ -47,6 +47,7 @@ class Output_file;
 class Output_symtab_xindex;
 class Pluginobj;
 class Dynobj;
+class Eh_frame_input;
 class Object_merge_map;
 class Relocatable_relocs;
 struct Symbols_data;
@@ -786,6 +787,12 @@ class Object
   read(off_t start, section_size_type size, void* p)
   { this->input_file()->file().read(start + this->offset_, size, p); }
 
+  // Tell the system that we will soon read SIZE bytes of the
+  // underlying file at START.
+  void
+  will_need(off_t start, section_size_type size)
+  { this->input_file()->file().will_need(start + this->offset_, size); }
+
   // Read multiple data from the underlying file.
   void
   read_multiple(const File_read::Read_multiple& rm)
@@ -1362,6 +1369,10 @@ class Relobj : public Object
   const Output_section_data*
   find_merge_section(unsigned int shndx) const;
 
+  // Free the merge mappings for input section SHNDX.
+  void
+  release_merge_map(unsigned int shndx);
+
   // Record the relocatable reloc info for an input reloc section.
   void
   set_relocatable_relocs(unsigned int reloc_shndx, Relocatable_relocs* rr)
@@ -2262,6 +2273,11 @@ class Sized_relobj_file : public Sized_relobj<size, big_endian>
   unsigned int
   symbol_section_and_value(unsigned int sym, Address* value, bool* is_ordinary);
 
+  // Return the .eh_frame section SHNDX as read along with the symbols,
+  // or NULL if it was not read then.  The caller takes ownership.
+  Eh_frame_input*
+  release_eh_frame_input(unsigned int shndx);
+
   // Return a pointer to the Symbol_value structure which holds the
   // value of a local symbol.
   const Symbol_value<size>*
@@ -2670,6 +2686,15 @@ class Sized_relobj_file : public Sized_relobj<size, big_endian>
   find_eh_frame(const unsigned char* pshdrs, const char* names,
 		section_size_type names_size) const;
 
+  // Read the .eh_frame sections, so that Eh_frame need not.
+  void
+  read_eh_frame_sections(Read_symbols_data* sd);
+
+  // Free the .eh_frame sections read along with the symbols which
+  // were not laid out.
+  void
+  free_eh_frame_inputs();
+
   // Whether to include a section group in the link.
   bool
   include_section_group(Symbol_table*, Layout*, unsigned int, const char*,
@@ -2700,6 +2725,12 @@ class Sized_relobj_file : public Sized_relobj<size, big_endian>
   void
   layout_gnu_property_section(Layout* layout, unsigned int shndx);
 
+  // Tell the system that we are about to read the relocation sections
+  // which we use, and, if WITH_CONTENTS, the sections which we copy to
+  // the output file.
+  void
+  will_need_sections(const unsigned char* pshdrs, bool with_contents);
+
   // Write section data to the output file.  Record the views and
   // sizes in VIEWS for use when relocating.
   void
@@ -2734,13 +2765,15 @@ class Sized_relobj_file : public Sized_relobj<size, big_endian>
 
   // Scan the input relocations for --incremental.
   void
-  incremental_relocs_scan(const Read_relocs_data::Relocs_list::iterator&);
+  incremental_relocs_scan(const Symbol_table*,
+			  const Read_relocs_data::Relocs_list::iterator&);
 
   // Scan the input relocations for --incremental, templatized on the
   // type of the relocation section.
   template<int sh_type>
   void
   incremental_relocs_scan_reltype(
+      const Symbol_table*,
       const Read_relocs_data::Relocs_list::iterator&);
 
   void
@@ -2904,6 +2937,8 @@ class Sized_relobj_file : public Sized_relobj<size, big_endian>
   Kept_comdat_section_table kept_comdat_sections_;
   // Whether this object has a GNU style .eh_frame section.
   bool has_eh_frame_;
+  // The .eh_frame sections read along with the symbols.
+  std::vector<Eh_frame_input*> eh_frame_inputs_;
   // True if the layout of this object was deferred, waiting for plugin
   // replacement files.
   bool is_deferred_layout_;
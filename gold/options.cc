@@ -1387,6 +1387,11 @@ General_options::finalize()
     gold_fatal(_("binary output format not compatible "
 		 "with -shared or -pie or -r"));
 
+  if (this->call_graph_profile() != NULL
+      && this->section_ordering_file() != NULL)
+    gold_fatal(_("--call-graph-profile and --section-ordering-file "
+		 "are incompatible"));
+
   if (this->user_set_hash_bucket_empty_fraction()
       && (this->hash_bucket_empty_fraction() < 0.0
 	  || this->hash_bucket_empty_fraction() >= 1.0))
@@ -1415,15 +1420,16 @@ General_options::finalize()
 	gold_fatal(_("incremental linking is not compatible with -z relro"));
       if (this->pie())
 	gold_fatal(_("incremental linking is not compatible with -pie"));
-      if (this->gc_sections())
+      if (this->call_graph_profile() != NULL)
 	{
-	  gold_warning(_("ignoring --gc-sections for an incremental link"));
-	  this->set_gc_sections(false);
+	  gold_warning(_("ignoring --call-graph-profile for an "
+			 "incremental link"));
+	  this->set_call_graph_profile(NULL);
 	}
-      if (this->icf_enabled())
+      if (this->debug_names())
 	{
-	  gold_warning(_("ignoring --icf for an incremental link"));
-	  this->set_icf_status(ICF_NONE);
+	  gold_warning(_("ignoring --debug-names for an incremental link"));
+	  this->set_debug_names(false);
 	}
       if (strcmp(this->compress_debug_sections(), "none") != 0)
 	{
@@ -1446,6 +1452,10 @@ General_options::finalize()
   if (this->user_set_rosegment_gap())
     this->set_rosegment(true);
 
+  // --reduce-memory-overheads implies --no-keep-files-mapped.
+  if (this->reduce_memory_overheads() && !this->user_set_keep_files_mapped())
+    this->set_keep_files_mapped(false);
+
   // FIXME: we can/should be doing a lot more sanity checking here.
 }
 
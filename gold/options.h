@@ -698,6 +698,10 @@ class General_options
 	      N_("(aarch64 only) Do not apply link-time values "
 		 "for dynamic relocations"));
 
+  DEFINE_string(archive_symbol_cache, options::TWO_DASHES, '\0', NULL,
+		N_("Cache the symbols of archive members in DIRECTORY"),
+		N_("DIRECTORY"));
+
   DEFINE_bool(as_needed, options::TWO_DASHES, '\0', false,
 	      N_("Use DT_NEEDED only for shared libraries that are used"),
 	      N_("Use DT_NEEDED for all shared libraries"));
@@ -715,6 +719,11 @@ class General_options
   DEFINE_string(format, options::TWO_DASHES, 'b', "elf",
 		N_("Set input format"), ("[elf,binary]"));
 
+  DEFINE_bool(batch_relocs, options::TWO_DASHES, '\0', true,
+	      N_("Apply runs of simple relocations in unallocated sections"
+		 " together (default)"),
+	      N_("Apply each relocation in unallocated sections separately"));
+
   DEFINE_bool(be8, options::TWO_DASHES, '\0', false,
 	      N_("Output BE8 format image"), NULL);
 
@@ -724,7 +733,8 @@ class General_options
 
   DEFINE_uint64(build_id_chunk_size_for_treehash,
 		options::TWO_DASHES, '\0', 2 << 20,
-		N_("Chunk size for '--build-id=tree'"), N_("SIZE"));
+		N_("Chunk size for '--build-id=tree' and"
+		   " '--build-id=xxhash'"), N_("SIZE"));
 
   DEFINE_uint64(build_id_min_file_size_for_treehash, options::TWO_DASHES,
 		'\0', 40 << 20,
@@ -764,6 +774,11 @@ class General_options
 
   // c
 
+  DEFINE_string(call_graph_profile, options::TWO_DASHES, '\0', NULL,
+		N_("Order functions to follow the call graph profile in "
+		   "FILENAME"),
+		N_("FILENAME"));
+
   DEFINE_bool(check_sections, options::TWO_DASHES, '\0', true,
 	      N_("Check segment addresses for overlaps"),
 	      N_("Do not check segment addresses for overlaps"));
@@ -799,6 +814,10 @@ class General_options
 		N_("Turn on debugging"),
 		N_("[all,files,script,task][,...]"));
 
+  DEFINE_bool(debug_names, options::TWO_DASHES, '\0', false,
+	      N_("Generate .debug_names section"),
+	      N_("Do not generate .debug_names section"));
+
   DEFINE_special(defsym, options::TWO_DASHES, '\0',
 		 N_("Define a symbol"), N_("SYMBOL=EXPRESSION"));
 
@@ -885,6 +904,10 @@ class General_options
 	      N_("Treat warnings as errors"),
 	      N_("Do not treat warnings as errors"));
 
+  DEFINE_bool(file_access_hints, options::TWO_DASHES, '\0', true,
+	      N_("Tell the system how input files will be read (default)"),
+	      N_("Do not tell the system how input files will be read"));
+
   DEFINE_string(fini, options::ONE_DASH, '\0', "_fini",
 		N_("Call SYMBOL at unload-time"), N_("SYMBOL"));
 
@@ -1204,6 +1227,9 @@ class General_options
 	      N_("Relax branches on certain targets"),
 	      N_("Do not relax branches"));
 
+  DEFINE_bool(reduce_memory_overheads, options::TWO_DASHES, '\0', false,
+	      N_("Reduce memory overheads, possibly taking longer"), NULL);
+
   DEFINE_string(retain_symbols_file, options::TWO_DASHES, '\0', NULL,
 		N_("keep only symbols listed in this file"), N_("FILE"));
 
@@ -1313,6 +1339,11 @@ class General_options
 	      N_("[rel, abs, got-rel"), false,
 	      {"rel", "abs", "got-rel"});
 
+  DEFINE_string(task_trace, options::TWO_DASHES, '\0', NULL,
+		N_("Write a trace of task execution in Chrome trace event "
+		   "format to FILE"),
+		N_("FILE"));
+
   DEFINE_bool(text_reorder, options::TWO_DASHES, '\0', true,
 	      N_("Enable text section reordering for GCC section names"),
 	      N_("Disable text section reordering for GCC section names"));
@@ -1645,6 +1676,12 @@ class General_options
   icf_safe_folding() const
   { return this->icf_status_ == ICF_SAFE; }
 
+  // Return true if we are building an index of the debug
+  // information, in a .gdb_index or .debug_names section.
+  bool
+  debug_index() const
+  { return this->gdb_index() || this->debug_names(); }
+
   // The --demangle option takes an optional string, and there is also
   // a --no-demangle option.  This is the best way to decide whether
   // to demangle or not.
@@ -2560,6 +2560,15 @@ class Output_data_got : public Output_data_got_base
     this->replace_got_entry(i, Got_entry(constant));
   }
 
+  // Replace GOT entry I with the value of global symbol GSYM.  This is
+  // used in an incremental update for a reserved entry whose value is
+  // not set by a dynamic relocation.
+  void
+  replace_global(unsigned int i, Symbol* gsym)
+  {
+    this->replace_got_entry(i, Got_entry(gsym, false, 0));
+  }
+
   // Reserve a slot in the GOT for a local symbol plus ADDEND.
   void
   reserve_local(unsigned int i, Relobj* object, unsigned int sym_index,
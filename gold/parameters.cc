@@ -64,8 +64,8 @@ Set_parameters_target_once set_parameters_target_once(&static_parameters);
 // Class Parameters.
 
 Parameters::Parameters()
-   : errors_(NULL), timer_(NULL), options_(NULL), target_(NULL),
-     doing_static_link_valid_(false), doing_static_link_(false),
+   : errors_(NULL), timer_(NULL), workqueue_(NULL), options_(NULL),
+     target_(NULL), doing_static_link_valid_(false), doing_static_link_(false),
      debug_(0), incremental_mode_(General_options::INCREMENTAL_OFF),
      set_parameters_target_once_(&set_parameters_target_once)
  {
@@ -85,6 +85,13 @@ Parameters::set_timer(Timer* timer)
   this->timer_ = timer;
 }
 
+void
+Parameters::set_workqueue(Workqueue* workqueue)
+{
+  gold_assert(this->workqueue_ == NULL);
+  this->workqueue_ = workqueue;
+}
+
 void
 Parameters::set_options(const General_options* options)
 {
@@ -290,6 +297,10 @@ void
 set_parameters_timer(Timer* timer)
 { static_parameters.set_timer(timer); }
 
+void
+set_parameters_workqueue(Workqueue* workqueue)
+{ static_parameters.set_workqueue(workqueue); }
+
 void
 set_parameters_options(const General_options* options)
 { static_parameters.set_options(options); }
@@ -178,6 +178,11 @@ register_new_input(ld_plugin_new_input_handler handler);
 static enum ld_plugin_status
 get_wrap_symbols(uint64_t *num_symbols, const char ***wrap_symbol_list);
 
+static int
+get_api_version(const char *plugin_identifier, const char *plugin_version,
+		int minimal_api_supported, int maximal_api_supported,
+		const char **linker_identifier, const char **linker_version);
+
 };
 
 #endif // ENABLE_PLUGINS
@@ -223,7 +228,7 @@ Plugin::load()
   sscanf(ver, "%d.%d", &major, &minor);
 
   // Allocate and populate a transfer vector.
-  const int tv_fixed_size = 31;
+  const int tv_fixed_size = 33;
 
   int tv_size = this->args_.size() + tv_fixed_size;
   ld_plugin_tv* tv = new ld_plugin_tv[tv_size];
@@ -365,6 +370,14 @@ Plugin::load()
   tv[i].tv_tag = LDPT_GET_WRAP_SYMBOLS;
   tv[i].tv_u.tv_get_wrap_symbols = get_wrap_symbols;
 
+  ++i;
+  tv[i].tv_tag = LDPT_ADD_SYMBOLS_V2;
+  tv[i].tv_u.tv_add_symbols = add_symbols;
+
+  ++i;
+  tv[i].tv_tag = LDPT_GET_API_VERSION;
+  tv[i].tv_u.tv_get_api_version = get_api_version;
+
   ++i;
   tv[i].tv_tag = LDPT_NULL;
   tv[i].tv_u.tv_val = 0;
@@ -711,6 +724,7 @@ Plugin_manager::~Plugin_manager()
     delete *obj;
   this->objects_.clear();
   delete this->lock_;
+  delete this->objects_lock_;
   delete this->recorder_;
 }
 
@@ -731,9 +745,43 @@ Plugin_manager::load_plugins(Layout* layout)
        this->current_ != this->plugins_.end();
        ++this->current_)
     (*this->current_)->load();
+
+  // We can call the claim-file handlers for different files at the
+  // same time only if every plugin has agreed to that.
+  this->claim_file_is_thread_safe_ = true;
+  for (Plugin_list::const_iterator p = this->plugins_.begin();
+       p != this->plugins_.end();
+       ++p)
+    if (!(*p)->claim_file_is_thread_safe())
+      this->claim_file_is_thread_safe_ = false;
+}
+
+// Negotiate the API version with the plugin being loaded.  We support
+// LAPI_V1: we provide get_symbols_v3 and add_symbols_v2, and
+// add_symbols may be called from several threads at once.
+
+int
+Plugin_manager::set_api_version(int minimal_api_supported,
+				int maximal_api_supported)
+{
+  gold_assert(this->current_ != plugins_.end());
+  int version;
+  if (maximal_api_supported >= LAPI_V1)
+    version = LAPI_V1;
+  else
+    version = LAPI_V0;
+  if (version < minimal_api_supported)
+    gold_error(_("%s: plugin requires API version %d, but only version %d "
+		 "is supported"),
+	       (*this->current_)->filename().c_str(),
+	       minimal_api_supported, version);
+  (*this->current_)->set_api_version(version);
+  return version;
 }
 
 // Call the plugin claim-file handlers in turn to see if any claim the file.
+// If all the plugins said that their claim-file handlers are thread
+// safe, this may be called for different files at the same time.
 
 Pluginobj*
 Plugin_manager::claim_file(Input_file* input_file, off_t offset,
@@ -742,19 +790,33 @@ Plugin_manager::claim_file(Input_file* input_file, off_t offset,
   bool lock_initialized = this->initialize_lock_.initialize();
 
   gold_assert(lock_initialized);
-  Hold_lock hl(*this->lock_);
-
-  unsigned int handle = this->objects_.size();
-  this->input_file_ = input_file;
-  this->plugin_input_file_.name = input_file->filename().c_str();
-  this->plugin_input_file_.fd = input_file->file().descriptor();
-  this->plugin_input_file_.offset = offset;
-  this->plugin_input_file_.filesize = filesize;
-  this->plugin_input_file_.handle = reinterpret_cast<void*>(handle);
-  if (elf_object != NULL)
+
+  // Unless the handlers are thread safe, claim one file at a time.
+  // Without threads, Hold_optional_lock does nothing anyhow.
+  Hold_optional_lock hl(this->claim_file_is_thread_safe_
+			&& !this->in_replacement_phase_
+			? NULL
+			: this->lock_);
+
+  Pending_claim claim;
+  claim.input_file = input_file;
+  claim.plugin_input_file.name = input_file->filename().c_str();
+  claim.plugin_input_file.fd = input_file->file().descriptor();
+  claim.plugin_input_file.offset = offset;
+  claim.plugin_input_file.filesize = filesize;
+
+  // The handle is the index of a new entry in objects_.  We record the
+  // ELF object there so that the plugin can look at its sections.
+  unsigned int handle;
+  {
+    Hold_lock hlo(this->objects_lock());
+    handle = this->objects_.size();
     this->objects_.push_back(elf_object);
-  this->in_claim_file_handler_ = true;
+    this->pending_claims_[handle] = &claim;
+  }
+  claim.plugin_input_file.handle = reinterpret_cast<void*>(handle);
 
+  Pluginobj* obj = NULL;
   for (Plugin_list::iterator p = this->plugins_.begin();
        p != this->plugins_.end();
        ++p)
@@ -763,38 +825,39 @@ Plugin_manager::claim_file(Input_file* input_file, off_t offset,
       // files, otherwise notify the plugin of the new input file, if needed.
       if (!this->in_replacement_phase_)
 	{
-	  if ((*p)->claim_file(&this->plugin_input_file_))
+	  if ((*p)->claim_file(&claim.plugin_input_file))
 	    {
-	      this->any_claimed_ = true;
-              this->in_claim_file_handler_ = false;
-
 	      if (this->recorder_ != NULL)
 		{
 		  const std::string& objname = (elf_object == NULL
 						? input_file->filename()
 						: elf_object->name());
+		  Hold_lock hlo(this->objects_lock());
 		  this->recorder_->claimed_file(objname,
 						offset, filesize,
 						(*p)->filename());
 		}
 
-              if (this->objects_.size() > handle
-                  && this->objects_[handle]->pluginobj() != NULL)
-                return this->objects_[handle]->pluginobj();
-
               // If the plugin claimed the file but did not call the
               // add_symbols callback, we need to create the Pluginobj now.
-              Pluginobj* obj = this->make_plugin_object(handle);
-              return obj;
+	      obj = this->make_plugin_object(handle);
+
+	      Hold_lock hlo(this->objects_lock());
+	      this->any_claimed_ = true;
+	      if (obj == NULL)
+		obj = this->objects_[handle]->pluginobj();
+	      this->pending_claims_.erase(handle);
+	      return obj;
             }
         }
       else
         {
-	  (*p)->new_input(&this->plugin_input_file_);
+	  (*p)->new_input(&claim.plugin_input_file);
         }
     }
 
-  this->in_claim_file_handler_ = false;
+  Hold_lock hlo(this->objects_lock());
+  this->pending_claims_.erase(handle);
 
   if (this->recorder_ != NULL)
     this->recorder_->unclaimed_file(input_file->filename(), offset, filesize);
@@ -1035,35 +1098,37 @@ Plugin_manager::cleanup()
 }
 
 // Make a new Pluginobj object.  This is called when the plugin calls
-// the add_symbols API.
+// the add_symbols API, which may only be done while the file is being
+// claimed.
 
 Pluginobj*
 Plugin_manager::make_plugin_object(unsigned int handle)
 {
-  // Make sure we aren't asked to make an object for the same handle twice.
-  if (this->objects_.size() != handle
-      && this->objects_[handle]->pluginobj() != NULL)
-    return NULL;
-
-  const std::string* filename = &this->input_file_->filename();
+  Hold_lock hl(this->objects_lock());
 
-  // If the elf object for this file was pushed into the objects_ vector,
-  // use its filename, then delete it to make room for the Pluginobj as
-  // this file is claimed.
-  if (this->objects_.size() != handle)
-    {
-      filename = &this->objects_.back()->name();
-      this->objects_.pop_back();
-    }
+  Pending_claims::const_iterator p = this->pending_claims_.find(handle);
+  if (p == this->pending_claims_.end())
+    return NULL;
+  const Pending_claim* claim = p->second;
 
-  Pluginobj* obj = make_sized_plugin_object(*filename,
-					    this->input_file_,
-                                            this->plugin_input_file_.offset,
-                                            this->plugin_input_file_.filesize);
+  // Make sure we aren't asked to make an object for the same handle twice.
+  Object* elf_object = this->objects_[handle];
+  if (elf_object != NULL && elf_object->pluginobj() != NULL)
+    return NULL;
 
+  // If the elf object for this file was recorded in the objects_
+  // vector, use its filename.  The Pluginobj replaces it, as this file
+  // is claimed.
+  const std::string& filename(elf_object != NULL
+			      ? elf_object->name()
+			      : claim->input_file->filename());
 
+  Pluginobj* obj = make_sized_plugin_object(filename,
+					    claim->input_file,
+                                            claim->plugin_input_file.offset,
+                                            claim->plugin_input_file.filesize);
 
-  this->objects_.push_back(obj);
+  this->objects_[handle] = obj;
   return obj;
 }
 
@@ -1127,13 +1192,14 @@ Plugin_manager::get_view(unsigned int handle, const void **viewp)
   off_t offset;
   size_t filesize;
   Input_file *input_file;
-  if (this->in_claim_file_handler_)
+  const Pending_claim* claim = this->pending_claim(handle);
+  if (claim != NULL)
     {
       // We are being called from the claim_file hook.
-      const struct ld_plugin_input_file &f = this->plugin_input_file_;
+      const struct ld_plugin_input_file &f = claim->plugin_input_file;
       offset = f.offset;
       filesize = f.filesize;
-      input_file = this->input_file_;
+      input_file = claim->input_file;
     }
   else
     {
@@ -2138,6 +2204,27 @@ get_wrap_symbols(uint64_t *count, const char ***wrap_symbols)
   return LDPS_OK;
 }
 
+// Negotiate the plugin API version.  This is called from the plugin's
+// onload function.
+
+static int
+get_api_version(const char *plugin_identifier, const char *plugin_version,
+		int minimal_api_supported, int maximal_api_supported,
+		const char **linker_identifier, const char **linker_version)
+{
+  gold_assert(parameters->options().has_plugins());
+  gold_debug(DEBUG_PLUGIN, "plugin %s %s asks for API version %d to %d",
+	     plugin_identifier != NULL ? plugin_identifier : "(unknown)",
+	     plugin_version != NULL ? plugin_version : "",
+	     minimal_api_supported, maximal_api_supported);
+
+  *linker_identifier = "GNU gold";
+  *linker_version = get_version_string();
+
+  return parameters->options().plugins()->set_api_version(
+      minimal_api_supported, maximal_api_supported);
+}
+
 
 // Specify the ordering of sections in the final layout. The sections are
 // specified as (handle,shndx) pairs in the two arrays in the order in
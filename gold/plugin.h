@@ -24,6 +24,7 @@
 #define GOLD_PLUGIN_H
 
 #include <list>
+#include <map>
 #include <string>
 
 #include "object.h"
@@ -62,6 +63,7 @@ class Plugin
       all_symbols_read_handler_(NULL),
       cleanup_handler_(NULL),
       new_input_handler_(NULL),
+      api_version_(LAPI_V0),
       cleanup_done_(false)
   { }
 
@@ -108,6 +110,20 @@ class Plugin
   set_new_input_handler(ld_plugin_new_input_handler handler)
   { this->new_input_handler_ = handler; }
 
+  // Record the API version negotiated with the plugin.
+  void
+  set_api_version(int version)
+  { this->api_version_ = version; }
+
+  // Return true if the claim-file handler may be called for several
+  // files at the same time.
+  bool
+  claim_file_is_thread_safe() const
+  {
+    return (this->claim_file_handler_ == NULL
+	    || this->api_version_ >= LAPI_V1);
+  }
+
   // Add an argument
   void
   add_option(const char* arg)
@@ -134,6 +150,8 @@ class Plugin
   ld_plugin_all_symbols_read_handler all_symbols_read_handler_;
   ld_plugin_cleanup_handler cleanup_handler_;
   ld_plugin_new_input_handler new_input_handler_;
+  // The API version negotiated through get_api_version.
+  int api_version_;
   // TRUE if the cleanup handlers have been called.
   bool cleanup_done_;
 };
@@ -144,14 +162,15 @@ class Plugin_manager
 {
  public:
   Plugin_manager(const General_options& options)
-    : plugins_(), objects_(), deferred_layout_objects_(), input_file_(NULL),
-      plugin_input_file_(), rescannable_(), undefined_symbols_(),
+    : plugins_(), objects_(), deferred_layout_objects_(),
+      pending_claims_(), rescannable_(), undefined_symbols_(),
       any_claimed_(false), in_replacement_phase_(false), any_added_(false),
-      in_claim_file_handler_(false),
+      claim_file_is_thread_safe_(false),
       options_(options), workqueue_(NULL), task_(NULL), input_objects_(NULL),
       symtab_(NULL), layout_(NULL), dirpath_(NULL), mapfile_(NULL),
       this_blocker_(NULL), extra_search_path_(), lock_(NULL),
-      initialize_lock_(&lock_), defsym_defines_set_(),
+      initialize_lock_(&lock_), objects_lock_(NULL),
+      initialize_objects_lock_(&objects_lock_), defsym_defines_set_(),
       recorder_(NULL)
   { this->current_ = plugins_.end(); }
 
@@ -194,7 +213,14 @@ class Plugin_manager
   // True if the claim_file handler of the plugins is being called.
   bool
   in_claim_file_handler()
-  { return in_claim_file_handler_; }
+  {
+    Hold_lock hl(this->objects_lock());
+    return !this->pending_claims_.empty();
+  }
+
+  // Negotiate the API version with the plugin being loaded.
+  int
+  set_api_version(int minimal_api_supported, int maximal_api_supported);
 
   // Let the plugin manager save an archive for later rescanning.
   // This takes ownership of the Archive pointer.
@@ -265,8 +291,9 @@ class Plugin_manager
 
   // Return the object associated with the given HANDLE.
   Object*
-  object(unsigned int handle) const
+  object(unsigned int handle)
   {
+    Hold_lock hl(this->objects_lock());
     if (handle >= this->objects_.size())
       return NULL;
     return this->objects_[handle];
@@ -353,8 +380,16 @@ class Plugin_manager
     { this->u.input_group = input_group; }
   };
 
+  // A file which is being offered to the claim-file handlers.
+  struct Pending_claim
+  {
+    Input_file* input_file;
+    struct ld_plugin_input_file plugin_input_file;
+  };
+
   typedef std::list<Plugin*> Plugin_list;
   typedef std::vector<Object*> Object_list;
+  typedef std::map<unsigned int, const Pending_claim*> Pending_claims;
   typedef std::vector<Relobj*> Deferred_layout_list;
   typedef std::vector<Rescannable> Rescannable_list;
   typedef std::vector<Symbol*> Undefined_symbol_list;
@@ -363,6 +398,24 @@ class Plugin_manager
   void
   rescan(Task*);
 
+  // Return the lock which protects objects_ and pending_claims_.
+  Lock&
+  objects_lock()
+  {
+    bool lock_initialized = this->initialize_objects_lock_.initialize();
+    gold_assert(lock_initialized);
+    return *this->objects_lock_;
+  }
+
+  // Return the file being claimed with handle HANDLE, or NULL.
+  const Pending_claim*
+  pending_claim(unsigned int handle)
+  {
+    Hold_lock hl(this->objects_lock());
+    Pending_claims::const_iterator p = this->pending_claims_.find(handle);
+    return p == this->pending_claims_.end() ? NULL : p->second;
+  }
+
   // See whether the rescannable at index I defines SYM.
   bool
   rescannable_defines(size_t i, Symbol* sym);
@@ -379,9 +432,10 @@ class Plugin_manager
   // The list of regular objects whose layout has been deferred.
   Deferred_layout_list deferred_layout_objects_;
 
-  // The file currently up for claim by the plugins.
-  Input_file* input_file_;
-  struct ld_plugin_input_file plugin_input_file_;
+  // The files currently up for claim by the plugins, indexed by
+  // handle.  There is more than one only if all the claim-file
+  // handlers are thread safe.
+  Pending_claims pending_claims_;
 
   // A list of archives and input groups being saved for possible
   // later rescanning.
@@ -401,8 +455,9 @@ class Plugin_manager
   // Whether any input files or libraries were added by a plugin.
   bool any_added_;
 
-  // Set to true when the claim_file handler of a plugin is called.
-  bool in_claim_file_handler_;
+  // Whether the claim-file handlers of all the plugins may be called
+  // for different files at the same time.
+  bool claim_file_is_thread_safe_;
 
   const General_options& options_;
   Workqueue* workqueue_;
@@ -419,6 +474,10 @@ class Plugin_manager
   std::string extra_search_path_;
   Lock* lock_;
   Initialize_lock initialize_lock_;
+  // A lock for objects_ and pending_claims_, which may be used while
+  // lock_ is not held.
+  Lock* objects_lock_;
+  Initialize_lock initialize_objects_lock_;
 
   // Keep track of all symbols defined by defsym.
   typedef Unordered_set<std::string> Defsym_defines_set;
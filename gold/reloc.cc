@@ -126,7 +126,9 @@ Gc_process_relocs::is_runnable()
 void
 Gc_process_relocs::locks(Task_locker* tl)
 {
-  tl->add(this, this->object_->token());
+  Task_token* token = this->object_->token();
+  if (token != NULL)
+    tl->add(this, token);
   tl->add(this, this->next_blocker_);
 }
 
@@ -274,6 +276,9 @@ Sized_relobj_file<size, big_endian>::do_read_relocs(Read_relocs_data* rd)
   const unsigned char* pshdrs = this->get_view(this->elf_file_.shoff(),
 					       shnum * This::shdr_size,
 					       true, true);
+
+  this->will_need_sections(pshdrs, false);
+
   // Skip the first, dummy, section.
   const unsigned char* ps = pshdrs + This::shdr_size;
   for (unsigned int i = 1; i < shnum; ++i, ps += This::shdr_size)
@@ -468,7 +473,7 @@ Sized_relobj_file<size, big_endian>::do_scan_relocs(Symbol_table* symtab,
 	  if (parameters->options().emit_relocs())
 	    this->emit_relocs_scan(symtab, layout, local_symbols, p);
 	  if (layout->incremental_inputs() != NULL)
-	    this->incremental_relocs_scan(p);
+	    this->incremental_relocs_scan(symtab, p);
 	}
       else
 	{
@@ -532,19 +537,46 @@ Sized_relobj_file<size, big_endian>::emit_relocs_scan(
     rr);
 }
 
+// Return true if GSYM is defined in an input section that has no
+// output section and was not folded by --icf, i.e., one removed by
+// --gc-sections.  Such a symbol gets no entry in the output symbol
+// table, so we do not record incremental relocations against it.
+// They can only come from sections that are not subject to garbage
+// collection, such as debug sections.
+
+static bool
+is_defined_in_discarded_section(const Symbol_table* symtab,
+				const Symbol* gsym)
+{
+  if (gsym->is_forwarder())
+    gsym = symtab->resolve_forwards(gsym);
+  if (gsym->source() != Symbol::FROM_OBJECT
+      || !gsym->is_defined()
+      || gsym->object()->is_dynamic())
+    return false;
+  bool is_ordinary;
+  unsigned int shndx = gsym->shndx(&is_ordinary);
+  if (!is_ordinary)
+    return false;
+  Relobj* relobj = static_cast<Relobj*>(gsym->object());
+  return (relobj->output_section(shndx) == NULL
+	  && !symtab->is_section_folded(relobj, shndx));
+}
+
 // Scan the input relocations for --incremental.
 
 template<int size, bool big_endian>
 void
 Sized_relobj_file<size, big_endian>::incremental_relocs_scan(
+    const Symbol_table* symtab,
     const Read_relocs_data::Relocs_list::iterator& p)
 {
   if (p->sh_type == elfcpp::SHT_REL)
-    this->incremental_relocs_scan_reltype<elfcpp::SHT_REL>(p);
+    this->incremental_relocs_scan_reltype<elfcpp::SHT_REL>(symtab, p);
   else
     {
       gold_assert(p->sh_type == elfcpp::SHT_RELA);
-      this->incremental_relocs_scan_reltype<elfcpp::SHT_RELA>(p);
+      this->incremental_relocs_scan_reltype<elfcpp::SHT_RELA>(symtab, p);
     }
 }
 
@@ -555,8 +587,10 @@ template<int size, bool big_endian>
 template<int sh_type>
 void
 Sized_relobj_file<size, big_endian>::incremental_relocs_scan_reltype(
+    const Symbol_table* symtab,
     const Read_relocs_data::Relocs_list::iterator& p)
 {
+  const bool check_discarded = parameters->options().gc_sections();
   typedef typename Reloc_types<sh_type, size, big_endian>::Reloc Reltype;
   const int reloc_size = Reloc_types<sh_type, size, big_endian>::reloc_size;
   const unsigned char* prelocs = p->contents->data();
@@ -575,8 +609,15 @@ Sized_relobj_file<size, big_endian>::incremental_relocs_scan_reltype(
       typename elfcpp::Elf_types<size>::Elf_WXword r_info = reloc.get_r_info();
       const unsigned int r_sym = elfcpp::elf_r_sym<size>(r_info);
 
-      if (r_sym >= this->local_symbol_count_)
-	this->count_incremental_reloc(r_sym - this->local_symbol_count_);
+      if (r_sym < this->local_symbol_count_)
+	continue;
+
+      if (check_discarded
+	  && is_defined_in_discarded_section(symtab,
+					     this->global_symbol(r_sym)))
+	continue;
+
+      this->count_incremental_reloc(r_sym - this->local_symbol_count_);
     }
 }
 
@@ -598,6 +639,8 @@ Sized_relobj_file<size, big_endian>::do_relocate(const Symbol_table* symtab,
   Views views;
   views.resize(shnum);
 
+  this->will_need_sections(pshdrs, true);
+
   // Make two passes over the sections.  The first one copies the
   // section data to the output file.  The second one applies
   // relocations.
@@ -658,6 +701,22 @@ Sized_relobj_file<size, big_endian>::do_relocate(const Symbol_table* symtab,
   this->write_local_symbols(of, layout->sympool(), layout->dynpool(),
 			    layout->symtab_xindex(), layout->dynsym_xindex(),
 			    layout->symtab_section_offset());
+
+  // Only the relocations of this object refer to its merged sections
+  // which are not allocated, such as .debug_str, and there are no
+  // dynamic relocations for them.  With --reduce-memory-overheads,
+  // free their offset maps now rather than at the end of the link.
+  if (parameters->options().reduce_memory_overheads())
+    {
+      const unsigned char* p = pshdrs + This::shdr_size;
+      for (unsigned int i = 1; i < shnum; ++i, p += This::shdr_size)
+	{
+	  typename This::Shdr shdr(p);
+	  if ((shdr.get_sh_flags() & elfcpp::SHF_MERGE) != 0
+	      && (shdr.get_sh_flags() & elfcpp::SHF_ALLOC) == 0)
+	    this->release_merge_map(i);
+	}
+    }
 }
 
 // Sort a Read_multiple vector by file offset.
@@ -669,6 +728,85 @@ struct Read_multiple_compare
   { return rme1.file_offset < rme2.file_offset; }
 };
 
+// Tell the system that we are about to read the relocation sections
+// which we use and, if WITH_CONTENTS, the contents of the sections
+// which we copy to the output file, so that it can start reading them
+// all in the background.  Otherwise each page of a cold file is read
+// when we first touch it.  PSHDRS points to the section headers.
+
+template<int size, bool big_endian>
+void
+Sized_relobj_file<size, big_endian>::will_need_sections(
+    const unsigned char* pshdrs,
+    bool with_contents)
+{
+  if (!parameters->options().file_access_hints())
+    return;
+
+  // When scanning we only use the relocations for allocated sections;
+  // see do_read_relocs.
+  bool want_unallocated_relocs = (with_contents
+				  || parameters->options().relocatable()
+				  || parameters->options().emit_relocs()
+				  || parameters->incremental());
+
+  const Output_sections& out_sections(this->output_sections());
+  const unsigned int shnum = this->shnum();
+
+  std::vector<std::pair<off_t, off_t> > ranges;
+  const unsigned char* ps = pshdrs + This::shdr_size;
+  for (unsigned int i = 1; i < shnum; ++i, ps += This::shdr_size)
+    {
+      typename This::Shdr shdr(ps);
+
+      unsigned int sh_type = shdr.get_sh_type();
+      if (sh_type == elfcpp::SHT_NOBITS || shdr.get_sh_size() == 0)
+	continue;
+
+      bool want;
+      if (sh_type == elfcpp::SHT_REL || sh_type == elfcpp::SHT_RELA)
+	{
+	  unsigned int shndx = this->adjust_shndx(shdr.get_sh_info());
+	  want = shndx < shnum && out_sections[shndx] != NULL;
+	  if (want && !want_unallocated_relocs)
+	    {
+	      typename This::Shdr secshdr(pshdrs + shndx * This::shdr_size);
+	      want = (secshdr.get_sh_flags() & elfcpp::SHF_ALLOC) != 0;
+	    }
+	}
+      else
+	want = with_contents && out_sections[i] != NULL;
+      if (want)
+	{
+	  off_t start = shdr.get_sh_offset();
+	  ranges.push_back(std::make_pair(start, start + shdr.get_sh_size()));
+	}
+    }
+
+  if (ranges.empty())
+    return;
+
+  // The assembler normally puts the relocation sections after all the
+  // other sections, so sort the ranges, and combine the ones which
+  // are close together to make fewer system calls.
+  std::sort(ranges.begin(), ranges.end());
+  off_t range_start = ranges[0].first;
+  off_t range_end = ranges[0].second;
+  for (size_t i = 1; i < ranges.size(); ++i)
+    {
+      if (ranges[i].first > range_end + 65536)
+	{
+	  this->will_need(range_start,
+			  convert_to_section_size_type(range_end - range_start));
+	  range_start = ranges[i].first;
+	}
+      if (ranges[i].second > range_end)
+	range_end = ranges[i].second;
+    }
+  this->will_need(range_start,
+		  convert_to_section_size_type(range_end - range_start));
+}
+
 // Write section data to the output file.  PSHDRS points to the
 // section headers.  Record the views in *PVIEWS for use when
 // relocating.
@@ -1104,6 +1242,8 @@ Sized_relobj_file<size, big_endian>::incremental_relocs_write_reltype(
   const off_t relocs_size = inputs->relocs_section()->data_size();
   unsigned char* const view = of->get_output_view(relocs_off, relocs_size);
 
+  const bool check_discarded = parameters->options().gc_sections();
+
   for (size_t i = 0; i < reloc_count; ++i, prelocs += reloc_size)
     {
       Reloc reloc(prelocs);
@@ -1116,6 +1256,11 @@ Sized_relobj_file<size, big_endian>::incremental_relocs_write_reltype(
       if (r_sym < this->local_symbol_count_)
         continue;
 
+      if (check_discarded
+	  && is_defined_in_discarded_section(relinfo->symtab,
+					     this->global_symbol(r_sym)))
+	continue;
+
       // Get the new offset--the location in the output section where
       // this relocation should be applied.
 
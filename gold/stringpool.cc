@@ -503,22 +503,39 @@ Stringpool_template<Stringpool_char>::write(Output_file* of, off_t offset)
   of->write_output_view(offset, this->strtab_size_, view);
 }
 
+// Return statistical information about the pool.
+
+template<typename Stringpool_char>
+typename Stringpool_template<Stringpool_char>::Stats
+Stringpool_template<Stringpool_char>::get_stats() const
+{
+  Stats stats;
+  stats.entries = this->string_set_.size();
+#if defined(HAVE_UNORDERED_MAP) || defined(HAVE_TR1_UNORDERED_MAP) || defined(HAVE_EXT_HASH_MAP)
+  stats.buckets = this->string_set_.bucket_count();
+#else
+  stats.buckets = 0;
+#endif
+  stats.stringdata = this->strings_.size();
+  return stats;
+}
+
 // Print statistical information to stderr.  This is used for --stats.
 
 template<typename Stringpool_char>
 void
-Stringpool_template<Stringpool_char>::print_stats(const char* name) const
+Stringpool_template<Stringpool_char>::print_stats(const char* name,
+						  const Stats& stats)
 {
 #if defined(HAVE_UNORDERED_MAP) || defined(HAVE_TR1_UNORDERED_MAP) || defined(HAVE_EXT_HASH_MAP)
   fprintf(stderr, _("%s: %s entries: %zu; buckets: %zu\n"),
-	  program_name, name, this->string_set_.size(),
-	  this->string_set_.bucket_count());
+	  program_name, name, stats.entries, stats.buckets);
 #else
   fprintf(stderr, _("%s: %s entries: %zu\n"),
-	  program_name, name, this->table_.size());
+	  program_name, name, stats.entries);
 #endif
   fprintf(stderr, _("%s: %s Stringdata structures: %zu\n"),
-	  program_name, name, this->strings_.size());
+	  program_name, name, stats.stringdata);
 }
 
 // Instantiate the templates we need.
@@ -285,9 +285,30 @@ class Stringpool_template
   void
   write_to_buffer(unsigned char* buffer, section_size_type buffer_size);
 
+  // Statistical information about the pool.
+  struct Stats
+  {
+    // The number of strings.
+    size_t entries;
+    // The number of hash table buckets.
+    size_t buckets;
+    // The number of Stringdata structures.
+    size_t stringdata;
+  };
+
+  // Return statistical information about the pool.
+  Stats
+  get_stats() const;
+
   // Dump statistical information to stderr.
   void
-  print_stats(const char*) const;
+  print_stats(const char* name) const
+  { print_stats(name, this->get_stats()); }
+
+  // Dump statistical information gathered earlier by get_stats to
+  // stderr, for a pool which may since have been cleared.
+  static void
+  print_stats(const char* name, const Stats&);
 
  private:
   Stringpool_template(const Stringpool_template&);
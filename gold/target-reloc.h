@@ -470,6 +470,159 @@ relocate_section(
     }
 }
 
+// Return the local symbol of RELOC for relocate_section_batched
+// below, if RELOC can be applied there: the symbol must be a local
+// symbol in a section which is kept, and the field of WIDTH bytes at
+// the relocation offset must be within the view.  Otherwise return
+// NULL, and leave the relocation to the general code.
+
+template<int size, bool big_endian, typename Classify_reloc>
+inline const Symbol_value<size>*
+batched_reloc_symval(const Sized_relobj_file<size, big_endian>* object,
+		     const typename Classify_reloc::Reltype* reloc,
+		     int width, section_size_type view_size)
+{
+  unsigned int r_sym = Classify_reloc::get_r_sym(reloc);
+  if (r_sym >= object->local_symbol_count())
+    return NULL;
+
+  const Symbol_value<size>* psymval = object->local_symbol(r_sym);
+  bool is_ordinary;
+  unsigned int shndx = psymval->input_shndx(&is_ordinary);
+  if (!is_ordinary
+      || shndx == elfcpp::SHN_UNDEF
+      || !object->is_section_included(shndx)
+      || psymval->is_tls_symbol()
+      || psymval->is_ifunc_symbol())
+    return NULL;
+
+  section_offset_type offset =
+    convert_to_section_size_type(reloc->get_r_offset());
+  if (offset < 0
+      || static_cast<section_size_type>(offset) + width > view_size)
+    return NULL;
+
+  return psymval;
+}
+
+// Like relocate_section, but apply runs of absolute relocations
+// against local symbols in sections which are not allocated in a
+// tight loop, without going through the target's Relocate class for
+// each one.  Most of the relocations in debugging sections are of
+// that kind.  This is only done for SHT_RELA relocations.
+
+// RELOCATE_ABS is a class with a static function
+//   int width(unsigned int r_type, Overflow_check* check)
+// which returns the size in bytes of the field set by a relocation of
+// type R_TYPE if it is a plain S + A relocation of 4 or 8 bytes, and
+// sets *CHECK to the overflow check for a 4 byte field; otherwise it
+// returns 0.  All other relocations go to relocate_section, a run at
+// a time and in order.
+
+template<int size, bool big_endian, typename Target_type,
+	 typename Relocate,
+	 typename Relocate_comdat_behavior,
+	 typename Classify_reloc,
+	 typename Relocate_abs>
+inline void
+relocate_section_batched(
+    const Relocate_info<size, big_endian>* relinfo,
+    Target_type* target,
+    const unsigned char* prelocs,
+    size_t reloc_count,
+    Output_section* output_section,
+    bool needs_special_offset_handling,
+    unsigned char* view,
+    typename elfcpp::Elf_types<size>::Elf_Addr view_address,
+    section_size_type view_size,
+    const Reloc_symbol_changes* reloc_symbol_changes)
+{
+  typedef typename Classify_reloc::Reltype Reltype;
+  typedef Relocate_functions<size, big_endian> Reloc_funcs;
+  const int reloc_size = Classify_reloc::reloc_size;
+
+  if (Classify_reloc::sh_type != elfcpp::SHT_RELA
+      || (output_section->flags() & elfcpp::SHF_ALLOC) != 0
+      || needs_special_offset_handling
+      || reloc_symbol_changes != NULL
+      || !parameters->options().batch_relocs())
+    {
+      relocate_section<size, big_endian, Target_type, Relocate,
+		       Relocate_comdat_behavior, Classify_reloc>(
+	relinfo, target, prelocs, reloc_count, output_section,
+	needs_special_offset_handling, view, view_address, view_size,
+	reloc_symbol_changes);
+      return;
+    }
+
+  const Sized_relobj_file<size, big_endian>* object = relinfo->object;
+
+  // The relocations from START up to I are left to relocate_section.
+  size_t start = 0;
+  size_t i = 0;
+  while (i < reloc_count)
+    {
+      Reltype reloc(prelocs + i * reloc_size);
+      unsigned int r_type = Classify_reloc::get_r_type(&reloc);
+      typename Reloc_funcs::Overflow_check check = Reloc_funcs::CHECK_NONE;
+      int width = Relocate_abs::width(r_type, &check);
+      const Symbol_value<size>* psymval =
+	(width == 0
+	 ? NULL
+	 : batched_reloc_symval<size, big_endian, Classify_reloc>(
+	     object, &reloc, width, view_size));
+      if (psymval == NULL)
+	{
+	  ++i;
+	  continue;
+	}
+
+      // Keep the relocations in order.
+      if (start < i)
+	relocate_section<size, big_endian, Target_type, Relocate,
+			 Relocate_comdat_behavior, Classify_reloc>(
+	  relinfo, target, prelocs + start * reloc_size, i - start,
+	  output_section, false, view, view_address, view_size, NULL);
+
+      // Apply the run of relocations of type R_TYPE.
+      while (true)
+	{
+	  unsigned char* v =
+	    view + convert_to_section_size_type(reloc.get_r_offset());
+	  typename elfcpp::Elf_types<size>::Elf_Swxword addend =
+	    Classify_reloc::get_r_addend(&reloc);
+	  if (width == 8)
+	    Reloc_funcs::rela64(v, object, psymval, addend);
+	  else if (Reloc_funcs::rela32_check(v, object, psymval, addend, check)
+		   != Reloc_funcs::RELOC_OK)
+	    {
+	      // Let the general code report the overflow.
+	      start = i;
+	      ++i;
+	      break;
+	    }
+
+	  ++i;
+	  start = i;
+	  if (i >= reloc_count)
+	    break;
+	  reloc = Reltype(prelocs + i * reloc_size);
+	  if (Classify_reloc::get_r_type(&reloc) != r_type)
+	    break;
+	  psymval = batched_reloc_symval<size, big_endian, Classify_reloc>(
+	    object, &reloc, width, view_size);
+	  if (psymval == NULL)
+	    break;
+	}
+    }
+
+  if (start < reloc_count)
+    relocate_section<size, big_endian, Target_type, Relocate,
+		     Relocate_comdat_behavior, Classify_reloc>(
+      relinfo, target, prelocs + start * reloc_size, reloc_count - start,
+      output_section, false, view, view_address, view_size, NULL);
+}
+
 // Apply an incremental relocation.
 
 template<int size, bool big_endian, typename Target_type,
@@ -0,0 +1,117 @@
+#!/bin/sh
+
+# archive_symbol_cache_test.sh -- test --archive-symbol-cache.
+
+# Copyright (C) 2023 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# archive_symbol_cache_test_2 was linked with an empty cache
+# directory, so it wrote the cache, and archive_symbol_cache_test_3
+# was linked using the cache.  Both must be the same as the program
+# linked without a cache.  archive_symbol_cache_test_4 was linked after
+# its archive changed, so the cache written for the old archive must
+# have been rejected.  archive_symbol_cache_test_5 was linked after its
+# archive was touched, so the cache must have been used and written
+# again.
+
+# The links also use the cache for the system archives, so the number
+# of caches depends on the compiler.  Print the count of caches read or
+# written, as given by --stats.
+
+cache_stat()
+{
+    sed -n -e "s/.*archive symbol caches $2: \\([0-9]*\\)$/\\1/p" "$1"
+}
+
+if ! ls archive_symbol_cache_dir/*.cache > /dev/null 2>&1
+then
+    echo "archive symbol cache was not written"
+    exit 1
+fi
+
+for n in 2 3
+do
+    if ! cmp -s archive_symbol_cache_test_1 archive_symbol_cache_test_$n
+    then
+	echo "archive_symbol_cache_test_1 and archive_symbol_cache_test_$n differ"
+	exit 1
+    fi
+done
+
+if test "`cache_stat archive_symbol_cache_test_2.err written`" -eq 0
+then
+    echo "archive_symbol_cache_test_2 wrote no archive symbol cache"
+    exit 1
+fi
+if test "`cache_stat archive_symbol_cache_test_3.err written`" -ne 0 \
+   || test "`cache_stat archive_symbol_cache_test_3.err read`" -eq 0
+then
+    echo "archive_symbol_cache_test_3 did not use the archive symbol cache"
+    grep "archive symbol caches" archive_symbol_cache_test_3.err
+    exit 1
+fi
+
+# The link which read the cache must not have rewritten it.
+if test -n "`find archive_symbol_cache_dir -name '*.cache' -newer archive_symbol_cache_test_2`"
+then
+    echo "archive symbol cache was rewritten by archive_symbol_cache_test_3"
+    exit 1
+fi
+
+# Only the cache for the changed archive must have been written again.
+if test "`cache_stat archive_symbol_cache_test_4.err written`" -ne 1
+then
+    echo "archive_symbol_cache_test_4 used a stale archive symbol cache"
+    grep "archive symbol caches" archive_symbol_cache_test_4.err
+    exit 1
+fi
+
+if ! ./archive_symbol_cache_test_4
+then
+    echo "archive_symbol_cache_test_4 failed"
+    exit 1
+fi
+
+# Naming the archive twice writes its cache twice, and the writers must
+# not get in each other's way.
+if grep "archive symbol cache" archive_symbol_cache_test_5.warn
+then
+    echo "archive_symbol_cache_test_5 could not write the cache"
+    exit 1
+fi
+
+if test "`cache_stat archive_symbol_cache_test_5.err written`" -ne 0
+then
+    echo "archive_symbol_cache_test_5 did not use the cache after touching the archive"
+    grep "archive symbol caches" archive_symbol_cache_test_5.err
+    exit 1
+fi
+if test -z "`find archive_symbol_cache_dir_5 -name '*.cache' -newer archive_symbol_cache_test_5.stamp`"
+then
+    echo "archive symbol cache was not written again for the touched archive"
+    exit 1
+fi
+
+if ! ./archive_symbol_cache_test_5
+then
+    echo "archive_symbol_cache_test_5 failed"
+    exit 1
+fi
+
+exit 0
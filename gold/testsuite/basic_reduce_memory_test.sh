@@ -0,0 +1,92 @@
+#!/bin/sh
+
+# basic_reduce_memory_test.sh -- test --reduce-memory-overheads.
+
+# Copyright (C) 2023 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# basic_reduce_memory_test_1 was linked with --stats, and
+# basic_reduce_memory_test_2 with --stats and
+# --reduce-memory-overheads.  The output must be the same.  The
+# objects have debug information, so with --reduce-memory-overheads
+# the merged .debug_str strings and offset maps have been freed by the
+# end of the final pass, and less memory must be in use then.
+
+if ! cmp -s basic_reduce_memory_test_1 basic_reduce_memory_test_2
+then
+    echo "basic_reduce_memory_test_1 and basic_reduce_memory_test_2 differ"
+    exit 1
+fi
+
+# Print the --stats value $3 of pass $2 in file $1.
+pass_stat()
+{
+    sed -n -e "s/.*: $2 tasks $3: \([0-9]*\) bytes$/\1/p" "$1"
+}
+
+for f in basic_reduce_memory_test_1.err basic_reduce_memory_test_2.err
+do
+    for pass in initial middle final
+    do
+	if ! grep -q "$pass tasks run time:" $f
+	then
+	    echo "$f: missing --stats output for the $pass tasks"
+	    exit 1
+	fi
+    done
+done
+
+# The peak resident memory comes from /proc, and the space in use from
+# mallinfo, so the statistics may be missing on some systems.
+if test -r /proc/self/status
+then
+    for pass in initial middle final
+    do
+	if test -z "`pass_stat basic_reduce_memory_test_1.err $pass 'peak resident memory'`"
+	then
+	    echo "missing peak resident memory for the $pass tasks"
+	    exit 1
+	fi
+    done
+fi
+
+# The merged string statistics are printed after the strings have been
+# freed, and must not change.
+grep 'merged .*strings' basic_reduce_memory_test_1.err \
+  > basic_reduce_memory_test_1.merge
+grep 'merged .*strings' basic_reduce_memory_test_2.err \
+  > basic_reduce_memory_test_2.merge
+if ! test -s basic_reduce_memory_test_1.merge \
+   || ! cmp -s basic_reduce_memory_test_1.merge basic_reduce_memory_test_2.merge
+then
+    echo "merged string statistics differ with --reduce-memory-overheads"
+    diff basic_reduce_memory_test_1.merge basic_reduce_memory_test_2.merge
+    exit 1
+fi
+
+m1=`pass_stat basic_reduce_memory_test_1.err final 'end space in use by malloc'`
+m2=`pass_stat basic_reduce_memory_test_2.err final 'end space in use by malloc'`
+if test -n "$m1" && test -n "$m2" && test "$m2" -ge "$m1"
+then
+    echo "--reduce-memory-overheads did not free any memory"
+    echo "in use at the end of the final tasks: $m2 bytes, $m1 without"
+    exit 1
+fi
+
+exit 0
@@ -0,0 +1,23 @@
+	.data
+low:
+	.byte 1
+	.byte 2
+	.byte 3
+
+	.text
+	.globl	bar
+	.type	bar, @function
+bar:
+	ret
+	.size	bar, .-bar
+
+# A run of absolute relocations against local symbols in an
+# unallocated section, with one in the middle whose addend makes it
+# overflow.
+	.section .debug_batch,"",@progbits
+	.quad	low
+	.long	low
+	.long	low+1
+	.long	low+0x100000000
+	.long	low+2
+	.quad	low+3
@@ -0,0 +1,75 @@
+#!/bin/sh
+
+# batch_relocs_test.sh -- test applying runs of relocations in
+# unallocated sections together.
+
+# Copyright (C) 2023 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# batch_relocs_test was linked from objects compiled with -g, and
+# batch_relocs_test_nobatch from the same objects with
+# --no-batch-relocs.  The debugging sections, dumped in the .stdout
+# files, and the rest of the output must be the same.
+
+# batch_relocs_test_overflow.err and
+# batch_relocs_test_overflow_nobatch.err come from links of
+# batch_relocs_test.s which must fail, since one R_X86_64_32 in the
+# middle of a run in an unallocated section overflows.  Both must
+# report that relocation, and only that one.
+
+check()
+{
+    if ! grep -q "$2" "$1"
+    then
+	echo "Did not find expected output in $1:"
+	echo "   $2"
+	echo ""
+	echo "Actual output below:"
+	cat "$1"
+	exit 1
+    fi
+}
+
+for s in .debug_info .debug_line .debug_str; do
+    check batch_relocs_test.stdout "Hex dump of section '$s'"
+done
+
+if ! cmp -s batch_relocs_test.stdout batch_relocs_test_nobatch.stdout; then
+    echo "debugging sections differ with --no-batch-relocs"
+    diff batch_relocs_test.stdout batch_relocs_test_nobatch.stdout | head
+    exit 1
+fi
+
+if ! cmp -s batch_relocs_test batch_relocs_test_nobatch; then
+    echo "batch_relocs_test and batch_relocs_test_nobatch differ"
+    exit 1
+fi
+
+for f in batch_relocs_test_overflow.err \
+	 batch_relocs_test_overflow_nobatch.err; do
+    check $f "(.debug_batch+0x10): error: relocation overflow"
+    n=`grep -c "relocation overflow" $f`
+    if test "$n" -ne 1; then
+	echo "expected one relocation overflow in $f, found $n:"
+	cat $f
+	exit 1
+    fi
+done
+
+exit 0
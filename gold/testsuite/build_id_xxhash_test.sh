@@ -0,0 +1,62 @@
+#!/bin/sh
+
+# build_id_xxhash_test.sh -- a test case for --build-id=xxhash.
+
+# Copyright (C) 2023 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# build_id_xxhash_test_1 and build_id_xxhash_test_2 are linked
+# identically with a small chunk size, so that the build ID is a hash
+# of the hashes of many chunks.  build_id_xxhash_test_3 is small enough
+# to be hashed as a single chunk.
+
+check()
+{
+    if ! grep -q "^$1: *Build ID: [0-9a-f]\{32\}$" build_id_xxhash_test.stdout
+    then
+	echo "Did not find 128-bit build ID for $1 in build_id_xxhash_test.stdout"
+	echo ""
+	echo "Actual output below:"
+	cat build_id_xxhash_test.stdout
+	exit 1
+    fi
+}
+
+id()
+{
+    grep "^$1:" build_id_xxhash_test.stdout | sed -e 's/.*Build ID: *//'
+}
+
+check build_id_xxhash_test_1
+check build_id_xxhash_test_2
+check build_id_xxhash_test_3
+
+if test "`id build_id_xxhash_test_1`" != "`id build_id_xxhash_test_2`"; then
+    echo "Build IDs of identical links differ"
+    cat build_id_xxhash_test.stdout
+    exit 1
+fi
+
+if test "`id build_id_xxhash_test_1`" = "`id build_id_xxhash_test_3`"; then
+    echo "Build IDs of chunked and flat hashes are the same"
+    cat build_id_xxhash_test.stdout
+    exit 1
+fi
+
+exit 0
@@ -0,0 +1,56 @@
+// call_graph_profile_test.cc -- a test case for gold
+
+// Copyright (C) 2023 Free Software Foundation, Inc.
+
+// This file is part of gold.
+
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+// MA 02110-1301, USA.
+
+// The goal of this program is to verify that --call-graph-profile
+// places functions which call each other often next to each other.
+// The functions are defined in an order which the profile changes.
+
+extern "C"
+{
+
+int cgp_f3(int x) { return x * 3; }
+
+int cgp_g1(int);
+
+int cgp_cold(int x) { return x * 7; }
+
+int cgp_f2(int x) { return cgp_f3(x) + 2; }
+
+int cgp_g2(int x) { return x * 5; }
+
+int cgp_g1(int x) { return cgp_g2(x) + 1; }
+
+int cgp_f1(int x) { return cgp_f2(x) + 1; }
+
+}
+
+int
+main(int argc, char**)
+{
+  int s = 0;
+  for (int i = 0; i < 1000; ++i)
+    s += cgp_f1(i);
+  for (int i = 0; i < 10; ++i)
+    s += cgp_g1(i);
+  if (argc > 10)
+    s += cgp_cold(argc);
+  return s == 0;
+}
@@ -0,0 +1,47 @@
+#!/bin/sh
+
+# call_graph_profile_test.sh -- test --call-graph-profile
+
+# Copyright (C) 2023 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+
+# The goal of this program is to verify that --call-graph-profile
+# orders functions as intended, with a profile given either as a list
+# of edges or as a gprof call graph.  File call_graph_profile_test.cc
+# is in this test.  main and the functions it calls should form a
+# single cluster, in call order, after the functions not in the
+# profile.
+
+expected="cgp_cold main cgp_f1 cgp_f2 cgp_f3 cgp_g1 cgp_g2"
+
+check()
+{
+    actual=`awk '$2 == "T" && ($3 == "main" || $3 ~ /^cgp_/) { print $3 }' $1`
+    actual=`echo $actual`
+    if test "$actual" != "$expected"; then
+	echo "Wrong function order in $1"
+	echo "Expected: $expected"
+	echo "Actual:   $actual"
+	exit 1
+    fi
+}
+
+check call_graph_profile_test_1.stdout
+check call_graph_profile_test_2.stdout
+
+exit 0
@@ -0,0 +1,90 @@
+#!/bin/sh
+
+# debug_names_test_comm.sh -- common code for --debug-names tests.
+
+# Copyright (C) 2023 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+check()
+{
+    if ! grep -q "$2" "$1"
+    then
+	echo "Did not find expected output:"
+	echo "   $2"
+	echo ""
+	echo "Actual error output below:"
+	cat "$1"
+	exit 1
+    fi
+}
+
+STDOUT="$1"
+
+check $STDOUT "^Contents of the .debug_names section:"
+check $STDOUT "^Version 5"
+check $STDOUT "^Augmentation string: 47 44 42 00"
+
+# Look for the symbols we know should be in the name table.
+
+check $STDOUT "^\[ *[0-9]*\] #[0-9a-f]* (anonymous namespace):"
+check $STDOUT "^\[ *[0-9]*\] #[0-9a-f]* (anonymous namespace)::c1_count:"
+check $STDOUT "^\[ *[0-9]*\] #[0-9a-f]* (anonymous namespace)::c2_count:"
+check $STDOUT "^\[ *[0-9]*\] #[0-9a-f]* bool:"
+check $STDOUT "^\[ *[0-9]*\] #[0-9a-f]* check<one::c1>:"
+check $STDOUT "^\[ *[0-9]*\] #[0-9a-f]* check<two::c2<double> >:"
+check $STDOUT "^\[ *[0-9]*\] #[0-9a-f]* check<two::c2<int> >:"
+check $STDOUT "^\[ *[0-9]*\] #[0-9a-f]* double:"
+check $STDOUT "^\[ *[0-9]*\] #[0-9a-f]* F_A:"
+check $STDOUT "^\[ *[0-9]*\] #[0-9a-f]* F_B:"
+check $STDOUT "^\[ *[0-9]*\] #[0-9a-f]* F_C:"
+check $STDOUT "^\[ *[0-9]*\] #[0-9a-f]* int:"
+check $STDOUT "^\[ *[0-9]*\] #[0-9a-f]* main:"
+check $STDOUT "^\[ *[0-9]*\] #[0-9a-f]* one:"
+check $STDOUT "^\[ *[0-9]*\] #[0-9a-f]* one::c1:"
+check $STDOUT "^\[ *[0-9]*\] #[0-9a-f]* one::c1::~c1:"
+check $STDOUT "^\[ *[0-9]*\] #[0-9a-f]* one::c1::c1:"
+check $STDOUT "^\[ *[0-9]*\] #[0-9a-f]* one::c1::val:"
+check $STDOUT "^\[ *[0-9]*\] #[0-9a-f]* one::c1v:"
+check $STDOUT "^\[ *[0-9]*\] #[0-9a-f]* one::G_A:"
+check $STDOUT "^\[ *[0-9]*\] #[0-9a-f]* one::G_B:"
+check $STDOUT "^\[ *[0-9]*\] #[0-9a-f]* two:"
+check $STDOUT "^\[ *[0-9]*\] #[0-9a-f]* two::c2<double>::~c2:"
+check $STDOUT "^\[ *[0-9]*\] #[0-9a-f]* two::c2<double>::c2:"
+check $STDOUT "^\[ *[0-9]*\] #[0-9a-f]* two::c2<double>::val:"
+check $STDOUT "^\[ *[0-9]*\] #[0-9a-f]* two::c2<double>:"
+check $STDOUT "^\[ *[0-9]*\] #[0-9a-f]* two::c2<int const\*>:"
+check $STDOUT "^\[ *[0-9]*\] #[0-9a-f]* two::c2<int const\*>::~c2:"
+check $STDOUT "^\[ *[0-9]*\] #[0-9a-f]* two::c2<int const\*>::c2:"
+check $STDOUT "^\[ *[0-9]*\] #[0-9a-f]* two::c2<int const\*>::val:"
+check $STDOUT "^\[ *[0-9]*\] #[0-9a-f]* two::c2<int>::~c2:"
+check $STDOUT "^\[ *[0-9]*\] #[0-9a-f]* two::c2<int>::c2:"
+check $STDOUT "^\[ *[0-9]*\] #[0-9a-f]* two::c2<int>::val:"
+check $STDOUT "^\[ *[0-9]*\] #[0-9a-f]* two::c2<int>:"
+check $STDOUT "^\[ *[0-9]*\] #[0-9a-f]* two::c2v1:"
+check $STDOUT "^\[ *[0-9]*\] #[0-9a-f]* two::c2v2:"
+check $STDOUT "^\[ *[0-9]*\] #[0-9a-f]* anonymous_union_var:"
+check $STDOUT "^\[ *[0-9]*\] #[0-9a-f]* inline_func_1:"
+
+# Check the tags of a few of them.
+
+check $STDOUT "^\[ *[0-9]*\] #[0-9a-f]* main: <[0-9]*> DW_TAG_subprogram"
+check $STDOUT "^\[ *[0-9]*\] #[0-9a-f]* one::c1: <[0-9]*> DW_TAG_structure_type"
+check $STDOUT "^\[ *[0-9]*\] #[0-9a-f]* two::c2v1: <[0-9]*> DW_TAG_variable"
+
+exit 0
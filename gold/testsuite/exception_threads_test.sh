@@ -0,0 +1,73 @@
+#!/bin/sh
+
+# exception_threads_test.sh -- check the .eh_frame_hdr section built
+# with several threads.
+
+# Copyright (C) 2023 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# exception_threads_test was linked from the same objects as
+# exception_test, but with three threads, so the two must be
+# identical.  exception_threads_test.hdr holds the contents of its
+# .eh_frame_hdr section, and exception_threads_test.stdout the output
+# of readelf -wf.
+
+if ! cmp -s exception_test exception_threads_test
+then
+    echo "exception_test and exception_threads_test differ"
+    exit 1
+fi
+
+# The header must say that the table holds pairs of 4-byte signed
+# offsets from the start of the section.
+enc=`od -An -v -tx1 -N4 exception_threads_test.hdr | tr -d ' \n'`
+if test "$enc" != "011b033b"
+then
+    echo "unexpected .eh_frame_hdr encodings $enc"
+    exit 1
+fi
+
+nfdes=`grep -c " FDE " exception_threads_test.stdout`
+
+# Check that the table has an entry for each FDE, and that it is
+# sorted by initial location.
+od -An -v -td4 -j8 exception_threads_test.hdr | awk -v nfdes=$nfdes '
+{
+  for (i = 1; i <= NF; i++)
+    words[n++] = $i;
+}
+END {
+  count = words[0];
+  if (count != nfdes) {
+    printf "%d .eh_frame_hdr entries, but %d FDEs\n", count, nfdes;
+    exit 1;
+  }
+  if (n != 1 + 2 * count) {
+    printf "%d .eh_frame_hdr entries, but room for %d\n", count, (n - 1) / 2;
+    exit 1;
+  }
+  for (i = 1; i < count; i++) {
+    if (words[1 + 2 * i] <= words[1 + 2 * (i - 1)]) {
+      printf ".eh_frame_hdr entry %d is out of order\n", i;
+      exit 1;
+    }
+  }
+}' || exit 1
+
+exit 0
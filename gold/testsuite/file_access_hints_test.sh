@@ -0,0 +1,71 @@
+#!/bin/sh
+
+# file_access_hints_test.sh -- test that input files are released.
+
+# Copyright (C) 2023 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# file_access_hints_test_1 was linked from four objects, and
+# file_access_hints_test_2 from the same objects but with the last one
+# in an archive.  The archive must not be released, so one file fewer
+# is released.  file_access_hints_test_3 was linked with
+# --no-file-access-hints, so no file is released, and the output must
+# be the same as with the hints.
+
+released()
+{
+    sed -n -e 's/.*files released after reading: \([0-9]*\)$/\1/p' "$1"
+}
+
+n1=`released file_access_hints_test_1.err`
+n2=`released file_access_hints_test_2.err`
+n3=`released file_access_hints_test_3.err`
+
+if test -z "$n1" || test -z "$n2" || test -z "$n3"
+then
+    echo "missing --stats output"
+    exit 1
+fi
+
+if test "$n1" -eq 0
+then
+    echo "file_access_hints_test_1 released no files"
+    exit 1
+fi
+
+if test `expr $n1 - $n2` -ne 1
+then
+    echo "file_access_hints_test_1 released $n1 files"
+    echo "file_access_hints_test_2 released $n2 files, expected `expr $n1 - 1`"
+    exit 1
+fi
+
+if test "$n3" -ne 0
+then
+    echo "file_access_hints_test_3 released $n3 files with --no-file-access-hints"
+    exit 1
+fi
+
+if ! cmp -s file_access_hints_test_1 file_access_hints_test_3
+then
+    echo "file_access_hints_test_1 and file_access_hints_test_3 differ"
+    exit 1
+fi
+
+exit 0
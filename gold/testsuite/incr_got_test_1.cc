@@ -0,0 +1,47 @@
+// incr_got_test_1.cc -- test incremental update of a GOT entry
+
+// Copyright (C) 2023 Free Software Foundation, Inc.
+
+// This file is part of gold.
+
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+// MA 02110-1301, USA.
+
+// The function added before got_fn moves it in the incremental update.
+// The GOT entry for got_fn, which has no dynamic relocation in a
+// non-PIE link, must then be given its new address.
+
+void* got_addr();
+
+int
+got_pad(int i)
+{
+  volatile int a[64];
+  for (int j = 0; j < 64; j++)
+    a[j] = i + j;
+  return a[i & 63];
+}
+
+int
+got_fn()
+{
+  return 2;
+}
+
+bool
+got_check()
+{
+  return reinterpret_cast<void*>(&got_fn) == got_addr();
+}
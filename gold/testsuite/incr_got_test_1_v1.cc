@@ -0,0 +1,37 @@
+// incr_got_test_1_v1.cc -- test incremental update of a GOT entry
+
+// Copyright (C) 2023 Free Software Foundation, Inc.
+
+// This file is part of gold.
+
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+// MA 02110-1301, USA.
+
+// This is the version of incr_got_test_1.cc in the first link.  The
+// update moves got_fn, whose GOT entry incr_got_test_2.cc uses.
+
+void* got_addr();
+
+int
+got_fn()
+{
+  return 1;
+}
+
+bool
+got_check()
+{
+  return reinterpret_cast<void*>(&got_fn) == got_addr();
+}
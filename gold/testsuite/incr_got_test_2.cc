@@ -0,0 +1,40 @@
+// incr_got_test_2.cc -- test incremental update of a GOT entry
+
+// Copyright (C) 2023 Free Software Foundation, Inc.
+
+// This file is part of gold.
+
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+// MA 02110-1301, USA.
+
+// Compiled as PIE, so that the address of got_fn is loaded from the GOT.
+
+#include <cassert>
+
+int got_fn();
+bool got_check();
+
+void*
+got_addr()
+{
+  return reinterpret_cast<void*>(&got_fn);
+}
+
+int
+main()
+{
+  assert(got_check());
+  return 0;
+}
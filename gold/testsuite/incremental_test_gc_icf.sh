@@ -0,0 +1,112 @@
+#!/bin/sh
+
+# incremental_test_gc_icf.sh -- test --gc-sections and --icf with an
+# incremental update.
+
+# Copyright (C) 2023 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# incremental_test_gc_icf was linked with --incremental-full, and then
+# updated with one changed object.  incremental_test_gc_icf_v1.nm is
+# the symbol table after the first link, incremental_test_gc_icf.nm
+# after the update, incremental_test_gc_icf.stdout is the output of
+# incremental-dump, and incremental_test_gc_icf.err is the output of
+# the update.
+
+check()
+{
+    if ! grep -q "$2" "$1"
+    then
+	echo "Did not find expected output in $1:"
+	echo "   $2"
+	echo ""
+	echo "Actual output below:"
+	cat "$1"
+	exit 1
+    fi
+}
+
+check_missing()
+{
+    if grep -q "$2" "$1"
+    then
+	echo "Found unexpected output in $1:"
+	echo "   $2"
+	echo ""
+	echo "Actual output below:"
+	cat "$1"
+	exit 1
+    fi
+}
+
+# Print the address of symbol $2 in the nm output $1.
+address()
+{
+    awk -v sym="$2" '$3 == sym { print $1 }' "$1"
+}
+
+# The update must not have fallen back to a full link.
+check_missing incremental_test_gc_icf.err "incremental-full"
+
+# gc_icf_unused was removed by --gc-sections, and gc_icf_folded_2 was
+# folded into gc_icf_folded_1 by --icf, both in the first link.
+for nm in incremental_test_gc_icf_v1.nm incremental_test_gc_icf.nm
+do
+    if test -n "`address $nm _Z13gc_icf_unusedi`"
+    then
+	echo "$nm: gc_icf_unused was not removed"
+	exit 1
+    fi
+    folded_1=`address $nm _Z15gc_icf_folded_1i`
+    folded_2=`address $nm _Z15gc_icf_folded_2i`
+    if test -z "$folded_1" || test "$folded_1" != "$folded_2"
+    then
+	echo "$nm: gc_icf_folded_1 and gc_icf_folded_2 were not folded"
+	exit 1
+    fi
+done
+
+# incremental_test_gc_icf_a.o did not change, so its symbols must not
+# have moved in the update.
+for sym in _Z15gc_icf_folded_1i _Z15gc_icf_folded_2i gc_icf_value
+do
+    if test "`address incremental_test_gc_icf_v1.nm $sym`" \
+	 != "`address incremental_test_gc_icf.nm $sym`"
+    then
+	echo "$sym moved in the incremental update"
+	exit 1
+    fi
+done
+
+# The incremental inputs must still record the removed symbol and the
+# folded section of the unchanged object.
+
+awk '
+    /^[A-Za-z][A-Za-z ]+:$/ { section = $0; }
+    /^[[]/ { subsection = $0; }
+    /^ / { print section, subsection, $0; }
+' < incremental_test_gc_icf.stdout > incremental_test_gc_icf.dump
+
+check incremental_test_gc_icf.dump "Input files: .* incremental_test_gc_icf_a.o .*Folded section count: 1"
+check incremental_test_gc_icf.dump "Input sections: .* incremental_test_gc_icf_a.o .*Folded section: "
+check incremental_test_gc_icf.dump "Global symbols per input file: .* incremental_test_gc_icf_a.o .* GC  *_Z13gc_icf_unusedi"
+
+rm -f incremental_test_gc_icf.dump
+
+exit 0
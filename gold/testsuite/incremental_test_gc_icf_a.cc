@@ -0,0 +1,46 @@
+// incremental_test_gc_icf_a.cc -- a test case for gold
+
+// Copyright (C) 2023 Free Software Foundation, Inc.
+
+// This file is part of gold.
+
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+// MA 02110-1301, USA.
+
+// This file is linked into incremental_test_gc_icf, and does not
+// change in the incremental update.  With --gc-sections,
+// gc_icf_unused must be removed, and with --icf=all, gc_icf_folded_2
+// must be folded into gc_icf_folded_1.  Both must still hold after
+// the update.
+
+int
+gc_icf_unused(int i)
+{
+  return i * 17 - 5;
+}
+
+int
+gc_icf_folded_1(int i)
+{
+  return i * 3 + 7;
+}
+
+int
+gc_icf_folded_2(int i)
+{
+  return i * 3 + 7;
+}
+
+int gc_icf_value = gc_icf_folded_1(1) + gc_icf_folded_2(2);
@@ -0,0 +1,36 @@
+#!/bin/sh
+
+# many_dynsyms_hash_test.sh -- check the dynamic hash tables of a
+# shared library with many symbols.
+
+# Copyright (C) 2023 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# many_dynsyms_hash.so has enough dynamic symbols for the symbol
+# hashes and the .gnu.hash bloom filter to be computed in pieces, and
+# was linked with four threads.  many_dynsyms_hash_1.so was linked
+# without threads.  The two must be the same.
+
+if ! cmp -s many_dynsyms_hash.so many_dynsyms_hash_1.so
+then
+    echo "many_dynsyms_hash.so and many_dynsyms_hash_1.so differ"
+    exit 1
+fi
+
+exit 0
@@ -0,0 +1,64 @@
+#!/bin/sh
+
+# many_fdes_test.sh -- check the .eh_frame_hdr table of a shared
+# library with many FDEs.
+
+# Copyright (C) 2023 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# many_fdes.so was linked with four threads, and has enough FDEs for
+# the .eh_frame_hdr table to be sorted in pieces which are then
+# merged.  many_fdes_1.so was linked without threads.
+# many_fdes.hdr holds the contents of the .eh_frame_hdr section of
+# many_fdes.so, and many_fdes.stdout the output of readelf -wf.
+
+if ! cmp -s many_fdes.so many_fdes_1.so
+then
+    echo "many_fdes.so and many_fdes_1.so differ"
+    exit 1
+fi
+
+nfdes=`grep -c " FDE " many_fdes.stdout`
+
+# Check that the table has an entry for each FDE, and that it is
+# sorted by initial location.
+od -An -v -td4 -j8 many_fdes.hdr | awk -v nfdes=$nfdes '
+{
+  for (i = 1; i <= NF; i++)
+    words[n++] = $i;
+}
+END {
+  count = words[0];
+  if (count != nfdes) {
+    printf "%d .eh_frame_hdr entries, but %d FDEs\n", count, nfdes;
+    exit 1;
+  }
+  if (n != 1 + 2 * count) {
+    printf "%d .eh_frame_hdr entries, but room for %d\n", count, (n - 1) / 2;
+    exit 1;
+  }
+  for (i = 1; i < count; i++) {
+    if (words[1 + 2 * i] <= words[1 + 2 * (i - 1)]) {
+      printf ".eh_frame_hdr entry %d is out of order\n", i;
+      exit 1;
+    }
+  }
+}' || exit 1
+
+exit 0
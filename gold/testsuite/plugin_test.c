@@ -27,6 +27,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <pthread.h>
 #include "plugin-api.h"
 
 struct claimed_file
@@ -52,6 +53,10 @@ struct sym_info
 static struct claimed_file* first_claimed_file = NULL;
 static struct claimed_file* last_claimed_file = NULL;
 
+/* With the "thread_safe" option we tell the linker that the claim file
+   hook may be called from several threads at once.  */
+static pthread_mutex_t claimed_file_lock = PTHREAD_MUTEX_INITIALIZER;
+
 static ld_plugin_register_claim_file register_claim_file_hook = NULL;
 static ld_plugin_register_all_symbols_read register_all_symbols_read_hook = NULL;
 static ld_plugin_register_cleanup register_cleanup_hook = NULL;
@@ -70,6 +75,7 @@ static ld_plugin_get_input_section_contents get_input_section_contents = NULL;
 static ld_plugin_update_section_order update_section_order = NULL;
 static ld_plugin_allow_section_ordering allow_section_ordering = NULL;
 static ld_plugin_get_wrap_symbols get_wrap_symbols = NULL;
+static ld_plugin_get_api_version get_api_version = NULL;
 
 #define MAXOPTS 10
 
@@ -163,6 +169,9 @@ onload(struct ld_plugin_tv *tv)
 	case LDPT_GET_WRAP_SYMBOLS:
 	  get_wrap_symbols = *entry->tv_u.tv_get_wrap_symbols;
 	  break;
+	case LDPT_GET_API_VERSION:
+	  get_api_version = *entry->tv_u.tv_get_api_version;
+	  break;
         default:
           break;
         }
@@ -198,6 +207,26 @@ onload(struct ld_plugin_tv *tv)
   for (i = 0; i < nopts; ++i)
     (*message)(LDPL_INFO, "option: %s", opts[i]);
 
+  for (i = 0; i < nopts; ++i)
+    {
+      if (strcmp(opts[i], "thread_safe") == 0)
+	{
+	  const char *linker_identifier;
+	  const char *linker_version;
+	  int version;
+
+	  if (get_api_version == NULL)
+	    {
+	      fprintf(stderr, "tv_get_api_version interface missing\n");
+	      return LDPS_ERR;
+	    }
+	  version = (*get_api_version)("plugin_test", "1.0", LAPI_V1, LAPI_V1,
+				       &linker_identifier, &linker_version);
+	  (*message)(LDPL_INFO, "negotiated API version: %d (%s)",
+		     version, linker_identifier);
+	}
+    }
+
   if ((*register_claim_file_hook)(claim_file_hook) != LDPS_OK)
     {
       (*message)(LDPL_ERROR, "error registering claim file hook");
@@ -423,11 +452,13 @@ claim_file_hook (const struct ld_plugin_input_file* file, int* claimed)
   claimed_file->nsyms = nsyms;
   claimed_file->syms = syms;
   claimed_file->next = NULL;
+  pthread_mutex_lock(&claimed_file_lock);
   if (last_claimed_file == NULL)
     first_claimed_file = claimed_file;
   else
     last_claimed_file->next = claimed_file;
   last_claimed_file = claimed_file;
+  pthread_mutex_unlock(&claimed_file_lock);
 
   (*message)(LDPL_INFO, "%s: claiming file, adding %d symbols",
              file->name, nsyms);
@@ -0,0 +1,58 @@
+#!/bin/sh
+
+# plugin_test_threads.sh -- test a plugin which claims files from
+# several threads.
+
+# Copyright (C) 2023 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# The plugin asked for API version 1, which says that its claim file
+# hook is thread safe, so gold may have claimed the input files in any
+# order.  The result must be the same as for plugin_test_1.
+
+check()
+{
+    if ! grep -q "$2" "$1"
+    then
+	echo "Did not find expected output in $1:"
+	echo "   $2"
+	echo ""
+	echo "Actual output below:"
+	cat "$1"
+	exit 1
+    fi
+}
+
+check plugin_test_threads.err "negotiated API version: 1 (GNU gold)"
+check plugin_test_threads.err "two_file_test_main.o: claim file hook called"
+check plugin_test_threads.err "two_file_test_1.o.syms: claim file hook called"
+check plugin_test_threads.err "two_file_test_1b.o.syms: claim file hook called"
+check plugin_test_threads.err "two_file_test_2.o.syms: claim file hook called"
+check plugin_test_threads.err "two_file_test_1.o.syms: claiming file"
+check plugin_test_threads.err "two_file_test_1b.o.syms: claiming file"
+check plugin_test_threads.err "two_file_test_2.o.syms: claiming file"
+check plugin_test_threads.err "two_file_test_1.o.syms: _Z4f13iv: PREVAILING_DEF_IRONLY"
+check plugin_test_threads.err "two_file_test_1.o.syms: _Z2t2v: PREVAILING_DEF_REG"
+check plugin_test_threads.err "two_file_test_2.o.syms: _Z4f13iv: PREEMPTED_IR"
+check plugin_test_threads.err "two_file_test_1.o: adding new input file"
+check plugin_test_threads.err "two_file_test_1b.o: adding new input file"
+check plugin_test_threads.err "two_file_test_2.o: adding new input file"
+check plugin_test_threads.err "cleanup hook called"
+
+exit 0
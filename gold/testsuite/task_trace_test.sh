@@ -0,0 +1,48 @@
+#!/bin/sh
+
+# task_trace_test.sh -- test --task-trace.
+
+# Copyright (C) 2023 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# This file goes with task_trace_test.json, which is the task trace
+# written when linking basic_test.o.  Check that it has the expected
+# structure and records the main tasks.
+
+check()
+{
+    if ! grep -q "$2" "$1"
+    then
+	echo "Did not find expected output in $1:"
+	echo "   $2"
+	echo ""
+	echo "Actual output below:"
+	cat "$1"
+	exit 1
+    fi
+}
+
+check task_trace_test.json '^{"traceEvents":\['
+check task_trace_test.json '"name":"thread_name","pid":1,"tid":0'
+check task_trace_test.json '"ph":"X","cat":"task","name":"Read_symbols basic_test.o"'
+check task_trace_test.json '"ph":"X","cat":"task","name":"Add_symbols basic_test.o"'
+check task_trace_test.json '"ph":"X","cat":"task","name":"Write_sections_task"'
+check task_trace_test.json '^\],"displayTimeUnit":"ms"}$'
+
+exit 0
@@ -0,0 +1,87 @@
+#!/bin/sh
+
+# two_file_shared_hash_test.sh -- check the dynamic hash tables built
+# with -O1.
+
+# Copyright (C) 2023 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# two_file_shared_hash.so was linked with -O1 and three threads, and
+# two_file_shared_hash_1.so with -O1 and no threads.  The hash tables
+# must not depend on the number of threads.
+
+if ! cmp -s two_file_shared_hash.so two_file_shared_hash_1.so
+then
+    echo "two_file_shared_hash.so and two_file_shared_hash_1.so differ"
+    exit 1
+fi
+
+# two_file_shared_hash.stdout is the output of readelf -I --dyn-syms.
+# Every symbol but the null symbol must be on a .hash chain, and every
+# defined symbol on a .gnu.hash chain.  Both tables are smaller than a
+# page, so with -O1 the number of buckets must be the largest prime no
+# larger than twice the number of symbols in the table.
+
+awk '
+function is_prime(n,  d) {
+  if (n < 2)
+    return 0;
+  for (d = 2; d * d <= n; d++)
+    if (n % d == 0)
+      return 0;
+  return 1;
+}
+function check(table, nsyms,  want) {
+  if (chained[table] != nsyms) {
+    printf "%s: %d symbols on hash chains, expected %d\n", table, chained[table], nsyms;
+    status = 1;
+  }
+  want = 2 * nsyms;
+  while (want > 2 && !is_prime(want))
+    want--;
+  if (buckets[table] != want) {
+    printf "%s: %d buckets, expected %d\n", table, buckets[table], want;
+    status = 1;
+  }
+}
+/^Symbol table .\.dynsym. contains/ { entries = $5; next }
+/^ *[0-9]+: / { if ($1 != "0:" && $7 != "UND") defined++; next }
+/^Histogram for bucket list length/ { table = ".hash" }
+/^Histogram for .\.gnu\.hash. bucket list length/ { table = ".gnu.hash" }
+/^Histogram for/ {
+  sub(/.*total of /, "");
+  buckets[table] = $1 + 0;
+  next;
+}
+/^ *[0-9]+ +[0-9]+ +\(/ { chained[table] += $1 * $2; next }
+END {
+  status = 0;
+  if (entries == 0 || !(".hash" in buckets) || !(".gnu.hash" in buckets)) {
+    print "missing dynamic symbol table or hash table histograms";
+    exit 1;
+  }
+  check(".hash", entries - 1);
+  check(".gnu.hash", defined);
+  exit status;
+}' two_file_shared_hash.stdout || {
+    echo "bad hash tables in two_file_shared_hash.so"
+    exit 1
+}
+
+exit 0
@@ -0,0 +1,46 @@
+#!/bin/sh
+
+# workqueue_threads_test.sh -- test the run queues of the Workqueue.
+
+# Copyright (C) 2023 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# workqueue_threads_test_1 was linked on one thread and
+# workqueue_threads_test_2 on four, both with --stats.  The outputs
+# must be the same.  Which thread runs a task, and how many tasks are
+# run, depends on scheduling, so we only check that the statistics
+# for the run queues were printed.
+
+if ! cmp -s workqueue_threads_test_1 workqueue_threads_test_2
+then
+    echo "workqueue_threads_test_1 and workqueue_threads_test_2 differ"
+    exit 1
+fi
+
+for f in workqueue_threads_test_1.err workqueue_threads_test_2.err
+do
+    if ! grep -q 'run queue 0: tasks run [0-9]*, tasks stolen [0-9]*,' $f
+    then
+	echo "no run queue statistics in $f"
+	cat $f
+	exit 1
+    fi
+done
+
+exit 0
@@ -22,12 +22,19 @@
 
 #include "gold.h"
 
+#include <cstdio>
+#include <cstring>
 #include <unistd.h>
+#include <sys/time.h>
 
 #ifdef HAVE_TIMES
 #include <sys/times.h>
 #endif
 
+#if defined(HAVE_MALLINFO) || defined(HAVE_MALLINFO2)
+#include <malloc.h>
+#endif
+
 #include "libiberty.h"
 
 #include "timer.h"
@@ -42,9 +49,16 @@ Timer::Timer()
   this->start_time_.wall = 0;
   this->start_time_.user = 0;
   this->start_time_.sys = 0;
+  for (int i = 0; i < 3; ++i)
+    {
+      this->pass_memory_[i].malloc = -1;
+      this->pass_memory_[i].peak_rss = -1;
+    }
 }
 
-// Start counting the time.
+// Start counting the time.  This does not reset the peak resident
+// set size, since tasks are timed with their own Timers; the peak is
+// only reset when a pass ends, in stamp.
 void
 Timer::start()
 {
@@ -58,6 +72,8 @@ Timer::stamp(int n)
   gold_assert(n >= 0 && n <= 2);
   TimeStats& thispass = this->pass_times_[n];
   this->get_time(&thispass);
+  this->get_memory(&this->pass_memory_[n]);
+  this->reset_peak_rss();
 }
 
 #if HAVE_SYSCONF && defined _SC_CLK_TCK
@@ -104,6 +120,64 @@ Timer::get_time(TimeStats *now)
 #endif
 }
 
+// Write the current memory information.  The peak resident set size
+// comes from /proc, so it is only available on systems which have it.
+
+void
+Timer::get_memory(MemoryStats* now)
+{
+#if defined(HAVE_MALLINFO2)
+  struct mallinfo2 m = mallinfo2();
+  now->malloc = static_cast<long long>(m.uordblks + m.hblkhd);
+#elif defined(HAVE_MALLINFO)
+  struct mallinfo m = mallinfo();
+  now->malloc = static_cast<long long>(m.uordblks) + m.hblkhd;
+#else
+  now->malloc = -1;
+#endif
+
+  now->peak_rss = -1;
+  FILE* f = fopen("/proc/self/status", "r");
+  if (f == NULL)
+    return;
+  char line[128];
+  while (fgets(line, sizeof line, f) != NULL)
+    {
+      long long kbytes;
+      if (strncmp(line, "VmHWM:", 6) == 0
+	  && sscanf(line + 6, "%lld", &kbytes) == 1)
+	{
+	  now->peak_rss = kbytes * 1024;
+	  break;
+	}
+    }
+  fclose(f);
+}
+
+// Reset the peak resident set size, so that the next call to
+// get_memory reports the peak since now.  If this does not work, the
+// peak is the peak since the start of the process.
+
+void
+Timer::reset_peak_rss()
+{
+  FILE* f = fopen("/proc/self/clear_refs", "w");
+  if (f == NULL)
+    return;
+  fputs("5", f);
+  fclose(f);
+}
+
+// Return the current wall clock time in microseconds.
+
+uint64_t
+Timer::get_wall_time_usec()
+{
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return static_cast<uint64_t>(tv.tv_sec) * 1000000 + tv.tv_usec;
+}
+
 // Return the stats since start was called.
 Timer::TimeStats
 Timer::get_elapsed_time()
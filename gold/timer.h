@@ -42,6 +42,17 @@ class Timer
     long wall;
   };
 
+  // Used to report memory statistics.  All fields are in bytes, and
+  // are -1 if the value is not available.
+  struct MemoryStats
+  {
+    /* Space in use by malloc at the end of the pass.  */
+    long long malloc;
+
+    /* Peak resident set size during the pass.  */
+    long long peak_rss;
+  };
+
   Timer();
 
   // Return the stats since start was called.
@@ -52,6 +63,11 @@ class Timer
   TimeStats
   get_pass_time(int n);
 
+  // Return the memory stats for pass N (0 <= N <= 2).
+  MemoryStats
+  get_pass_memory(int n) const
+  { return this->pass_memory_[n]; }
+
   // Start counting the time.
   void
   start();
@@ -60,6 +76,12 @@ class Timer
   void
   stamp(int n);
 
+  // Return the current wall clock time in microseconds.  This is
+  // finer grained than the times in TimeStats, and is used to time
+  // individual tasks.
+  static uint64_t
+  get_wall_time_usec();
+
  private:
   // This class cannot be copied.
   Timer(const Timer&);
@@ -69,11 +91,23 @@ class Timer
   static void
   get_time(TimeStats* now);
 
+  // Write the current memory information.
+  static void
+  get_memory(MemoryStats* now);
+
+  // Start a new period for the peak resident set size, if the system
+  // lets us.
+  static void
+  reset_peak_rss();
+
   // The time of the last call to start.
   TimeStats start_time_;
 
   // Times for each pass.
   TimeStats pass_times_[3];
+
+  // Memory use of each pass.
+  MemoryStats pass_memory_[3];
 };
 
 }
@@ -26,6 +26,10 @@
 #include <queue>
 #include <csignal>
 
+#ifdef ENABLE_THREADS
+#include <pthread.h>
+#endif
+
 #include "gold-threads.h"
 #include "workqueue.h"
 
@@ -37,6 +41,95 @@ namespace gold
 
 class Workqueue_thread;
 
+// A run queue for the tasks which are ready to run.  Each thread
+// which runs Workqueue::process has one of these (when there are more
+// threads than queues, threads share them).  A thread takes tasks
+// from its own queue first, and steals from the queues of other
+// threads when its own is empty.  Each queue has its own lock, so
+// adding, removing and stealing tasks does not require the main
+// Workqueue lock.  The steal count is changed while holding the queue
+// lock; the other statistics are only changed while holding the main
+// Workqueue lock.
+
+class Workqueue_deque
+{
+ public:
+  Workqueue_deque()
+    : lock_(), first_tasks_(), tasks_(), count_(0), tasks_run_(0),
+      steals_(0), busy_usec_(0), idle_usec_(0)
+  { }
+
+  ~Workqueue_deque()
+  { gold_assert(this->count_ == 0); }
+
+  // Return whether the queue appears to be empty.  This does not
+  // take the lock, so the result is only a hint.
+  bool
+  maybe_empty() const
+  { return this->count_ == 0; }
+
+  // Add T to the queue.  If SOON is true T goes on the list of tasks
+  // to run soon.  If FRONT is true T is added to the front of that
+  // list.
+  void
+  push(Task* t, bool soon, bool front);
+
+  // Remove and return the first task on the list selected by SOON.
+  // Return NULL if that list is empty.
+  Task*
+  pop(bool soon);
+
+  // Record that a task taken from this queue's thread ran for USEC
+  // microseconds.
+  void
+  add_busy_time(uint64_t usec)
+  {
+    ++this->tasks_run_;
+    this->busy_usec_ += usec;
+  }
+
+  // Record that this queue's thread waited for USEC microseconds.
+  void
+  add_idle_time(uint64_t usec)
+  { this->idle_usec_ += usec; }
+
+  // Record that this queue's thread stole a task from another queue.
+  void
+  add_steal();
+
+  // Return whether any thread using this queue ran or waited for a
+  // task.
+  bool
+  is_used() const
+  { return this->tasks_run_ > 0 || this->idle_usec_ > 0; }
+
+  // Print statistics for queue number INDEX.
+  void
+  print_stats(int index) const;
+
+ private:
+  // This class can not be copied.
+  Workqueue_deque(const Workqueue_deque&);
+  Workqueue_deque& operator=(const Workqueue_deque&);
+
+  // Lock controlling access to first_tasks_, tasks_ and count_.
+  Lock lock_;
+  // Tasks to execute soon.
+  Task_list first_tasks_;
+  // Tasks to execute after the ones in first_tasks_.
+  Task_list tasks_;
+  // Number of tasks on the two lists.
+  volatile int count_;
+  // Number of tasks run by the threads using this queue.
+  unsigned int tasks_run_;
+  // Number of tasks those threads stole from other queues.
+  unsigned int steals_;
+  // Time those threads spent running tasks.
+  uint64_t busy_usec_;
+  // Time those threads spent waiting for a task.
+  uint64_t idle_usec_;
+};
+
 // The Workqueue_threader abstract class.  This is the interface used
 // by the general workqueue code to manage threads.
 
@@ -58,6 +151,10 @@ class Workqueue_threader
   virtual bool
   should_cancel_thread(int thread_number) = 0;
 
+  // Return the thread number of the calling thread.
+  virtual int
+  current_thread() = 0;
+
  protected:
   // Get the Workqueue.
   Workqueue*
@@ -69,6 +166,8 @@ class Workqueue_threader
   Workqueue* workqueue_;
 };
 
+#ifdef ENABLE_THREADS
+
 // The threaded instantiation of Workqueue_threader.
 
 class Workqueue_threader_threadpool : public Workqueue_threader
@@ -86,12 +185,18 @@ class Workqueue_threader_threadpool : public Workqueue_threader
   bool
   should_cancel_thread(int thread_number);
 
+  // Return the thread number of the calling thread.
+  int
+  current_thread();
+
   // Process all tasks.  This keeps running until told to cancel.
   void
-  process(int thread_number)
-  { this->get_workqueue()->process(thread_number); }
+  process(int thread_number);
 
  private:
+  // Thread specific key holding the thread number plus one.  The
+  // main thread never sets it, so it reads as zero there.
+  pthread_key_t thread_number_key_;
   // This is set if we need to check the thread count.
   volatile sig_atomic_t check_thread_count_;
 
@@ -104,6 +209,8 @@ class Workqueue_threader_threadpool : public Workqueue_threader
   int threads_;
 };
 
+#endif // defined(ENABLE_THREADS)
+
 } // End namespace gold.
 
 #endif // !defined(GOLD_WORKQUEUE_INTERNAL_H)
@@ -134,6 +134,9 @@ Workqueue_threader_threadpool::Workqueue_threader_threadpool(
     desired_thread_count_(1),
     threads_(1)
 {
+  int err = pthread_key_create(&this->thread_number_key_, NULL);
+  if (err != 0)
+    gold_fatal(_("pthread_key_create failed: %s"), strerror(err));
 }
 
 // Destructor.
@@ -142,6 +145,33 @@ Workqueue_threader_threadpool::~Workqueue_threader_threadpool()
 {
   // Tell the threads to exit.
   this->get_workqueue()->set_thread_count(0);
+  // The key is not deleted, as threads which are still exiting may
+  // look at it.
+}
+
+// Process all tasks in a new thread.  Record the thread number so
+// that tasks queued by this thread go on its own run queue.
+
+void
+Workqueue_threader_threadpool::process(int thread_number)
+{
+  int err = pthread_setspecific(this->thread_number_key_,
+				reinterpret_cast<void*>(
+				  static_cast<intptr_t>(thread_number + 1)));
+  if (err != 0)
+    gold_fatal(_("pthread_setspecific failed: %s"), strerror(err));
+  this->get_workqueue()->process(thread_number);
+}
+
+// Return the thread number of the calling thread.
+
+int
+Workqueue_threader_threadpool::current_thread()
+{
+  void* p = pthread_getspecific(this->thread_number_key_);
+  if (p == NULL)
+    return 0;
+  return static_cast<int>(reinterpret_cast<intptr_t>(p)) - 1;
 }
 
 // Set the thread count.
@@ -22,7 +22,12 @@
 
 #include "gold.h"
 
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+
 #include "debug.h"
+#include "parameters.h"
 #include "options.h"
 #include "timer.h"
 #include "workqueue.h"
@@ -94,6 +99,83 @@ Task_list::pop_front()
   return ret;
 }
 
+// Atomically add V to *P and return the new value.  When atomic
+// operations are available this is a full memory barrier, which the
+// scheduler relies on when deciding whether a thread may sleep.
+// Otherwise all callers hold the Workqueue lock.
+
+static inline int
+atomic_add(volatile int* p, int v)
+{
+#if defined(ENABLE_THREADS) && defined(__GCC_HAVE_SYNC_COMPARE_AND_SWAP_4)
+  return __sync_add_and_fetch(p, v);
+#else
+  *p += v;
+  return *p;
+#endif
+}
+
+// Read *P with a full memory barrier.
+
+static inline int
+atomic_read(volatile int* p)
+{
+  return atomic_add(p, 0);
+}
+
+// Class Workqueue_deque.
+
+// Add T to the queue.
+
+void
+Workqueue_deque::push(Task* t, bool soon, bool front)
+{
+  Hold_lock hl(this->lock_);
+  Task_list* list = soon ? &this->first_tasks_ : &this->tasks_;
+  if (front)
+    list->push_front(t);
+  else
+    list->push_back(t);
+  ++this->count_;
+}
+
+// Remove the first task from one of the lists.
+
+Task*
+Workqueue_deque::pop(bool soon)
+{
+  Hold_lock hl(this->lock_);
+  Task* t = (soon ? &this->first_tasks_ : &this->tasks_)->pop_front();
+  if (t != NULL)
+    --this->count_;
+  return t;
+}
+
+// Record that a thread using this queue stole a task.  Threads may
+// share a queue, so this takes the queue lock.
+
+void
+Workqueue_deque::add_steal()
+{
+  Hold_lock hl(this->lock_);
+  ++this->steals_;
+}
+
+// Print statistics.
+
+void
+Workqueue_deque::print_stats(int index) const
+{
+  fprintf(stderr,
+	  _("%s: run queue %d: tasks run %u, tasks stolen %u, "
+	    "busy: %llu.%06llu idle: %llu.%06llu\n"),
+	  program_name, index, this->tasks_run_, this->steals_,
+	  static_cast<unsigned long long>(this->busy_usec_ / 1000000),
+	  static_cast<unsigned long long>(this->busy_usec_ % 1000000),
+	  static_cast<unsigned long long>(this->idle_usec_ / 1000000),
+	  static_cast<unsigned long long>(this->idle_usec_ % 1000000));
+}
+
 // The simple single-threaded implementation of Workqueue_threader.
 
 class Workqueue_threader_single : public Workqueue_threader
@@ -112,16 +194,39 @@ class Workqueue_threader_single : public Workqueue_threader
   bool
   should_cancel_thread(int)
   { return false; }
+
+  int
+  current_thread()
+  { return 0; }
 };
 
 // Workqueue methods.
 
+// The number of run queues to use when running threads, if the user
+// did not give an explicit thread count.  Threads beyond this number
+// share queues.
+
+static const unsigned int default_deque_count = 32;
+
+// The maximum number of run queues.  Idle threads scan all the
+// queues, so having a queue for each of thousands of threads would
+// make that expensive.
+
+static const unsigned int max_deque_count = 256;
+
 Workqueue::Workqueue(const General_options& options)
   : lock_(),
-    first_tasks_(),
-    tasks_(),
+    deques_(),
+    queued_(0),
+    generation_(0),
+    sleeping_(0),
     running_(0),
     waiting_(0),
+    collect_stats_(options.stats()),
+    trace_(options.user_set_task_trace()),
+    trace_start_(0),
+    trace_entries_(),
+    trace_thread_counts_(),
     condvar_(this->lock_),
     threader_(NULL)
 {
@@ -129,6 +234,7 @@ Workqueue::Workqueue(const General_options& options)
 #ifndef ENABLE_THREADS
   threads = false;
 #endif
+  unsigned int deque_count = 1;
   if (!threads)
     this->threader_ = new Workqueue_threader_single(this);
   else
@@ -138,47 +244,79 @@ Workqueue::Workqueue(const General_options& options)
 #else
       gold_unreachable();
 #endif
+      int thread_count = std::max(std::max(options.thread_count(),
+					   options.thread_count_initial()),
+				  std::max(options.thread_count_middle(),
+					   options.thread_count_final()));
+      if (thread_count <= 0)
+	deque_count = default_deque_count;
+      else
+	deque_count = std::min(static_cast<unsigned int>(thread_count),
+			       max_deque_count);
     }
+
+  this->deques_.reserve(deque_count);
+  for (unsigned int i = 0; i < deque_count; ++i)
+    this->deques_.push_back(new Workqueue_deque());
+
+  if (this->trace_)
+    this->trace_start_ = Timer::get_wall_time_usec();
 }
 
 Workqueue::~Workqueue()
 {
+  for (size_t i = 0; i < this->deques_.size(); ++i)
+    delete this->deques_[i];
 }
 
-// Add a task to the end of a specific queue, or put it on the list
-// waiting for a Token.
+// Add a task to a run queue.  The task will be checked for
+// runnability when it is taken off the queue; if it is not runnable
+// then it will be added to the list for the appropriate Token.
 
 void
-Workqueue::add_to_queue(Task_list* queue, Task* t, bool front)
+Workqueue::push_task(Workqueue_deque* deque, Task* t, bool soon, bool front,
+		     bool locked)
 {
-  Hold_lock hl(this->lock_);
+#if !defined(ENABLE_THREADS) || !defined(__GCC_HAVE_SYNC_COMPARE_AND_SWAP_4)
+  // Without atomic operations the counters are protected by the
+  // Workqueue lock.
+  Hold_optional_lock hl(locked ? NULL : &this->lock_);
+  locked = true;
+#endif
 
-  Task_token* token = t->is_runnable();
-  if (token != NULL)
+  atomic_add(&this->queued_, 1);
+  deque->push(t, soon, front);
+  atomic_add(&this->generation_, 1);
+
+  // Tell any waiting thread that there is work to do.  A thread
+  // about to sleep increments sleeping_ before checking generation_,
+  // and we increment generation_ before checking sleeping_, so at
+  // least one of us will see the other.
+  if (locked)
+    this->condvar_.signal();
+  else if (atomic_read(&this->sleeping_) > 0)
     {
-      if (front)
-	token->add_waiting_front(t);
-      else
-	token->add_waiting(t);
-      ++this->waiting_;
-    }
-  else
-    {
-      if (front)
-	queue->push_front(t);
-      else
-	queue->push_back(t);
-      // Tell any waiting thread that there is work to do.
+      Hold_lock hl(this->lock_);
       this->condvar_.signal();
     }
 }
 
+// Add a task to the run queue of the calling thread.
+
+void
+Workqueue::add_to_queue(Task* t, bool soon, bool front)
+{
+  int thread_number = this->threader_->current_thread();
+  this->push_task(this->deque_for_thread(thread_number), t, soon, front,
+		  false);
+}
+
 // Add a task to the queue.
 
 void
 Workqueue::queue(Task* t)
 {
-  this->add_to_queue(&this->tasks_, t, false);
+  this->add_to_queue(t, false, false);
 }
 
 // Queue a task which should run soon.
@@ -187,7 +325,7 @@ void
 Workqueue::queue_soon(Task* t)
 {
   t->set_should_run_soon();
-  this->add_to_queue(&this->first_tasks_, t, false);
+  this->add_to_queue(t, true, false);
 }
 
 // Queue a task which should run next.
@@ -196,7 +334,7 @@ void
 Workqueue::queue_next(Task* t)
 {
   t->set_should_run_soon();
-  this->add_to_queue(&this->first_tasks_, t, true);
+  this->add_to_queue(t, true, true);
 }
 
 // Return whether to cancel the current thread.
@@ -207,55 +345,95 @@ Workqueue::should_cancel_thread(int thread_number)
   return this->threader_->should_cancel_thread(thread_number);
 }
 
-// Find a runnable task in TASKS.  Return NULL if none could be found.
-// If we find a Task waiting for a Token, add it to the list for that
-// Token.  The workqueue lock must be held when this is called.
+// Take a task off the run queues.  We look at the tasks to run soon
+// before the other tasks.  For each list we look at the queue of
+// THREAD_NUMBER first, and then steal from the other queues.  This
+// is called without the workqueue lock held, and only takes the locks
+// of the queues it looks at.  The caller must decrement queued_ after
+// deciding what to do with the task.
+
+Task*
+Workqueue::pop_task(int thread_number)
+{
+  size_t count = this->deques_.size();
+  size_t index = thread_number % count;
+  Workqueue_deque* local = this->deques_[index];
+  for (int soon = 1; soon >= 0; --soon)
+    {
+      Task* t = local->pop(soon);
+      if (t != NULL)
+	return t;
+      for (size_t i = 1; i < count; ++i)
+	{
+	  Workqueue_deque* victim = this->deques_[(index + i) % count];
+	  if (victim->maybe_empty())
+	    continue;
+	  t = victim->pop(soon);
+	  if (t != NULL)
+	    {
+	      if (this->collect_stats_)
+		local->add_steal();
+	      gold_debug(DEBUG_TASK, "%3d stole     task %s", thread_number,
+			 t->name().c_str());
+	      return t;
+	    }
+	}
+    }
+  return NULL;
+}
+
+// Find a runnable task.  Return NULL if none could be found.  If we
+// find a Task waiting for a Token, add it to the list for that Token.
+// If we find a runnable Task, get its locks in TL.  This must be
+// called without the workqueue lock held.  We only take that lock
+// to check a task we have already taken off a run queue, since that
+// looks at the Task_tokens.
 
 Task*
-Workqueue::find_runnable_in_list(Task_list* tasks)
+Workqueue::find_runnable(int thread_number, Task_locker* tl)
 {
   Task* t;
-  while ((t = tasks->pop_front()) != NULL)
+  while ((t = this->pop_task(thread_number)) != NULL)
     {
-      Task_token* token = t->is_runnable();
+      Hold_lock hl(this->lock_);
 
+      atomic_add(&this->queued_, -1);
+
+      Task_token* token = t->is_runnable();
       if (token == NULL)
-	return t;
+	{
+	  // Get the locks for the task.  This must be called while we
+	  // are still holding the Workqueue lock.
+	  t->locks(tl);
+	  ++this->running_;
+	  return t;
+	}
 
-      token->add_waiting(t);
-      ++this->waiting_;
+      this->add_waiting(token, t);
     }
 
   // We couldn't find any runnable task.
   return NULL;
 }
 
-// Find a runnable task.  Return NULL if none could be found.  The
-// workqueue lock must be held when this is called.
+// Find a runnable a task, and wait until we find one.  Return NULL if
+// we should exit.  This must be called without the workqueue lock
+// held.
 
 Task*
-Workqueue::find_runnable()
+Workqueue::find_runnable_or_wait(int thread_number, Task_locker* tl)
 {
-  Task* t = this->find_runnable_in_list(&this->first_tasks_);
-  if (t == NULL)
-    t = this->find_runnable_in_list(&this->tasks_);
-  return t;
-}
+  while (true)
+    {
+      int generation = atomic_read(&this->generation_);
 
-// Find a runnable a task, and wait until we find one.  Return NULL if
-// we should exit.  The workqueue lock must be held when this is
-// called.
+      Task* t = this->find_runnable(thread_number, tl);
+      if (t != NULL)
+	return t;
 
-Task*
-Workqueue::find_runnable_or_wait(int thread_number)
-{
-  Task* t = this->find_runnable();
+      Hold_lock hl(this->lock_);
 
-  while (t == NULL)
-    {
-      if (this->running_ == 0
-	  && this->first_tasks_.empty()
-	  && this->tasks_.empty())
+      if (this->running_ == 0 && atomic_read(&this->queued_) == 0)
 	{
 	  // Kick all the threads to make them exit.
 	  this->condvar_.broadcast();
@@ -267,16 +445,27 @@ Workqueue::find_runnable_or_wait(int thread_number)
       if (this->should_cancel_thread(thread_number))
 	return NULL;
 
-      gold_debug(DEBUG_TASK, "%3d sleeping", thread_number);
+      // Tasks counted in queued_ which we did not find have been taken
+      // off a run queue by another thread, which will run them or put
+      // them on the list of a Task_token.  So we only need to check
+      // that nothing was queued since we looked.
+      atomic_add(&this->sleeping_, 1);
+      if (atomic_read(&this->generation_) == generation)
+	{
+	  gold_debug(DEBUG_TASK, "%3d sleeping", thread_number);
 
-      this->condvar_.wait();
+	  uint64_t start = this->collect_stats_ ? Timer::get_wall_time_usec() : 0;
 
-      gold_debug(DEBUG_TASK, "%3d awake", thread_number);
+	  this->condvar_.wait();
 
-      t = this->find_runnable();
-    }
+	  if (this->collect_stats_)
+	    this->deque_for_thread(thread_number)->add_idle_time(
+		Timer::get_wall_time_usec() - start);
 
-  return t;
+	  gold_debug(DEBUG_TASK, "%3d awake", thread_number);
+	}
+      atomic_add(&this->sleeping_, -1);
+    }
 }
 
 // Find and run tasks.  If we can't find a runnable task, wait for one
@@ -288,24 +477,13 @@ Workqueue::find_runnable_or_wait(int thread_number)
 bool
 Workqueue::find_and_run_task(int thread_number)
 {
-  Task* t;
+  Workqueue_deque* local = this->deque_for_thread(thread_number);
   Task_locker tl;
 
-  {
-    Hold_lock hl(this->lock_);
-
-    // Find a runnable task.
-    t = this->find_runnable_or_wait(thread_number);
-
-    if (t == NULL)
-      return false;
-
-    // Get the locks for the task.  This must be called while we are
-    // still holding the Workqueue lock.
-    t->locks(&tl);
-
-    ++this->running_;
-  }
+  // Find a runnable task.
+  Task* t = this->find_runnable_or_wait(thread_number, &tl);
+  if (t == NULL)
+    return false;
 
   while (t != NULL)
     {
@@ -315,6 +493,13 @@ Workqueue::find_and_run_task(int thread_number)
       Timer timer;
       if (is_debugging_enabled(DEBUG_TASK))
         timer.start();
+      bool timing = this->collect_stats_ || this->trace_;
+      uint64_t start = timing ? Timer::get_wall_time_usec() : 0;
+
+      // The name of some tasks refers to data which the task frees
+      // when it runs, so get the name for the trace first.
+      if (this->trace_)
+	t->name();
 
       t->run(this);
 
@@ -335,14 +520,18 @@ Workqueue::find_and_run_task(int thread_number)
       {
 	Hold_lock hl(this->lock_);
 
+	uint64_t end = timing ? Timer::get_wall_time_usec() : 0;
+	if (this->collect_stats_)
+	  local->add_busy_time(end - start);
+	int trace_index = -1;
+	if (this->trace_)
+	  trace_index = this->add_trace_entry(t, thread_number, start, end);
+
 	--this->running_;
 
 	// Release the locks for the task.  This must be done with the
 	// workqueue lock held.  Get the next Task to run if any.
-	next = this->release_locks(t, &tl);
-
-	if (next == NULL)
-	  next = this->find_runnable();
+	next = this->release_locks(t, &tl, local, trace_index);
 
 	// If we have another Task to run, get the Locks.  This must
 	// be called while we are still holding the Workqueue lock.
@@ -358,6 +547,14 @@ Workqueue::find_and_run_task(int thread_number)
       // We are done with this task.
       delete t;
 
+      // If releasing the locks did not give us a task, look on the
+      // run queues.
+      if (next == NULL)
+	{
+	  tl.clear();
+	  next = this->find_runnable(thread_number, &tl);
+	}
+
       t = next;
     }
 
@@ -370,8 +567,8 @@ Workqueue::find_and_run_task(int thread_number)
 // 1) If T is not runnable, queue it on the appropriate token.
 
 // 2) Otherwise, T is runnable.  If *PRET is not NULL, then we have
-// already decided which Task to run next.  Add T to the list of
-// runnable tasks, and signal another thread.
+// already decided which Task to run next.  Add T to the run queue
+// DEQUE of this thread, and signal another thread.
 
 // 3) Otherwise, *PRET is NULL.  If IS_BLOCKER is false, then T was
 // waiting on a write lock.  We can grab that lock now, so we run T
@@ -390,21 +587,25 @@ Workqueue::find_and_run_task(int thread_number)
 // run this one now.
 
 // This function must be called with the Workqueue lock held.
+// TRACE_INDEX is the index in the task trace of the Task which
+// released the lock T was waiting for, or -1.
 
 // Return true if we set *PRET to T, false otherwise.
 
 bool
-Workqueue::return_or_queue(Task* t, bool is_blocker, Task** pret)
+Workqueue::return_or_queue(Task* t, bool is_blocker, Workqueue_deque* deque,
+			   int trace_index, Task** pret)
 {
   Task_token* token = t->is_runnable();
 
   if (token != NULL)
     {
-      token->add_waiting(t);
-      ++this->waiting_;
+      this->add_waiting(token, t);
       return false;
     }
 
+  t->set_trace_released_by(trace_index);
+
   bool should_queue = false;
   bool should_return = false;
 
@@ -414,7 +615,7 @@ Workqueue::return_or_queue(Task* t, bool is_blocker, Task** pret)
     should_return = true;
   else if (t->should_run_soon())
     should_return = true;
-  else if (!this->first_tasks_.empty() || !this->tasks_.empty())
+  else if (atomic_read(&this->queued_) > 0)
     should_queue = true;
   else
     should_return = true;
@@ -427,11 +628,7 @@ Workqueue::return_or_queue(Task* t, bool is_blocker, Task** pret)
     }
   else if (should_queue)
     {
-      if (t->should_run_soon())
-	this->first_tasks_.push_back(t);
-      else
-	this->tasks_.push_back(t);
-      this->condvar_.signal();
+      this->push_task(deque, t, t->should_run_soon(), false, true);
       return false;
     }
 
@@ -440,11 +637,13 @@ Workqueue::return_or_queue(Task* t, bool is_blocker, Task** pret)
 
 // Release the locks associated with a Task.  Return the first
 // runnable Task that we find.  If we find more runnable tasks, add
-// them to the run queue and signal any other threads.  This must be
-// called with the Workqueue lock held.
+// them to DEQUE and signal any other threads.  This must be called
+// with the Workqueue lock held.  TRACE_INDEX is the index of T in the
+// task trace, or -1.
 
 Task*
-Workqueue::release_locks(Task* t, Task_locker* tl)
+Workqueue::release_locks(Task* t, Task_locker* tl, Workqueue_deque* deque,
+			 int trace_index)
 {
   Task* ret = NULL;
   for (Task_locker::iterator p = tl->begin(); p != tl->end(); ++p)
@@ -460,7 +659,7 @@ Workqueue::release_locks(Task* t, Task_locker* tl)
 	      while ((t = token->remove_first_waiting()) != NULL)
 		{
 		  --this->waiting_;
-		  this->return_or_queue(t, true, &ret);
+		  this->return_or_queue(t, true, deque, trace_index, &ret);
 		}
 	    }
 	}
@@ -477,7 +676,7 @@ Workqueue::release_locks(Task* t, Task_locker* tl)
 	  while ((t = token->remove_first_waiting()) != NULL)
 	    {
 	      --this->waiting_;
-	      if (this->return_or_queue(t, false, &ret))
+	      if (this->return_or_queue(t, false, deque, trace_index, &ret))
 		break;
 	    }
 	}
@@ -485,6 +684,36 @@ Workqueue::release_locks(Task* t, Task_locker* tl)
   return ret;
 }
 
+// Put T on the list of tasks waiting for TOKEN.  This must be called
+// with the Workqueue lock held.
+
+void
+Workqueue::add_waiting(Task_token* token, Task* t)
+{
+  token->add_waiting(t);
+  ++this->waiting_;
+  t->set_trace_blocker(token);
+  t->set_trace_released_by(-1);
+}
+
+// Record a task in the task trace.  This must be called with the
+// Workqueue lock held.
+
+int
+Workqueue::add_trace_entry(Task* t, int thread_number, uint64_t start,
+			   uint64_t end)
+{
+  Trace_entry entry;
+  entry.name = t->name();
+  entry.thread_number = thread_number;
+  entry.start = start;
+  entry.end = end;
+  entry.blocker = t->trace_blocker();
+  entry.released_by = t->trace_released_by();
+  this->trace_entries_.push_back(entry);
+  return this->trace_entries_.size() - 1;
+}
+
 // Process all the tasks on the workqueue.  Keep going until the
 // workqueue is empty, or until we have been told to exit.  This
 // function is called by all threads.
@@ -504,6 +733,14 @@ Workqueue::set_thread_count(int threads)
 {
   Hold_lock hl(this->lock_);
 
+  if (this->trace_ && parameters->options().threads())
+    {
+      Trace_thread_count tc;
+      tc.time = Timer::get_wall_time_usec();
+      tc.thread_count = threads;
+      this->trace_thread_counts_.push_back(tc);
+    }
+
   this->threader_->set_thread_count(threads);
   // Wake up all the threads, since something has changed.
   this->condvar_.broadcast();
@@ -518,4 +755,275 @@ Workqueue::add_blocker(Task_token* token)
   token->add_blocker();
 }
 
+// The pieces of one call to Workqueue::run_in_parallel.  The calling
+// thread and each Parallel_piece_task take pieces until none are
+// left, and then the calling thread waits for the pieces which other
+// threads took.  A Parallel_piece_task may not run until after the
+// call has returned, so this is deleted by whichever user releases
+// it last.
+
+class Parallel_run
+{
+ public:
+  Parallel_run(Parallel_work* work, size_t items, unsigned int pieces,
+	       int refs)
+    : work_(work), items_(items), pieces_(pieces), lock_(),
+      condvar_(this->lock_), next_(0), done_(0), refs_(refs)
+  { }
+
+  // Run pieces until there are none left to start.
+  void
+  run_pieces();
+
+  // Wait until all the pieces are done.
+  void
+  wait();
+
+  // Release one reference, deleting this if it was the last.
+  void
+  release();
+
+ private:
+  Parallel_work* work_;
+  size_t items_;
+  unsigned int pieces_;
+  // Protects the fields below.
+  Lock lock_;
+  // Signalled when the last piece is done.
+  Condvar condvar_;
+  // The next piece to start.
+  unsigned int next_;
+  // The number of pieces done.
+  unsigned int done_;
+  // The number of references to this object.
+  int refs_;
+};
+
+void
+Parallel_run::run_pieces()
+{
+  while (true)
+    {
+      unsigned int piece;
+      {
+	Hold_lock hl(this->lock_);
+	if (this->next_ == this->pieces_)
+	  return;
+	piece = this->next_++;
+      }
+
+      this->work_->run_piece(piece, this->items_ * piece / this->pieces_,
+			     this->items_ * (piece + 1) / this->pieces_);
+
+      Hold_lock hl(this->lock_);
+      ++this->done_;
+      if (this->done_ == this->pieces_)
+	this->condvar_.broadcast();
+    }
+}
+
+void
+Parallel_run::wait()
+{
+  Hold_lock hl(this->lock_);
+  while (this->done_ < this->pieces_)
+    this->condvar_.wait();
+}
+
+void
+Parallel_run::release()
+{
+  bool last;
+  {
+    Hold_lock hl(this->lock_);
+    last = --this->refs_ == 0;
+  }
+  if (last)
+    delete this;
+}
+
+// A Task run by an idle thread to take pieces of a Parallel_run.
+
+class Parallel_piece_task : public Task
+{
+ public:
+  Parallel_piece_task(Parallel_run* run)
+    : run_(run)
+  { }
+
+  Task_token*
+  is_runnable()
+  { return NULL; }
+
+  void
+  locks(Task_locker*)
+  { }
+
+  void
+  run(Workqueue*)
+  {
+    this->run_->run_pieces();
+    this->run_->release();
+  }
+
+  std::string
+  get_name() const
+  { return "Parallel_piece_task"; }
+
+ private:
+  Parallel_run* run_;
+};
+
+// Run WORK on ITEMS items divided into PIECES pieces.  Queue a task
+// for each thread which is waiting for work, up to one for each piece
+// after the first, so that this never starts more threads than the
+// workqueue already has.  This thread runs the pieces they do not
+// take, so it never waits for a piece which has not started.
+
+void
+Workqueue::run_in_parallel(Parallel_work* work, size_t items,
+			   unsigned int pieces)
+{
+  unsigned int helpers = pieces - 1;
+  unsigned int sleeping = atomic_read(&this->sleeping_);
+  if (helpers > sleeping)
+    helpers = sleeping;
+
+  Parallel_run* run = new Parallel_run(work, items, pieces, helpers + 1);
+  for (unsigned int i = 0; i < helpers; ++i)
+    this->queue_next(new Parallel_piece_task(run));
+  run->run_pieces();
+  run->wait();
+  run->release();
+}
+
+// Print statistics about the run queues.  A queue is shared by
+// several threads when there are more threads than queues.
+
+void
+Workqueue::print_stats() const
+{
+  for (size_t i = 0; i < this->deques_.size(); ++i)
+    if (this->deques_[i]->is_used())
+      this->deques_[i]->print_stats(i);
+}
+
+// Write STR to F as a JSON string.
+
+static void
+write_json_string(FILE* f, const char* str)
+{
+  putc('"', f);
+  for (const char* p = str; *p != '\0'; ++p)
+    {
+      unsigned char c = *p;
+      if (c == '"' || c == '\\')
+	fprintf(f, "\\%c", c);
+      else if (c < 0x20)
+	fprintf(f, "\\u%04x", c);
+      else
+	putc(c, f);
+    }
+  putc('"', f);
+}
+
+// Write the task trace to the file named by --task-trace, in the
+// Chrome trace event format.  Each task is a complete event on the
+// thread which ran it.  When a task waited for a Task_token, a flow
+// event connects it to the task which released the token.  This is
+// called after all the tasks have run.
+
+void
+Workqueue::write_trace() const
+{
+  const char* filename = parameters->options().task_trace();
+  FILE* f = fopen(filename, "w");
+  if (f == NULL)
+    {
+      gold_error(_("cannot open task trace file %s: %s"), filename,
+		 strerror(errno));
+      return;
+    }
+
+  fprintf(f, "{\"traceEvents\":[\n");
+  fprintf(f, "{\"ph\":\"M\",\"name\":\"process_name\",\"pid\":1,"
+	  "\"args\":{\"name\":");
+  write_json_string(f, program_name);
+  fprintf(f, "}}");
+
+  std::vector<bool> seen_thread;
+  for (size_t i = 0; i < this->trace_entries_.size(); ++i)
+    {
+      const Trace_entry& e(this->trace_entries_[i]);
+      if (static_cast<size_t>(e.thread_number) >= seen_thread.size())
+	seen_thread.resize(e.thread_number + 1);
+      if (!seen_thread[e.thread_number])
+	{
+	  fprintf(f, ",\n{\"ph\":\"M\",\"name\":\"thread_name\","
+		  "\"pid\":1,\"tid\":%d,\"args\":{\"name\":"
+		  "\"thread %d\"}}",
+		  e.thread_number, e.thread_number);
+	  seen_thread[e.thread_number] = true;
+	}
+    }
+
+  for (size_t i = 0; i < this->trace_thread_counts_.size(); ++i)
+    {
+      const Trace_thread_count& tc(this->trace_thread_counts_[i]);
+      fprintf(f, ",\n{\"ph\":\"i\",\"s\":\"g\",\"name\":"
+	      "\"thread count %d\",\"pid\":1,\"tid\":0,\"ts\":%llu}",
+	      tc.thread_count,
+	      static_cast<unsigned long long>(tc.time - this->trace_start_));
+    }
+
+  for (size_t i = 0; i < this->trace_entries_.size(); ++i)
+    {
+      const Trace_entry& e(this->trace_entries_[i]);
+      fprintf(f, ",\n{\"ph\":\"X\",\"cat\":\"task\",\"name\":");
+      write_json_string(f, e.name.c_str());
+      fprintf(f, ",\"pid\":1,\"tid\":%d,\"ts\":%llu,\"dur\":%llu",
+	      e.thread_number,
+	      static_cast<unsigned long long>(e.start - this->trace_start_),
+	      static_cast<unsigned long long>(e.end - e.start));
+      if (e.blocker != NULL)
+	{
+	  fprintf(f, ",\"args\":{\"blocker\":\"%p\"",
+		  static_cast<const void*>(e.blocker));
+	  if (e.released_by >= 0)
+	    {
+	      fprintf(f, ",\"released_by\":");
+	      write_json_string(f,
+				this->trace_entries_[e.released_by].name.c_str());
+	    }
+	  fprintf(f, "}");
+	}
+      fprintf(f, "}");
+
+      if (e.released_by >= 0)
+	{
+	  // The flow starts at the end of the releasing task, and binds
+	  // to the task which it released.
+	  const Trace_entry& r(this->trace_entries_[e.released_by]);
+	  fprintf(f, ",\n{\"ph\":\"s\",\"cat\":\"token\","
+		  "\"name\":\"unblock\",\"id\":%zu,\"pid\":1,"
+		  "\"tid\":%d,\"ts\":%llu}",
+		  i, r.thread_number,
+		  static_cast<unsigned long long>(
+		    (r.end > r.start ? r.end - 1 : r.start)
+		    - this->trace_start_));
+	  fprintf(f, ",\n{\"ph\":\"f\",\"bp\":\"e\",\"cat\":\"token\","
+		  "\"name\":\"unblock\",\"id\":%zu,\"pid\":1,"
+		  "\"tid\":%d,\"ts\":%llu}",
+		  i, e.thread_number,
+		  static_cast<unsigned long long>(e.start - this->trace_start_));
+	}
+    }
+
+  fprintf(f, "\n],\"displayTimeUnit\":\"ms\"}\n");
+
+  if (fclose(f) != 0)
+    gold_error(_("cannot close task trace file %s: %s"), filename,
+	       strerror(errno));
+}
+
 } // End namespace gold.
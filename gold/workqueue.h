@@ -28,6 +28,7 @@
 #define GOLD_WORKQUEUE_H
 
 #include <string>
+#include <vector>
 
 #include "gold-threads.h"
 #include "token.h"
@@ -45,7 +46,8 @@ class Task
 {
  public:
   Task()
-    : list_next_(NULL), name_(), should_run_soon_(false)
+    : list_next_(NULL), name_(), should_run_soon_(false),
+      trace_blocker_(NULL), trace_released_by_(-1)
   { }
   virtual ~Task()
   { }
@@ -96,6 +98,29 @@ class Task
   clear_list_next()
   { this->list_next_ = NULL; }
 
+  // Record that the Task is waiting for TOKEN.  This is only used
+  // when writing a task trace.
+  void
+  set_trace_blocker(const Task_token* token)
+  { this->trace_blocker_ = token; }
+
+  // Return the token the Task last waited for, or NULL.
+  const Task_token*
+  trace_blocker() const
+  { return this->trace_blocker_; }
+
+  // Record that the token the Task waited for was released by the
+  // Task with index INDEX in the task trace.
+  void
+  set_trace_released_by(int index)
+  { this->trace_released_by_ = index; }
+
+  // Return the index in the task trace of the Task which released the
+  // token this Task waited for, or -1.
+  int
+  trace_released_by() const
+  { return this->trace_released_by_; }
+
   // Return the name of the Task.  This is only used for debugging
   // purposes.
   const std::string&
@@ -127,6 +152,11 @@ class Task
   // Whether this Task should be executed soon.  This is used for
   // Tasks which can be run after some data is read.
   bool should_run_soon_;
+  // The Task_token this Task last waited for, for the task trace.
+  const Task_token* trace_blocker_;
+  // The index in the task trace of the Task which released
+  // trace_blocker_, or -1.
+  int trace_released_by_;
 };
 
 // An interface for Task_function.  This is a convenience class to run
@@ -194,6 +224,7 @@ class Task_function : public Task
 // The workqueue itself.
 
 class Workqueue_threader;
+class Workqueue_deque;
 
 class Workqueue
 {
@@ -233,26 +264,52 @@ class Workqueue
   void
   add_blocker(Task_token*);
 
+  // Run WORK on ITEMS items divided into PIECES pieces, and return
+  // when all the pieces are done.  This is called by a running Task.
+  // Threads waiting for work may run some of the pieces.
+  void
+  run_in_parallel(Parallel_work* work, size_t items, unsigned int pieces);
+
+  // Print statistics about the run queues to stderr.
+  void
+  print_stats() const;
+
+  // Write the task trace requested by --task-trace.
+  void
+  write_trace() const;
+
  private:
   // This class can not be copied.
   Workqueue(const Workqueue&);
   Workqueue& operator=(const Workqueue&);
 
-  // Add a task to a queue.
+  // Return the run queue used by THREAD_NUMBER.
+  Workqueue_deque*
+  deque_for_thread(int thread_number) const
+  { return this->deques_[thread_number % this->deques_.size()]; }
+
+  // Add a task to the run queue of the calling thread.
   void
-  add_to_queue(Task_list* queue, Task* t, bool front);
+  add_to_queue(Task* t, bool soon, bool front);
 
-  // Find a runnable task, or wait for one.
+  // Add a task to a run queue.  This may be called with or without
+  // the workqueue lock held; LOCKED says which.
+  void
+  push_task(Workqueue_deque* deque, Task* t, bool soon, bool front,
+	    bool locked);
+
+  // Take a task off the run queues, without checking whether it is
+  // runnable.
   Task*
-  find_runnable_or_wait(int thread_number);
+  pop_task(int thread_number);
 
-  // Find a runnable task.
+  // Find a runnable task, or wait for one.
   Task*
-  find_runnable();
+  find_runnable_or_wait(int thread_number, Task_locker*);
 
-  // Find a runnable task in a list.
+  // Find a runnable task.
   Task*
-  find_runnable_in_list(Task_list*);
+  find_runnable(int thread_number, Task_locker*);
 
   // Find an run a task.
   bool
@@ -260,27 +317,82 @@ class Workqueue
 
   // Release the locks for a Task.  Return the next Task to run.
   Task*
-  release_locks(Task*, Task_locker*);
+  release_locks(Task*, Task_locker*, Workqueue_deque*, int trace_index);
 
   // Store T into *PRET, or queue it as appropriate.
   bool
-  return_or_queue(Task* t, bool is_blocker, Task** pret);
+  return_or_queue(Task* t, bool is_blocker, Workqueue_deque*, int trace_index,
+		  Task** pret);
+
+  // Put T on the list of tasks waiting for TOKEN.
+  void
+  add_waiting(Task_token* token, Task* t);
+
+  // Record in the task trace that T ran on THREAD_NUMBER from START
+  // to END.  Return the index of the new entry.
+  int
+  add_trace_entry(Task* t, int thread_number, uint64_t start, uint64_t end);
+
+  // An entry in the task trace.
+  struct Trace_entry
+  {
+    // The name of the Task.
+    std::string name;
+    // The thread which ran the Task.
+    int thread_number;
+    // The wall clock times at which the Task started and finished,
+    // in microseconds.
+    uint64_t start;
+    uint64_t end;
+    // The Task_token the Task last waited for, or NULL.
+    const Task_token* blocker;
+    // The index of the entry for the Task which released BLOCKER, or
+    // -1.
+    int released_by;
+  };
+
+  // A change in the number of threads, for the task trace.
+  struct Trace_thread_count
+  {
+    uint64_t time;
+    int thread_count;
+  };
 
   // Return whether to cancel this thread.
   bool
   should_cancel_thread(int thread_number);
 
-  // Master Workqueue lock.  This controls access to the following
-  // member variables.
+  // Master Workqueue lock.  This controls access to the Task_tokens
+  // and to running_, waiting_ and the statistics.
   Lock lock_;
-  // List of tasks to execute soon.
-  Task_list first_tasks_;
-  // List of tasks to execute after the ones in first_tasks_.
-  Task_list tasks_;
+  // The run queues.  This is set at construction time and not
+  // changed thereafter; the queues have their own locks.
+  std::vector<Workqueue_deque*> deques_;
+  // Number of tasks on the run queues, plus tasks which have been
+  // removed from a run queue but not yet started or put on the list
+  // of a Task_token.  This is changed atomically.
+  volatile int queued_;
+  // Incremented each time a task is put on a run queue.  A thread
+  // going to sleep uses this to check that no task was queued after
+  // it last looked at the run queues.  This is changed atomically.
+  volatile int generation_;
+  // Number of threads sleeping on condvar_, or about to.  This is
+  // changed atomically.
+  volatile int sleeping_;
   // Number of tasks currently running.
   int running_;
   // Number of tasks waiting for a lock to release.
   int waiting_;
+  // Whether to collect the statistics printed by print_stats.
+  bool collect_stats_;
+  // Whether to record the task trace.
+  bool trace_;
+  // The wall clock time at which the trace started, in microseconds.
+  uint64_t trace_start_;
+  // The task trace.  This is protected by lock_.
+  std::vector<Trace_entry> trace_entries_;
+  // Changes to the number of threads.  This is protected by lock_.
+  std::vector<Trace_thread_count> trace_thread_counts_;
   // Condition variable associated with lock_.  This is signalled when
   // there may be a new Task to execute.
   Condvar condvar_;
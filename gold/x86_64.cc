@@ -1041,6 +1041,31 @@ class Target_x86_64 : public Sized_target<size, false>
     bool skip_call_tls_get_addr_;
   };
 
+  // The relocations which relocate_section applies directly in
+  // sections which are not allocated.
+  class Relocate_abs
+  {
+   public:
+    static int
+    width(unsigned int r_type,
+	  typename Relocate_functions<size, false>::Overflow_check* check)
+    {
+      switch (r_type)
+	{
+	case elfcpp::R_X86_64_64:
+	  return 8;
+	case elfcpp::R_X86_64_32:
+	  *check = Relocate_functions<size, false>::CHECK_UNSIGNED;
+	  return 4;
+	case elfcpp::R_X86_64_32S:
+	  *check = Relocate_functions<size, false>::CHECK_SIGNED;
+	  return 4;
+	default:
+	  return 0;
+	}
+    }
+  };
+
   // Check if relocation against this symbol is a candidate for
   // conversion from
   // mov foo@GOTPCREL(%rip), %reg
@@ -2749,6 +2774,12 @@ Target_x86_64<size>::reserve_global_got_entry(unsigned int got_index,
 	    rela_dyn->add_global_relative(gsym, elfcpp::R_X86_64_RELATIVE,
 					  this->got_, got_offset, 0, false);
 	}
+      else
+	{
+	  // The symbol may have moved, and no dynamic relocation will
+	  // set the entry, so write its new value.
+	  this->got_->replace_global(got_index, gsym);
+	}
       break;
     case GOT_TYPE_TLS_OFFSET:
       rela_dyn->add_global_relative(gsym, elfcpp::R_X86_64_TPOFF64,
@@ -5288,8 +5319,9 @@ Target_x86_64<size>::relocate_section(
 
   gold_assert(sh_type == elfcpp::SHT_RELA);
 
-  gold::relocate_section<size, false, Target_x86_64<size>, Relocate,
-			 gold::Default_comdat_behavior, Classify_reloc>(
+  gold::relocate_section_batched<size, false, Target_x86_64<size>, Relocate,
+				 gold::Default_comdat_behavior, Classify_reloc,
+				 Relocate_abs>(
     relinfo,
     this,
     prelocs,
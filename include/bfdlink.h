@@ -441,6 +441,10 @@ struct bfd_link_info
      caching ELF symbol buffer.  */
   unsigned int reduce_memory_overheads: 1;
 
+  /* TRUE if the final link may use worker threads to relocate input
+     sections.  */
+  unsigned int threads: 1;
+
   /* TRUE if the output file should be in a traditional format.  This
      is equivalent to the setting of the BFD_TRADITIONAL_FORMAT flag
      on the output file, but may be checked when reading the input
@@ -654,6 +658,10 @@ struct bfd_link_info
      relaxation returning true in *AGAIN.  */
   int relax_trip;
 
+  /* The number of worker threads to use when THREADS is set, or 0 to
+     use one per processor.  */
+  unsigned int thread_count;
+
   /* > 0 to treat protected data defined in the shared library as
      reference external.  0 to treat it as internal.  -1 to let
      backend to decide.  */
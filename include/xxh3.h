@@ -0,0 +1,46 @@
+/* xxh3.h - Declarations for the XXH3 non-cryptographic hash function.
+   Copyright (C) 2023 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify it
+   under the terms of the GNU General Public License as published by the
+   Free Software Foundation; either version 2, or (at your option) any
+   later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street - Fifth Floor, Boston, MA 02110-1301, USA.  */
+
+#ifndef _XXH3_H
+#define _XXH3_H 1
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* The size in bytes of a 128-bit XXH3 hash.  */
+#define XXH3_128_DIGEST_SIZE 16
+
+/* Compute the 128-bit XXH3 hash, with a seed of zero and the default
+   secret, of the LEN bytes beginning at BUFFER.  The result is written
+   to the 16 bytes beginning at RESBLOCK in the canonical byte order of
+   the reference implementation: the high 64 bits first, each half
+   stored big endian.  Return RESBLOCK.
+
+   XXH3 is not a cryptographic hash.  It is meant for uses such as
+   build IDs, where speed on large inputs matters and collisions need
+   only be unlikely.  */
+extern void *xxh3_128_buffer (const char *buffer, size_t len,
+			      void *resblock);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -50,6 +50,7 @@ fragment <<EOF
 #include "elf-bfd.h"
 #include "ldelf.h"
 #include "ldelfgen.h"
+#include "ldbuildid.h"
 
 /* Declare functions used by various EXTRA_EM_FILEs.  */
 static void gld${EMULATION_NAME}_before_parse (void);
@@ -572,6 +573,7 @@ enum elf_options
   OPTION_EXCLUDE_LIBS,
   OPTION_HASH_STYLE,
   OPTION_BUILD_ID,
+  OPTION_BUILD_ID_TREE_MIN_SIZE,
   OPTION_PACKAGE_METADATA,
   OPTION_AUDIT,
   OPTION_COMPRESS_DEBUG
@@ -603,6 +605,8 @@ EOF
 fi
 fragment <<EOF
     {"build-id", optional_argument, NULL, OPTION_BUILD_ID},
+    {"build-id-min-file-size-for-treehash", required_argument, NULL,
+     OPTION_BUILD_ID_TREE_MIN_SIZE},
     {"package-metadata", optional_argument, NULL, OPTION_PACKAGE_METADATA},
     {"compress-debug-sections", required_argument, NULL, OPTION_COMPRESS_DEBUG},
 EOF
@@ -652,6 +656,17 @@ gld${EMULATION_NAME}_handle_option (int optc)
 	ldelf_emit_note_gnu_build_id = xstrdup (optarg);
       break;
 
+    case OPTION_BUILD_ID_TREE_MIN_SIZE:
+      {
+	const char *end;
+
+	build_id_tree_min_size = bfd_scan_vma (optarg, &end, 0);
+	if (*optarg == '\0' || *end != '\0')
+	  einfo (_("%F%P: invalid build ID tree hash minimum size \`%s'\n"),
+		 optarg);
+      }
+      break;
+
     case OPTION_PACKAGE_METADATA:
       free ((char *) ldelf_emit_note_fdo_package_metadata);
       ldelf_emit_note_fdo_package_metadata = NULL;
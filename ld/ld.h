@@ -100,6 +100,9 @@ struct wildcard_spec
   struct name_list *exclude_name_list;
   struct flag_info *section_flag_list;
   size_t namelen, prefixlen, suffixlen;
+  /* NAME after its literal prefix compiled for quick matching, or
+     NULL if that has to go through fnmatch.  */
+  const struct wild_glob *glob;
   sort_type sorted;
 };
 
@@ -23,6 +23,8 @@
 #include "safe-ctype.h"
 #include "md5.h"
 #include "sha1.h"
+#include "xxh3.h"
+#include "libiberty.h"
 #include "ldbuildid.h"
 #ifdef __MINGW32__
 #include <windows.h>
@@ -35,6 +37,7 @@ bool
 validate_build_id_style (const char *style)
 {
   if ((streq (style, "md5")) || (streq (style, "sha1"))
+      || (streq (style, "tree")) || (streq (style, "xxhash"))
       || (streq (style, "uuid")) || (startswith (style, "0x")))
     return true;
 
@@ -44,10 +47,11 @@ validate_build_id_style (const char *style)
 bfd_size_type
 compute_build_id_size (const char *style)
 {
-  if (streq (style, "md5") || streq (style, "uuid"))
+  if (streq (style, "md5") || streq (style, "uuid")
+      || streq (style, "xxhash"))
     return 128 / 8;
 
-  if (streq (style, "sha1"))
+  if (streq (style, "sha1") || streq (style, "tree"))
     return 160 / 8;
 
   if (startswith (style, "0x"))
@@ -93,6 +97,153 @@ read_hex (const char xdigit)
   return 0;
 }
 
+/* The "tree" and "xxhash" styles hash the contents in chunks of this
+   many bytes, and then hash the string of chunk hashes.  This is the
+   same as gold's default --build-id-chunk-size-for-treehash.  */
+#define BUILD_ID_CHUNK_SIZE (2 << 20)
+
+/* The "tree" style only hashes in chunks when the contents are at least
+   this large, and is the same as "sha1" otherwise.  This is the same as
+   gold's --build-id-min-file-size-for-treehash.  */
+bfd_size_type build_id_tree_min_size = 40 << 20;
+
+/* The state of a chunked build ID computation.  */
+
+struct chunk_hash_ctx
+{
+  /* The contents of the current chunk.  */
+  unsigned char *buf;
+  /* The number of bytes in BUF.  */
+  size_t len;
+  /* The size and function of the hash of each chunk.  */
+  size_t hash_size;
+  void *(*hash_chunk) (const char *, size_t, void *);
+  /* The hashes of the chunks completed so far.  */
+  unsigned char *hashes;
+  size_t num_hashes;
+  size_t max_hashes;
+  /* The number of bytes seen so far.  */
+  bfd_size_type total;
+  /* If not NULL, a flat SHA-1 of the contents, kept until TOTAL reaches
+     build_id_tree_min_size.  */
+  struct sha1_ctx *sha1;
+};
+
+/* Append the hash of LEN bytes at P to the list of chunk hashes.  */
+
+static void
+chunk_hash_add (struct chunk_hash_ctx *ctx, const unsigned char *p,
+		size_t len)
+{
+  if (ctx->num_hashes == ctx->max_hashes)
+    {
+      ctx->max_hashes = ctx->max_hashes == 0 ? 64 : ctx->max_hashes * 2;
+      ctx->hashes = xrealloc (ctx->hashes, ctx->max_hashes * ctx->hash_size);
+    }
+  ctx->hash_chunk ((const char *) p, len,
+		   ctx->hashes + ctx->num_hashes * ctx->hash_size);
+  ctx->num_hashes++;
+}
+
+/* A sum_fn which adds LEN bytes at BUFFER to the chunked hash CTX.
+   A chunk is only hashed once more bytes follow it, so that contents
+   which fit in one chunk can be hashed directly.  Whole chunks are
+   hashed in place rather than copied.  */
+
+static void
+chunk_hash_process_bytes (const void *buffer, size_t len, void *data)
+{
+  struct chunk_hash_ctx *ctx = (struct chunk_hash_ctx *) data;
+  const unsigned char *p = (const unsigned char *) buffer;
+
+  if (ctx->sha1 != NULL)
+    {
+      sha1_process_bytes (buffer, len, ctx->sha1);
+      if (ctx->total + len >= build_id_tree_min_size)
+	ctx->sha1 = NULL;
+    }
+  ctx->total += len;
+
+  while (len > 0)
+    {
+      size_t n;
+
+      if (ctx->len == BUILD_ID_CHUNK_SIZE)
+	{
+	  chunk_hash_add (ctx, ctx->buf, ctx->len);
+	  ctx->len = 0;
+	}
+      if (ctx->len == 0 && len > BUILD_ID_CHUNK_SIZE)
+	{
+	  chunk_hash_add (ctx, p, BUILD_ID_CHUNK_SIZE);
+	  p += BUILD_ID_CHUNK_SIZE;
+	  len -= BUILD_ID_CHUNK_SIZE;
+	  continue;
+	}
+      n = BUILD_ID_CHUNK_SIZE - ctx->len;
+      if (n > len)
+	n = len;
+      memcpy (ctx->buf + ctx->len, p, n);
+      ctx->len += n;
+      p += n;
+      len -= n;
+    }
+}
+
+/* Compute a chunked build ID of the contents of ABFD.  Each chunk of
+   BUILD_ID_CHUNK_SIZE bytes is hashed with HASH_CHUNK, which produces
+   HASH_SIZE bytes, and the string of those hashes is hashed with
+   HASH_FINAL into ID_BITS.  If the contents fit in a single chunk they
+   are hashed directly with HASH_FINAL.  If SHA1_BELOW_MIN is true and
+   the contents are smaller than build_id_tree_min_size, ID_BITS is
+   their SHA-1 instead.  The chunks are hashed one after another, as
+   the contents are read; ld has no worker threads to spread them
+   over, unlike gold.  */
+
+static bool
+generate_chunked_build_id (bfd *abfd,
+			   checksum_fn checksum_contents,
+			   unsigned char *id_bits,
+			   size_t hash_size,
+			   void *(*hash_chunk) (const char *, size_t, void *),
+			   void *(*hash_final) (const char *, size_t, void *),
+			   bool sha1_below_min)
+{
+  struct chunk_hash_ctx ctx;
+  struct sha1_ctx sha1;
+  bool ret;
+
+  memset (&ctx, 0, sizeof (ctx));
+  ctx.buf = xmalloc (BUILD_ID_CHUNK_SIZE);
+  ctx.hash_size = hash_size;
+  ctx.hash_chunk = hash_chunk;
+  if (sha1_below_min && build_id_tree_min_size > 0)
+    {
+      sha1_init_ctx (&sha1);
+      ctx.sha1 = &sha1;
+    }
+
+  ret = (*checksum_contents) (abfd, chunk_hash_process_bytes, &ctx);
+  if (ret)
+    {
+      if (ctx.sha1 != NULL)
+	sha1_finish_ctx (ctx.sha1, id_bits);
+      else if (ctx.num_hashes == 0)
+	hash_final ((const char *) ctx.buf, ctx.len, id_bits);
+      else
+	{
+	  if (ctx.len > 0)
+	    chunk_hash_add (&ctx, ctx.buf, ctx.len);
+	  hash_final ((const char *) ctx.hashes,
+		      ctx.num_hashes * ctx.hash_size, id_bits);
+	}
+    }
+
+  free (ctx.hashes);
+  free (ctx.buf);
+  return ret;
+}
+
 bool
 generate_build_id (bfd *abfd,
 		   const char *style,
@@ -118,6 +269,21 @@ generate_build_id (bfd *abfd,
 	return false;
       sha1_finish_ctx (&ctx, id_bits);
     }
+  else if (streq (style, "tree"))
+    {
+      /* MD5 of each chunk and SHA-1 of the hashes, as gold does, or
+	 SHA-1 of small outputs.  */
+      if (!generate_chunked_build_id (abfd, checksum_contents, id_bits,
+				      16, md5_buffer, sha1_buffer, true))
+	return false;
+    }
+  else if (streq (style, "xxhash"))
+    {
+      if (!generate_chunked_build_id (abfd, checksum_contents, id_bits,
+				      XXH3_128_DIGEST_SIZE, xxh3_128_buffer,
+				      xxh3_128_buffer, false))
+	return false;
+    }
   else if (streq (style, "uuid"))
     {
 #ifndef __MINGW32__
@@ -36,4 +36,6 @@ typedef bool (*checksum_fn) (bfd *,
 extern bool
 generate_build_id (bfd *, const char *, checksum_fn, unsigned char *, int);
 
+extern bfd_size_type build_id_tree_min_size;
+
 #endif /* LDBUILDID_H */
@@ -218,6 +218,187 @@ name_match (const char *pattern, const char *name)
   return strcmp (pattern, name);
 }
 
+/* A glob compiled for matching without going through fnmatch.  Only
+   the part of the fnmatch syntax whose meaning doesn't depend on the
+   locale or the environment is compiled, see compile_wild_glob.  */
+
+enum wild_glob_op
+{
+  glob_char,
+  glob_any,
+  glob_star,
+  glob_set
+};
+
+struct wild_glob_token
+{
+  enum wild_glob_op op;
+  /* The character matched by glob_char.  */
+  unsigned char c;
+  /* The characters matched by glob_set.  */
+  unsigned char set[256 / CHAR_BIT];
+};
+
+struct wild_glob
+{
+  size_t count;
+  struct wild_glob_token tokens[1];
+};
+
+/* Add the characters from LO to HI inclusive to SET.  */
+
+static void
+wild_glob_set_range (unsigned char *set, unsigned int lo, unsigned int hi)
+{
+  for (; lo <= hi; lo++)
+    set[lo / CHAR_BIT] |= 1 << (lo % CHAR_BIT);
+}
+
+/* Compile PATTERN for wild_glob_match.  Return NULL if PATTERN uses
+   anything beyond plain ASCII characters, escapes, '?', '*' and simple
+   bracket expressions, leaving it to fnmatch.  */
+
+static const struct wild_glob *
+compile_wild_glob (const char *pattern)
+{
+  struct wild_glob *glob;
+  struct wild_glob_token *tok;
+  const unsigned char *p = (const unsigned char *) pattern;
+
+  glob = stat_alloc (sizeof (*glob)
+		     + strlen (pattern) * sizeof (glob->tokens[0]));
+  glob->count = 0;
+  for (; *p != 0; p++)
+    {
+      if (*p >= 0x80)
+	goto unsupported;
+
+      tok = &glob->tokens[glob->count];
+      switch (*p)
+	{
+	case '*':
+	  /* Consecutive stars match the same as a single one.  */
+	  if (glob->count != 0 && tok[-1].op == glob_star)
+	    continue;
+	  tok->op = glob_star;
+	  break;
+
+	case '?':
+	  tok->op = glob_any;
+	  break;
+
+	case '\\':
+	  if (p[1] == 0 || p[1] >= 0x80)
+	    goto unsupported;
+	  tok->op = glob_char;
+	  tok->c = *++p;
+	  break;
+
+	case '[':
+	  {
+	    const unsigned char *q = p + 1;
+	    bool negate = *q == '!';
+	    bool first = true;
+	    unsigned int i;
+
+	    /* '^' only negates when POSIXLY_CORRECT is unset.  */
+	    if (*q == '^')
+	      goto unsupported;
+	    if (negate)
+	      q++;
+	    memset (tok->set, 0, sizeof (tok->set));
+	    for (; *q != ']' || first; first = false)
+	      {
+		unsigned int lo = *q++;
+
+		/* Unterminated brackets, escapes, character classes,
+		   equivalence classes and collating symbols are all
+		   left to fnmatch.  */
+		if (lo == 0 || lo == '\\' || lo >= 0x80
+		    || (lo == '[' && (*q == ':' || *q == '=' || *q == '.')))
+		  goto unsupported;
+		if (*q == '-' && q[1] != ']' && q[1] != 0)
+		  {
+		    unsigned int hi = q[1];
+		    if (hi == '\\' || hi == '[' || hi >= 0x80 || hi < lo)
+		      goto unsupported;
+		    wild_glob_set_range (tok->set, lo, hi);
+		    q += 2;
+		  }
+		else
+		  wild_glob_set_range (tok->set, lo, lo);
+	      }
+	    if (negate)
+	      for (i = 0; i < sizeof (tok->set); i++)
+		tok->set[i] = ~tok->set[i];
+	    tok->op = glob_set;
+	    p = q;
+	  }
+	  break;
+
+	default:
+	  tok->op = glob_char;
+	  tok->c = *p;
+	  break;
+	}
+      glob->count++;
+    }
+  return glob;
+
+ unsupported:
+  /* GLOB is the last thing allocated, so this frees only it.  */
+  obstack_free (&stat_obstack, glob);
+  return NULL;
+}
+
+/* Match NAME against GLOB.  Return 1 on a match, 0 if there's no
+   match, or -1 if NAME has characters that fnmatch might treat as
+   part of a multibyte sequence, in which case fnmatch must decide.  */
+
+static int
+wild_glob_match (const struct wild_glob *glob, const char *name)
+{
+  const unsigned char *n = (const unsigned char *) name;
+  const unsigned char *star_n = NULL;
+  size_t p = 0, star_p = 0;
+
+  while (*n != 0)
+    {
+      const struct wild_glob_token *tok = &glob->tokens[p];
+
+      if (*n >= 0x80)
+	return -1;
+
+      if (p < glob->count && tok->op == glob_star)
+	{
+	  star_p = ++p;
+	  star_n = n;
+	  continue;
+	}
+
+      if (p < glob->count
+	  && (tok->op == glob_any
+	      || (tok->op == glob_char && tok->c == *n)
+	      || (tok->op == glob_set
+		  && (tok->set[*n / CHAR_BIT] & (1 << (*n % CHAR_BIT))) != 0)))
+	{
+	  p++;
+	  n++;
+	  continue;
+	}
+
+      /* Let the last star swallow one more character and retry.  */
+      if (star_n == NULL)
+	return 0;
+      p = star_p;
+      n = ++star_n;
+    }
+
+  while (p < glob->count && glob->tokens[p].op == glob_star)
+    p++;
+  return p == glob->count;
+}
+
 /* Given an analyzed wildcard_spec SPEC, match it against NAME,
    returns zero on a match, non-zero if there's no match.  */
 
@@ -254,7 +435,15 @@ spec_match (const struct wildcard_spec *spec, const char *name)
     return 0;
 
   if (nl > pl)
-    return fnmatch (spec->name + pl, name + pl, 0);
+    {
+      if (spec->glob != NULL)
+	{
+	  r = wild_glob_match (spec->glob, name + pl);
+	  if (r >= 0)
+	    return !r;
+	}
+      return fnmatch (spec->name + pl, name + pl, 0);
+    }
 
   if (inputlen >= nl)
     return name[nl];
@@ -405,18 +594,13 @@ add_matching_section (lang_wild_statement_type *ptr,
   new_section->input_stmt = file;
 }
 
-/* Process section S (from input file FILE) in relation to wildcard
-   statement PTR.  We already know that a prefix of the name of S matches
-   some wildcard in PTR's wildcard list.  Here we check if the filename
-   matches as well (if it's specified) and if any of the wildcards in fact
-   does match.  */
+/* Return true if input FILE matches the filename of wildcard statement
+   PTR (if it's specified) and is not excluded by it.  */
 
-static void
-walk_wild_section_match (lang_wild_statement_type *ptr,
-			 lang_input_statement_type *file,
-			 asection *s)
+static bool
+walk_wild_file_match (lang_wild_statement_type *ptr,
+		      lang_input_statement_type *file)
 {
-  struct wildcard_list *sec;
   const char *file_spec = ptr->filename;
   char *p;
 
@@ -426,12 +610,12 @@ walk_wild_section_match (lang_wild_statement_type *ptr,
   else if ((p = archive_path (file_spec)) != NULL)
     {
       if (!input_statement_is_archive_path (file_spec, p, file))
-	return;
+	return false;
     }
   else if (wildcardp (file_spec))
     {
       if (fnmatch (file_spec, file->filename, 0) != 0)
-	return;
+	return false;
     }
   else
     {
@@ -458,11 +642,34 @@ walk_wild_section_match (lang_wild_statement_type *ptr,
 	       && filename_cmp (arch_is->local_sym_name, file_spec) == 0)
 	;
       else
-	return;
+	return false;
     }
 
   /* If filename is excluded we're done.  */
-  if (walk_wild_file_in_exclude_list (ptr->exclude_name_list, file))
+  return !walk_wild_file_in_exclude_list (ptr->exclude_name_list, file);
+}
+
+/* Process section S (from input file FILE) in relation to wildcard
+   statement PTR.  We already know that a prefix of the name of S matches
+   some wildcard in PTR's wildcard list.  Here we check if the filename
+   matches as well (if it's specified) and if any of the wildcards in fact
+   does match.  */
+
+static void
+walk_wild_section_match (lang_wild_statement_type *ptr,
+			 lang_input_statement_type *file,
+			 asection *s)
+{
+  struct wildcard_list *sec;
+
+  /* The sections of a file are all matched in a row, so only check
+     the file once for all of them.  */
+  if (ptr->last_file != file)
+    {
+      ptr->last_file = file;
+      ptr->last_file_match = walk_wild_file_match (ptr, file);
+    }
+  if (!ptr->last_file_match)
     return;
 
   /* Check section name against each wildcard spec.  If there's no
@@ -682,7 +889,9 @@ wild_sort (lang_wild_statement_type *wild,
   return tree;
 }
 
-/* Use wild_sort to build a BST to sort sections.  */
+/* Record a section matched by a sorted wild statement.  The matches
+   are sorted once the whole statement has been walked, see
+   wild_sort_matches.  */
 
 static void
 output_section_callback_sort (lang_wild_statement_type *ptr,
@@ -691,8 +900,7 @@ output_section_callback_sort (lang_wild_statement_type *ptr,
 			      lang_input_statement_type *file,
 			      void *output)
 {
-  lang_section_bst_type *node;
-  lang_section_bst_type **tree;
+  lang_section_match_type *match;
   lang_output_section_statement_type *os;
 
   os = (lang_output_section_statement_type *) output;
@@ -700,18 +908,41 @@ output_section_callback_sort (lang_wild_statement_type *ptr,
   if (unique_section_p (section, os))
     return;
 
-  /* Don't add sections to the tree when we already know that
-     lang_add_section won't do anything with it.  */
+  /* Don't record sections when we already know that
+     lang_add_section won't do anything with them.  */
   if (wont_add_section_p (section, os))
     return;
 
+  if (ptr->match_count == ptr->match_alloc)
+    {
+      ptr->match_alloc = ptr->match_alloc ? 2 * ptr->match_alloc : 64;
+      ptr->matches = xrealloc (ptr->matches,
+			       ptr->match_alloc * sizeof (*ptr->matches));
+    }
+  match = &ptr->matches[ptr->match_count];
+  match->section = section;
+  match->sec = sec;
+  match->file = file;
+  match->seq = ptr->match_count;
+  ptr->match_count++;
+}
+
+/* Insert MATCH into the BST of wild statement PTR.  */
+
+static void
+wild_sort_insert (lang_wild_statement_type *ptr,
+		  const lang_section_match_type *match)
+{
+  lang_section_bst_type *node;
+  lang_section_bst_type **tree;
+
   node = (lang_section_bst_type *) xmalloc (sizeof (lang_section_bst_type));
   node->left = 0;
   node->right = 0;
-  node->section = section;
+  node->section = match->section;
   node->pattern = ptr->section_list;
 
-  tree = wild_sort (ptr, sec, file, section);
+  tree = wild_sort (ptr, match->sec, match->file, match->section);
   if (tree != NULL)
     {
       *tree = node;
@@ -740,6 +971,155 @@ output_section_callback_tree_to_list (lang_wild_statement_type *ptr,
   free (tree);
 }
 
+/* The section sort used for MATCH, or none.  */
+
+static sort_type
+match_section_sort (const lang_section_match_type *match)
+{
+  if (match->sec == NULL || match->sec->spec.sorted == by_none)
+    return none;
+  return match->sec->spec.sorted;
+}
+
+/* Names used to sort MATCH by file, as done by wild_sort.  */
+
+static void
+match_sort_filenames (const lang_section_match_type *match,
+		      const char **outer, const char **inner)
+{
+  bfd *abfd = match->section->owner;
+
+  *inner = sort_filename (abfd);
+  if (abfd->my_archive != NULL)
+    *outer = sort_filename (abfd->my_archive);
+  else
+    *outer = *inner;
+}
+
+/* The wild statement whose matches are being sorted by
+   compare_section_match.  */
+static lang_wild_statement_type *sorting_wild;
+
+/* qsort comparison function for the matches of a wild statement.
+   This orders matches the same way as the in-order walk of the BST
+   built by wild_sort: ties are kept in match order.  */
+
+static int
+compare_section_match (const void *a, const void *b)
+{
+  const lang_section_match_type *am = a;
+  const lang_section_match_type *bm = b;
+  sort_type sort;
+  int ret;
+
+  if (sorting_wild->filenames_sorted)
+    {
+      const char *aouter, *ainner, *bouter, *binner;
+
+      match_sort_filenames (am, &aouter, &ainner);
+      match_sort_filenames (bm, &bouter, &binner);
+      ret = filename_cmp (aouter, bouter);
+      if (ret == 0)
+	ret = filename_cmp (ainner, binner);
+      if (ret != 0)
+	return ret;
+    }
+
+  sort = match_section_sort (am);
+  if (sort != none)
+    {
+      ret = compare_section (sort, am->section, bm->section);
+      if (ret != 0)
+	return ret;
+    }
+
+  return am->seq < bm->seq ? -1 : am->seq > bm->seq;
+}
+
+/* Return TRUE if the matches of wild statement PTR can be put in
+   order with a single sort.  That is the case when they are all
+   compared the same way, so that the order does not depend on the
+   shape of the BST wild_sort would build.  */
+
+static bool
+wild_matches_sortable_p (lang_wild_statement_type *ptr)
+{
+  sort_type sort;
+  int priority_sign = 0;
+  size_t i;
+
+  sort = match_section_sort (&ptr->matches[0]);
+  for (i = 0; i < ptr->match_count; i++)
+    {
+      if (match_section_sort (&ptr->matches[i]) != sort)
+	return false;
+
+      /* Sections without an init priority are compared by name,
+	 both with each other and with sections that have one.  Mixing
+	 the two does not give a consistent order.  */
+      if (sort == by_init_priority)
+	{
+	  int sign = get_init_priority (ptr->matches[i].section) < 0 ? -1 : 1;
+	  if (priority_sign == 0)
+	    priority_sign = sign;
+	  else if (priority_sign != sign)
+	    return false;
+	}
+    }
+  return true;
+}
+
+/* Put the matches recorded for wild statement PTR in order.  When
+   every match is compared the same way a stable sort gives the
+   same order as inserting them one at a time into a BST, without
+   the quadratic cost of the BST degenerating into a list when the
+   sections arrive already sorted.  Otherwise fall back to the BST,
+   whose order depends on its shape.  */
+
+static void
+wild_sort_matches (lang_wild_statement_type *ptr, void *output)
+{
+  size_t i;
+
+  if (ptr->match_count == 0)
+    return;
+
+  if (wild_matches_sortable_p (ptr))
+    {
+      if (ptr->match_count > 1
+	  && (ptr->filenames_sorted
+	      || match_section_sort (&ptr->matches[0]) != none))
+	{
+	  sorting_wild = ptr;
+	  qsort (ptr->matches, ptr->match_count, sizeof (*ptr->matches),
+		 compare_section_match);
+	  sorting_wild = NULL;
+	}
+
+      for (i = 0; i < ptr->match_count; i++)
+	lang_add_section (&ptr->children, ptr->matches[i].section,
+			  ptr->section_list, ptr->section_flag_list,
+			  (lang_output_section_statement_type *) output);
+    }
+  else
+    {
+      for (i = 0; i < ptr->match_count; i++)
+	wild_sort_insert (ptr, &ptr->matches[i]);
+
+      if (ptr->tree)
+	{
+	  output_section_callback_tree_to_list (ptr, ptr->tree, output);
+	  ptr->tree = NULL;
+	  ptr->rightmost = &ptr->tree;
+	}
+    }
+
+  free (ptr->matches);
+  ptr->matches = NULL;
+  ptr->match_count = 0;
+  ptr->match_alloc = 0;
+}
+
 
 /* Sections are matched against wildcard statements via a prefix tree.
    The prefix tree holds prefixes of all matching patterns (up to the first
@@ -907,15 +1287,24 @@ analyze_walk_wild_section_handler (lang_wild_statement_type *ptr)
 
   ptr->tree = NULL;
   ptr->rightmost = &ptr->tree;
+  ptr->matches = NULL;
+  ptr->match_count = 0;
+  ptr->match_alloc = 0;
+  ptr->last_file = NULL;
+  ptr->last_file_match = false;
 
   for (sec = ptr->section_list; sec != NULL; sec = sec->next)
     {
+      sec->spec.glob = NULL;
       if (sec->spec.name)
 	{
 	  sec->spec.namelen = strlen (sec->spec.name);
 	  sec->spec.prefixlen = strcspn (sec->spec.name, "?*[");
 	  sec->spec.suffixlen = rstrcspn (sec->spec.name + sec->spec.prefixlen,
 					  "?*]");
+	  if (sec->spec.namelen > sec->spec.prefixlen)
+	    sec->spec.glob
+	      = compile_wild_glob (sec->spec.name + sec->spec.prefixlen);
 	}
       else
 	sec->spec.namelen = sec->spec.prefixlen = sec->spec.suffixlen = 0;
@@ -3118,17 +3507,8 @@ wild (lang_wild_statement_type *s,
 
   if (s->filenames_sorted || s->any_specs_sorted)
     {
-      lang_section_bst_type *tree;
-
       walk_wild (s, output_section_callback_sort, output);
-
-      tree = s->tree;
-      if (tree)
-	{
-	  output_section_callback_tree_to_list (s, tree, output);
-	  s->tree = NULL;
-	  s->rightmost = &s->tree;
-	}
+      wild_sort_matches (s, output);
     }
   else
     walk_wild (s, output_section_callback_nosort, output);
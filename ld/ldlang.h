@@ -388,6 +388,16 @@ typedef struct lang_section_bst
   struct lang_section_bst *right;
 } lang_section_bst_type;
 
+/* A section matched by a sorted wild statement, recorded in match
+   order so that all the matches can be sorted at once.  */
+typedef struct lang_section_match
+{
+  asection *section;
+  struct wildcard_list *sec;
+  lang_input_statement_type *file;
+  size_t seq;
+} lang_section_match_type;
+
 struct lang_wild_statement_struct
 {
   lang_statement_header_type header;
@@ -399,8 +409,14 @@ struct lang_wild_statement_struct
   lang_statement_list_type children;
   struct name_list *exclude_name_list;
   lang_statement_list_type matching_sections;
+  /* The input file last checked against FILENAME and
+     EXCLUDE_NAME_LIST, and whether it matched.  */
+  lang_input_statement_type *last_file;
+  bool last_file_match;
 
   lang_section_bst_type *tree, **rightmost;
+  lang_section_match_type *matches;
+  size_t match_count, match_alloc;
   struct flag_info *section_flag_list;
 };
 
@@ -377,6 +377,11 @@ main (int argc, char **argv)
   if (config.hash_table_size != 0)
     bfd_hash_set_default_size (config.hash_table_size);
 
+  /* Let BFD compress and decompress large sections on several
+     threads only with --threads.  */
+  if (link_info.threads)
+    bfd_set_thread_count (link_info.thread_count);
+
 #if BFD_SUPPORTS_PLUGINS
   /* Now all the plugin arguments have been gathered, we can load them.  */
   plugin_load_plugins ();
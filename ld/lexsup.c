@@ -499,6 +499,14 @@ static const struct ld_option ld_options[] =
     '\0', NULL, N_("Display target specific options"), TWO_DASHES },
   { {"task-link", required_argument, NULL, OPTION_TASK_LINK},
     '\0', N_("SYMBOL"), N_("Do task level linking"), TWO_DASHES },
+  { {"threads", no_argument, NULL, OPTION_THREADS},
+    '\0', NULL, N_("Relocate debugging sections on several threads"),
+    TWO_DASHES },
+  { {"no-threads", no_argument, NULL, OPTION_NO_THREADS},
+    '\0', NULL, N_("Do not use worker threads (default)"), TWO_DASHES },
+  { {"thread-count", required_argument, NULL, OPTION_THREAD_COUNT},
+    '\0', N_("COUNT"), N_("Use COUNT threads with --threads"),
+    TWO_DASHES },
   { {"traditional-format", no_argument, NULL, OPTION_TRADITIONAL_FORMAT},
     '\0', NULL, N_("Use same format as native linker"), TWO_DASHES },
   { {"section-start", required_argument, NULL, OPTION_SECTION_START},
@@ -1715,6 +1723,24 @@ parse_args (unsigned argc, char **argv)
 	    config.hash_table_size = 1021;
 	  break;
 
+	case OPTION_THREADS:
+	  link_info.threads = true;
+	  break;
+
+	case OPTION_NO_THREADS:
+	  link_info.threads = false;
+	  break;
+
+	case OPTION_THREAD_COUNT:
+	  {
+	    char *end;
+	    unsigned int count = strtoul (optarg, &end, 0);
+	    if (*end != '\0' || count == 0)
+	      einfo (_("%F%P: invalid thread count: %s\n"), optarg);
+	    link_info.thread_count = count;
+	  }
+	  break;
+
 	case OPTION_MAX_CACHE_SIZE:
 	  {
 	    char *end;
@@ -2220,6 +2246,10 @@ elf_static_list_options (FILE *file)
   fprintf (file, _("\
   --build-id[=STYLE]          Generate build ID note\n"));
   fprintf (file, _("\
+  --build-id-min-file-size-for-treehash=SIZE\n\
+                              Minimum size for --build-id=tree to differ\n\
+                                from --build-id=sha1\n"));
+  fprintf (file, _("\
   --package-metadata[=JSON]   Generate package metadata note\n"));
   fprintf (file, _("\
   --compress-debug-sections=[none|zlib|zlib-gnu|zlib-gabi|zstd]\n\
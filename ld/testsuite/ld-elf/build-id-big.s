@@ -0,0 +1,2 @@
+	.data
+	.space 0x300000, 0x5a
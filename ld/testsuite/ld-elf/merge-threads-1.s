@@ -0,0 +1,31 @@
+	.text
+	.globl _start
+_start:
+	.long 0
+
+	.section .rodata.str1.1,"aMS",%progbits,1
+	.irpc i,0123456789
+	.irpc j,0123456789
+	.irpc k,0123456789
+	.irpc l,0123456789
+	.asciz "file1_\i\j\k\l"
+	.asciz "shared_\i\j\k\l"
+	.asciz "\i\j\k\l"
+	.asciz "x1_\i\j\k\l-str"
+	.endr
+	.endr
+	.endr
+	.endr
+
+	.section .debug_str,"MS",%progbits,1
+	.irpc i,0123456789
+	.irpc j,0123456789
+	.irpc k,0123456789
+	.irpc l,0123456789
+	.asciz "debug_\i\j\k\l"
+	.asciz "name1_\i\j\k\l"
+	.asciz "_\i\j\k\l"
+	.endr
+	.endr
+	.endr
+	.endr
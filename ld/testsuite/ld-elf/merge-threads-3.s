@@ -0,0 +1,26 @@
+	.section .rodata.str1.1,"aMS",%progbits,1
+	.irpc i,0123456789
+	.irpc j,0123456789
+	.irpc k,0123456789
+	.irpc l,0123456789
+	.asciz "file3_\i\j\k\l"
+	.asciz "shared_\i\j\k\l"
+	.asciz "\i\j\k\l"
+	.asciz "x3_\i\j\k\l-str"
+	.endr
+	.endr
+	.endr
+	.endr
+
+	.section .debug_str,"MS",%progbits,1
+	.irpc i,0123456789
+	.irpc j,0123456789
+	.irpc k,0123456789
+	.irpc l,0123456789
+	.asciz "debug_\i\j\k\l"
+	.asciz "name3_\i\j\k\l"
+	.asciz "_\i\j\k\l"
+	.endr
+	.endr
+	.endr
+	.endr
@@ -0,0 +1,11 @@
+	.text
+	.globl	_start
+_start:
+	.long	0
+
+	.section	.debug_view,"",%progbits
+	.set	n, 0
+	.rept	65536
+	.long	n, n ^ 0x5a5a5a5a
+	.set	n, n + 1
+	.endr
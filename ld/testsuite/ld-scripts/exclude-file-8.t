@@ -0,0 +1,18 @@
+SECTIONS
+{
+	.pre 0x1000 : {
+		EXCLUDE_FILE (*8b.o) * (.text.pre*)
+	}
+
+	.suf 0x2000 : {
+		* (EXCLUDE_FILE (*8c.o) *.suf)
+	}
+
+	.set 0x3000 : {
+		*8[ab].o (.t?xt.[!a]*)
+	}
+
+	.star 0x4000 : {
+		* (*)
+	}
+}
@@ -0,0 +1,15 @@
+	.section .text.pre1,"ax"
+ap:
+	.long 0
+	.section .mid.suf,"ax"
+as:
+	.long 0
+	.section .tzxt.b2,"ax"
+at:
+	.long 0
+	.section .text.a1,"ax"
+aa:
+	.long 0
+	.section .other,"ax"
+ao:
+	.long 0
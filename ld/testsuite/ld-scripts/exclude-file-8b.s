@@ -0,0 +1,15 @@
+	.section .text.pre1,"ax"
+bp:
+	.long 0
+	.section .mid.suf,"ax"
+bs:
+	.long 0
+	.section .tzxt.b2,"ax"
+bt:
+	.long 0
+	.section .text.a1,"ax"
+ba:
+	.long 0
+	.section .other,"ax"
+bo:
+	.long 0
@@ -0,0 +1,15 @@
+	.section .text.pre1,"ax"
+cp:
+	.long 0
+	.section .mid.suf,"ax"
+cs:
+	.long 0
+	.section .tzxt.b2,"ax"
+ct:
+	.long 0
+	.section .text.a1,"ax"
+ca:
+	.long 0
+	.section .other,"ax"
+co:
+	.long 0
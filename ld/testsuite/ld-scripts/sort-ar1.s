@@ -0,0 +1,6 @@
+	.text
+ar1:
+	.long 0
+	.data
+ardata1:
+	.long 0
@@ -0,0 +1,6 @@
+	.text
+ar2:
+	.long 0
+	.data
+ardata2:
+	.long 0
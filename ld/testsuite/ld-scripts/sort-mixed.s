@@ -0,0 +1,14 @@
+	.section .text.n2,"ax"
+n2:
+	.long 0
+	.section .text.a1,"ax"
+	.p2align 2
+a1:
+	.long 0
+	.section .text.n1,"ax"
+n1:
+	.long 0
+	.section .text.a2,"ax"
+	.p2align 4
+a2:
+	.long 0
@@ -0,0 +1,5 @@
+SECTIONS
+{
+  .text : { *(SORT_BY_NAME(.text.n*) SORT_BY_ALIGNMENT(.text.a*)) }
+  /DISCARD/ : { *(*) }
+}
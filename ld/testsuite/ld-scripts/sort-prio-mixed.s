@@ -0,0 +1,15 @@
+	.section .init_array.00200,"aw"
+m200:
+	.quad 0
+	.section .init_array.zz,"aw"
+mzz:
+	.quad 0
+	.section .init_array.00100,"aw"
+m100:
+	.quad 0
+	.section .init_array.00300,"aw"
+m300:
+	.quad 0
+	.section .init_array.aa,"aw"
+maa:
+	.quad 0
@@ -0,0 +1,5 @@
+SECTIONS
+{
+  .init_array : { *(SORT_BY_INIT_PRIORITY(.init_array.*)) }
+  /DISCARD/ : { *(*) }
+}
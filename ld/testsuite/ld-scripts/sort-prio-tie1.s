@@ -0,0 +1,9 @@
+	.section .init_array.00200,"aw"
+p1_200:
+	.quad 0
+	.section .ctors.65435,"aw"
+c1_100:
+	.quad 0
+	.section .init_array.00100,"aw"
+p1_100:
+	.quad 0
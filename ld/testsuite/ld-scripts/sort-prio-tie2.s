@@ -0,0 +1,6 @@
+	.section .init_array.00100,"aw"
+p2_100:
+	.quad 0
+	.section .ctors.65335,"aw"
+c2_200:
+	.quad 0
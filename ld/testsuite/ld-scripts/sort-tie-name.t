@@ -0,0 +1,5 @@
+SECTIONS
+{
+  .text : { *(SORT_BY_NAME(.text.*)) }
+  /DISCARD/ : { *(*) }
+}
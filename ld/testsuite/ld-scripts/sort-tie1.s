@@ -0,0 +1,12 @@
+	.section .text.c,"ax"
+	.p2align 3
+c1:
+	.long 0
+	.section .text.b,"ax"
+	.p2align 3
+b1:
+	.long 0
+	.section .text.a,"ax"
+	.p2align 2
+a1:
+	.long 0
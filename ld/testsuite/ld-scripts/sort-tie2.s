@@ -0,0 +1,12 @@
+	.section .text.c,"ax"
+	.p2align 3
+c2:
+	.long 0
+	.section .text.b,"ax"
+	.p2align 3
+b2:
+	.long 0
+	.section .text.a,"ax"
+	.p2align 2
+a2:
+	.long 0
@@ -0,0 +1,3 @@
+	.section	.debug_info,"",@progbits
+	.quad	abs_sym + 2
+	.long	abs_sym + 3
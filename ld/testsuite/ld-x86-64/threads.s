@@ -0,0 +1,21 @@
+	.text
+	.globl	_start
+_start:
+	ret
+
+	.globl	abs_sym
+	.set	abs_sym, 0x12345678
+	.weak	weak_sym
+
+	.section	.debug_str,"MS",@progbits,1
+.Lstr1:
+	.string	"first"
+.Lstr2:
+	.string	"second"
+
+	.section	.debug_info,"",@progbits
+	.long	.Lstr1
+	.long	.Lstr2
+	.quad	abs_sym
+	.long	abs_sym + 1
+	.quad	weak_sym
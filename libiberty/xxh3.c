@@ -0,0 +1,536 @@
+/* xxh3.c - Compute the 128-bit XXH3 hash of a memory block.
+   Copyright (C) 2023 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify it
+   under the terms of the GNU General Public License as published by the
+   Free Software Foundation; either version 2, or (at your option) any
+   later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street - Fifth Floor, Boston, MA 02110-1301, USA.  */
+
+/* This is an implementation of the XXH3 128-bit hash, as specified by
+   the xxHash reference implementation (version 0.8), restricted to a
+   seed of zero and the default secret.  It produces the same values as
+   XXH3_128bits.  Inputs longer than 240 bytes are processed in 64-byte
+   stripes; on hosts with SSE2 the stripes are accumulated two lanes at
+   a time.  */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#if defined (__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "xxh3.h"
+
+typedef struct
+{
+  uint64_t low;
+  uint64_t high;
+} xxh3_uint128;
+
+#define PRIME32_1 0x9E3779B1U
+#define PRIME32_2 0x85EBCA77U
+#define PRIME32_3 0xC2B2AE3DU
+
+#define PRIME64_1 0x9E3779B185EBCA87ULL
+#define PRIME64_2 0xC2B2AE3D27D4EB4FULL
+#define PRIME64_3 0x165667B19E3779F9ULL
+#define PRIME64_4 0x85EBCA77C2B2AE63ULL
+#define PRIME64_5 0x27D4EB2F165667C5ULL
+
+#define PRIME_MX1 0x165667919E3779F9ULL
+#define PRIME_MX2 0x9FB21C651E98DF25ULL
+
+#define STRIPE_LEN 64
+#define SECRET_CONSUME_RATE 8
+#define ACC_NB (STRIPE_LEN / sizeof (uint64_t))
+#define SECRET_SIZE 192
+#define SECRET_MERGEACCS_START 11
+#define SECRET_LASTACC_START 7
+#define MIDSIZE_MAX 240
+#define MIDSIZE_STARTOFFSET 3
+#define MIDSIZE_LASTOFFSET 17
+#define SECRET_SIZE_MIN 136
+
+/* The default secret.  */
+static const unsigned char secret[SECRET_SIZE] =
+{
+  0xb8, 0xfe, 0x6c, 0x39, 0x23, 0xa4, 0x4b, 0xbe,
+  0x7c, 0x01, 0x81, 0x2c, 0xf7, 0x21, 0xad, 0x1c,
+  0xde, 0xd4, 0x6d, 0xe9, 0x83, 0x90, 0x97, 0xdb,
+  0x72, 0x40, 0xa4, 0xa4, 0xb7, 0xb3, 0x67, 0x1f,
+  0xcb, 0x79, 0xe6, 0x4e, 0xcc, 0xc0, 0xe5, 0x78,
+  0x82, 0x5a, 0xd0, 0x7d, 0xcc, 0xff, 0x72, 0x21,
+  0xb8, 0x08, 0x46, 0x74, 0xf7, 0x43, 0x24, 0x8e,
+  0xe0, 0x35, 0x90, 0xe6, 0x81, 0x3a, 0x26, 0x4c,
+  0x3c, 0x28, 0x52, 0xbb, 0x91, 0xc3, 0x00, 0xcb,
+  0x88, 0xd0, 0x65, 0x8b, 0x1b, 0x53, 0x2e, 0xa3,
+  0x71, 0x64, 0x48, 0x97, 0xa2, 0x0d, 0xf9, 0x4e,
+  0x38, 0x19, 0xef, 0x46, 0xa9, 0xde, 0xac, 0xd8,
+  0xa8, 0xfa, 0x76, 0x3f, 0xe3, 0x9c, 0x34, 0x3f,
+  0xf9, 0xdc, 0xbb, 0xc7, 0xc7, 0x0b, 0x4f, 0x1d,
+  0x8a, 0x51, 0xe0, 0x4b, 0xcd, 0xb4, 0x59, 0x31,
+  0xc8, 0x9f, 0x7e, 0xc9, 0xd9, 0x78, 0x73, 0x64,
+  0xea, 0xc5, 0xac, 0x83, 0x34, 0xd3, 0xeb, 0xc3,
+  0xc5, 0x81, 0xa0, 0xff, 0xfa, 0x13, 0x63, 0xeb,
+  0x17, 0x0d, 0xdd, 0x51, 0xb7, 0xf0, 0xda, 0x49,
+  0xd3, 0x16, 0x55, 0x26, 0x29, 0xd4, 0x68, 0x9e,
+  0x2b, 0x16, 0xbe, 0x58, 0x7d, 0x47, 0xa1, 0xfc,
+  0x8f, 0xf8, 0xb8, 0xd1, 0x7a, 0xd0, 0x31, 0xce,
+  0x45, 0xcb, 0x3a, 0x8f, 0x95, 0x16, 0x04, 0x28,
+  0xaf, 0xd7, 0xfb, 0xca, 0xbb, 0x4b, 0x40, 0x7e,
+};
+
+/* Read little endian values.  Compilers turn these into single loads
+   on little endian hosts.  */
+
+static inline uint32_t
+read32 (const unsigned char *p)
+{
+  return ((uint32_t) p[0]
+	  | ((uint32_t) p[1] << 8)
+	  | ((uint32_t) p[2] << 16)
+	  | ((uint32_t) p[3] << 24));
+}
+
+static inline uint64_t
+read64 (const unsigned char *p)
+{
+  return (uint64_t) read32 (p) | ((uint64_t) read32 (p + 4) << 32);
+}
+
+static inline void
+write64_be (unsigned char *p, uint64_t v)
+{
+  int i;
+
+  for (i = 7; i >= 0; --i)
+    {
+      p[i] = v & 0xff;
+      v >>= 8;
+    }
+}
+
+static inline uint32_t
+swap32 (uint32_t x)
+{
+  return (((x << 24) & 0xff000000U)
+	  | ((x << 8) & 0x00ff0000U)
+	  | ((x >> 8) & 0x0000ff00U)
+	  | ((x >> 24) & 0x000000ffU));
+}
+
+static inline uint64_t
+swap64 (uint64_t x)
+{
+  return ((uint64_t) swap32 ((uint32_t) x) << 32) | swap32 (x >> 32);
+}
+
+static inline uint32_t
+rotl32 (uint32_t x, int r)
+{
+  return (x << r) | (x >> (32 - r));
+}
+
+/* Return the full 128-bit product of A and B.  */
+
+static inline xxh3_uint128
+mult64to128 (uint64_t a, uint64_t b)
+{
+  xxh3_uint128 r;
+#if defined (__SIZEOF_INT128__)
+  __extension__ typedef unsigned __int128 uint128;
+  uint128 product = (uint128) a * b;
+  r.low = (uint64_t) product;
+  r.high = (uint64_t) (product >> 64);
+#else
+  uint64_t lo_lo = (a & 0xffffffff) * (b & 0xffffffff);
+  uint64_t hi_lo = (a >> 32) * (b & 0xffffffff);
+  uint64_t lo_hi = (a & 0xffffffff) * (b >> 32);
+  uint64_t hi_hi = (a >> 32) * (b >> 32);
+  uint64_t cross = (lo_lo >> 32) + (hi_lo & 0xffffffff) + lo_hi;
+  r.high = (hi_lo >> 32) + (cross >> 32) + hi_hi;
+  r.low = (cross << 32) | (lo_lo & 0xffffffff);
+#endif
+  return r;
+}
+
+static inline uint64_t
+mul128_fold64 (uint64_t a, uint64_t b)
+{
+  xxh3_uint128 product = mult64to128 (a, b);
+  return product.low ^ product.high;
+}
+
+static inline uint64_t
+xxh64_avalanche (uint64_t h)
+{
+  h ^= h >> 33;
+  h *= PRIME64_2;
+  h ^= h >> 29;
+  h *= PRIME64_3;
+  h ^= h >> 32;
+  return h;
+}
+
+static inline uint64_t
+xxh3_avalanche (uint64_t h)
+{
+  h ^= h >> 37;
+  h *= PRIME_MX1;
+  h ^= h >> 32;
+  return h;
+}
+
+/* Hash an input of 1 to 3 bytes.  */
+
+static xxh3_uint128
+hash_1to3 (const unsigned char *input, size_t len)
+{
+  uint8_t c1 = input[0];
+  uint8_t c2 = input[len >> 1];
+  uint8_t c3 = input[len - 1];
+  uint32_t combinedl = (((uint32_t) c1 << 16) | ((uint32_t) c2 << 24)
+			| ((uint32_t) c3 << 0) | ((uint32_t) len << 8));
+  uint32_t combinedh = rotl32 (swap32 (combinedl), 13);
+  uint64_t bitflipl = read32 (secret) ^ read32 (secret + 4);
+  uint64_t bitfliph = read32 (secret + 8) ^ read32 (secret + 12);
+  xxh3_uint128 h;
+
+  h.low = xxh64_avalanche ((uint64_t) combinedl ^ bitflipl);
+  h.high = xxh64_avalanche ((uint64_t) combinedh ^ bitfliph);
+  return h;
+}
+
+/* Hash an input of 4 to 8 bytes.  */
+
+static xxh3_uint128
+hash_4to8 (const unsigned char *input, size_t len)
+{
+  uint32_t input_lo = read32 (input);
+  uint32_t input_hi = read32 (input + len - 4);
+  uint64_t input_64 = input_lo + ((uint64_t) input_hi << 32);
+  uint64_t bitflip = read64 (secret + 16) ^ read64 (secret + 24);
+  uint64_t keyed = input_64 ^ bitflip;
+  xxh3_uint128 m128 = mult64to128 (keyed, PRIME64_1 + (len << 2));
+
+  m128.high += m128.low << 1;
+  m128.low ^= m128.high >> 3;
+  m128.low ^= m128.low >> 35;
+  m128.low *= PRIME_MX2;
+  m128.low ^= m128.low >> 28;
+  m128.high = xxh3_avalanche (m128.high);
+  return m128;
+}
+
+/* Hash an input of 9 to 16 bytes.  */
+
+static xxh3_uint128
+hash_9to16 (const unsigned char *input, size_t len)
+{
+  uint64_t bitflipl = read64 (secret + 32) ^ read64 (secret + 40);
+  uint64_t bitfliph = read64 (secret + 48) ^ read64 (secret + 56);
+  uint64_t input_lo = read64 (input);
+  uint64_t input_hi = read64 (input + len - 8);
+  xxh3_uint128 m128 = mult64to128 (input_lo ^ input_hi ^ bitflipl,
+				   PRIME64_1);
+  xxh3_uint128 h;
+
+  m128.low += (uint64_t) (len - 1) << 54;
+  input_hi ^= bitfliph;
+  m128.high += (input_hi
+		+ (uint64_t) (uint32_t) input_hi * (PRIME32_2 - 1));
+  m128.low ^= swap64 (m128.high);
+
+  h = mult64to128 (m128.low, PRIME64_2);
+  h.high += m128.high * PRIME64_2;
+  h.low = xxh3_avalanche (h.low);
+  h.high = xxh3_avalanche (h.high);
+  return h;
+}
+
+/* Hash an input of at most 16 bytes.  */
+
+static xxh3_uint128
+hash_0to16 (const unsigned char *input, size_t len)
+{
+  xxh3_uint128 h;
+
+  if (len > 8)
+    return hash_9to16 (input, len);
+  if (len >= 4)
+    return hash_4to8 (input, len);
+  if (len > 0)
+    return hash_1to3 (input, len);
+  h.low = xxh64_avalanche (read64 (secret + 64) ^ read64 (secret + 72));
+  h.high = xxh64_avalanche (read64 (secret + 80) ^ read64 (secret + 88));
+  return h;
+}
+
+static inline uint64_t
+mix16 (const unsigned char *input, const unsigned char *sec, uint64_t seed)
+{
+  uint64_t input_lo = read64 (input);
+  uint64_t input_hi = read64 (input + 8);
+  return mul128_fold64 (input_lo ^ (read64 (sec) + seed),
+			input_hi ^ (read64 (sec + 8) - seed));
+}
+
+static inline xxh3_uint128
+mix32 (xxh3_uint128 acc, const unsigned char *input_1,
+       const unsigned char *input_2, const unsigned char *sec,
+       uint64_t seed)
+{
+  acc.low += mix16 (input_1, sec, seed);
+  acc.low ^= read64 (input_2) + read64 (input_2 + 8);
+  acc.high += mix16 (input_2, sec + 16, seed);
+  acc.high ^= read64 (input_1) + read64 (input_1 + 8);
+  return acc;
+}
+
+static inline xxh3_uint128
+finish_mid (xxh3_uint128 acc, size_t len)
+{
+  xxh3_uint128 h;
+
+  h.low = acc.low + acc.high;
+  h.high = (acc.low * PRIME64_1
+	    + acc.high * PRIME64_4
+	    + (uint64_t) len * PRIME64_2);
+  h.low = xxh3_avalanche (h.low);
+  h.high = 0 - xxh3_avalanche (h.high);
+  return h;
+}
+
+/* Hash an input of 17 to 128 bytes.  */
+
+static xxh3_uint128
+hash_17to128 (const unsigned char *input, size_t len)
+{
+  xxh3_uint128 acc;
+  size_t i;
+
+  acc.low = len * PRIME64_1;
+  acc.high = 0;
+  i = (len - 1) / 32;
+  do
+    acc = mix32 (acc, input + 16 * i, input + len - 16 * (i + 1),
+		 secret + 32 * i, 0);
+  while (i-- != 0);
+  return finish_mid (acc, len);
+}
+
+/* Hash an input of 129 to 240 bytes.  */
+
+static xxh3_uint128
+hash_129to240 (const unsigned char *input, size_t len)
+{
+  size_t rounds = len / 32;
+  xxh3_uint128 acc;
+  size_t i;
+
+  acc.low = len * PRIME64_1;
+  acc.high = 0;
+  for (i = 0; i < 4; i++)
+    acc = mix32 (acc, input + 32 * i, input + 32 * i + 16,
+		 secret + 32 * i, 0);
+  acc.low = xxh3_avalanche (acc.low);
+  acc.high = xxh3_avalanche (acc.high);
+  for (i = 4; i < rounds; i++)
+    acc = mix32 (acc, input + 32 * i, input + 32 * i + 16,
+		 secret + MIDSIZE_STARTOFFSET + 32 * (i - 4), 0);
+  acc = mix32 (acc, input + len - 16, input + len - 32,
+	       secret + SECRET_SIZE_MIN - MIDSIZE_LASTOFFSET - 16, 0);
+  return finish_mid (acc, len);
+}
+
+/* Accumulate one 64-byte stripe of INPUT into ACC, using the 64 bytes
+   of the secret at SEC.  */
+
+#if defined (__SSE2__)
+
+static inline void
+accumulate_512 (__m128i *acc, const unsigned char *input,
+		const unsigned char *sec)
+{
+  size_t i;
+
+  for (i = 0; i < STRIPE_LEN / sizeof (__m128i); i++)
+    {
+      __m128i data_vec = _mm_loadu_si128 ((const __m128i *) input + i);
+      __m128i key_vec = _mm_loadu_si128 ((const __m128i *) sec + i);
+      __m128i data_key = _mm_xor_si128 (data_vec, key_vec);
+      /* Multiply the low 32 bits of each 64-bit lane by the high
+	 32 bits.  */
+      __m128i data_key_lo = _mm_shuffle_epi32 (data_key,
+					       _MM_SHUFFLE (0, 3, 0, 1));
+      __m128i product = _mm_mul_epu32 (data_key, data_key_lo);
+      /* Add the input to the neighbouring lane.  */
+      __m128i data_swap = _mm_shuffle_epi32 (data_vec,
+					     _MM_SHUFFLE (1, 0, 3, 2));
+      __m128i sum = _mm_add_epi64 (acc[i], data_swap);
+      acc[i] = _mm_add_epi64 (product, sum);
+    }
+}
+
+static inline void
+scramble_acc (__m128i *acc, const unsigned char *sec)
+{
+  const __m128i prime32 = _mm_set1_epi32 ((int) PRIME32_1);
+  size_t i;
+
+  for (i = 0; i < STRIPE_LEN / sizeof (__m128i); i++)
+    {
+      __m128i acc_vec = acc[i];
+      __m128i shifted = _mm_srli_epi64 (acc_vec, 47);
+      __m128i data_vec = _mm_xor_si128 (acc_vec, shifted);
+      __m128i key_vec = _mm_loadu_si128 ((const __m128i *) sec + i);
+      __m128i data_key = _mm_xor_si128 (data_vec, key_vec);
+      __m128i data_key_hi = _mm_shuffle_epi32 (data_key,
+					       _MM_SHUFFLE (0, 3, 0, 1));
+      __m128i prod_lo = _mm_mul_epu32 (data_key, prime32);
+      __m128i prod_hi = _mm_mul_epu32 (data_key_hi, prime32);
+      acc[i] = _mm_add_epi64 (prod_lo, _mm_slli_epi64 (prod_hi, 32));
+    }
+}
+
+#else /* !__SSE2__ */
+
+static inline void
+accumulate_512 (uint64_t *acc, const unsigned char *input,
+		const unsigned char *sec)
+{
+  size_t i;
+
+  for (i = 0; i < ACC_NB; i++)
+    {
+      uint64_t data_val = read64 (input + 8 * i);
+      uint64_t data_key = data_val ^ read64 (sec + 8 * i);
+      acc[i ^ 1] += data_val;
+      acc[i] += (uint64_t) (uint32_t) data_key * (data_key >> 32);
+    }
+}
+
+static inline void
+scramble_acc (uint64_t *acc, const unsigned char *sec)
+{
+  size_t i;
+
+  for (i = 0; i < ACC_NB; i++)
+    {
+      uint64_t acc64 = acc[i];
+      acc64 ^= acc64 >> 47;
+      acc64 ^= read64 (sec + 8 * i);
+      acc64 *= PRIME32_1;
+      acc[i] = acc64;
+    }
+}
+
+#endif /* !__SSE2__ */
+
+static uint64_t
+merge_accs (const uint64_t *acc, const unsigned char *sec, uint64_t start)
+{
+  uint64_t result = start;
+  size_t i;
+
+  for (i = 0; i < 4; i++)
+    result += mul128_fold64 (acc[2 * i] ^ read64 (sec + 16 * i),
+			     acc[2 * i + 1] ^ read64 (sec + 16 * i + 8));
+  return xxh3_avalanche (result);
+}
+
+/* Hash an input of more than 240 bytes.  */
+
+static xxh3_uint128
+hash_long (const unsigned char *input, size_t len)
+{
+  const size_t stripes_per_block
+    = (SECRET_SIZE - STRIPE_LEN) / SECRET_CONSUME_RATE;
+  const size_t block_len = STRIPE_LEN * stripes_per_block;
+  const size_t blocks = (len - 1) / block_len;
+  uint64_t acc64[ACC_NB] =
+    {
+      PRIME32_3, PRIME64_1, PRIME64_2, PRIME64_3,
+      PRIME64_4, PRIME32_2, PRIME64_5, PRIME32_1
+    };
+#if defined (__SSE2__)
+  __m128i acc[ACC_NB / 2];
+#else
+  uint64_t *acc = acc64;
+#endif
+  xxh3_uint128 h;
+  size_t stripes;
+  size_t n, s;
+
+#if defined (__SSE2__)
+  for (n = 0; n < ACC_NB / 2; n++)
+    acc[n] = _mm_loadu_si128 ((const __m128i *) acc64 + n);
+#endif
+
+  for (n = 0; n < blocks; n++)
+    {
+      const unsigned char *block = input + n * block_len;
+      for (s = 0; s < stripes_per_block; s++)
+	accumulate_512 (acc, block + s * STRIPE_LEN,
+			secret + s * SECRET_CONSUME_RATE);
+      scramble_acc (acc, secret + SECRET_SIZE - STRIPE_LEN);
+    }
+
+  /* The last partial block, and the last stripe, which may overlap
+     the stripes already processed.  */
+  stripes = ((len - 1) - block_len * blocks) / STRIPE_LEN;
+  for (s = 0; s < stripes; s++)
+    accumulate_512 (acc, input + blocks * block_len + s * STRIPE_LEN,
+		    secret + s * SECRET_CONSUME_RATE);
+  accumulate_512 (acc, input + len - STRIPE_LEN,
+		  secret + SECRET_SIZE - STRIPE_LEN - SECRET_LASTACC_START);
+
+#if defined (__SSE2__)
+  for (n = 0; n < ACC_NB / 2; n++)
+    _mm_storeu_si128 ((__m128i *) acc64 + n, acc[n]);
+#endif
+
+  h.low = merge_accs (acc64, secret + SECRET_MERGEACCS_START,
+		      (uint64_t) len * PRIME64_1);
+  h.high = merge_accs (acc64,
+		       secret + SECRET_SIZE - sizeof acc64
+		       - SECRET_MERGEACCS_START,
+		       ~((uint64_t) len * PRIME64_2));
+  return h;
+}
+
+void *
+xxh3_128_buffer (const char *buffer, size_t len, void *resblock)
+{
+  const unsigned char *input = (const unsigned char *) buffer;
+  unsigned char *result = (unsigned char *) resblock;
+  xxh3_uint128 h;
+
+  if (len <= 16)
+    h = hash_0to16 (input, len);
+  else if (len <= 128)
+    h = hash_17to128 (input, len);
+  else if (len <= MIDSIZE_MAX)
+    h = hash_129to240 (input, len);
+  else
+    h = hash_long (input, len);
+
+  write64_be (result, h.high);
+  write64_be (result + 8, h.low);
+  return resblock;
+}